@@ -5,10 +5,12 @@ document.addEventListener('DOMContentLoaded', () => {
 
     const isLocal = window.location.hostname === '127.0.0.1' || window.location.hostname === 'localhost';
     const apiBasePath = isLocal ? '/mock' : '/api';
+    // The device streams any range of lines; the page only needs the recent ones.
+    const TAIL_LINES = 500;
 
     function fetchLogs() {
         logContent.textContent = 'Loading logs...';
-        fetch(`${apiBasePath}/logs`)
+        fetch(`${apiBasePath}/logs?tail=${TAIL_LINES}`)
             .then(response => response.text())
             .then(text => {
                 logContent.textContent = text || 'Log file is empty.';
@@ -16,6 +16,8 @@ document.addEventListener('DOMContentLoaded', () => {
             document.getElementById('lowDeltaTDurationS').value = data.lowDeltaTDurationS;
             document.getElementById('noAirflowDurationS').value = data.noAirflowDurationS;
             document.getElementById('tempSensorDisconnectedDurationS').value = data.tempSensorDisconnectedDurationS;
+            document.getElementById('sensorReadIntervalMs').value = data.sensorReadIntervalMs;
+            document.getElementById('adcSamplesPerChannel').value = data.adcSamplesPerChannel;
         })
         .catch(error => console.error('Error fetching settings:', error));
 
@@ -28,7 +30,9 @@ document.addEventListener('DOMContentLoaded', () => {
             lowDeltaTThreshold: parseFloat(formData.get('lowDeltaTThreshold')),
             lowDeltaTDurationS: parseInt(formData.get('lowDeltaTDurationS'), 10),
             noAirflowDurationS: parseInt(formData.get('noAirflowDurationS'), 10),
-            tempSensorDisconnectedDurationS: parseInt(formData.get('tempSensorDisconnectedDurationS'), 10)
+            tempSensorDisconnectedDurationS: parseInt(formData.get('tempSensorDisconnectedDurationS'), 10),
+            sensorReadIntervalMs: parseInt(formData.get('sensorReadIntervalMs'), 10),
+            adcSamplesPerChannel: parseInt(formData.get('adcSamplesPerChannel'), 10)
         };
 
         // In local dev, we just simulate success. On the device, we send the real request.
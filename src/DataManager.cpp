@@ -1,23 +1,85 @@
 #include "DataManager.h"
+#include "config.h"
 #include "hardware/IHardwareManager.h"
 #include "interfaces/i_temperature_sensor.h"
-#include "interfaces/i_current_sensor.h"
+#include "interfaces/i_multi_channel_current_sensor.h"
+#include "metrics/stage_metrics.h"
+
+#ifndef ARDUINO
+#include "mocks/Arduino.h" // For millis() mock in native tests
+#endif
 
 DataManager::DataManager(IHardwareManager& hardwareManager,
                          const DeviceAddress& returnAddr,
                          const DeviceAddress& supplyAddr)
     : _hardwareManager(hardwareManager),
       _returnAirSensorAddress(returnAddr),
-      _supplyAirSensorAddress(supplyAddr)
+      _supplyAirSensorAddress(supplyAddr),
+      _readState(ReadState::IDLE),
+      _conversionStartTime(0),
+      _readCycleUs(0)
 {}
 
 void DataManager::readAndProcessData(HVACData& data, unsigned int adcSamples, float ampsOnThreshold) {
+    STAGE_TIMER(MetricStage::SENSOR_READ);
+    {
+        STAGE_TIMER(MetricStage::TEMPERATURE_REQUEST);
+        _hardwareManager.getTempAdapter().requestTemperatures();
+    }
+    readTemperatures(data);
+    readCurrents(data, adcSamples, ampsOnThreshold);
+
+    data.timestamp = millis();
+    data.isInitialized = true;
+}
+
+void DataManager::startReadCycle(HVACData& data, unsigned int adcSamples, float ampsOnThreshold) {
+    // The cycle is recorded once, when it completes, as the time spent here
+    // plus the time spent collecting the temperatures.
+    _readCycleUs = 0;
+    STAGE_PART_TIMER(_readCycleUs);
+    {
+        STAGE_TIMER(MetricStage::TEMPERATURE_REQUEST);
+        _hardwareManager.getTempAdapter().startConversion();
+    }
+    _conversionStartTime = millis();
+    _readState = ReadState::AWAITING_TEMPERATURES;
+
+    // The CT sampling window runs while the DS18B20s are converting.
+    readCurrents(data, adcSamples, ampsOnThreshold);
+}
+
+bool DataManager::pollReadCycle(HVACData& data) {
+    if (_readState != ReadState::AWAITING_TEMPERATURES) {
+        return false;
+    }
+
+    // A sensor that never reports completion (e.g. a shorted bus) must not stall
+    // the cycle forever; after the timeout we read whatever the bus returns.
+    bool timedOut = millis() - _conversionStartTime >= TEMP_CONVERSION_TIMEOUT_MS;
+    if (!_hardwareManager.getTempAdapter().isConversionComplete() && !timedOut) {
+        return false;
+    }
+
+    {
+        STAGE_PART_TIMER(_readCycleUs);
+        readTemperatures(data);
+        data.timestamp = millis();
+        data.isInitialized = true;
+        _readState = ReadState::IDLE;
+    }
+    STAGE_RECORD(MetricStage::SENSOR_READ, _readCycleUs);
+    return true;
+}
+
+bool DataManager::isReadInProgress() const {
+    return _readState != ReadState::IDLE;
+}
+
+void DataManager::readTemperatures(HVACData& data) {
+    STAGE_TIMER(MetricStage::TEMPERATURE_READ);
     ITemperatureSensor& tempSensor = _hardwareManager.getTempAdapter();
-    ICurrentSensor& fanSensor = _hardwareManager.getFanAdapter();
-    ICurrentSensor& compressorSensor = _hardwareManager.getCompressorAdapter();
-    ICurrentSensor& pumpsSensor = _hardwareManager.getPumpsAdapter();
 
-    tempSensor.requestTemperatures();
     data.returnTempC = tempSensor.getTempC(_returnAirSensorAddress);
     data.supplyTempC = tempSensor.getTempC(_supplyAirSensorAddress);
 
@@ -26,14 +88,28 @@ void DataManager::readAndProcessData(HVACData& data, unsigned int adcSamples, fl
     } else {
         data.deltaT = data.returnTempC - data.supplyTempC;
     }
+}
+
+void DataManager::readCurrents(HVACData& data, unsigned int adcSamples, float ampsOnThreshold) {
+    // All three CTs are sampled in one interleaved pass. Splitting the sample
+    // budget across the channels keeps the same time span per channel while
+    // taking a third of the wall time of three sequential windows.
+    unsigned int samplesPerChannel = adcSamples / CURRENT_CHANNEL_COUNT;
+    if (samplesPerChannel == 0) {
+        samplesPerChannel = 1;
+    }
+
+    double irms[CURRENT_CHANNEL_COUNT];
+    {
+        STAGE_TIMER(MetricStage::CURRENT_SAMPLING);
+        _hardwareManager.getCurrentSampler().calcIrms(samplesPerChannel, irms);
+    }
 
-    data.fanAmps = fanSensor.calcIrms(adcSamples);
-    data.compressorAmps = compressorSensor.calcIrms(adcSamples);
-    data.geoPumpsAmps = pumpsSensor.calcIrms(adcSamples);
+    data.fanAmps = irms[FAN_CURRENT_CHANNEL];
+    data.compressorAmps = irms[COMPRESSOR_CURRENT_CHANNEL];
+    data.geoPumpsAmps = irms[PUMPS_CURRENT_CHANNEL];
 
     data.fanStatus = (data.fanAmps > ampsOnThreshold) ? ComponentStatus::ON : ComponentStatus::OFF;
     data.compressorStatus = (data.compressorAmps > ampsOnThreshold) ? ComponentStatus::ON : ComponentStatus::OFF;
     data.geoPumpsStatus = (data.geoPumpsAmps > ampsOnThreshold) ? ComponentStatus::ON : ComponentStatus::OFF;
-
-    data.isInitialized = true;
-}
\ No newline at end of file
+}
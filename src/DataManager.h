@@ -3,6 +3,7 @@
 
 #include "hvac_data.h"
 #include "hvac_hardware_types.h"
+#include <cstdint>
 
 class IHardwareManager; // Forward declaration
 
@@ -12,12 +13,29 @@ public:
                          const DeviceAddress& returnAddr,
                          const DeviceAddress& supplyAddr);
 
+    // Blocking read: waits for the temperature conversion before returning.
     void readAndProcessData(HVACData& data, unsigned int adcSamples, float ampsOnThreshold);
 
+    // Non-blocking read cycle. startReadCycle() starts the temperature conversion
+    // and samples the CTs while the bus converts. pollReadCycle() must then be
+    // called on later loop passes; it returns true once the temperatures have
+    // been collected and `data` holds a complete reading.
+    void startReadCycle(HVACData& data, unsigned int adcSamples, float ampsOnThreshold);
+    bool pollReadCycle(HVACData& data);
+    [[nodiscard]] bool isReadInProgress() const;
+
 private:
+    enum class ReadState { IDLE, AWAITING_TEMPERATURES };
+
+    void readCurrents(HVACData& data, unsigned int adcSamples, float ampsOnThreshold);
+    void readTemperatures(HVACData& data);
+
     IHardwareManager& _hardwareManager;
     const DeviceAddress& _returnAirSensorAddress;
     const DeviceAddress& _supplyAirSensorAddress;
+    ReadState _readState;
+    unsigned long _conversionStartTime;
+    uint32_t _readCycleUs; // Time spent on the cycle so far, for the SENSOR_READ stage
 };
 
-#endif // DATA_PROCESSING_H
\ No newline at end of file
+#endif // DATA_PROCESSING_H
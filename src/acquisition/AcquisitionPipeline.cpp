@@ -0,0 +1,59 @@
+#include "AcquisitionPipeline.h"
+#include "DataManager.h"
+#include "interfaces/i_task_runner.h"
+
+#ifndef ARDUINO
+#include "mocks/Arduino.h" // For millis() mock in native tests
+#endif
+
+AcquisitionPipeline::AcquisitionPipeline(DataManager& dataManager,
+                                         unsigned long readIntervalMs,
+                                         unsigned int adcSamples,
+                                         float ampsOnThreshold)
+    : _dataManager(dataManager),
+      _readIntervalMs(readIntervalMs),
+      _adcSamples(adcSamples),
+      _ampsOnThreshold(ampsOnThreshold),
+      _workingSample(),
+      _lastReadStartTime(0),
+      _droppedSamples(0)
+{}
+
+bool AcquisitionPipeline::start(ITaskRunner& runner, uint32_t pollIntervalMs) {
+    return runner.start(&AcquisitionPipeline::taskEntry, this, pollIntervalMs);
+}
+
+void AcquisitionPipeline::taskEntry(void* context) {
+    static_cast<AcquisitionPipeline*>(context)->step();
+}
+
+void AcquisitionPipeline::step() {
+    // The read cycle is throttled. Starting a cycle kicks off the temperature
+    // conversion and samples the CTs; the temperatures are collected on a later
+    // step so the task sleeps instead of spinning on the 1-Wire bus.
+    unsigned long currentTime = millis();
+    if (!_dataManager.isReadInProgress() &&
+        currentTime - _lastReadStartTime >= _readIntervalMs.load(std::memory_order_relaxed)) {
+        _lastReadStartTime = currentTime;
+        _dataManager.startReadCycle(_workingSample, _adcSamples.load(std::memory_order_relaxed), _ampsOnThreshold);
+    }
+
+    if (_dataManager.pollReadCycle(_workingSample)) {
+        if (!_queue.push(_workingSample)) {
+            _droppedSamples.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void AcquisitionPipeline::setSampling(unsigned long readIntervalMs, unsigned int adcSamples) {
+    _readIntervalMs.store(readIntervalMs, std::memory_order_relaxed);
+    _adcSamples.store(adcSamples, std::memory_order_relaxed);
+}
+
+bool AcquisitionPipeline::popSample(HVACData& sample) {
+    return _queue.pop(sample);
+}
+
+unsigned long AcquisitionPipeline::getDroppedSampleCount() const {
+    return _droppedSamples.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,61 @@
+#ifndef ACQUISITION_PIPELINE_H
+#define ACQUISITION_PIPELINE_H
+
+#include <atomic>
+#include "hvac_data.h"
+#include "concurrency/spsc_ring_buffer.h"
+
+class DataManager;
+class ITaskRunner;
+
+// Runs the sensor read cycle off the main loop. step() is the producer: it
+// drives DataManager's non-blocking read cycle and pushes each completed sample
+// into a lock-free queue. The main loop is the consumer and drains the queue
+// with popSample(), so a slow network call can no longer delay sampling.
+class AcquisitionPipeline {
+public:
+    // Enough headroom for the main loop to stall for several read intervals.
+    static constexpr size_t QUEUE_CAPACITY = 8;
+
+    AcquisitionPipeline(DataManager& dataManager,
+                        unsigned long readIntervalMs,
+                        unsigned int adcSamples,
+                        float ampsOnThreshold);
+
+    // Runs step() repeatedly on the given runner. Returns false if the task
+    // could not be started.
+    bool start(ITaskRunner& runner, uint32_t pollIntervalMs);
+
+    // One producer iteration. Called by the task, or directly from the main
+    // loop when no task runner is available (e.g. native builds).
+    void step();
+
+    // Changes the read interval and the ADC samples taken per read cycle. Safe
+    // to call from the main loop while the task runs; a cycle already under
+    // way finishes with the old values.
+    void setSampling(unsigned long readIntervalMs, unsigned int adcSamples);
+
+    // Consumer side. Returns false if no completed sample is waiting.
+    bool popSample(HVACData& sample);
+
+    // Samples discarded because the consumer fell QUEUE_CAPACITY behind.
+    [[nodiscard]] unsigned long getDroppedSampleCount() const;
+
+private:
+    static void taskEntry(void* context);
+
+    DataManager& _dataManager;
+    // Written by the main loop from the runtime settings, read by step().
+    std::atomic<unsigned long> _readIntervalMs;
+    std::atomic<unsigned int> _adcSamples;
+    const float _ampsOnThreshold;
+
+    // Producer-owned; only ever touched from step().
+    HVACData _workingSample;
+    unsigned long _lastReadStartTime;
+
+    SpscRingBuffer<HVACData, QUEUE_CAPACITY> _queue;
+    std::atomic<unsigned long> _droppedSamples;
+};
+
+#endif // ACQUISITION_PIPELINE_H
@@ -0,0 +1,15 @@
+#include "analog_read_sample_source.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+int AnalogReadSampleSource::readSample(int pin) {
+    return analogRead(pin);
+}
+#else
+// "Hollow" implementation for the native build environment.
+int AnalogReadSampleSource::readSample(int /*pin*/) {
+    // A flat mid-scale signal, i.e. no current flowing.
+    return 512;
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef ANALOG_READ_SAMPLE_SOURCE_H
+#define ANALOG_READ_SAMPLE_SOURCE_H
+
+#include "interfaces/i_adc_sample_source.h"
+
+class AnalogReadSampleSource : public IAdcSampleSource {
+public:
+    int readSample(int pin) override;
+};
+
+#endif // ANALOG_READ_SAMPLE_SOURCE_H
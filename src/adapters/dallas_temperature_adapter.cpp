@@ -8,6 +8,18 @@ void DallasTemperatureAdapter::requestTemperatures() {
     _sensors.requestTemperatures();
 }
 
+void DallasTemperatureAdapter::startConversion() {
+    // Issue the convert command and return immediately instead of blocking for
+    // up to 750 ms (12-bit resolution) while the sensors convert.
+    _sensors.setWaitForConversion(false);
+    _sensors.requestTemperatures();
+    _sensors.setWaitForConversion(true);
+}
+
+bool DallasTemperatureAdapter::isConversionComplete() {
+    return _sensors.isConversionComplete();
+}
+
 float DallasTemperatureAdapter::getTempC(const DeviceAddress& address) {
     float temp = _sensors.getTempC(address);
     // The library returns a specific value for disconnected sensors.
@@ -24,6 +36,12 @@ DallasTemperatureAdapter::DallasTemperatureAdapter() {
 
 void DallasTemperatureAdapter::requestTemperatures() { /* Do nothing in native build. */ }
 
+void DallasTemperatureAdapter::startConversion() { /* Do nothing in native build. */ }
+
+bool DallasTemperatureAdapter::isConversionComplete() {
+    return true; // There is no bus to wait for in a native build.
+}
+
 float DallasTemperatureAdapter::getTempC(const DeviceAddress& /*address*/) {
     // For native tests, return a sensible default or mock value.
     return 20.0; // e.g., return a default room temperature
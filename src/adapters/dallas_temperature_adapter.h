@@ -17,6 +17,8 @@ public:
     DallasTemperatureAdapter(); // Default constructor for native builds
 #endif
     void requestTemperatures() override;
+    void startConversion() override;
+    bool isConversionComplete() override;
     float getTempC(const DeviceAddress& address) override;
 
 private:
@@ -0,0 +1,31 @@
+#include "esp_memory_probe.h"
+
+#ifdef ARDUINO
+#include <Esp.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+uint32_t EspMemoryProbe::freeHeap() {
+    return ESP.getFreeHeap();
+}
+
+uint32_t EspMemoryProbe::largestFreeBlock() {
+    return ESP.getMaxAllocHeap();
+}
+
+uint32_t EspMemoryProbe::minFreeHeap() {
+    return ESP.getMinFreeHeap();
+}
+
+uint32_t EspMemoryProbe::stackHighWater(const char* taskName) {
+    TaskHandle_t handle = xTaskGetHandle(taskName);
+    // On the ESP32 a stack word is a byte, so the mark is already in bytes.
+    return handle ? uxTaskGetStackHighWaterMark(handle) : 0;
+}
+#else
+// "Hollow" implementation for the native build environment.
+uint32_t EspMemoryProbe::freeHeap() { return 0; }
+uint32_t EspMemoryProbe::largestFreeBlock() { return 0; }
+uint32_t EspMemoryProbe::minFreeHeap() { return 0; }
+uint32_t EspMemoryProbe::stackHighWater(const char* /*taskName*/) { return 0; }
+#endif
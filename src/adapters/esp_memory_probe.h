@@ -0,0 +1,15 @@
+#ifndef ESP_MEMORY_PROBE_H
+#define ESP_MEMORY_PROBE_H
+
+#include "interfaces/i_memory_probe.h"
+
+// IMemoryProbe backed by the ESP heap API and FreeRTOS.
+class EspMemoryProbe : public IMemoryProbe {
+public:
+    uint32_t freeHeap() override;
+    uint32_t largestFreeBlock() override;
+    uint32_t minFreeHeap() override;
+    uint32_t stackHighWater(const char* taskName) override;
+};
+
+#endif // ESP_MEMORY_PROBE_H
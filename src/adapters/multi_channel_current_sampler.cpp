@@ -0,0 +1,59 @@
+#include "multi_channel_current_sampler.h"
+#include "interfaces/i_adc_sample_source.h"
+#include <cmath>
+
+MultiChannelCurrentSampler::MultiChannelCurrentSampler(IAdcSampleSource& source,
+                                                       int fanPin, int compressorPin, int pumpsPin,
+                                                       double calibration,
+                                                       int adcCounts,
+                                                       double supplyVoltage)
+    : _source(source),
+      _pins{fanPin, compressorPin, pumpsPin},
+      _offsets{adcCounts / 2.0, adcCounts / 2.0, adcCounts / 2.0},
+      _calibration(calibration),
+      _adcCounts(adcCounts),
+      _supplyVoltage(supplyVoltage),
+      _views{{*this, FAN_CURRENT_CHANNEL}, {*this, COMPRESSOR_CURRENT_CHANNEL}, {*this, PUMPS_CURRENT_CHANNEL}}
+{}
+
+void MultiChannelCurrentSampler::calcIrms(unsigned int samples, double (&irms)[CURRENT_CHANNEL_COUNT]) {
+    double sumOfSquares[CURRENT_CHANNEL_COUNT] = {0.0, 0.0, 0.0};
+
+    for (unsigned int n = 0; n < samples; n++) {
+        for (size_t ch = 0; ch < CURRENT_CHANNEL_COUNT; ch++) {
+            double filtered = filterSample(ch, _source.readSample(_pins[ch]));
+            sumOfSquares[ch] += filtered * filtered;
+        }
+    }
+
+    for (size_t ch = 0; ch < CURRENT_CHANNEL_COUNT; ch++) {
+        irms[ch] = toIrms(sumOfSquares[ch], samples);
+    }
+}
+
+ICurrentSensor& MultiChannelCurrentSampler::channel(CurrentChannel channel) {
+    return _views[channel];
+}
+
+double MultiChannelCurrentSampler::calcChannelIrms(size_t index, unsigned int samples) {
+    double sumOfSquares = 0.0;
+    for (unsigned int n = 0; n < samples; n++) {
+        double filtered = filterSample(index, _source.readSample(_pins[index]));
+        sumOfSquares += filtered * filtered;
+    }
+    return toIrms(sumOfSquares, samples);
+}
+
+double MultiChannelCurrentSampler::filterSample(size_t index, int sample) {
+    // Digital low-pass filter that tracks the DC bias of the CT signal.
+    _offsets[index] = _offsets[index] + (sample - _offsets[index]) / _adcCounts;
+    return sample - _offsets[index];
+}
+
+double MultiChannelCurrentSampler::toIrms(double sumOfSquares, unsigned int samples) const {
+    if (samples == 0) {
+        return 0.0;
+    }
+    double ratio = _calibration * (_supplyVoltage / _adcCounts);
+    return ratio * std::sqrt(sumOfSquares / samples);
+}
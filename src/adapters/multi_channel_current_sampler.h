@@ -0,0 +1,54 @@
+#ifndef MULTI_CHANNEL_CURRENT_SAMPLER_H
+#define MULTI_CHANNEL_CURRENT_SAMPLER_H
+
+#include "interfaces/i_current_sensor.h"
+#include "interfaces/i_multi_channel_current_sensor.h"
+
+class IAdcSampleSource;
+
+// Reads all CT pins round-robin in one pass instead of running a full EmonLib
+// sampling window per channel. Each channel keeps its own DC offset filter and
+// sum of squares, so the maths per channel matches EmonLib::calcIrms().
+class MultiChannelCurrentSampler : public IMultiChannelCurrentSensor {
+public:
+    // EmonLib's scaling on the ESP32 (10-bit ADC_COUNTS, 3.3 V supply). Keeping
+    // the same scaling means existing CT_CALIBRATION values stay valid.
+    static constexpr int DEFAULT_ADC_COUNTS = 1024;
+    static constexpr double DEFAULT_SUPPLY_VOLTAGE = 3.3;
+
+    MultiChannelCurrentSampler(IAdcSampleSource& source,
+                               int fanPin, int compressorPin, int pumpsPin,
+                               double calibration,
+                               int adcCounts = DEFAULT_ADC_COUNTS,
+                               double supplyVoltage = DEFAULT_SUPPLY_VOLTAGE);
+
+    void calcIrms(unsigned int samples, double (&irms)[CURRENT_CHANNEL_COUNT]) override;
+
+    // A single-channel view for code that still expects an ICurrentSensor.
+    // It only samples its own pin but shares that channel's offset filter.
+    [[nodiscard]] ICurrentSensor& channel(CurrentChannel channel);
+
+private:
+    class ChannelView : public ICurrentSensor {
+    public:
+        ChannelView(MultiChannelCurrentSampler& owner, size_t index) : _owner(owner), _index(index) {}
+        double calcIrms(unsigned int samples) override { return _owner.calcChannelIrms(_index, samples); }
+    private:
+        MultiChannelCurrentSampler& _owner;
+        size_t _index;
+    };
+
+    double calcChannelIrms(size_t index, unsigned int samples);
+    double filterSample(size_t index, int sample);
+    double toIrms(double sumOfSquares, unsigned int samples) const;
+
+    IAdcSampleSource& _source;
+    int _pins[CURRENT_CHANNEL_COUNT];
+    double _offsets[CURRENT_CHANNEL_COUNT];
+    double _calibration;
+    int _adcCounts;
+    double _supplyVoltage;
+    ChannelView _views[CURRENT_CHANNEL_COUNT];
+};
+
+#endif // MULTI_CHANNEL_CURRENT_SAMPLER_H
@@ -0,0 +1,25 @@
+#include "system_clock.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+uint32_t SystemClock::nowMs() const {
+    return millis();
+}
+
+uint32_t SystemClock::nowUs() const {
+    return micros();
+}
+#else
+// "Hollow" implementation for the native build environment.
+#include "mocks/Arduino.h"
+
+uint32_t SystemClock::nowMs() const {
+    return static_cast<uint32_t>(millis());
+}
+
+uint32_t SystemClock::nowUs() const {
+    // The mock clock only has millisecond resolution.
+    return static_cast<uint32_t>(millis() * 1000UL);
+}
+#endif
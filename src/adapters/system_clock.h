@@ -0,0 +1,13 @@
+#ifndef SYSTEM_CLOCK_H
+#define SYSTEM_CLOCK_H
+
+#include "interfaces/i_clock.h"
+
+// IClock backed by millis() and micros().
+class SystemClock : public IClock {
+public:
+    [[nodiscard]] uint32_t nowMs() const override;
+    [[nodiscard]] uint32_t nowUs() const override;
+};
+
+#endif // SYSTEM_CLOCK_H
@@ -2,6 +2,8 @@
 #include <memory> // For std::make_unique
 #include "config.h"
 #include "network/PubSubClientWrapper.h"
+#include "interfaces/i_multi_channel_current_sensor.h"
+#include "metrics/stage_metrics.h"
 #include "secrets.h"
 #include "version.h"
 
@@ -13,47 +15,79 @@
 #include "mocks/Arduino.h"
 #endif
 
+namespace {
+    const char* const TAG = "APP";
+
+    // Scheduler priorities; higher runs first when tasks fall due together.
+    constexpr uint8_t PRIORITY_SENSING = 3;
+    constexpr uint8_t PRIORITY_NETWORK = 2;
+    constexpr uint8_t PRIORITY_HOUSEKEEPING = 1;
+    constexpr uint8_t PRIORITY_DISPLAY = 0;
+}
+
 #ifdef ARDUINO
 Application::Application() // Full constructor for hardware builds
     : _systemState(),
-      _aggregationCycleCounter(0),
       _net(),
       _mqttClient(_net),
       _hardwareManager(),
       _spiffs(),
-      _configManager(_spiffs),
-      _logManager(_spiffs),
-      _dataManager(_hardwareManager, returnAirSensorAddress, supplyAirSensorAddress),
-      _webServerManager(_systemState, _configManager, _logManager),
-      _mqttManager(_systemState, _logManager, std::unique_ptr<PubSubClientWrapper>(new PubSubClientWrapper(_mqttClient))),
+      _hardware(_hardwareManager),
+      _fileSystem(_spiffs),
+      _configManager(_fileSystem),
+      _logManager(_fileSystem),
+      _historyLog(_fileSystem, HISTORY_LOG_BASE_PATH, HISTORY_LOG_SEGMENT_COUNT, HISTORY_LOG_RECORDS_PER_SEGMENT, HISTORY_LOG_PAGE_SIZE),
+      _dataManager(_hardware, returnAirSensorAddress, supplyAirSensorAddress),
+      _memoryProbe(),
+      _memoryTelemetry(_memoryProbe),
+      _webServerManager(_systemState, _configManager, _logManager, _scheduler, _memoryTelemetry),
+      _mqttManager(_systemState, _logManager, _fileSystem, std::unique_ptr<PubSubClientWrapper>(new PubSubClientWrapper(_mqttClient))),
       _displayManager(),
-      _lastSensorReadTime(0) {}
+      _acquisitionPipeline(_dataManager, SENSOR_READ_INTERVAL_MS, ADC_SAMPLES_PER_CHANNEL * CURRENT_CHANNEL_COUNT, AMPS_ON_THRESHOLD),
+      _acquisitionTask("acquisition", ACQUISITION_TASK_STACK_SIZE, ACQUISITION_TASK_PRIORITY, ACQUISITION_TASK_CORE),
+      _adaptiveSampler(IDLE_SENSOR_READ_INTERVAL_MS, IDLE_SETTLE_MS),
+      _clock(),
+      _scheduler(_clock) {}
 #else
 Application::Application() // "Hollow" constructor for native testing
+    : Application(_hardwareManager, _spiffs, nullptr) {} // No MQTT client
+
+Application::Application(IHardwareManager& hardware, IFileSystem& fileSystem, std::unique_ptr<IPubSubClient> mqttClient)
     : _systemState(),
-      _aggregationCycleCounter(0),
       // _net and _mqttClient do not exist in native builds
       _hardwareManager(),
       _spiffs(),
-      _configManager(_spiffs),
-      _logManager(_spiffs),
-      _dataManager(_hardwareManager, {}, {}), // Pass empty device addresses
-      _webServerManager(_systemState, _configManager, _logManager),
-      _mqttManager(_systemState, _logManager, nullptr), // Pass nullptr for the client
+      _hardware(hardware),
+      _fileSystem(fileSystem),
+      _configManager(_fileSystem),
+      _logManager(_fileSystem),
+      _historyLog(_fileSystem, HISTORY_LOG_BASE_PATH, HISTORY_LOG_SEGMENT_COUNT, HISTORY_LOG_RECORDS_PER_SEGMENT, HISTORY_LOG_PAGE_SIZE),
+      _dataManager(_hardware, returnAirSensorAddress, supplyAirSensorAddress),
+      _memoryProbe(),
+      _memoryTelemetry(_memoryProbe),
+      _webServerManager(_systemState, _configManager, _logManager, _scheduler, _memoryTelemetry),
+      _mqttManager(_systemState, _logManager, _fileSystem, std::move(mqttClient)),
       _displayManager(),
-      _lastSensorReadTime(0) {}
+      _acquisitionPipeline(_dataManager, SENSOR_READ_INTERVAL_MS, ADC_SAMPLES_PER_CHANNEL * CURRENT_CHANNEL_COUNT, AMPS_ON_THRESHOLD),
+      _acquisitionTask("acquisition", ACQUISITION_TASK_STACK_SIZE, ACQUISITION_TASK_PRIORITY, ACQUISITION_TASK_CORE),
+      _adaptiveSampler(IDLE_SENSOR_READ_INTERVAL_MS, IDLE_SETTLE_MS),
+      _clock(),
+      _scheduler(_clock) {}
 #endif
 
 void Application::setup() {
-#ifdef ARDUINO
     setupSerial();
     setupFileSystem();
 
     // Load configuration from SPIFFS
     _configManager.load();
 
+    restoreHistory();
+
     setupHardware();
-    
+    setupAcquisition();
+
+#ifdef ARDUINO
     // Setup WiFi, WebServer, and MQTT Client
     setupNetwork();
     // Configure MQTT client before setting up the manager that uses it
@@ -61,18 +95,23 @@ void Application::setup() {
     _net.setCertificate(AWS_CERT_CRT);
     _net.setPrivateKey(AWS_CERT_PRIVATE);
     _mqttClient.setServer(AWS_IOT_ENDPOINT, 8883);
+    _mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
+#endif
+    setupMqtt();
+#ifdef ARDUINO
     _webServerManager.setup();
-    _logManager.log("Network setup complete. IP: %s", WiFi.localIP().toString().c_str()); // WiFi is guarded in WebServerManager
+    LOG_INFO(_logManager, TAG, "Network setup complete. IP: %s", WiFi.localIP().toString().c_str()); // WiFi is guarded in WebServerManager
     
     setupWatchdog();
 
     // Setup display
     if (!_displayManager.setup()) {
-        _logManager.log("ERROR: SSD1306 allocation failed");
+        LOG_ERROR(_logManager, TAG, "SSD1306 allocation failed");
     }
-
-    _logManager.log("Setup complete. Entering main loop.");
 #endif
+
+    setupScheduler();
+    LOG_INFO(_logManager, TAG, "Setup complete. Entering main loop.");
 }
 
 void Application::loop() {
@@ -81,69 +120,114 @@ void Application::loop() {
     esp_task_wdt_reset();
 #endif
 
-    // Handle non-blocking network tasks on every loop
-    _mqttManager.handleClient();
+    STAGE_TIMER(MetricStage::LOOP);
+    _scheduler.runDue();
+}
+
+void Application::processSamples() {
+    // Pick up sampling changes saved through the settings page, stretched
+    // while the system is idle.
+    const AppConfig& config = _configManager.getConfig();
+    _acquisitionPipeline.setSampling(_adaptiveSampler.readIntervalMs(config.sensorReadIntervalMs),
+                                     config.adcSamplesPerChannel * CURRENT_CHANNEL_COUNT);
 
-    // The main sensor read and publish cycle is throttled
-    unsigned long currentTime = millis();
-    if (currentTime - _lastSensorReadTime >= SENSOR_READ_INTERVAL_MS) {
-        _lastSensorReadTime = currentTime;
-        performSensorReadCycle();
+    // If the acquisition task could not be started, drive it from here instead.
+    if (!_acquisitionTask.isRunning()) {
+        _acquisitionPipeline.step();
     }
 
-    // The display can update on its own, more frequent schedule
-    _displayManager.update(_systemState.getLatestData());
+    // Consume every sample the acquisition task has completed since the last pass.
+    HVACData sample;
+    while (_acquisitionPipeline.popSample(sample)) {
+        // The alert status is owned by the main loop, not the sensor read.
+        sample.alertStatus = _systemState.getLatestData().alertStatus;
+        _systemState.getLatestData() = sample;
+        completeSensorReadCycle();
+    }
 }
 
-void Application::performSensorReadCycle() {
-    // Read sensor data and process it into the _hvacData member.
-    _dataManager.readAndProcessData(_systemState.getLatestData(), ADC_SAMPLES, AMPS_ON_THRESHOLD);
-
+void Application::completeSensorReadCycle() {
     // Store the latest measurement in our historical data buffer.
     _systemState.recordLatestData();
 
     // Check for alert conditions based on the historical data
-    _systemState.getLatestData().alertStatus = AlertManager::checkAlerts(_systemState.getDataBuffer(), _configManager.getConfig());
+    _systemState.getLatestData().alertStatus = _systemState.evaluateAlerts(_configManager.getConfig());
 
-    // Check if it's time to perform an aggregation cycle.
-    _aggregationCycleCounter++;
-    if (_aggregationCycleCounter >= DATA_BUFFER_SIZE) {
-        performAggregation();
-        _aggregationCycleCounter = 0;
+    // Read faster on any transition or alert, slower once things settle.
+    if (_adaptiveSampler.update(_systemState.getLatestData())) {
+        LOG_INFO(_logManager, TAG, "Sampling %s", _adaptiveSampler.isIdle() ? "slowed: system idle" : "resumed: system active");
     }
 
+    // Let the cloud see transitions now rather than with the next aggregate.
+    _mqttManager.publishChanges(_systemState.getLatestData());
+
     // Log the current status to the serial monitor for debugging.
     logStatus();
 }
 
 void Application::logStatus() {
-#ifdef ARDUINO
-    // This provides a concise summary of the system state to the serial monitor.
+    // This provides a concise summary of the system state for debugging. It
+    // runs every read cycle, so release builds compile it out.
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
     const HVACData& data = _systemState.getLatestData();
-    Serial.printf("[Status] Ret: %.2fC, Sup: %.2fC, dT: %.2fC | Fan: %.2fA, Comp: %.2fA, Pumps: %.2fA | Alert: %d\n",
-                  data.returnTempC,
-                  data.supplyTempC,
-                  data.deltaT,
-                  data.fanAmps,
-                  data.compressorAmps,
-                  data.geoPumpsAmps,
-                  static_cast<int>(data.alertStatus));
+    LOG_DEBUG(_logManager, "STATUS", "Ret: %.2fC, Sup: %.2fC, dT: %.2fC | Fan: %.2fA, Comp: %.2fA, Pumps: %.2fA | Alert: %d",
+              data.returnTempC,
+              data.supplyTempC,
+              data.deltaT,
+              data.fanAmps,
+              data.compressorAmps,
+              data.geoPumpsAmps,
+              static_cast<int>(data.alertStatus));
 #endif
 }
 
 void Application::performAggregation() {
-    // Use the dedicated aggregator to calculate the averages and capture final state
-    AggregatedHVACData aggregatedData = DataAggregator::aggregate(_systemState.getDataBuffer(), _systemState.getLatestData());
+    STAGE_TIMER(MetricStage::AGGREGATION);
+    // The statistics were accumulated as samples were recorded; this just takes them.
+    AggregatedHVACData aggregatedData = _systemState.takeAggregate();
     aggregatedData.timestamp = millis();
 
     _systemState.addAggregatedData(aggregatedData);
-#ifdef ARDUINO
-    Serial.printf("[App] Performed data aggregation cycle. Avg dT: %.2f\n", aggregatedData.avgDeltaT);
-#endif
+    // One record every AGGREGATION_INTERVAL_MS is little wear, and a record
+    // left waiting for its page to fill would be lost to a reset.
+    _historyLog.append(aggregatedData);
+    if (!_historyLog.flush()) {
+        LOG_WARNING(_logManager, TAG, "Failed to write aggregate to the history log.");
+    }
+    LOG_DEBUG(_logManager, TAG, "Performed data aggregation cycle. Avg dT: %.2f", aggregatedData.avgDeltaT);
 
     _mqttManager.publishAggregatedData();
 }
 
+void Application::reportSchedule() {
+    // Names any task that ran past its period or fell behind since the last
+    // report; the full table is only logged in debug builds.
+    for (size_t slot = 0; slot < _scheduler.taskSlots(); slot++) {
+        CooperativeScheduler::TaskId id = static_cast<CooperativeScheduler::TaskId>(slot);
+        if (!_scheduler.isActive(id)) {
+            continue;
+        }
+        const CooperativeScheduler::TaskStats& stats = _scheduler.stats(id);
+        LOG_DEBUG(_logManager, "SCHED", "%s: %u runs, mean %u us, max %u us, max late %u ms",
+                  _scheduler.name(id), static_cast<unsigned>(stats.runs), static_cast<unsigned>(stats.meanRunUs()),
+                  static_cast<unsigned>(stats.maxRunUs), static_cast<unsigned>(stats.maxLatenessMs));
+        if (stats.overruns > 0 || stats.missedDeadlines > 0) {
+            LOG_WARNING(_logManager, "SCHED", "%s overran %u time(s) and missed %u deadline(s); max run %u us",
+                        _scheduler.name(id), static_cast<unsigned>(stats.overruns),
+                        static_cast<unsigned>(stats.missedDeadlines), static_cast<unsigned>(stats.maxRunUs));
+        }
+    }
+    _scheduler.resetStats();
+}
+
+void Application::sampleMemory() {
+    MemorySample sample = _memoryTelemetry.sample(millis());
+    LOG_DEBUG(_logManager, TAG, "Heap: %u free, %u largest block (%u%% fragmented), %u minimum",
+              static_cast<unsigned>(sample.freeHeap), static_cast<unsigned>(sample.largestFreeBlock),
+              static_cast<unsigned>(sample.fragmentationPercent()), static_cast<unsigned>(sample.minFreeHeap));
+    _mqttManager.publishMemory(sample);
+}
+
 void Application::setupSerial() {
 #ifdef ARDUINO
     Serial.begin(115200);
@@ -159,14 +243,29 @@ void Application::setupFileSystem() {
     }
 #endif
     _logManager.begin(); // This is now empty but kept for consistency.
-    _logManager.log("System boot. Version: %s", FIRMWARE_VERSION);
+    LOG_INFO(_logManager, TAG, "System boot. Version: %s", FIRMWARE_VERSION);
+}
+
+void Application::restoreHistory() {
+    _historyLog.begin();
+    if (_historyLog.corruptRecordsFound() > 0) {
+        LOG_WARNING(_logManager, TAG, "Skipped %u corrupt history record(s).", static_cast<unsigned>(_historyLog.corruptRecordsFound()));
+    }
+    size_t restored = _historyLog.replay(AGGREGATED_DATA_BUFFER_SIZE, [this](const AggregatedHVACData& data) {
+        _systemState.addAggregatedData(data);
+    });
+    LOG_INFO(_logManager, TAG, "Restored %u aggregated record(s) from flash.", static_cast<unsigned>(restored));
+
+    // The outbox saves its own next sequence number before each aggregate can
+    // be sent; the history log's count is only a floor should that file be lost.
+    _mqttManager.begin(_historyLog.nextSequence());
 }
 
 void Application::setupNetwork() {
 #ifdef ARDUINO
     WiFi.mode(WIFI_STA);
     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    _logManager.log("Connecting to WiFi...");
+    LOG_INFO(_logManager, TAG, "Connecting to WiFi...");
     while (WiFi.status() != WL_CONNECTED) {
         delay(500);
     }
@@ -174,7 +273,44 @@ void Application::setupNetwork() {
 }
 
 void Application::setupHardware() {
-    _hardwareManager.setup();
+    _hardware.setup();
+}
+
+void Application::setupAcquisition() {
+    if (!_acquisitionPipeline.start(_acquisitionTask, ACQUISITION_POLL_INTERVAL_MS)) {
+        LOG_ERROR(_logManager, TAG, "Failed to start acquisition task. Sampling from the main loop.");
+    }
+}
+
+void Application::setupMqtt() {
+    _mqttManager.setBatching(MQTT_BATCH_MAX_RECORDS, MQTT_BATCH_MAX_LATENCY_MS);
+    _mqttManager.setEncoding(MQTT_PAYLOAD_ENCODING);
+    _logManager.setRemoteSink([this](LogLevel level, const char* tag, const char* message) {
+        _mqttManager.publishLog(level, tag, message);
+    });
+}
+
+void Application::setupScheduler() {
+    // Samples are drained on every pass; aggregation shares their priority so
+    // a period never closes ahead of a sample that was already waiting.
+    _scheduler.addPeriodic("sensing", 0, PRIORITY_SENSING, [this]() { processSamples(); });
+    _scheduler.addPeriodic("aggregation", AGGREGATION_INTERVAL_MS, PRIORITY_SENSING, [this]() { performAggregation(); });
+    // The client is not thread-safe, so log lines queued by any task are
+    // published from here too.
+    _scheduler.addPeriodic("mqtt", 0, PRIORITY_NETWORK, [this]() {
+        _mqttManager.handleClient();
+        _logManager.sendRemote();
+    });
+    CooperativeScheduler::TaskId reconnect = _scheduler.addPeriodic("mqtt-reconnect", MQTT_RECONNECT_INTERVAL_MS, PRIORITY_NETWORK,
+                                                                    [this]() { _mqttManager.reconnect(); });
+    _scheduler.trigger(reconnect); // Connect straight away rather than after one interval
+    _scheduler.addPeriodic("log-flush", LOG_FLUSH_CHECK_INTERVAL_MS, PRIORITY_HOUSEKEEPING, [this]() { _logManager.update(); });
+    _scheduler.addPeriodic("sched-report", SCHEDULER_REPORT_INTERVAL_MS, PRIORITY_HOUSEKEEPING, [this]() { reportSchedule(); });
+    CooperativeScheduler::TaskId memory = _scheduler.addPeriodic("memory", MEMORY_SAMPLE_INTERVAL_MS, PRIORITY_HOUSEKEEPING,
+                                                                 [this]() { sampleMemory(); });
+    _scheduler.trigger(memory); // A baseline taken right after setup
+    _scheduler.addPeriodic("display", DISPLAY_UPDATE_INTERVAL_MS, PRIORITY_DISPLAY,
+                           [this]() { _displayManager.update(_systemState.getLatestData()); });
 }
 
 void Application::setupWatchdog() {
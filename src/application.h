@@ -2,16 +2,24 @@
 #define APPLICATION_H
 
 #include <array>
+#include <memory>
 #include "config.h"
 #include "hvac_data.h"
 #include "logging/log_manager.h"
 #include "config/config_manager.h"
 #include "logic/alert_manager.h"
-#include "logic/data_aggregator.h"
 #include "DataManager.h"
+#include "acquisition/AcquisitionPipeline.h"
+#include "logic/adaptive_sampler.h"
+#include "concurrency/freertos_task_runner.h"
+#include "concurrency/cooperative_scheduler.h"
+#include "adapters/system_clock.h"
+#include "adapters/esp_memory_probe.h"
+#include "metrics/memory_telemetry.h"
 #include "state/SystemState.h"
 #include "hardware/hardware_manager.h"
 #include "fs/SPIFFSFileSystem.h"
+#include "storage/TimeSeriesLog.h"
 #include "network/WebServerManager.h" // Corrected path
 #include "network/MqttManager.h"
 #include "display/display_manager.h"
@@ -27,12 +35,16 @@
 class Application {
 public:
     Application();
+#ifndef ARDUINO
+    // Runs against the given hardware, filesystem and MQTT client instead of
+    // the hollow native ones, e.g. to simulate the whole system on a PC.
+    Application(IHardwareManager& hardware, IFileSystem& fileSystem, std::unique_ptr<IPubSubClient> mqttClient);
+#endif
     void setup();
     void loop();
 
 private:
     SystemState _systemState;
-    size_t _aggregationCycleCounter;
     // Network objects are now owned by Application
 #ifdef ARDUINO
     // Hardware-specific network objects are owned by Application
@@ -41,24 +53,45 @@ private:
 #endif
     HardwareManager _hardwareManager;
     SPIFFSFileSystem _spiffs; // The concrete filesystem object
+    // What the managers use: the two above, unless others were passed in
+    IHardwareManager& _hardware;
+    IFileSystem& _fileSystem;
     // Managers - order matters for initialization
     ConfigManager _configManager;
     LogManager _logManager;
+    TimeSeriesLog _historyLog; // Aggregated data persisted across reboots
     DataManager _dataManager;
+    // Heap and stack figures for /api/status and MQTT
+    EspMemoryProbe _memoryProbe;
+    MemoryTelemetry _memoryTelemetry;
     WebServerManager _webServerManager;
     MqttManager _mqttManager;
     DisplayManager _displayManager;
-    unsigned long _lastSensorReadTime;
+    // Sensor acquisition runs on its own task and hands samples to loop()
+    AcquisitionPipeline _acquisitionPipeline;
+    FreeRtosTaskRunner _acquisitionTask;
+    // Slows the reads down while the system is idle
+    AdaptiveSampler _adaptiveSampler;
+    // Everything loop() does runs as a task here
+    SystemClock _clock;
+    CooperativeScheduler _scheduler;
 
-    void performSensorReadCycle();
+    void processSamples();
+    void completeSensorReadCycle();
     void performAggregation();
     void logStatus();
+    void reportSchedule();
+    void sampleMemory();
     // Helper methods to make setup() more readable
     void setupSerial();
     void setupFileSystem();
+    void restoreHistory();
     void setupNetwork();
     void setupHardware();
+    void setupAcquisition();
+    void setupMqtt();
     void setupWatchdog();
+    void setupScheduler();
 };
 
 #endif // APPLICATION_H
\ No newline at end of file
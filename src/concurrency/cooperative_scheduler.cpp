@@ -0,0 +1,199 @@
+#include "cooperative_scheduler.h"
+#include "interfaces/i_clock.h"
+#include <utility>
+
+namespace {
+    // True once `now` has reached `due`, allowing for the clock wrapping.
+    bool reached(uint32_t now, uint32_t due) {
+        return static_cast<int32_t>(now - due) >= 0;
+    }
+
+    const CooperativeScheduler::TaskStats NO_STATS;
+}
+
+CooperativeScheduler::CooperativeScheduler(IClock& clock)
+    : _clock(clock),
+      _slotsUsed(0)
+{}
+
+CooperativeScheduler::TaskId CooperativeScheduler::addPeriodic(const char* name, uint32_t periodMs, uint8_t priority, Task task) {
+    return add(name, periodMs, periodMs, priority, false, std::move(task));
+}
+
+CooperativeScheduler::TaskId CooperativeScheduler::addOneShot(const char* name, uint32_t delayMs, uint8_t priority, Task task) {
+    return add(name, 0, delayMs, priority, true, std::move(task));
+}
+
+CooperativeScheduler::TaskId CooperativeScheduler::add(const char* name, uint32_t periodMs, uint32_t delayMs,
+                                                       uint8_t priority, bool oneShot, Task task) {
+    // Reuse a freed slot before taking a new one.
+    size_t slot = 0;
+    while (slot < _slotsUsed && _tasks[slot].active) {
+        slot++;
+    }
+    if (slot == MAX_TASKS || !task) {
+        return INVALID_TASK;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (slot == _slotsUsed) {
+        _slotsUsed++;
+    }
+    Entry& entry = _tasks[slot];
+    entry = Entry();
+    entry.name = name;
+    entry.task = std::move(task);
+    entry.periodMs = periodMs;
+    entry.dueMs = _clock.nowMs() + delayMs;
+    entry.priority = priority;
+    entry.active = true;
+    entry.oneShot = oneShot;
+    return static_cast<TaskId>(slot);
+}
+
+void CooperativeScheduler::setPeriod(TaskId id, uint32_t periodMs) {
+    if (valid(id)) {
+        _tasks[id].periodMs = periodMs;
+    }
+}
+
+void CooperativeScheduler::trigger(TaskId id) {
+    if (valid(id) && _tasks[id].active) {
+        _tasks[id].dueMs = _clock.nowMs();
+    }
+}
+
+void CooperativeScheduler::cancel(TaskId id) {
+    // The function is kept until the slot is reused: a task may cancel itself.
+    if (valid(id)) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks[id].active = false;
+    }
+}
+
+size_t CooperativeScheduler::runDue() {
+    // Pick the due tasks first so a task made due by another runs next pass.
+    uint32_t now = _clock.nowMs();
+    size_t order[MAX_TASKS];
+    size_t dueCount = 0;
+    for (size_t i = 0; i < _slotsUsed; i++) {
+        if (!_tasks[i].active || !reached(now, _tasks[i].dueMs)) {
+            continue;
+        }
+        // Insertion sort by priority; a stable one, so ties keep their order.
+        size_t j = dueCount++;
+        while (j > 0 && _tasks[order[j - 1]].priority < _tasks[i].priority) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    size_t ran = 0;
+    for (size_t k = 0; k < dueCount; k++) {
+        Entry& entry = _tasks[order[k]];
+        if (entry.active) { // An earlier task may have cancelled it
+            run(entry);
+            ran++;
+        }
+    }
+    return ran;
+}
+
+void CooperativeScheduler::run(Entry& entry) {
+    uint32_t startMs = _clock.nowMs();
+    uint32_t lateness = startMs - entry.dueMs;
+    uint32_t startUs = _clock.nowUs();
+    entry.task();
+    uint32_t runUs = _clock.nowUs() - startUs;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    TaskStats& stats = entry.stats;
+    stats.runs++;
+    stats.lastRunUs = runUs;
+    stats.totalRunUs += runUs;
+    if (runUs > stats.maxRunUs) {
+        stats.maxRunUs = runUs;
+    }
+    if (entry.periodMs > 0 && lateness > stats.maxLatenessMs) {
+        stats.maxLatenessMs = lateness;
+    }
+    if (entry.periodMs > 0 && runUs > static_cast<uint64_t>(entry.periodMs) * 1000) {
+        stats.overruns++;
+    }
+
+    if (entry.oneShot || !entry.active) {
+        entry.active = false;
+        entry.task = nullptr;
+        return;
+    }
+    if (entry.periodMs == 0) {
+        entry.dueMs = startMs;
+        return;
+    }
+    // Keep to the original cadence, skipping whole periods that went by.
+    uint32_t missed = lateness / entry.periodMs;
+    stats.missedDeadlines += missed;
+    entry.dueMs += (missed + 1) * entry.periodMs;
+}
+
+uint32_t CooperativeScheduler::msUntilNextDue() const {
+    uint32_t now = _clock.nowMs();
+    bool any = false;
+    uint32_t soonest = 0;
+    for (size_t i = 0; i < _slotsUsed; i++) {
+        const Entry& entry = _tasks[i];
+        if (!entry.active) {
+            continue;
+        }
+        if (reached(now, entry.dueMs)) {
+            return 0;
+        }
+        uint32_t wait = entry.dueMs - now;
+        if (!any || wait < soonest) {
+            soonest = wait;
+            any = true;
+        }
+    }
+    return soonest;
+}
+
+bool CooperativeScheduler::isActive(TaskId id) const {
+    return valid(id) && _tasks[id].active;
+}
+
+const char* CooperativeScheduler::name(TaskId id) const {
+    return valid(id) ? _tasks[id].name : nullptr;
+}
+
+uint32_t CooperativeScheduler::period(TaskId id) const {
+    return valid(id) ? _tasks[id].periodMs : 0;
+}
+
+uint8_t CooperativeScheduler::priority(TaskId id) const {
+    return valid(id) ? _tasks[id].priority : 0;
+}
+
+const CooperativeScheduler::TaskStats& CooperativeScheduler::stats(TaskId id) const {
+    return valid(id) ? _tasks[id].stats : NO_STATS;
+}
+
+size_t CooperativeScheduler::snapshot(TaskSnapshot* tasks, size_t capacity) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = 0;
+    for (size_t i = 0; i < _slotsUsed && count < capacity; i++) {
+        if (_tasks[i].active) {
+            tasks[count].name = _tasks[i].name;
+            tasks[count].stats = _tasks[i].stats;
+            count++;
+        }
+    }
+    return count;
+}
+
+void CooperativeScheduler::resetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < _slotsUsed; i++) {
+        _tasks[i].stats = TaskStats();
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef COOPERATIVE_SCHEDULER_H
+#define COOPERATIVE_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+class IClock;
+
+// Runs registered tasks from the main loop as they fall due. Tasks are
+// cooperative: each one runs to completion, so a slow task delays everything
+// behind it. The per-task statistics show which one that is.
+//
+// A periodic task is due one period after its last due time. If it starts a
+// whole period or more late, the runs it missed are skipped rather than made
+// up in a burst, and they are counted as missed deadlines. A period of 0 runs
+// the task on every pass.
+//
+// Everything runs on the thread that calls runDue(), except snapshot(), which
+// may be called from any thread.
+class CooperativeScheduler {
+public:
+    using Task = std::function<void()>;
+    using TaskId = int;
+
+    static constexpr TaskId INVALID_TASK = -1;
+    static constexpr size_t MAX_TASKS = 12;
+
+    struct TaskStats {
+        uint32_t runs = 0;
+        uint32_t overruns = 0;        // Runs that took longer than the period
+        uint32_t missedDeadlines = 0; // Periodic runs skipped because of lateness
+        uint32_t lastRunUs = 0;
+        uint32_t maxRunUs = 0;
+        uint64_t totalRunUs = 0;
+        uint32_t maxLatenessMs = 0;   // Longest wait past the due time
+
+        [[nodiscard]] uint32_t meanRunUs() const {
+            return runs > 0 ? static_cast<uint32_t>(totalRunUs / runs) : 0;
+        }
+    };
+
+    // One active task's name and statistics, as copied by snapshot().
+    struct TaskSnapshot {
+        const char* name = nullptr;
+        TaskStats stats;
+    };
+
+    explicit CooperativeScheduler(IClock& clock);
+
+    // Runs `task` every `periodMs`, the first time one period from now.
+    // Higher priorities run first when several tasks are due together. Returns
+    // INVALID_TASK if every slot is taken. `name` must outlive the scheduler.
+    TaskId addPeriodic(const char* name, uint32_t periodMs, uint8_t priority, Task task);
+    // Runs `task` once, `delayMs` from now; its slot is then freed.
+    TaskId addOneShot(const char* name, uint32_t delayMs, uint8_t priority, Task task);
+
+    // Takes effect from the next due time.
+    void setPeriod(TaskId id, uint32_t periodMs);
+    // Makes the task due on the next pass.
+    void trigger(TaskId id);
+    // A task may cancel itself, or another task, while running.
+    void cancel(TaskId id);
+
+    // Runs every task that is due, highest priority first and in order of
+    // registration among equals. Returns the number of tasks run.
+    size_t runDue();
+    // Time until the next task is due; 0 if one is due now or none is active.
+    [[nodiscard]] uint32_t msUntilNextDue() const;
+
+    [[nodiscard]] bool isActive(TaskId id) const;
+    [[nodiscard]] const char* name(TaskId id) const;
+    [[nodiscard]] uint32_t period(TaskId id) const;
+    [[nodiscard]] uint8_t priority(TaskId id) const;
+    [[nodiscard]] const TaskStats& stats(TaskId id) const;
+    // Slots in use or used before; iterate ids 0..taskSlots()-1 with isActive().
+    [[nodiscard]] size_t taskSlots() const { return _slotsUsed; }
+    // Copies the active tasks, in slot order, into `tasks` under a lock, so
+    // each task's figures are from the same moment. Returns the number
+    // copied, at most `capacity`; MAX_TASKS is always enough.
+    size_t snapshot(TaskSnapshot* tasks, size_t capacity) const;
+    void resetStats();
+
+private:
+    struct Entry {
+        const char* name = nullptr;
+        Task task;
+        uint32_t periodMs = 0;
+        uint32_t dueMs = 0;
+        uint8_t priority = 0;
+        bool active = false;
+        bool oneShot = false;
+        TaskStats stats;
+    };
+
+    TaskId add(const char* name, uint32_t periodMs, uint32_t delayMs, uint8_t priority, bool oneShot, Task task);
+    void run(Entry& entry);
+    [[nodiscard]] bool valid(TaskId id) const { return id >= 0 && static_cast<size_t>(id) < _slotsUsed; }
+
+    IClock& _clock;
+    Entry _tasks[MAX_TASKS];
+    size_t _slotsUsed;
+    // Held while anything snapshot() copies is changed, never while a task runs.
+    mutable std::mutex _mutex;
+};
+
+#endif // COOPERATIVE_SCHEDULER_H
@@ -0,0 +1,65 @@
+#include "freertos_task_runner.h"
+
+FreeRtosTaskRunner::FreeRtosTaskRunner(const char* name, uint32_t stackSize, unsigned int priority, int core)
+    : _name(name),
+      _stackSize(stackSize),
+      _priority(priority),
+      _core(core),
+      _function(nullptr),
+      _context(nullptr),
+      _idleDelayMs(0),
+      _running(false),
+      _stopRequested(false)
+#ifdef ARDUINO
+      , _handle(nullptr)
+#endif
+{}
+
+bool FreeRtosTaskRunner::isRunning() const {
+    return _running.load();
+}
+
+#ifdef ARDUINO
+bool FreeRtosTaskRunner::start(TaskFunction function, void* context, uint32_t idleDelayMs) {
+    if (_running.load()) {
+        return false;
+    }
+    _function = function;
+    _context = context;
+    _idleDelayMs = idleDelayMs;
+    _stopRequested.store(false);
+    _running.store(true);
+
+    BaseType_t result = xTaskCreatePinnedToCore(taskEntry, _name, _stackSize, this, _priority, &_handle, _core);
+    if (result != pdPASS) {
+        _running.store(false);
+        _handle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void FreeRtosTaskRunner::stop() {
+    // The task notices the flag after its current iteration and deletes itself.
+    _stopRequested.store(true);
+}
+
+void FreeRtosTaskRunner::taskEntry(void* param) {
+    FreeRtosTaskRunner* self = static_cast<FreeRtosTaskRunner*>(param);
+    while (!self->_stopRequested.load()) {
+        self->_function(self->_context);
+        // Always block for at least one tick so lower-priority tasks on this
+        // core (including the idle task the watchdog checks) get to run.
+        vTaskDelay(self->_idleDelayMs > 0 ? pdMS_TO_TICKS(self->_idleDelayMs) : 1);
+    }
+    self->_handle = nullptr;
+    self->_running.store(false);
+    vTaskDelete(nullptr); // A FreeRTOS task must never return
+}
+
+#else
+// Native build "hollow" implementations. Use ThreadTaskRunner on the host.
+bool FreeRtosTaskRunner::start(TaskFunction /*function*/, void* /*context*/, uint32_t /*idleDelayMs*/) { return false; }
+void FreeRtosTaskRunner::stop() {}
+void FreeRtosTaskRunner::taskEntry(void* /*param*/) {}
+#endif
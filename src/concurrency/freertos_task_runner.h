@@ -0,0 +1,42 @@
+#ifndef FREERTOS_TASK_RUNNER_H
+#define FREERTOS_TASK_RUNNER_H
+
+#include "interfaces/i_task_runner.h"
+#include <atomic>
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+class FreeRtosTaskRunner : public ITaskRunner {
+public:
+    FreeRtosTaskRunner(const char* name, uint32_t stackSize, unsigned int priority, int core);
+
+    bool start(TaskFunction function, void* context, uint32_t idleDelayMs) override;
+    void stop() override;
+    [[nodiscard]] bool isRunning() const override;
+
+#ifdef ARDUINO
+    // Lets callers report the task's stack high-water mark.
+    [[nodiscard]] TaskHandle_t getHandle() const { return _handle; }
+#endif
+
+private:
+    static void taskEntry(void* param);
+
+    const char* _name;
+    uint32_t _stackSize;
+    unsigned int _priority;
+    int _core;
+    TaskFunction _function;
+    void* _context;
+    uint32_t _idleDelayMs;
+    std::atomic<bool> _running;
+    std::atomic<bool> _stopRequested;
+#ifdef ARDUINO
+    TaskHandle_t _handle;
+#endif
+};
+
+#endif // FREERTOS_TASK_RUNNER_H
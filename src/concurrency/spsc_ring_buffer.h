@@ -0,0 +1,64 @@
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// A lock-free single-producer/single-consumer queue. Exactly one task may call
+// push() and exactly one (other) task may call pop(). An item is copied into its
+// slot before the write index is published with release ordering, and the
+// consumer reads the index with acquire ordering, so the consumer never sees a
+// partially written item.
+template <typename T, size_t Capacity>
+class SpscRingBuffer {
+public:
+    static_assert(Capacity > 0, "SpscRingBuffer needs at least one slot");
+
+    SpscRingBuffer() : _head(0), _tail(0) {}
+
+    // Producer side. Returns false (and drops the item) if the queue is full.
+    bool push(const T& item) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t next = increment(head);
+        if (next == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        _slots[head] = item;
+        _head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool pop(T& item) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _slots[tail];
+        _tail.store(increment(tail), std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with push()/pop().
+    [[nodiscard]] size_t size() const {
+        size_t head = _head.load(std::memory_order_acquire);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        return (head + SLOT_COUNT - tail) % SLOT_COUNT;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] static constexpr size_t capacity() { return Capacity; }
+
+private:
+    // One slot is always left empty to tell "full" apart from "empty".
+    static constexpr size_t SLOT_COUNT = Capacity + 1;
+
+    static size_t increment(size_t index) { return (index + 1) % SLOT_COUNT; }
+
+    std::array<T, SLOT_COUNT> _slots;
+    std::atomic<size_t> _head; // Next slot to write, owned by the producer
+    std::atomic<size_t> _tail; // Next slot to read, owned by the consumer
+};
+
+#endif // SPSC_RING_BUFFER_H
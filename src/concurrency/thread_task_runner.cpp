@@ -0,0 +1,42 @@
+#include "thread_task_runner.h"
+
+#ifndef ARDUINO
+#include <chrono>
+
+ThreadTaskRunner::ThreadTaskRunner() : _running(false), _stopRequested(false) {}
+
+ThreadTaskRunner::~ThreadTaskRunner() {
+    stop();
+}
+
+bool ThreadTaskRunner::start(TaskFunction function, void* context, uint32_t idleDelayMs) {
+    if (_running.load()) {
+        return false;
+    }
+    _stopRequested.store(false);
+    _running.store(true);
+    _thread = std::thread([this, function, context, idleDelayMs]() {
+        while (!_stopRequested.load()) {
+            function(context);
+            if (idleDelayMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(idleDelayMs));
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    return true;
+}
+
+void ThreadTaskRunner::stop() {
+    _stopRequested.store(true);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _running.store(false);
+}
+
+bool ThreadTaskRunner::isRunning() const {
+    return _running.load();
+}
+#endif // ARDUINO
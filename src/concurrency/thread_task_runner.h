@@ -0,0 +1,29 @@
+#ifndef THREAD_TASK_RUNNER_H
+#define THREAD_TASK_RUNNER_H
+
+// Host-side ITaskRunner used to exercise task code with real threads in
+// native tests. Not available in the firmware build.
+#ifndef ARDUINO
+
+#include "interfaces/i_task_runner.h"
+#include <atomic>
+#include <thread>
+
+class ThreadTaskRunner : public ITaskRunner {
+public:
+    ThreadTaskRunner();
+    ~ThreadTaskRunner() override;
+
+    bool start(TaskFunction function, void* context, uint32_t idleDelayMs) override;
+    // Blocks until the thread has finished its current iteration and exited.
+    void stop() override;
+    [[nodiscard]] bool isRunning() const override;
+
+private:
+    std::thread _thread;
+    std::atomic<bool> _running;
+    std::atomic<bool> _stopRequested;
+};
+
+#endif // ARDUINO
+#endif // THREAD_TASK_RUNNER_H
@@ -12,8 +12,35 @@ const int PUMPS_CT_PIN = 32;
 // Application Logic
 const float AMPS_ON_THRESHOLD = 0.5f;
 const float CT_CALIBRATION = 60.606;
-const unsigned int ADC_SAMPLES = 1480;
+const unsigned int ADC_SAMPLES_PER_CHANNEL = 493; // 1480 across the three CTs
 const unsigned long SENSOR_READ_INTERVAL_MS = 5000;
+const unsigned long IDLE_SENSOR_READ_INTERVAL_MS = 30000; // While everything is off and no alert is raised
+const unsigned long IDLE_SETTLE_MS = 120000; // Quiet this long before slowing down
+const unsigned long TEMP_CONVERSION_TIMEOUT_MS = 1000; // DS18B20 needs 750 ms at 12-bit
+const unsigned long AGGREGATION_INTERVAL_MS = 300000; // 5 minutes
+
+// Acquisition Task
+// The Arduino loop() runs on core 1, so sensor acquisition is pinned to core 0.
+const int ACQUISITION_TASK_CORE = 0;
+const unsigned int ACQUISITION_TASK_STACK_SIZE = 4096; // bytes
+const unsigned int ACQUISITION_TASK_PRIORITY = 1;
+const unsigned int ACQUISITION_POLL_INTERVAL_MS = 10;
+
+// History Retention (raw -> 1 min -> 15 min -> 1 h)
+const RetentionTierConfig RETENTION_TIERS[RETENTION_TIER_COUNT] = {
+    {60000UL, 180},   // 1 minute rollups for 3 hours
+    {900000UL, 96},   // 15 minute rollups for 1 day
+    {3600000UL, 168}, // 1 hour rollups for 1 week
+};
+const unsigned int HISTORY_QUERY_MAX_POINTS = 60; // Bounds the /api/history_range response size
+const size_t METRICS_JSON_BUFFER_SIZE = 6144; // Every stage and task slot with every counter at its widest
+
+// Persistent Aggregated History Log
+// 8 segments x 64 records of 64 bytes = 32 KB on SPIFFS, ~42 hours at 5 minute aggregation.
+const char* const HISTORY_LOG_BASE_PATH = "/history";
+const unsigned int HISTORY_LOG_SEGMENT_COUNT = 8;
+const unsigned int HISTORY_LOG_RECORDS_PER_SEGMENT = 64;
+const unsigned int HISTORY_LOG_PAGE_SIZE = 256; // SPIFFS logical page size
 
 // Alerting Thresholds
 const float LOW_DELTA_T_THRESHOLD = 2.0f;      // Degrees C
@@ -24,6 +51,53 @@ const unsigned int TEMP_SENSOR_DISCONNECTED_DURATION_S = 30; // 30 seconds
 // Watchdog Timer
 const unsigned int WATCHDOG_TIMEOUT_S = 15; // seconds
 
+// Main Loop Schedule
+// Sensing and the MQTT client run on every pass; these are the periodic tasks.
+const unsigned long DISPLAY_UPDATE_INTERVAL_MS = 1000;
+const unsigned long LOG_FLUSH_CHECK_INTERVAL_MS = 1000; // LogManager decides whether a flush is due
+const unsigned long SCHEDULER_REPORT_INTERVAL_MS = 900000; // 15 minutes
+
+// Memory Telemetry
+// Sampled every minute, so the history on /api/status covers the last 16.
+const unsigned long MEMORY_SAMPLE_INTERVAL_MS = 60000;
+// The Arduino main loop, the sensor acquisition task and the web server.
+const char* const MEMORY_TRACKED_TASKS[MEMORY_TRACKED_TASK_COUNT] = {"loopTask", "acquisition", "async_tcp"};
+const size_t STATUS_JSON_BUFFER_SIZE = 4096; // The whole memory history at its widest
+
+// MQTT
+// PubSubClient's default 256-byte packet buffer is too small for the aggregated
+// payload. This fits a full batch of worst-case aggregates (~920 bytes each).
+const unsigned int MQTT_BUFFER_SIZE = 6144; // bytes
+// JSON keeps the payload readable by existing cloud rules; BINARY is about a
+// tenth of the size.
+const MqttPayloadEncoding MQTT_PAYLOAD_ENCODING = MqttPayloadEncoding::JSON;
+const char* const MQTT_BINARY_TOPIC_SUFFIX = "/bin";
+// Aggregates waiting to be sent: up to 24 hours of 5-minute aggregates on
+// flash, the newest few also in RAM so they go out without a flash read.
+const char* const MQTT_OUTBOX_SPILL_PATH = "/mqtt_outbox.bin";
+const unsigned int MQTT_OUTBOX_RAM_CAPACITY = 8;
+const unsigned int MQTT_OUTBOX_SPILL_CAPACITY = 288;
+const unsigned int MQTT_OUTBOX_DRAIN_PER_LOOP = 2; // Messages sent per loop() while catching up
+const unsigned long MQTT_RECONNECT_INTERVAL_MS = 5000;
+// Aggregates are sent in batches of up to this many, or once the oldest has
+// waited this long, trading some latency for fewer TLS round-trips. At 1 each
+// aggregate is sent on its own as soon as it is made, in the single-record
+// payload existing cloud rules read; a batch is a different payload.
+const unsigned int MQTT_BATCH_MAX_RECORDS = 1;
+const unsigned long MQTT_BATCH_MAX_LATENCY_MS = 30 * 60 * 1000UL; // 30 minutes
+// Live samples are also sent to the event topic when they change materially:
+// alerts at once, statuses once they have held for the debounce time, and
+// readings once one moves beyond its deadband (rate limited).
+const char* const MQTT_EVENT_TOPIC_SUFFIX = "/event";
+const float MQTT_EVENT_TEMP_DEADBAND_C = 0.5f;
+const float MQTT_EVENT_CURRENT_DEADBAND_A = 0.5f;
+const unsigned long MQTT_EVENT_STATUS_DEBOUNCE_MS = 10000; // Two reads at the 5 s interval
+const unsigned long MQTT_EVENT_ANALOG_MIN_INTERVAL_MS = 60000;
+// Log lines at or above the LogManager REMOTE level are published here.
+const char* const MQTT_LOG_TOPIC_SUFFIX = "/log";
+// Each memory telemetry sample is published here as it is taken.
+const char* const MQTT_TELEMETRY_TOPIC_SUFFIX = "/telemetry";
+
 // I2C Pins for OLED Display
 const int I2C_SDA_PIN = 21;
 const int I2C_SCL_PIN = 22;
@@ -13,6 +13,26 @@
 // The values are based on the project's README.
 constexpr int DATA_BUFFER_SIZE = 60;
 constexpr int AGGREGATED_DATA_BUFFER_SIZE = 32;
+// Raw history kept in the compact store: 22.5 minutes at the 5 s read
+// interval, in the 4.2 KB the DATA_BUFFER_SIZE HVACData it replaced took.
+// Older history is served by the rollup tiers.
+constexpr int SAMPLE_HISTORY_SIZE = 270;
+
+// Rollup tiers behind the raw history, finest first. Each tier keeps `capacity`
+// rollups covering `periodMs` each.
+struct RetentionTierConfig {
+    unsigned long periodMs;
+    unsigned int capacity;
+};
+constexpr int RETENTION_TIER_COUNT = 3;
+extern const RetentionTierConfig RETENTION_TIERS[RETENTION_TIER_COUNT];
+extern const unsigned int HISTORY_QUERY_MAX_POINTS;
+extern const size_t METRICS_JSON_BUFFER_SIZE;
+
+extern const char* const HISTORY_LOG_BASE_PATH;
+extern const unsigned int HISTORY_LOG_SEGMENT_COUNT;
+extern const unsigned int HISTORY_LOG_RECORDS_PER_SEGMENT;
+extern const unsigned int HISTORY_LOG_PAGE_SIZE;
 
 extern const int ONE_WIRE_BUS_PIN;
 extern const int FAN_CT_PIN;
@@ -20,8 +40,19 @@ extern const int COMPRESSOR_CT_PIN;
 extern const int PUMPS_CT_PIN;
 extern const float AMPS_ON_THRESHOLD;
 extern const float CT_CALIBRATION;
-extern const unsigned int ADC_SAMPLES;
+// Defaults for the runtime sampling settings in AppConfig.
+extern const unsigned int ADC_SAMPLES_PER_CHANNEL;
 extern const unsigned long SENSOR_READ_INTERVAL_MS;
+extern const unsigned long IDLE_SENSOR_READ_INTERVAL_MS;
+extern const unsigned long IDLE_SETTLE_MS;
+extern const unsigned long TEMP_CONVERSION_TIMEOUT_MS;
+extern const unsigned long AGGREGATION_INTERVAL_MS;
+
+extern const int ACQUISITION_TASK_CORE;
+extern const unsigned int ACQUISITION_TASK_STACK_SIZE;
+extern const unsigned int ACQUISITION_TASK_PRIORITY;
+extern const unsigned int ACQUISITION_POLL_INTERVAL_MS;
+
 extern const float LOW_DELTA_T_THRESHOLD;
 extern const unsigned int LOW_DELTA_T_DURATION_S;
 extern const unsigned int NO_AIRFLOW_DURATION_S;
@@ -29,6 +60,40 @@ extern const unsigned int TEMP_SENSOR_DISCONNECTED_DURATION_S;
 
 extern const unsigned int WATCHDOG_TIMEOUT_S;
 
+// Main loop schedule (see CooperativeScheduler)
+extern const unsigned long DISPLAY_UPDATE_INTERVAL_MS;
+extern const unsigned long LOG_FLUSH_CHECK_INTERVAL_MS;
+extern const unsigned long SCHEDULER_REPORT_INTERVAL_MS;
+
+// Memory telemetry (see MemoryTelemetry)
+constexpr int MEMORY_HISTORY_SIZE = 16;
+constexpr int MEMORY_TRACKED_TASK_COUNT = 3;
+extern const char* const MEMORY_TRACKED_TASKS[MEMORY_TRACKED_TASK_COUNT];
+extern const unsigned long MEMORY_SAMPLE_INTERVAL_MS;
+extern const size_t STATUS_JSON_BUFFER_SIZE;
+
+// How aggregates are encoded on the wire. BINARY payloads (see BinaryPayload)
+// go to the topic with MQTT_BINARY_TOPIC_SUFFIX appended.
+enum class MqttPayloadEncoding { JSON, BINARY };
+
+extern const unsigned int MQTT_BUFFER_SIZE;
+extern const MqttPayloadEncoding MQTT_PAYLOAD_ENCODING;
+extern const char* const MQTT_BINARY_TOPIC_SUFFIX;
+extern const char* const MQTT_OUTBOX_SPILL_PATH;
+extern const unsigned int MQTT_OUTBOX_RAM_CAPACITY;
+extern const unsigned int MQTT_OUTBOX_SPILL_CAPACITY;
+extern const unsigned int MQTT_OUTBOX_DRAIN_PER_LOOP;
+extern const unsigned long MQTT_RECONNECT_INTERVAL_MS;
+extern const unsigned int MQTT_BATCH_MAX_RECORDS;
+extern const unsigned long MQTT_BATCH_MAX_LATENCY_MS;
+extern const char* const MQTT_EVENT_TOPIC_SUFFIX;
+extern const char* const MQTT_LOG_TOPIC_SUFFIX;
+extern const char* const MQTT_TELEMETRY_TOPIC_SUFFIX;
+extern const float MQTT_EVENT_TEMP_DEADBAND_C;
+extern const float MQTT_EVENT_CURRENT_DEADBAND_A;
+extern const unsigned long MQTT_EVENT_STATUS_DEBOUNCE_MS;
+extern const unsigned long MQTT_EVENT_ANALOG_MIN_INTERVAL_MS;
+
 extern const int I2C_SDA_PIN;
 extern const int I2C_SCL_PIN;
 
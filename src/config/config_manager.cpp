@@ -23,6 +23,8 @@ void ConfigManager::load() {
     _config.lowDeltaTDurationS = LOW_DELTA_T_DURATION_S;
     _config.noAirflowDurationS = NO_AIRFLOW_DURATION_S;
     _config.tempSensorDisconnectedDurationS = TEMP_SENSOR_DISCONNECTED_DURATION_S;
+    _config.sensorReadIntervalMs = SENSOR_READ_INTERVAL_MS;
+    _config.adcSamplesPerChannel = ADC_SAMPLES_PER_CHANNEL;
 
     if (!_fs.exists(CONFIG_FILE)) {
 #ifdef ARDUINO
@@ -55,6 +57,8 @@ void ConfigManager::load() {
     _config.lowDeltaTDurationS = doc["lowDeltaTDurationS"] | LOW_DELTA_T_DURATION_S;
     _config.noAirflowDurationS = doc["noAirflowDurationS"] | NO_AIRFLOW_DURATION_S;
     _config.tempSensorDisconnectedDurationS = doc["tempSensorDisconnectedDurationS"] | TEMP_SENSOR_DISCONNECTED_DURATION_S;
+    _config.sensorReadIntervalMs = doc["sensorReadIntervalMs"] | SENSOR_READ_INTERVAL_MS;
+    _config.adcSamplesPerChannel = doc["adcSamplesPerChannel"] | ADC_SAMPLES_PER_CHANNEL;
 #ifdef ARDUINO
     Serial.println("Loaded configuration from SPIFFS.");
 #endif
@@ -74,6 +78,8 @@ void ConfigManager::save() {
     doc["lowDeltaTDurationS"] = _config.lowDeltaTDurationS;
     doc["noAirflowDurationS"] = _config.noAirflowDurationS;
     doc["tempSensorDisconnectedDurationS"] = _config.tempSensorDisconnectedDurationS;
+    doc["sensorReadIntervalMs"] = _config.sensorReadIntervalMs;
+    doc["adcSamplesPerChannel"] = _config.adcSamplesPerChannel;
 
     JsonPrintAdapter adapter(*configFile);
     if (serializeJson(doc, adapter) == 0) {
@@ -7,6 +7,8 @@ struct AppConfig {
     unsigned int lowDeltaTDurationS;
     unsigned int noAirflowDurationS;
     unsigned int tempSensorDisconnectedDurationS;
+    unsigned long sensorReadIntervalMs;
+    unsigned int adcSamplesPerChannel;
 };
 
 class IFileSystem; // Forward declaration
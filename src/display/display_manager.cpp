@@ -14,10 +14,8 @@
 #include <Wire.h>
 #include <WiFi.h>
 
-const unsigned long DISPLAY_UPDATE_INTERVAL_MS = 1000;
-
 DisplayManager::DisplayManager()
-    : _display(nullptr), _lastUpdateTime(0), _isSetup(false) {
+    : _display(nullptr), _isSetup(false) {
     // Defer display object creation until setup() is called on hardware.
 }
 
@@ -52,12 +50,6 @@ bool DisplayManager::setup() {
 void DisplayManager::update(const HVACData& data) {
     if (!_isSetup) return;
 
-    unsigned long currentTime = millis();
-    if (currentTime - _lastUpdateTime < DISPLAY_UPDATE_INTERVAL_MS) {
-        return;
-    }
-    _lastUpdateTime = currentTime;
-
     drawStatusScreen(data);
 }
 
@@ -81,7 +73,7 @@ void DisplayManager::drawStatusScreen(const HVACData& data) {
 
 #else
 // Native build "hollow" implementations
-DisplayManager::DisplayManager() : _display(nullptr), _lastUpdateTime(0), _isSetup(false) {}
+DisplayManager::DisplayManager() : _display(nullptr), _isSetup(false) {}
 DisplayManager::~DisplayManager() {} // Destructor is empty, _display is nullptr
 bool DisplayManager::setup() { _isSetup = true; return true; }
 void DisplayManager::update(const HVACData& /*data*/) {}
@@ -13,13 +13,13 @@ public:
     ~DisplayManager();
 
     bool setup();
+    // Redraws the status screen; the caller decides how often.
     void update(const HVACData& data);
 
 private:
     void drawStatusScreen(const HVACData& data);
 
     Adafruit_SSD1306* _display;
-    unsigned long _lastUpdateTime;
     bool _isSetup;
 };
 
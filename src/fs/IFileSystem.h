@@ -21,6 +21,8 @@ public:
     virtual void print(const char* content) = 0;
     virtual void println(const char* content) = 0;
     virtual String readString() = 0;
+    // Moves the read position to `position` bytes from the start.
+    virtual bool seek(size_t position) = 0;
     virtual size_t size() = 0;
     virtual void close() = 0;
     virtual operator bool() const = 0;
@@ -15,6 +15,7 @@ size_t SPIFFSFile::readBytes(char *buffer, size_t length) { return _file.readByt
 void SPIFFSFile::print(const char* content) { _file.print(content); }
 void SPIFFSFile::println(const char* content) { _file.println(content); }
 String SPIFFSFile::readString() { return _file.readString(); }
+bool SPIFFSFile::seek(size_t position) { return _file.seek(position); }
 size_t SPIFFSFile::size() { return _file.size(); }
 void SPIFFSFile::close() { _file.close(); }
 SPIFFSFile::operator bool() const { return !!_file; }
@@ -58,6 +59,7 @@ size_t SPIFFSFile::readBytes(char*, size_t) { return 0; }
 void SPIFFSFile::print(const char*) {}
 void SPIFFSFile::println(const char*) {}
 String SPIFFSFile::readString() { return String(); }
+bool SPIFFSFile::seek(size_t) { return false; }
 size_t SPIFFSFile::size() { return 0; }
 void SPIFFSFile::close() {}
 SPIFFSFile::operator bool() const { return false; }
@@ -22,6 +22,7 @@ public:
     void print(const char* content) override;
     void println(const char* content) override;
     String readString() override;
+    bool seek(size_t position) override;
     size_t size() override;
     void close() override;
     operator bool() const override;
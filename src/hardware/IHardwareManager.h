@@ -4,6 +4,7 @@
 // Forward declare interfaces to avoid circular dependencies
 class ITemperatureSensor;
 class ICurrentSensor;
+class IMultiChannelCurrentSensor;
 
 class IHardwareManager {
 public:
@@ -15,6 +16,7 @@ public:
     [[nodiscard]] virtual ICurrentSensor& getFanAdapter() = 0;
     [[nodiscard]] virtual ICurrentSensor& getCompressorAdapter() = 0;
     [[nodiscard]] virtual ICurrentSensor& getPumpsAdapter() = 0;
+    [[nodiscard]] virtual IMultiChannelCurrentSensor& getCurrentSampler() = 0;
 };
 
 #endif // I_HARDWARE_MANAGER_H
\ No newline at end of file
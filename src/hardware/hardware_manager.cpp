@@ -7,21 +7,18 @@ HardwareManager::HardwareManager()
       _tempSensors(&_oneWire),
     // Initialize adapters, passing references to the hardware objects
       _tempAdapter(_tempSensors),
-      _fanAdapter(_fanMonitor),
-      _compressorAdapter(_compressorMonitor),
-      _pumpsAdapter(_pumpsMonitor)
+      _currentSampler(_adcSource, FAN_CT_PIN, COMPRESSOR_CT_PIN, PUMPS_CT_PIN, CT_CALIBRATION)
 {}
 
 void HardwareManager::setup() {
     _tempSensors.begin();
-    _fanMonitor.current(FAN_CT_PIN, CT_CALIBRATION);
-    _compressorMonitor.current(COMPRESSOR_CT_PIN, CT_CALIBRATION);
-    _pumpsMonitor.current(PUMPS_CT_PIN, CT_CALIBRATION);
 }
 #else
 // Native build "hollow" implementations
 HardwareManager::HardwareManager()
-    // Adapters are default-initialized using their native constructors
+    // Adapters are default-initialized using their native constructors.
+    // The sampler reads from the hollow ADC source, so it reports 0 A.
+    : _currentSampler(_adcSource, FAN_CT_PIN, COMPRESSOR_CT_PIN, PUMPS_CT_PIN, CT_CALIBRATION)
 {}
 
 void HardwareManager::setup() {}
@@ -32,13 +29,17 @@ ITemperatureSensor& HardwareManager::getTempAdapter() {
 }
 
 ICurrentSensor& HardwareManager::getFanAdapter() {
-    return _fanAdapter;
+    return _currentSampler.channel(FAN_CURRENT_CHANNEL);
 }
 
 ICurrentSensor& HardwareManager::getCompressorAdapter() {
-    return _compressorAdapter;
+    return _currentSampler.channel(COMPRESSOR_CURRENT_CHANNEL);
 }
 
 ICurrentSensor& HardwareManager::getPumpsAdapter() {
-    return _pumpsAdapter;
+    return _currentSampler.channel(PUMPS_CURRENT_CHANNEL);
+}
+
+IMultiChannelCurrentSensor& HardwareManager::getCurrentSampler() {
+    return _currentSampler;
 }
@@ -6,12 +6,12 @@
 #ifdef ARDUINO
 #include <OneWire.h>
 #include <DallasTemperature.h>
-#include <EmonLib.h>
 #endif
 
 #include "interfaces/i_current_sensor.h"
 #include "adapters/dallas_temperature_adapter.h"
-#include "adapters/emon_lib_adapter.h"
+#include "adapters/analog_read_sample_source.h"
+#include "adapters/multi_channel_current_sampler.h"
 #include "config.h"
 
 class HardwareManager : public IHardwareManager {
@@ -25,18 +25,19 @@ public:
     [[nodiscard]] ICurrentSensor& getFanAdapter() override;
     [[nodiscard]] ICurrentSensor& getCompressorAdapter() override;
     [[nodiscard]] ICurrentSensor& getPumpsAdapter() override;
+    [[nodiscard]] IMultiChannelCurrentSensor& getCurrentSampler() override;
 
 private:
 #ifdef ARDUINO
     // Hardware Objects
     OneWire _oneWire;
     DallasTemperature _tempSensors;
-    EnergyMonitor _fanMonitor, _compressorMonitor, _pumpsMonitor;
 #endif
 
     // Adapters
     DallasTemperatureAdapter _tempAdapter;
-    EmonLibAdapter _fanAdapter, _compressorAdapter, _pumpsAdapter;
+    AnalogReadSampleSource _adcSource;
+    MultiChannelCurrentSampler _currentSampler;
 };
 
 #endif // HARDWARE_MANAGER_H
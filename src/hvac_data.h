@@ -13,6 +13,7 @@
 // This is used to pass data between modules without using global variables.
 struct HVACData {
     bool isInitialized = false;
+    uint32_t timestamp = 0; // millis() when the read completed
     float returnTempC = -127.0;
     float supplyTempC = -127.0;
     float deltaT = 0.0;
@@ -29,12 +30,32 @@ struct HVACData {
 // A struct to hold aggregated data over a period of time.
 struct AggregatedHVACData {
     uint32_t timestamp = 0; // millis() at time of aggregation
+    uint32_t sampleCount = 0; // Number of samples in the aggregation period
+    uint32_t durationMs = 0; // Time the samples stand for; 0 if unknown
     float avgReturnTempC = 0.0;
+    float minReturnTempC = 0.0;
+    float maxReturnTempC = 0.0;
+    float stddevReturnTempC = 0.0;
     float avgSupplyTempC = 0.0;
+    float minSupplyTempC = 0.0;
+    float maxSupplyTempC = 0.0;
+    float stddevSupplyTempC = 0.0;
     float avgDeltaT = 0.0;
+    float minDeltaT = 0.0;
+    float maxDeltaT = 0.0;
+    float stddevDeltaT = 0.0;
     double avgFanAmps = 0.0;
+    double minFanAmps = 0.0;
+    double maxFanAmps = 0.0;
+    double stddevFanAmps = 0.0;
     double avgCompressorAmps = 0.0;
+    double minCompressorAmps = 0.0;
+    double maxCompressorAmps = 0.0;
+    double stddevCompressorAmps = 0.0;
     double avgGeoPumpsAmps = 0.0;
+    double minGeoPumpsAmps = 0.0;
+    double maxGeoPumpsAmps = 0.0;
+    double stddevGeoPumpsAmps = 0.0;
     ComponentStatus lastFanStatus = ComponentStatus::UNKNOWN;
     ComponentStatus lastCompressorStatus = ComponentStatus::UNKNOWN;
     ComponentStatus lastGeoPumpsStatus = ComponentStatus::UNKNOWN;
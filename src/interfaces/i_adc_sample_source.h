@@ -0,0 +1,11 @@
+#ifndef I_ADC_SAMPLE_SOURCE_H
+#define I_ADC_SAMPLE_SOURCE_H
+
+// A source of raw ADC readings. On hardware this wraps analogRead(); in native
+// tests it can be replaced with a synthetic waveform generator.
+class IAdcSampleSource {
+public:
+    virtual ~IAdcSampleSource() = default;
+    virtual int readSample(int pin) = 0;
+};
+#endif // I_ADC_SAMPLE_SOURCE_H
@@ -0,0 +1,17 @@
+#ifndef I_CLOCK_H
+#define I_CLOCK_H
+
+#include <cstdint>
+
+// Monotonic time since boot, so code that schedules or times work can run
+// against a controllable clock in native tests. Both counters wrap; compare
+// them by unsigned subtraction.
+class IClock {
+public:
+    virtual ~IClock() = default;
+
+    [[nodiscard]] virtual uint32_t nowMs() const = 0;
+    [[nodiscard]] virtual uint32_t nowUs() const = 0;
+};
+
+#endif // I_CLOCK_H
@@ -0,0 +1,21 @@
+#ifndef I_MEMORY_PROBE_H
+#define I_MEMORY_PROBE_H
+
+#include <cstdint>
+
+// Reads the heap and task stack figures that MemoryTelemetry records. All
+// sizes are in bytes.
+class IMemoryProbe {
+public:
+    virtual ~IMemoryProbe() = default;
+
+    virtual uint32_t freeHeap() = 0;
+    // The largest single allocation that would currently succeed.
+    virtual uint32_t largestFreeBlock() = 0;
+    // The lowest free heap seen since boot.
+    virtual uint32_t minFreeHeap() = 0;
+    // Stack the named task has never touched, or 0 if there is no such task.
+    virtual uint32_t stackHighWater(const char* taskName) = 0;
+};
+
+#endif // I_MEMORY_PROBE_H
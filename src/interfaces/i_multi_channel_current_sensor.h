@@ -0,0 +1,21 @@
+#ifndef I_MULTI_CHANNEL_CURRENT_SENSOR_H
+#define I_MULTI_CHANNEL_CURRENT_SENSOR_H
+
+#include <cstddef>
+
+// Index of each CT channel in the arrays filled by IMultiChannelCurrentSensor.
+enum CurrentChannel : size_t {
+    FAN_CURRENT_CHANNEL = 0,
+    COMPRESSOR_CURRENT_CHANNEL,
+    PUMPS_CURRENT_CHANNEL,
+    CURRENT_CHANNEL_COUNT
+};
+
+class IMultiChannelCurrentSensor {
+public:
+    virtual ~IMultiChannelCurrentSensor() = default;
+    // Samples every channel in a single pass and writes one RMS value per channel.
+    // `samples` is the number of samples taken on each channel.
+    virtual void calcIrms(unsigned int samples, double (&irms)[CURRENT_CHANNEL_COUNT]) = 0;
+};
+#endif // I_MULTI_CHANNEL_CURRENT_SENSOR_H
@@ -0,0 +1,22 @@
+#ifndef I_TASK_RUNNER_H
+#define I_TASK_RUNNER_H
+
+#include <cstdint>
+
+// Runs a function repeatedly on its own thread of execution. On the ESP32 this
+// is a pinned FreeRTOS task; in native builds it is a std::thread.
+class ITaskRunner {
+public:
+    using TaskFunction = void (*)(void* context);
+
+    virtual ~ITaskRunner() = default;
+
+    // Starts calling `function(context)` in a loop, sleeping `idleDelayMs`
+    // between calls, until stop() is called. Returns false if the task could
+    // not be created or is already running.
+    virtual bool start(TaskFunction function, void* context, uint32_t idleDelayMs) = 0;
+    virtual void stop() = 0;
+    [[nodiscard]] virtual bool isRunning() const = 0;
+};
+
+#endif // I_TASK_RUNNER_H
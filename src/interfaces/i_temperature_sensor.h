@@ -5,7 +5,14 @@
 
 class ITemperatureSensor {
 public:
+    // Blocking request: returns once every device on the bus has a fresh reading.
     virtual void requestTemperatures() = 0;
+
+    // Non-blocking split of requestTemperatures(): kick off a conversion, poll
+    // until the bus reports it is finished, then read each device with getTempC().
+    virtual void startConversion() = 0;
+    virtual bool isConversionComplete() = 0;
+
     virtual float getTempC(const DeviceAddress& address) = 0;
 };
-#endif // I_TEMPERATURE_SENSOR_H
\ No newline at end of file
+#endif // I_TEMPERATURE_SENSOR_H
@@ -1,81 +1,402 @@
 #include "log_manager.h"
+#include "log_streamer.h"
 #include "fs/IFileSystem.h"
-#ifdef ARDUINO
-#include <cstdarg>  // for va_list etc.
 #include <cstdio>   // for snprintf, vsnprintf
+#include <cstring>
+
+#ifndef ARDUINO
+#include "mocks/Arduino.h" // For millis() mock in native tests
 #endif
 
 const char* LOG_FILE = "/system.log";
-const char* OLD_LOG_FILE = "/system.log.old";
-const size_t MAX_LOG_SIZE = 4096; // 4KB
+// Three archives of 4KB each besides the current file.
+const size_t LOG_GENERATIONS = 3;
+const size_t LOG_SIZE_BUDGET = 16384;
+// Four SPIFFS pages. Flushing before it fills leaves room for a burst of
+// lines while the previous batch is written.
+const size_t LOG_BUFFER_SIZE = 1024;
+const size_t LOG_FLUSH_HIGH_WATER = 768;
+const unsigned long LOG_FLUSH_INTERVAL_MS = 10000;
+// Lines waiting for the MQTT task; at the default WARNING level a burst of
+// more than this is already a sign of trouble.
+const size_t LOG_REMOTE_QUEUE_LINES = 8;
+
+namespace {
+    // The single archive kept by earlier firmware; adopted as generation 1.
+    const char* const LEGACY_LOG_FILE = "/system.log.old";
+    constexpr size_t PATH_SIZE = 32; // The SPIFFS limit
+    constexpr size_t PREFIX_SIZE = 40;
+    constexpr size_t MESSAGE_SIZE = 256;
+    constexpr size_t TAG_SIZE = 16;
+    constexpr size_t SINK_CONSOLE = static_cast<size_t>(LogSink::CONSOLE);
+    constexpr size_t SINK_FLASH = static_cast<size_t>(LogSink::FLASH);
+    constexpr size_t SINK_REMOTE = static_cast<size_t>(LogSink::REMOTE);
+
+    char levelLetter(LogLevel level) {
+        switch (level) {
+            case LogLevel::DEBUG: return 'D';
+            case LogLevel::INFO: return 'I';
+            case LogLevel::WARNING: return 'W';
+            case LogLevel::ERROR: return 'E';
+            case LogLevel::CRITICAL: return 'C';
+            default: return '?';
+        }
+    }
+}
 
-LogManager::LogManager(IFileSystem& fs) : _fs(fs) {}
+struct LogManager::RemoteLine {
+    LogLevel level;
+    char tag[TAG_SIZE];
+    char message[MESSAGE_SIZE];
+};
+
+LogManager::LogManager(IFileSystem& fs)
+    : _fs(fs),
+      _generations(0),
+      _fileLimit(0),
+      _metadataLoaded(false),
+      _buffer(new char[LOG_BUFFER_SIZE]),
+      _pending(0),
+      _oldestPendingAt(0),
+      _droppedLines(0),
+      _formatted(0),
+      _minEnabled(LogLevel::NONE),
+      _remoteQueue(new RemoteLine[LOG_REMOTE_QUEUE_LINES]),
+      _remoteHead(0),
+      _remoteCount(0),
+      _droppedRemoteLines(0),
+      _inRemoteSink(false)
+{
+    _levels[SINK_CONSOLE] = LogLevel::DEBUG; // Whatever was compiled in
+    _levels[SINK_FLASH] = LogLevel::INFO;
+    _levels[SINK_REMOTE] = LogLevel::WARNING; // Once a remote sink is set
+    updateMinEnabled();
+    setRotation(LOG_GENERATIONS, LOG_SIZE_BUDGET);
+}
+
+// Defined here, where RemoteLine is a complete type.
+LogManager::~LogManager() = default;
 
 void LogManager::begin() {
     // This is just a placeholder in case any specific setup is needed later.
     // The filesystem is now initialized in the Application class.
 }
 
-void LogManager::rotateLogs() {
-    if (_fs.exists(OLD_LOG_FILE)) {
-        _fs.remove(OLD_LOG_FILE);
+const char* LogManager::logPath(size_t generation, char* buffer, size_t size) {
+    if (generation == 0) {
+        snprintf(buffer, size, "%s", LOG_FILE);
+    } else {
+        snprintf(buffer, size, "%s.%u", LOG_FILE, static_cast<unsigned>(generation));
+    }
+    return buffer;
+}
+
+void LogManager::setRotation(size_t generations, size_t budgetBytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _generations = generations < MAX_GENERATIONS ? generations : MAX_GENERATIONS;
+    _fileLimit = budgetBytes / (_generations + 1);
+    // A full buffer must fit in an empty file.
+    if (_fileLimit < LOG_BUFFER_SIZE) {
+        _fileLimit = LOG_BUFFER_SIZE;
+    }
+    _metadataLoaded = false; // Reload to prune generations beyond the new count
+}
+
+void LogManager::loadMetadata() {
+    char path[PATH_SIZE];
+    for (size_t generation = 0; generation <= MAX_GENERATIONS; generation++) {
+        auto file = _fs.open(logPath(generation, path, sizeof(path)), "r");
+        _present[generation] = file && *file;
+        _sizes[generation] = _present[generation] ? file->size() : 0;
+        if (file) {
+            file->close();
+        }
+        if (generation > _generations && _present[generation]) {
+            _fs.remove(path);
+            _present[generation] = false;
+            _sizes[generation] = 0;
+        }
     }
-    if (_fs.exists(LOG_FILE)) {
-        _fs.rename(LOG_FILE, OLD_LOG_FILE);
+
+    auto legacy = _fs.open(LEGACY_LOG_FILE, "r");
+    if (legacy && *legacy) {
+        size_t size = legacy->size();
+        legacy->close();
+        if (_generations > 0 && !_present[1] && _fs.rename(LEGACY_LOG_FILE, logPath(1, path, sizeof(path)))) {
+            _present[1] = true;
+            _sizes[1] = size;
+        } else {
+            _fs.remove(LEGACY_LOG_FILE);
+        }
     }
+    _metadataLoaded = true;
+}
+
+bool LogManager::rotateLogs() {
+    // Make room at the end of the chain, then move every file up one.
+    // SPIFFS will not rename onto an existing file, so each step frees the
+    // target of the next. The cache follows each step only once it has
+    // succeeded, so after a failure it still matches the files.
+    char from[PATH_SIZE];
+    char to[PATH_SIZE];
+    if (_present[_generations]) {
+        logPath(_generations, to, sizeof(to));
+        if (!_fs.remove(to) && _fs.exists(to)) {
+            return false;
+        }
+        _present[_generations] = false;
+        _sizes[_generations] = 0;
+    }
+    for (size_t generation = _generations; generation > 0; generation--) {
+        if (_present[generation - 1] &&
+            !_fs.rename(logPath(generation - 1, from, sizeof(from)), logPath(generation, to, sizeof(to)))) {
+            return false;
+        }
+        _present[generation] = _present[generation - 1];
+        _sizes[generation] = _sizes[generation - 1];
+        _present[generation - 1] = false;
+        _sizes[generation - 1] = 0;
+    }
+    return true;
+}
+
+const char* LogManager::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::CRITICAL: return "CRITICAL";
+        default: return "NONE";
+    }
+}
+
+void LogManager::setLevel(LogSink sink, LogLevel level) {
+    _levels[static_cast<size_t>(sink)].store(level, std::memory_order_relaxed);
+    updateMinEnabled();
+}
+
+LogLevel LogManager::getLevel(LogSink sink) const {
+    return _levels[static_cast<size_t>(sink)].load(std::memory_order_relaxed);
+}
+
+void LogManager::setRemoteSink(RemoteSink sink) {
+    _remoteSink = std::move(sink);
+    updateMinEnabled();
+}
+
+void LogManager::updateMinEnabled() {
+    LogLevel minimum = LogLevel::NONE;
+    for (size_t sink = 0; sink < SINK_COUNT; sink++) {
+        if (sink == SINK_REMOTE && !_remoteSink) {
+            continue;
+        }
+        LogLevel level = _levels[sink].load(std::memory_order_relaxed);
+        if (level < minimum) {
+            minimum = level;
+        }
+    }
+    // Critical lines always reach flash.
+    _minEnabled.store(minimum < LogLevel::CRITICAL ? minimum : LogLevel::CRITICAL, std::memory_order_relaxed);
 }
 
 void LogManager::log(const char* format, ...) {
+    if (!isEnabled(LogLevel::INFO)) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    append(LogLevel::INFO, nullptr, format, args);
+    va_end(args);
+}
+
+void LogManager::logCritical(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    append(LogLevel::CRITICAL, nullptr, format, args);
+    va_end(args);
+}
+
+void LogManager::write(LogLevel level, const char* tag, const char* format, ...) {
+    if (!isEnabled(level)) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    append(level, tag, format, args);
+    va_end(args);
+}
+
+void LogManager::append(LogLevel level, const char* tag, const char* format, va_list args) {
     // --- Format Message ---
-    char timestampBuffer[16];
-    char messageBuffer[256];
+    char prefixBuffer[PREFIX_SIZE];
+    char messageBuffer[MESSAGE_SIZE];
 
-    // Create timestamp string
+    // Timestamp, level letter and tag, e.g. "[12345] W [MQTT] "
 #ifdef ARDUINO
-    snprintf(timestampBuffer, sizeof(timestampBuffer), "[%lu] ", millis());
+    unsigned long timestamp = millis();
 #else
-    snprintf(timestampBuffer, sizeof(timestampBuffer), "[0] "); // Placeholder for native tests
+    unsigned long timestamp = 0; // Placeholder for native tests
 #endif
+    int prefixLength = tag
+        ? snprintf(prefixBuffer, sizeof(prefixBuffer), "[%lu] %c [%s] ", timestamp, levelLetter(level), tag)
+        : snprintf(prefixBuffer, sizeof(prefixBuffer), "[%lu] %c ", timestamp, levelLetter(level));
+    if (prefixLength < 0 || static_cast<size_t>(prefixLength) >= sizeof(prefixBuffer)) {
+        prefixLength = static_cast<int>(strlen(prefixBuffer));
+    }
 
     // Create formatted message string
-    va_list args;
-    va_start(args, format);
     vsnprintf(messageBuffer, sizeof(messageBuffer), format, args);
-    va_end(args);
+    _formatted++;
 
     // --- Output to Serial ---
 #ifdef ARDUINO
-    Serial.print(timestampBuffer);
-    Serial.println(messageBuffer);
+    if (level >= getLevel(LogSink::CONSOLE)) {
+        Serial.print(prefixBuffer);
+        Serial.println(messageBuffer);
+    }
 #endif
 
-    // --- Output to File ---
-    auto logFile = _fs.open(LOG_FILE, "a");
-    if (logFile && logFile->size() > MAX_LOG_SIZE) {
-        logFile->close(); // Close before rotating
-        rotateLogs();
-        logFile = _fs.open(LOG_FILE, "a");
+    // --- Output to the file buffer ---
+    if (level >= getLevel(LogSink::FLASH) || level >= LogLevel::CRITICAL) {
+        appendToBuffer(prefixBuffer, prefixLength, messageBuffer, strlen(messageBuffer), level >= LogLevel::CRITICAL);
+    }
+
+    // --- Queue for the remote sink ---
+    if (_remoteSink && level >= getLevel(LogSink::REMOTE) && !_inRemoteSink.load()) {
+        queueRemote(level, tag ? tag : "", messageBuffer);
+    }
+}
+
+void LogManager::queueRemote(LogLevel level, const char* tag, const char* message) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_remoteCount == LOG_REMOTE_QUEUE_LINES) {
+        // Keep the lines already waiting; they say when the trouble began.
+        _droppedRemoteLines++;
+        return;
+    }
+    RemoteLine& line = _remoteQueue[(_remoteHead + _remoteCount) % LOG_REMOTE_QUEUE_LINES];
+    line.level = level;
+    snprintf(line.tag, sizeof(line.tag), "%s", tag);
+    snprintf(line.message, sizeof(line.message), "%s", message);
+    _remoteCount++;
+}
+
+size_t LogManager::sendRemote() {
+    if (!_remoteSink) {
+        return 0;
+    }
+    // Bounded, so other tasks logging all the while cannot hold this one here.
+    size_t sent = 0;
+    RemoteLine line;
+    while (sent < LOG_REMOTE_QUEUE_LINES) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_remoteCount == 0) {
+                break;
+            }
+            line = _remoteQueue[_remoteHead];
+            _remoteHead = (_remoteHead + 1) % LOG_REMOTE_QUEUE_LINES;
+            _remoteCount--;
+        }
+        // Outside the lock: the sink may log, and may be slow.
+        _inRemoteSink = true;
+        _remoteSink(line.level, line.tag, line.message);
+        _inRemoteSink = false;
+        sent++;
     }
+    return sent;
+}
+
+void LogManager::appendToBuffer(const char* prefix, size_t prefixLength, const char* message, size_t messageLength, bool flushNow) {
+    size_t lineLength = prefixLength + messageLength + 1;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pending + lineLength > LOG_BUFFER_SIZE) {
+        flushLocked();
+        if (_pending + lineLength > LOG_BUFFER_SIZE) {
+            // The file cannot take what is already buffered; keep that, lose this.
+            _droppedLines++;
+            return;
+        }
+    }
+    if (_pending == 0) {
+        _oldestPendingAt = millis();
+    }
+    char* line = _buffer.get() + _pending;
+    memcpy(line, prefix, prefixLength);
+    memcpy(line + prefixLength, message, messageLength);
+    line[lineLength - 1] = '\n';
+    _pending += lineLength;
 
-    if (logFile) {
-        logFile->print(timestampBuffer);
-        logFile->println(messageBuffer);
-        logFile->close();
+    if (flushNow || _pending >= LOG_FLUSH_HIGH_WATER) {
+        flushLocked();
     }
 }
 
-String LogManager::getLogs() {
-    auto logFile = _fs.open(LOG_FILE, "r");
-    if (!logFile) {
-        return "No log file found.";
+void LogManager::update() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pending > 0 && millis() - _oldestPendingAt >= LOG_FLUSH_INTERVAL_MS) {
+        flushLocked();
+    }
+}
+
+bool LogManager::flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return flushLocked();
+}
+
+bool LogManager::flushLocked() {
+    // Done even with nothing to write, so the files are tidied before a read.
+    if (!_metadataLoaded) {
+        loadMetadata();
+    }
+    if (_pending == 0) {
+        return true;
     }
-    String logs = logFile->readString();
+
+    if (_sizes[0] > 0 && _sizes[0] + _pending > _fileLimit && !rotateLogs()) {
+        // The lines still go to the live file, past its limit, rather than
+        // being lost. The files are looked at again before the next attempt,
+        // in case they are not what the cache says.
+        _metadataLoaded = false;
+    }
+
+    auto logFile = _fs.open(LOG_FILE, "a");
+    if (!logFile || !*logFile) {
+        return false;
+    }
+
+    size_t written = logFile->write(reinterpret_cast<const uint8_t*>(_buffer.get()), _pending);
     logFile->close();
-    return logs;
+    _present[0] = true;
+    _sizes[0] += written;
+    // A short write leaves a partial line in the file; retrying would repeat it.
+    bool complete = written == _pending;
+    _pending = 0;
+    return complete;
+}
+
+std::unique_ptr<LogStreamer> LogManager::streamLogs(size_t offset, size_t limit, size_t tail) {
+    flush();
+    return std::unique_ptr<LogStreamer>(new LogStreamer(_fs, _generations, offset, limit, tail));
 }
 
 void LogManager::clearLogs() {
-    _fs.remove(LOG_FILE);
-    _fs.remove(OLD_LOG_FILE);
-    log("Logs cleared.");
-}
\ No newline at end of file
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending = 0;
+        if (!_metadataLoaded) {
+            loadMetadata();
+        }
+        char path[PATH_SIZE];
+        for (size_t generation = 0; generation <= _generations; generation++) {
+            if (_present[generation]) {
+                _fs.remove(logPath(generation, path, sizeof(path)));
+            }
+            _present[generation] = false;
+            _sizes[generation] = 0;
+        }
+    }
+    logCritical("Logs cleared.");
+}
@@ -1,31 +1,199 @@
 #ifndef LOG_MANAGER_H
 #define LOG_MANAGER_H
 
-#include <string>
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #ifdef ARDUINO
 #include <Arduino.h>
-#else
-using String = std::string;
 #endif
 
 // Constants used for logging, exposed via `extern` to be accessible for testing.
 extern const char* LOG_FILE;
-extern const char* OLD_LOG_FILE;
-extern const size_t MAX_LOG_SIZE;
+extern const size_t LOG_GENERATIONS;
+extern const size_t LOG_SIZE_BUDGET;
+extern const size_t LOG_BUFFER_SIZE;
+extern const size_t LOG_FLUSH_HIGH_WATER;
+extern const unsigned long LOG_FLUSH_INTERVAL_MS;
+extern const size_t LOG_REMOTE_QUEUE_LINES;
+
+// Numeric severities, usable in #if. Keep in step with LogLevel.
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_CRITICAL 4
+#define LOG_LEVEL_NONE 5
+
+// Calls below this level are removed by the preprocessor, arguments and all.
+// Override with -D LOG_COMPILE_LEVEL=LOG_LEVEL_DEBUG for a debug build.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : uint8_t {
+    DEBUG = LOG_LEVEL_DEBUG,
+    INFO = LOG_LEVEL_INFO,
+    WARNING = LOG_LEVEL_WARNING,
+    ERROR = LOG_LEVEL_ERROR,
+    CRITICAL = LOG_LEVEL_CRITICAL,
+    NONE = LOG_LEVEL_NONE // Only as a sink level: nothing is sent
+};
+
+// Where formatted lines go; each has its own runtime level.
+enum class LogSink : uint8_t { CONSOLE, FLASH, REMOTE };
 
 class IFileSystem; // Forward declaration
+class LogStreamer;
 
+// Lines are collected in a RAM buffer and appended to LOG_FILE in one write
+// when the buffer passes LOG_FLUSH_HIGH_WATER, when update() finds the oldest
+// line has waited LOG_FLUSH_INTERVAL_MS, or straight away at CRITICAL.
+//
+// LOG_FILE is archived as LOG_FILE.1, .1 moves to .2 and so on, keeping up to
+// a configured number of generations within a byte budget shared equally
+// between them. Which files exist and how large the current one is are read
+// once and then tracked, so a flush costs one open and close however many
+// lines it carries, and a rotation is one remove and a chain of renames.
+//
+// A message is only formatted if at least one sink wants its level; use the
+// LOG_* macros below so that the check also skips evaluating the arguments.
+//
+// Lines for the remote sink are queued under the same lock, up to
+// LOG_REMOTE_QUEUE_LINES, and handed to the sink by sendRemote(). The sink so
+// always runs on the task that calls sendRemote(), whichever task logged.
 class LogManager {
 public:
+    // Receives lines at or above the REMOTE level, e.g. to publish them.
+    using RemoteSink = std::function<void(LogLevel level, const char* tag, const char* message)>;
+
     explicit LogManager(IFileSystem& fs);
+    ~LogManager();
     void begin(); // Kept for potential future use, though currently empty.
+
+    // Untagged INFO line.
     void log(const char* format, ...);
-    [[nodiscard]] String getLogs();
+    // Untagged CRITICAL line; it is on flash before this returns.
+    void logCritical(const char* format, ...);
+    // `tag` names the module ("MQTT", "APP", ...) and may be null.
+    void write(LogLevel level, const char* tag, const char* format, ...);
+
+    // Keeps `generations` archived files besides LOG_FILE, all of them within
+    // `budgetBytes`. Archives beyond the new count are deleted at the next
+    // flush.
+    void setRotation(size_t generations, size_t budgetBytes);
+    [[nodiscard]] size_t generations() const { return _generations; }
+    // Files are rotated before a flush would take LOG_FILE past this size.
+    [[nodiscard]] size_t fileLimit() const { return _fileLimit; }
+
+    void setLevel(LogSink sink, LogLevel level);
+    [[nodiscard]] LogLevel getLevel(LogSink sink) const;
+    [[nodiscard]] bool isEnabled(LogLevel level) const { return level >= _minEnabled.load(std::memory_order_relaxed); }
+    // Set once during setup, before other tasks log.
+    void setRemoteSink(RemoteSink sink);
+    // Hands queued lines to the remote sink, at most one queue's worth per
+    // call. Lines logged by the sink itself are not queued. Returns the
+    // number of lines sent.
+    size_t sendRemote();
+
+    // Flushes buffered lines once they are due. Call from the main loop.
+    void update();
+    // Writes any buffered lines now. Returns false if the write failed.
+    bool flush();
+    // Flushes, then returns a reader for a range of lines across both log
+    // files; see LogStreamer for the meaning of the arguments.
+    [[nodiscard]] std::unique_ptr<LogStreamer> streamLogs(size_t offset, size_t limit, size_t tail = 0);
     void clearLogs();
 
+    [[nodiscard]] size_t pendingBytes() const { return _pending; }
+    // Lines lost because the buffer was full and could not be flushed.
+    [[nodiscard]] size_t droppedLines() const { return _droppedLines; }
+    // Lines for the remote sink lost because its queue was full.
+    [[nodiscard]] size_t droppedRemoteLines() const { return _droppedRemoteLines; }
+    // Messages that passed the level check and were formatted.
+    [[nodiscard]] size_t formattedCount() const { return _formatted; }
+
+    static const char* levelName(LogLevel level);
+    // Writes the path of a generation (0 is LOG_FILE) into `buffer`.
+    static const char* logPath(size_t generation, char* buffer, size_t size);
+
+    static constexpr size_t MAX_GENERATIONS = 8;
+
 private:
+    static constexpr size_t SINK_COUNT = 3;
+
+    struct RemoteLine;
+
     IFileSystem& _fs;
-    void rotateLogs();
+    size_t _generations;
+    size_t _fileLimit;
+    // Cached so rotation needs no filesystem probes; index 0 is LOG_FILE.
+    bool _metadataLoaded;
+    bool _present[MAX_GENERATIONS + 1];
+    size_t _sizes[MAX_GENERATIONS + 1];
+    std::unique_ptr<char[]> _buffer;
+    size_t _pending;
+    unsigned long _oldestPendingAt;
+    size_t _droppedLines;
+    std::atomic<size_t> _formatted;
+    std::atomic<LogLevel> _levels[SINK_COUNT];
+    std::atomic<LogLevel> _minEnabled;
+    RemoteSink _remoteSink;
+    std::unique_ptr<RemoteLine[]> _remoteQueue;
+    size_t _remoteHead;
+    size_t _remoteCount;
+    size_t _droppedRemoteLines;
+    std::atomic<bool> _inRemoteSink; // A remote sink that logs must not feed itself
+    // log() runs on the main loop while the web server reads and clears the
+    // logs from its own task.
+    std::mutex _mutex;
+
+    void append(LogLevel level, const char* tag, const char* format, va_list args);
+    void appendToBuffer(const char* prefix, size_t prefixLength, const char* message, size_t messageLength, bool flushNow);
+    void queueRemote(LogLevel level, const char* tag, const char* message);
+    bool flushLocked();
+    void loadMetadata();
+    bool rotateLogs();
+    void updateMinEnabled();
 };
 
-#endif // LOG_MANAGER_H
\ No newline at end of file
+#define LOG_AT(logger, level, tag, ...) \
+    do { \
+        if ((logger).isEnabled(level)) { \
+            (logger).write(level, tag, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_DISABLED(logger, tag, ...) do {} while (0)
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(logger, tag, ...) LOG_AT(logger, LogLevel::DEBUG, tag, __VA_ARGS__)
+#else
+#define LOG_DEBUG(logger, tag, ...) LOG_DISABLED(logger, tag, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(logger, tag, ...) LOG_AT(logger, LogLevel::INFO, tag, __VA_ARGS__)
+#else
+#define LOG_INFO(logger, tag, ...) LOG_DISABLED(logger, tag, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_WARNING
+#define LOG_WARNING(logger, tag, ...) LOG_AT(logger, LogLevel::WARNING, tag, __VA_ARGS__)
+#else
+#define LOG_WARNING(logger, tag, ...) LOG_DISABLED(logger, tag, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(logger, tag, ...) LOG_AT(logger, LogLevel::ERROR, tag, __VA_ARGS__)
+#else
+#define LOG_ERROR(logger, tag, ...) LOG_DISABLED(logger, tag, __VA_ARGS__)
+#endif
+
+// Critical lines are never compiled out.
+#define LOG_CRITICAL(logger, tag, ...) LOG_AT(logger, LogLevel::CRITICAL, tag, __VA_ARGS__)
+
+#endif // LOG_MANAGER_H
@@ -0,0 +1,153 @@
+#include "log_streamer.h"
+#include "log_manager.h"
+#include "fs/IFileSystem.h"
+#include <cstring>
+
+LogStreamer::LogStreamer(IFileSystem& fs, size_t generations, size_t offset, size_t limit, size_t tail)
+    : _fs(fs),
+      _fileCount(generations + 1),
+      _fileIndex(0),
+      _line(0),
+      _first(offset),
+      _end(0),
+      _linesWritten(0),
+      _midLine(false),
+      _pendingNewline(false),
+      _chunkOffset(0),
+      _chunkLength(0)
+{
+    if (tail > 0) {
+        size_t total = countLines();
+        _first = total > tail ? total - tail : 0;
+    }
+    _end = limit > ALL_LINES - _first ? ALL_LINES : _first + limit;
+}
+
+LogStreamer::~LogStreamer() {
+    if (_file) {
+        _file->close();
+    }
+}
+
+size_t LogStreamer::fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (_pendingNewline) {
+            buffer[written++] = '\n';
+            _pendingNewline = false;
+            _linesWritten++;
+            continue;
+        }
+        if (_line >= _end) {
+            finish();
+            break;
+        }
+        if (_chunkOffset == _chunkLength) {
+            // Loop round even on success: moving to the next file may have
+            // left a newline to send first.
+            if (readMore() || _pendingNewline) {
+                continue;
+            }
+            break;
+        }
+
+        // Take the rest of the current line, or as much of it as was read.
+        const char* start = _chunk + _chunkOffset;
+        size_t available = _chunkLength - _chunkOffset;
+        const char* newline = static_cast<const char*>(memchr(start, '\n', available));
+        size_t segment = newline ? static_cast<size_t>(newline - start) + 1 : available;
+        bool wanted = inRange();
+        if (wanted) {
+            if (segment > maxLen - written) {
+                segment = maxLen - written;
+                newline = nullptr; // The end of the line goes in the next call
+            }
+            memcpy(buffer + written, start, segment);
+            written += segment;
+        }
+        _chunkOffset += segment;
+
+        if (newline) {
+            _line++;
+            _midLine = false;
+            if (wanted) {
+                _linesWritten++;
+            }
+        } else {
+            _midLine = true;
+        }
+    }
+    return written;
+}
+
+bool LogStreamer::readMore() {
+    while (_fileIndex < _fileCount) {
+        if (!_file && !openFile(_fileIndex)) {
+            _fileIndex++;
+            continue;
+        }
+
+        size_t length = _file->readBytes(_chunk, READ_SIZE);
+        if (length > 0) {
+            _chunkOffset = 0;
+            _chunkLength = length;
+            return true;
+        }
+
+        _file->close();
+        _file.reset();
+        _fileIndex++;
+        if (_midLine) {
+            // Terminate a truncated last line so it stays a line of its own.
+            _pendingNewline = inRange();
+            _line++;
+            _midLine = false;
+        }
+    }
+    return false;
+}
+
+size_t LogStreamer::countLines() {
+    size_t lines = 0;
+    for (size_t index = 0; index < _fileCount; index++) {
+        if (!openFile(index)) {
+            continue;
+        }
+        char last = '\n';
+        size_t length;
+        while ((length = _file->readBytes(_chunk, READ_SIZE)) > 0) {
+            for (size_t i = 0; i < length; i++) {
+                if (_chunk[i] == '\n') {
+                    lines++;
+                }
+            }
+            last = _chunk[length - 1];
+        }
+        if (last != '\n') {
+            lines++;
+        }
+        _file->close();
+        _file.reset();
+    }
+    return lines;
+}
+
+bool LogStreamer::openFile(size_t index) {
+    // Index 0 is the oldest archive, the last is LOG_FILE.
+    char path[32];
+    _file = _fs.open(LogManager::logPath(_fileCount - 1 - index, path, sizeof(path)), "r");
+    if (!_file || !*_file) {
+        _file.reset();
+        return false;
+    }
+    return true;
+}
+
+void LogStreamer::finish() {
+    if (_file) {
+        _file->close();
+        _file.reset();
+    }
+    _fileIndex = _fileCount;
+    _chunkOffset = _chunkLength = 0;
+}
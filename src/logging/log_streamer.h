@@ -0,0 +1,64 @@
+#ifndef LOG_STREAMER_H
+#define LOG_STREAMER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class IFile;
+class IFileSystem;
+
+// Streams a range of lines from the archived and current log files, oldest
+// first, into whatever buffer the caller hands it. The files are read through
+// a small fixed buffer, so a chunked HTTP response costs the same memory
+// however large the logs are.
+//
+// Lines are numbered from 0 across the archives, oldest first, and then
+// LOG_FILE; `generations` is the number of archives. A file that does not end
+// in a newline has one added, so lines never run together. If the logs rotate
+// while a response is draining, lines may be skipped or repeated, but each
+// line is still sent whole.
+class LogStreamer {
+public:
+    static constexpr size_t READ_SIZE = 128;
+    static constexpr size_t ALL_LINES = SIZE_MAX;
+
+    // Sends up to `limit` lines starting at line `offset`. A non-zero `tail`
+    // replaces the offset with the start of the last `tail` lines, which
+    // costs one extra pass over the files to count them.
+    LogStreamer(IFileSystem& fs, size_t generations, size_t offset, size_t limit, size_t tail = 0);
+    ~LogStreamer();
+
+    // Copies up to `maxLen` bytes of output into `buffer`. Returns the number
+    // of bytes written, or 0 once the range has been delivered.
+    size_t fill(uint8_t* buffer, size_t maxLen);
+
+    [[nodiscard]] bool done() const { return _fileIndex >= _fileCount && !_pendingNewline; }
+    [[nodiscard]] size_t linesWritten() const { return _linesWritten; }
+
+private:
+    // Refills the read buffer, moving on to the next file as each one runs
+    // out. Returns false when there is nothing left to read.
+    bool readMore();
+    bool openFile(size_t index);
+    size_t countLines();
+    void finish();
+    [[nodiscard]] bool inRange() const { return _line >= _first && _line < _end; }
+
+    IFileSystem& _fs;
+    std::unique_ptr<IFile> _file;
+    size_t _fileCount;
+    size_t _fileIndex;
+    size_t _line;
+    size_t _first;
+    size_t _end;
+    size_t _linesWritten;
+    bool _midLine;        // The last byte consumed was not a newline
+    bool _pendingNewline; // A file ended mid-line inside the range
+
+    char _chunk[READ_SIZE];
+    size_t _chunkOffset;
+    size_t _chunkLength;
+};
+
+#endif // LOG_STREAMER_H
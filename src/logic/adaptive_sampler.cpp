@@ -0,0 +1,55 @@
+#include "adaptive_sampler.h"
+#include "state/CompactSampleStore.h"
+
+namespace {
+    bool allOff(const HVACData& data) {
+        return data.fanStatus == ComponentStatus::OFF &&
+               data.compressorStatus == ComponentStatus::OFF &&
+               data.geoPumpsStatus == ComponentStatus::OFF;
+    }
+
+    bool probeDisconnected(const HVACData& data) {
+        return data.returnTempC == -127.0f || data.supplyTempC == -127.0f;
+    }
+}
+
+AdaptiveSampler::AdaptiveSampler(unsigned long idleIntervalMs, uint32_t settleMs)
+    : _idleIntervalMs(idleIntervalMs),
+      _settleMs(settleMs)
+{
+    reset();
+}
+
+void AdaptiveSampler::reset() {
+    _idle = false;
+    _hasLast = false;
+    _lastStatuses = 0;
+    _quietSince = 0;
+}
+
+bool AdaptiveSampler::update(const HVACData& sample) {
+    if (!sample.isInitialized) {
+        return false;
+    }
+    uint16_t statuses = CompactSampleStore::packStatus(sample);
+    bool quiet = _hasLast && statuses == _lastStatuses &&
+                 allOff(sample) && sample.alertStatus == AlertStatus::NONE && !probeDisconnected(sample);
+    _hasLast = true;
+    _lastStatuses = statuses;
+
+    bool wasIdle = _idle;
+    if (!quiet) {
+        _quietSince = sample.timestamp;
+        _idle = false;
+    } else if (!_idle && sample.timestamp - _quietSince >= _settleMs) {
+        _idle = true;
+    }
+    return _idle != wasIdle;
+}
+
+unsigned long AdaptiveSampler::readIntervalMs(unsigned long activeIntervalMs) const {
+    if (_idle && _idleIntervalMs > activeIntervalMs) {
+        return _idleIntervalMs;
+    }
+    return activeIntervalMs;
+}
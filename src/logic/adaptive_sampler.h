@@ -0,0 +1,40 @@
+#ifndef ADAPTIVE_SAMPLER_H
+#define ADAPTIVE_SAMPLER_H
+
+#include <cstdint>
+#include "hvac_data.h"
+
+// Chooses the sensor read interval from what the system is doing. While every
+// component is off and no alert is raised nothing changes quickly, so once
+// that has held, with no status changes, for `settleMs`, reads slow down to
+// `idleIntervalMs`. A status change, a component that is not off, an alert or
+// a disconnected probe returns to the configured interval at once; only
+// slowing down waits. Alert weights are capped at the configured interval, so
+// a disconnected probe has to be confirmed by reads at that rate.
+class AdaptiveSampler {
+public:
+    AdaptiveSampler(unsigned long idleIntervalMs, uint32_t settleMs);
+
+    // Feeds a completed sample, with its alert status already evaluated.
+    // Returns true if the cadence changed. Uninitialized samples are ignored.
+    bool update(const HVACData& sample);
+
+    // The interval to read at, given the configured (active) one. Idle reads
+    // are never faster than active ones.
+    [[nodiscard]] unsigned long readIntervalMs(unsigned long activeIntervalMs) const;
+
+    [[nodiscard]] bool isIdle() const { return _idle; }
+
+    void reset();
+
+private:
+    unsigned long _idleIntervalMs;
+    uint32_t _settleMs;
+
+    bool _idle;
+    bool _hasLast;
+    uint16_t _lastStatuses; // Statuses and alert of the previous sample
+    uint32_t _quietSince;   // Timestamp of the last sample that showed activity
+};
+
+#endif // ADAPTIVE_SAMPLER_H
@@ -0,0 +1,85 @@
+#include "alert_evaluator.h"
+#include "config/config_manager.h" // For AppConfig struct
+#include "state/CompactSampleStore.h"
+#include <algorithm>
+
+// Durations start at the compiled-in settings; evaluate() rebuilds them if the
+// loaded configuration differs.
+AlertEvaluator::AlertEvaluator()
+    : _durations(),
+      _lowDeltaTThreshold(LOW_DELTA_T_THRESHOLD),
+      _maxWeightMs(SENSOR_READ_INTERVAL_MS),
+      _windowMs(std::max({LOW_DELTA_T_DURATION_S, NO_AIRFLOW_DURATION_S, TEMP_SENSOR_DISCONNECTED_DURATION_S}) * 1000UL +
+                SENSOR_READ_INTERVAL_MS),
+      _windowSize(0),
+      _seenPushes(0),
+      _stale(false)
+{}
+
+void AlertEvaluator::onSamplePushed(const CompactSampleStore& history) {
+    uint32_t unseen = history.totalPushed() - _seenPushes;
+    if (unseen == 0) {
+        return;
+    }
+    if (unseen > 1 || _stale) {
+        // Samples went in without us; counting them one by one is no cheaper.
+        rebuild(history, _lowDeltaTThreshold, _maxWeightMs, _windowMs);
+        return;
+    }
+    _seenPushes = history.totalPushed();
+
+    // Indices are counted back from the newest sample, so the window keeps its
+    // place even when the push evicted the oldest stored sample.
+    size_t size = history.size();
+    if (size >= 2) {
+        apply(history, size - 1, 1);
+        _windowSize++;
+    }
+
+    // Let go of the samples that have aged out.
+    size_t target = AlertManager::windowSamples(history, _windowMs);
+    while (_windowSize > target) {
+        size_t oldest = size - _windowSize;
+        if (oldest == 0) {
+            // Its weight is gone with the sample before it.
+            _stale = true;
+            return;
+        }
+        apply(history, oldest, -1);
+        _windowSize--;
+    }
+    if (_windowSize < target) {
+        _stale = true; // Timestamps went backwards
+    }
+}
+
+AlertStatus AlertEvaluator::evaluate(const CompactSampleStore& history, const AppConfig& config) {
+    unsigned long windowMs = AlertManager::windowMs(config);
+    if (config.lowDeltaTThreshold != _lowDeltaTThreshold || config.sensorReadIntervalMs != _maxWeightMs ||
+        windowMs != _windowMs || history.totalPushed() != _seenPushes || _stale) {
+        rebuild(history, config.lowDeltaTThreshold, config.sensorReadIntervalMs, windowMs);
+    }
+    return AlertManager::statusFromDurations(_durations, config);
+}
+
+void AlertEvaluator::rebuild(const CompactSampleStore& history, float lowDeltaTThreshold, unsigned long maxWeightMs,
+                             unsigned long windowMs) {
+    _lowDeltaTThreshold = lowDeltaTThreshold;
+    _maxWeightMs = maxWeightMs;
+    _windowMs = windowMs;
+    _windowSize = AlertManager::windowSamples(history, windowMs);
+    _seenPushes = history.totalPushed();
+    _stale = false;
+    _durations = AlertManager::sumDurations(history, _windowSize, lowDeltaTThreshold, maxWeightMs);
+}
+
+void AlertEvaluator::apply(const CompactSampleStore& history, size_t index, long sign) {
+    // Same weighting as sumDurations(): the time since the sample before, capped.
+    if (index == 0) {
+        return;
+    }
+    long weight = AlertManager::sampleWeight(history.timestampAt(index), history.timestampAt(index - 1), _maxWeightMs);
+    if (weight != 0) {
+        AlertManager::accumulate(_durations, history.at(index), _lowDeltaTThreshold, sign * weight);
+    }
+}
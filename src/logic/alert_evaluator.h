@@ -0,0 +1,48 @@
+#ifndef ALERT_EVALUATOR_H
+#define ALERT_EVALUATOR_H
+
+#include "config.h"
+#include "hvac_data.h"
+#include "logic/alert_manager.h"
+#include <cstddef>
+#include <cstdint>
+
+struct AppConfig; // Forward declaration
+class CompactSampleStore;
+
+// Incremental equivalent of AlertManager::checkAlerts. Instead of rescanning
+// the whole window every cycle, it keeps running condition durations that are
+// updated as samples enter and age out of the window, so each evaluation costs
+// the same regardless of the window length.
+class AlertEvaluator {
+public:
+    AlertEvaluator();
+
+    // Called after a sample may have been pushed to `history`; uninitialized
+    // samples are not stored and so change nothing.
+    void onSamplePushed(const CompactSampleStore& history);
+
+    // Returns the same result as checkAlerts() over the current window. The
+    // durations are rebuilt from `history` (one full scan) if the low delta-T
+    // threshold, the read interval capping sample weights or the window
+    // length has changed.
+    AlertStatus evaluate(const CompactSampleStore& history, const AppConfig& config);
+
+    // Recounts every condition from scratch.
+    void rebuild(const CompactSampleStore& history, float lowDeltaTThreshold, unsigned long maxWeightMs,
+                 unsigned long windowMs);
+
+private:
+    // Adds or removes the sample at `index` with its weight.
+    void apply(const CompactSampleStore& history, size_t index, long sign);
+
+    AlertManager::AlertDurations _durations;
+    float _lowDeltaTThreshold;
+    unsigned long _maxWeightMs;
+    unsigned long _windowMs;
+    size_t _windowSize; // Samples currently counted, ending at the newest
+    uint32_t _seenPushes;
+    bool _stale; // The window outran the history; rebuild before the next use
+};
+
+#endif // ALERT_EVALUATOR_H
@@ -1,49 +1,97 @@
 #include "alert_manager.h"
 #include "config/config_manager.h" // For AppConfig struct
+#include "state/CompactSampleStore.h"
+#include <algorithm>
 
-AlertStatus AlertManager::checkAlerts(const std::array<HVACData, DATA_BUFFER_SIZE>& dataBuffer, const AppConfig& config) {
-    int fanOnNoAirflowCount = 0;
-    int lowDeltaTCount = 0;
-    int tempSensorDisconnectedCount = 0;
+unsigned long AlertManager::windowMs(const AppConfig& config) {
+    unsigned int longestS = std::max({config.lowDeltaTDurationS, config.noAirflowDurationS,
+                                      config.tempSensorDisconnectedDurationS});
+    return longestS * 1000UL + config.sensorReadIntervalMs;
+}
 
-    for (const auto& data : dataBuffer) {
-        if (!data.isInitialized) {
-            continue;
+size_t AlertManager::windowSamples(const CompactSampleStore& history, unsigned long windowMs) {
+    size_t count = history.size();
+    if (count < 2) {
+        return 0;
+    }
+    // Ages only grow towards the oldest sample, so the first one inside the
+    // window can be found by bisection. Unsigned ages survive millis() wrapping.
+    uint32_t newest = history.timestampAt(count - 1);
+    size_t low = 1;
+    size_t high = count - 1;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (newest - history.timestampAt(mid) < windowMs) {
+            high = mid;
+        } else {
+            low = mid + 1;
         }
+    }
+    return count - low;
+}
 
-        // Check for Fan ON but no airflow
-        if (data.fanStatus == ComponentStatus::ON && data.airflowStatus == AirflowStatus::NA) {
-            fanOnNoAirflowCount++;
-        }
+AlertStatus AlertManager::checkAlerts(const CompactSampleStore& history, size_t windowSize, const AppConfig& config) {
+    return statusFromDurations(sumDurations(history, windowSize, config.lowDeltaTThreshold, config.sensorReadIntervalMs), config);
+}
 
-        // Check for Compressor ON but low Delta T
-        if (data.compressorStatus == ComponentStatus::ON && data.deltaT < config.lowDeltaTThreshold) {
-            lowDeltaTCount++;
-        }
+AlertManager::AlertDurations AlertManager::sumDurations(const CompactSampleStore& history, size_t windowSize, float lowDeltaTThreshold,
+                                                        unsigned long maxWeightMs) {
+    AlertDurations durations;
 
-        // Check for disconnected temperature sensor
-        if (data.returnTempC == -127.0f || data.supplyTempC == -127.0f) {
-            tempSensorDisconnectedCount++;
+    // One extra sample for the timestamp before the window. The oldest stored
+    // sample has nothing before it, so it carries no weight either way.
+    bool first = true;
+    uint32_t previousTimestamp = 0;
+    history.forEachRecent(windowSize + 1, [&](const HVACData& data) {
+        if (!first) {
+            accumulate(durations, data, lowDeltaTThreshold, sampleWeight(data.timestamp, previousTimestamp, maxWeightMs));
         }
+        first = false;
+        previousTimestamp = data.timestamp;
+    });
+
+    return durations;
+}
+
+long AlertManager::sampleWeight(uint32_t timestamp, uint32_t previousTimestamp, unsigned long maxWeightMs) {
+    uint32_t elapsed = timestamp - previousTimestamp;
+    return static_cast<long>(elapsed < maxWeightMs ? elapsed : maxWeightMs);
+}
+
+void AlertManager::accumulate(AlertDurations& durations, const HVACData& data, float lowDeltaTThreshold, long weightMs) {
+    if (!data.isInitialized) {
+        return;
+    }
+
+    // Check for Fan ON but no airflow
+    if (data.fanStatus == ComponentStatus::ON && data.airflowStatus == AirflowStatus::NA) {
+        durations.fanOnNoAirflowMs += weightMs;
     }
 
-    // Convert counts to duration in seconds
-    float fanOnNoAirflowDuration = fanOnNoAirflowCount * (SENSOR_READ_INTERVAL_MS / 1000.0f);
-    float lowDeltaTDuration = lowDeltaTCount * (SENSOR_READ_INTERVAL_MS / 1000.0f);
-    float tempSensorDisconnectedDuration = tempSensorDisconnectedCount * (SENSOR_READ_INTERVAL_MS / 1000.0f);
+    // Check for Compressor ON but low Delta T
+    if (data.compressorStatus == ComponentStatus::ON && data.deltaT < lowDeltaTThreshold) {
+        durations.lowDeltaTMs += weightMs;
+    }
+
+    // Check for disconnected temperature sensor
+    if (data.returnTempC == -127.0f || data.supplyTempC == -127.0f) {
+        durations.tempSensorDisconnectedMs += weightMs;
+    }
+}
 
-    if (tempSensorDisconnectedDuration >= config.tempSensorDisconnectedDurationS) {
+AlertStatus AlertManager::statusFromDurations(const AlertDurations& durations, const AppConfig& config) {
+    if (durations.tempSensorDisconnectedMs >= static_cast<long>(config.tempSensorDisconnectedDurationS) * 1000) {
         return AlertStatus::TEMP_SENSOR_DISCONNECTED;
     }
 
     // Check if durations exceed thresholds
-    if (fanOnNoAirflowDuration >= config.noAirflowDurationS) {
+    if (durations.fanOnNoAirflowMs >= static_cast<long>(config.noAirflowDurationS) * 1000) {
         return AlertStatus::FAN_NO_AIRFLOW;
     }
 
-    if (lowDeltaTDuration >= config.lowDeltaTDurationS) {
+    if (durations.lowDeltaTMs >= static_cast<long>(config.lowDeltaTDurationS) * 1000) {
         return AlertStatus::LOW_DELTA_T;
     }
 
     return AlertStatus::NONE;
-}
\ No newline at end of file
+}
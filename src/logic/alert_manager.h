@@ -3,12 +3,52 @@
 
 #include "config.h"
 #include "hvac_data.h"
-#include <array>
+#include <cstddef>
+#include <cstdint>
 
 struct AppConfig; // Forward declaration
+class CompactSampleStore;
 
+// Alerts are judged over the samples taken in the last windowMs(config). Each
+// sample stands for the time since the one before it, taken from their
+// timestamps, so a condition's duration is right whatever the read interval
+// is, including while the interval changes with the system's activity. That
+// weight is capped at the configured (active) read interval: one reading
+// taken after a long gap, such as a single glitch at the idle cadence, cannot
+// on its own stand for a condition held the whole time.
 namespace AlertManager {
-    AlertStatus checkAlerts(const std::array<HVACData, DATA_BUFFER_SIZE>& dataBuffer, const AppConfig& config);
+    // Time in the window during which each alert condition held.
+    struct AlertDurations {
+        long fanOnNoAirflowMs = 0;
+        long lowDeltaTMs = 0;
+        long tempSensorDisconnectedMs = 0;
+    };
+
+    // The longest configured alert duration plus one read interval, so each
+    // condition can be reached even when reads run a little late.
+    unsigned long windowMs(const AppConfig& config);
+
+    // Number of most recent samples taken within `windowMs` of the newest one.
+    // The oldest stored sample is never included, since its weight is unknown.
+    size_t windowSamples(const CompactSampleStore& history, unsigned long windowMs);
+
+    // Full scan of the most recent `windowSize` samples of the compact history.
+    AlertStatus checkAlerts(const CompactSampleStore& history, size_t windowSize, const AppConfig& config);
+
+    // Condition durations over the most recent `windowSize` samples, with no
+    // sample weighing more than `maxWeightMs`.
+    AlertDurations sumDurations(const CompactSampleStore& history, size_t windowSize, float lowDeltaTThreshold,
+                                unsigned long maxWeightMs);
+
+    // The weight of a sample taken at `timestamp` after one at `previousTimestamp`.
+    long sampleWeight(uint32_t timestamp, uint32_t previousTimestamp, unsigned long maxWeightMs);
+
+    // Adds `weightMs` to each condition that `data` meets; negative to remove it.
+    void accumulate(AlertDurations& durations, const HVACData& data, float lowDeltaTThreshold, long weightMs);
+
+    // Compares the durations with the configured thresholds and picks the
+    // highest-priority alert.
+    AlertStatus statusFromDurations(const AlertDurations& durations, const AppConfig& config);
 } // namespace AlertManager
 
-#endif // ALERT_MANAGER_H
\ No newline at end of file
+#endif // ALERT_MANAGER_H
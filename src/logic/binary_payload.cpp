@@ -0,0 +1,166 @@
+#include "binary_payload.h"
+#include "hvac_data.h"
+#include "state/RollupStore.h"
+#include "state/CompactSampleStore.h"
+#include <cstring>
+
+namespace {
+    constexpr size_t HEADER_FIXED_SIZE = 4; // Schema, count and the two string lengths
+
+    size_t boundedLength(const char* text, size_t maxLength) {
+        size_t length = strlen(text);
+        return length > maxLength ? maxLength : length;
+    }
+
+    void putU16(uint8_t* out, uint16_t value) {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void putU32(uint8_t* out, uint32_t value) {
+        putU16(out, static_cast<uint16_t>(value));
+        putU16(out + 2, static_cast<uint16_t>(value >> 16));
+    }
+
+    uint16_t getU16(const uint8_t* in) {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+
+    uint32_t getU32(const uint8_t* in) {
+        return getU16(in) | (static_cast<uint32_t>(getU16(in + 2)) << 16);
+    }
+
+    void encodeRecord(uint32_t sequence, const AggregatedHVACData& data, uint8_t* out) {
+        RollupStore::PackedRollup packed = RollupStore::pack(data);
+        putU32(out, sequence);
+        putU32(out + 4, packed.timestamp);
+        putU16(out + 8, packed.sampleCount);
+        putU16(out + 10, packed.lastStatuses);
+        uint8_t* stats = out + 12;
+        for (size_t metric = 0; metric < RollupStore::METRIC_COUNT; metric++) {
+            for (size_t stat = 0; stat < RollupStore::STATS_PER_METRIC; stat++) {
+                putU16(stats, static_cast<uint16_t>(packed.stats[metric][stat]));
+                stats += 2;
+            }
+        }
+    }
+
+    void decodeRecord(const uint8_t* in, uint32_t& sequence, AggregatedHVACData& data) {
+        RollupStore::PackedRollup packed;
+        sequence = getU32(in);
+        packed.timestamp = getU32(in + 4);
+        packed.durationMs = 0; // Not carried; merges fall back to the sample count
+        packed.sampleCount = getU16(in + 8);
+        packed.lastStatuses = getU16(in + 10);
+        const uint8_t* stats = in + 12;
+        for (size_t metric = 0; metric < RollupStore::METRIC_COUNT; metric++) {
+            for (size_t stat = 0; stat < RollupStore::STATS_PER_METRIC; stat++) {
+                packed.stats[metric][stat] = static_cast<int16_t>(getU16(stats));
+                stats += 2;
+            }
+        }
+        data = RollupStore::unpack(packed);
+    }
+}
+
+static_assert(BinaryPayload::RECORD_SIZE == 12 + 2 * RollupStore::METRIC_COUNT * RollupStore::STATS_PER_METRIC,
+              "RECORD_SIZE must match the record layout");
+
+BinaryPayload::Batch::Batch(uint8_t* buffer, size_t bufferSize, const char* version, const char* buildDate)
+    : _buffer(buffer),
+      _bufferSize(bufferSize),
+      _length(0),
+      _count(0),
+      _valid(false)
+{
+    size_t versionLength = boundedLength(version, MAX_VERSION_LENGTH);
+    size_t buildDateLength = boundedLength(buildDate, MAX_BUILD_DATE_LENGTH);
+    if (bufferSize < HEADER_FIXED_SIZE + versionLength + buildDateLength) {
+        return;
+    }
+    _buffer[0] = SCHEMA_VERSION;
+    _buffer[1] = 0;
+    _buffer[2] = static_cast<uint8_t>(versionLength);
+    memcpy(_buffer + 3, version, versionLength);
+    _length = 3 + versionLength;
+    _buffer[_length++] = static_cast<uint8_t>(buildDateLength);
+    memcpy(_buffer + _length, buildDate, buildDateLength);
+    _length += buildDateLength;
+    _valid = true;
+}
+
+bool BinaryPayload::Batch::add(const AggregatedHVACData& data, uint32_t sequence) {
+    if (!_valid || _count >= MAX_RECORDS || _bufferSize - _length < RECORD_SIZE) {
+        return false;
+    }
+    encodeRecord(sequence, data, _buffer + _length);
+    _length += RECORD_SIZE;
+    _count++;
+    return true;
+}
+
+size_t BinaryPayload::Batch::finish() {
+    if (!_valid || _count == 0) {
+        return 0;
+    }
+    _buffer[1] = static_cast<uint8_t>(_count);
+    _valid = false; // Nothing can be added once closed
+    return _length;
+}
+
+bool BinaryPayload::decode(const uint8_t* payload, size_t length, const RecordCallback& emit) {
+    if (length < HEADER_FIXED_SIZE || payload[0] != SCHEMA_VERSION) {
+        return false;
+    }
+    size_t count = payload[1];
+    size_t buildDateAt = 3 + payload[2];
+    if (count == 0 || length <= buildDateAt) {
+        return false;
+    }
+    size_t offset = buildDateAt + 1 + payload[buildDateAt];
+    if (length != offset + count * RECORD_SIZE) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++, offset += RECORD_SIZE) {
+        uint32_t sequence;
+        AggregatedHVACData data;
+        decodeRecord(payload + offset, sequence, data);
+        emit(sequence, data);
+    }
+    return true;
+}
+
+size_t BinaryPayload::encodeEvent(const HVACData& data, uint8_t changes, uint8_t* buffer, size_t bufferSize) {
+    if (bufferSize < EVENT_SIZE) {
+        return 0;
+    }
+    buffer[0] = SCHEMA_VERSION;
+    buffer[1] = changes;
+    putU32(buffer + 2, data.timestamp);
+    putU16(buffer + 6, static_cast<uint16_t>(CompactSampleStore::encodeTemp(data.returnTempC)));
+    putU16(buffer + 8, static_cast<uint16_t>(CompactSampleStore::encodeTemp(data.supplyTempC)));
+    putU16(buffer + 10, static_cast<uint16_t>(CompactSampleStore::encodeCurrent(data.fanAmps)));
+    putU16(buffer + 12, static_cast<uint16_t>(CompactSampleStore::encodeCurrent(data.compressorAmps)));
+    putU16(buffer + 14, static_cast<uint16_t>(CompactSampleStore::encodeCurrent(data.geoPumpsAmps)));
+    putU16(buffer + 16, CompactSampleStore::packStatus(data));
+    return EVENT_SIZE;
+}
+
+bool BinaryPayload::decodeEvent(const uint8_t* payload, size_t length, HVACData& data, uint8_t& changes) {
+    if (length != EVENT_SIZE || payload[0] != SCHEMA_VERSION) {
+        return false;
+    }
+    changes = payload[1];
+    data = HVACData();
+    data.isInitialized = true;
+    data.timestamp = getU32(payload + 2);
+    data.returnTempC = CompactSampleStore::decodeTemp(static_cast<int16_t>(getU16(payload + 6)));
+    data.supplyTempC = CompactSampleStore::decodeTemp(static_cast<int16_t>(getU16(payload + 8)));
+    data.deltaT = data.returnTempC - data.supplyTempC;
+    data.fanAmps = CompactSampleStore::decodeCurrent(static_cast<int16_t>(getU16(payload + 10)));
+    data.compressorAmps = CompactSampleStore::decodeCurrent(static_cast<int16_t>(getU16(payload + 12)));
+    data.geoPumpsAmps = CompactSampleStore::decodeCurrent(static_cast<int16_t>(getU16(payload + 14)));
+    CompactSampleStore::unpackStatus(getU16(payload + 16), data);
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef BINARY_PAYLOAD_H
+#define BINARY_PAYLOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+struct HVACData;
+struct AggregatedHVACData;
+
+// Compact fixed-layout alternative to the JSON aggregate payload. Multi-byte
+// fields are little-endian.
+//
+//   Header  u8   schema version (SCHEMA_VERSION)
+//           u8   record count
+//           u8   firmware version length n, followed by n bytes of it
+//           u8   build date length m, followed by m bytes of it
+//   Record  u32  sequence
+//           u32  timestamp, millis() at aggregation
+//           u16  sample count, saturating at 65535
+//           u16  last fan, compressor and geo pump ComponentStatus, 2 bits each
+//           i16  x 24: avg, min, max, stddev of return temp, supply temp and
+//                delta T (0.01 °C), then fan, compressor and geo pump current
+//                (0.01 A)
+//
+// The statistics are quantized exactly as in RollupStore::PackedRollup, so a
+// record is what the device itself keeps on flash.
+//
+// Live-sample events have their own fixed EVENT_SIZE layout:
+//
+//   u8   schema version (SCHEMA_VERSION)
+//   u8   ChangeDetector change bits
+//   u32  timestamp, millis() at the read
+//   i16  x 5: return temp, supply temp (0.01 °C), fan, compressor and geo
+//        pump current (0.01 A); delta T is their difference
+//   u16  statuses packed as in CompactSampleStore::packStatus
+class BinaryPayload {
+public:
+    static constexpr uint8_t SCHEMA_VERSION = 1;
+    static constexpr size_t RECORD_SIZE = 60;
+    static constexpr size_t EVENT_SIZE = 18;
+    static constexpr size_t MAX_RECORDS = 255;
+    static constexpr size_t MAX_VERSION_LENGTH = 32; // Longer versions are cut short
+    static constexpr size_t MAX_BUILD_DATE_LENGTH = 32; // Likewise for build dates
+
+    using RecordCallback = std::function<void(uint32_t sequence, const AggregatedHVACData& data)>;
+
+    // Builds a payload one record at a time, straight into a fixed buffer.
+    // Same contract as JsonBuilder::AggregatedBatch.
+    class Batch {
+    public:
+        Batch(uint8_t* buffer, size_t bufferSize, const char* version, const char* buildDate);
+
+        // Appends a record if it fits. Returns false, leaving the batch
+        // unchanged, if it does not.
+        bool add(const AggregatedHVACData& data, uint32_t sequence);
+
+        // Returns the payload length, or 0 if it holds no records.
+        size_t finish();
+
+        [[nodiscard]] size_t count() const { return _count; }
+
+    private:
+        uint8_t* _buffer;
+        size_t _bufferSize;
+        size_t _length;
+        size_t _count;
+        bool _valid;
+    };
+
+    // Emits each record of a payload in order. Returns false, emitting
+    // nothing, if the payload is malformed or from another schema version.
+    static bool decode(const uint8_t* payload, size_t length, const RecordCallback& emit);
+
+    // Writes a live-sample event. Returns EVENT_SIZE, or 0 if it does not fit.
+    static size_t encodeEvent(const HVACData& data, uint8_t changes, uint8_t* buffer, size_t bufferSize);
+    static bool decodeEvent(const uint8_t* payload, size_t length, HVACData& data, uint8_t& changes);
+};
+
+#endif // BINARY_PAYLOAD_H
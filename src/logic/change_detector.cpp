@@ -0,0 +1,72 @@
+#include "change_detector.h"
+#include "state/CompactSampleStore.h"
+#include <cmath>
+
+namespace {
+    // No real sample packs to this, so the first check always sees a change.
+    constexpr uint16_t NO_STATUSES = 0xFFFF;
+
+    // Component and airflow statuses; alerts are reported on their own.
+    uint16_t statusBits(const HVACData& data) {
+        return CompactSampleStore::packStatus(data) & ~CompactSampleStore::ALERT_STATUS_BITS;
+    }
+
+    bool beyond(double a, double b, double deadband) {
+        return std::fabs(a - b) > deadband;
+    }
+}
+
+ChangeDetector::ChangeDetector(float tempDeadbandC, float currentDeadbandA,
+                               uint32_t statusDebounceMs, uint32_t analogMinIntervalMs)
+    : _tempDeadbandC(tempDeadbandC),
+      _currentDeadbandA(currentDeadbandA),
+      _statusDebounceMs(statusDebounceMs),
+      _analogMinIntervalMs(analogMinIntervalMs)
+{
+    reset();
+}
+
+void ChangeDetector::reset() {
+    _hasReported = false;
+    _reported = HVACData();
+    _lastStatuses = NO_STATUSES;
+    _statusesSince = 0;
+}
+
+uint8_t ChangeDetector::check(const HVACData& sample) {
+    uint16_t statuses = statusBits(sample);
+    if (statuses != _lastStatuses) {
+        _lastStatuses = statuses;
+        _statusesSince = sample.timestamp;
+    }
+
+    if (!_hasReported) {
+        return STATUS | ALERT | ANALOG;
+    }
+
+    uint8_t changes = 0;
+    if (sample.alertStatus != _reported.alertStatus) {
+        changes |= ALERT;
+    }
+    if (statuses != statusBits(_reported) && sample.timestamp - _statusesSince >= _statusDebounceMs) {
+        changes |= STATUS;
+    }
+    if (analogMoved(sample) && sample.timestamp - _reported.timestamp >= _analogMinIntervalMs) {
+        changes |= ANALOG;
+    }
+    return changes;
+}
+
+void ChangeDetector::commit(const HVACData& sample) {
+    _hasReported = true;
+    _reported = sample;
+}
+
+bool ChangeDetector::analogMoved(const HVACData& sample) const {
+    return beyond(sample.returnTempC, _reported.returnTempC, _tempDeadbandC) ||
+           beyond(sample.supplyTempC, _reported.supplyTempC, _tempDeadbandC) ||
+           beyond(sample.deltaT, _reported.deltaT, _tempDeadbandC) ||
+           beyond(sample.fanAmps, _reported.fanAmps, _currentDeadbandA) ||
+           beyond(sample.compressorAmps, _reported.compressorAmps, _currentDeadbandA) ||
+           beyond(sample.geoPumpsAmps, _reported.geoPumpsAmps, _currentDeadbandA);
+}
@@ -0,0 +1,52 @@
+#ifndef CHANGE_DETECTOR_H
+#define CHANGE_DETECTOR_H
+
+#include <cstdint>
+#include "hvac_data.h"
+
+// Decides when a live sample differs enough from the last one reported to be
+// worth sending on its own, so transitions reach the cloud within a read
+// cycle instead of with the next aggregate.
+//
+// - Alert changes are reported at once.
+// - Component and airflow status changes are reported once the new set of
+//   statuses has held for `statusDebounceMs`, so a status flickering around
+//   the current threshold is not reported on every read.
+// - Temperatures and currents are reported once one has moved beyond its
+//   deadband from the last reported value, at most once per
+//   `analogMinIntervalMs`.
+class ChangeDetector {
+public:
+    // Bits of the mask returned by check().
+    static constexpr uint8_t STATUS = 0x1;
+    static constexpr uint8_t ALERT = 0x2;
+    static constexpr uint8_t ANALOG = 0x4;
+
+    ChangeDetector(float tempDeadbandC, float currentDeadbandA,
+                   uint32_t statusDebounceMs, uint32_t analogMinIntervalMs);
+
+    // Returns which kinds of change make `sample` reportable, or 0. The first
+    // sample after construction or reset() reports everything.
+    uint8_t check(const HVACData& sample);
+
+    // Records `sample` as reported; later samples are compared against it.
+    // Until this is called, check() keeps reporting the same changes.
+    void commit(const HVACData& sample);
+
+    void reset();
+
+private:
+    [[nodiscard]] bool analogMoved(const HVACData& sample) const;
+
+    float _tempDeadbandC;
+    float _currentDeadbandA;
+    uint32_t _statusDebounceMs;
+    uint32_t _analogMinIntervalMs;
+
+    bool _hasReported;
+    HVACData _reported;
+    uint16_t _lastStatuses;     // Statuses of the previous sample checked
+    uint32_t _statusesSince;    // When they last changed
+};
+
+#endif // CHANGE_DETECTOR_H
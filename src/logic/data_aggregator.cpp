@@ -24,6 +24,7 @@ AggregatedHVACData DataAggregator::aggregate(const std::array<HVACData, DATA_BUF
     }
 
     AggregatedHVACData result;
+    result.sampleCount = static_cast<uint32_t>(validSamples);
     if (validSamples > 0) {
         result.avgReturnTempC = sumReturnTemp / validSamples;
         result.avgSupplyTempC = sumSupplyTemp / validSamples;
@@ -0,0 +1,100 @@
+#include "history_json_streamer.h"
+#include <cstring>
+#include "hvac_data.h"
+#include "logic/json_builder.h"
+#include "logic/json_writer.h"
+#include "state/CompactSampleStore.h"
+
+HistoryJsonStreamer::HistoryJsonStreamer(const CompactSampleStore& store, size_t maxSamples)
+    : _store(store),
+      _nextSequence(0),
+      _endSequence(store.totalPushed()),
+      _state(State::OPEN),
+      _samplesWritten(0),
+      _samplesSkipped(0),
+      _pendingOffset(0),
+      _pendingLength(0)
+{
+    size_t count = store.size() < maxSamples ? store.size() : maxSamples;
+    _nextSequence = _endSequence - static_cast<uint32_t>(count);
+}
+
+size_t HistoryJsonStreamer::fill(uint8_t* buffer, size_t maxLen) {
+    size_t written = 0;
+    while (written < maxLen) {
+        if (_pendingOffset == _pendingLength && !loadNext()) {
+            break;
+        }
+        size_t chunk = _pendingLength - _pendingOffset;
+        if (chunk > maxLen - written) {
+            chunk = maxLen - written;
+        }
+        memcpy(buffer + written, _scratch + _pendingOffset, chunk);
+        _pendingOffset += chunk;
+        written += chunk;
+    }
+    return written;
+}
+
+bool HistoryJsonStreamer::loadNext() {
+    _pendingOffset = 0;
+    _pendingLength = 0;
+
+    switch (_state) {
+        case State::OPEN:
+            _scratch[0] = '[';
+            _pendingLength = 1;
+            _state = State::SAMPLES;
+            return true;
+        case State::SAMPLES:
+            if (loadNextSample()) {
+                return true;
+            }
+            _scratch[0] = ']';
+            _pendingLength = 1;
+            _state = State::DONE;
+            return true;
+        case State::DONE:
+        default:
+            return false;
+    }
+}
+
+bool HistoryJsonStreamer::loadNextSample() {
+    while (_nextSequence != _endSequence) {
+        // Sequence numbers are unsigned and may wrap, so compare by distance.
+        uint32_t oldest = _store.totalPushed() - static_cast<uint32_t>(_store.size());
+        uint32_t offset = _nextSequence - oldest;
+        if (offset >= _store.size()) {
+            // Overwritten while the response was draining; resume at the
+            // oldest sample still held, if it is still inside our range.
+            uint32_t evicted = oldest - _nextSequence;
+            uint32_t remaining = _endSequence - _nextSequence;
+            if (evicted > remaining) {
+                evicted = remaining;
+            }
+            _samplesSkipped += evicted;
+            _nextSequence += evicted;
+            continue;
+        }
+
+        HVACData data = _store.at(offset);
+        _nextSequence++;
+
+        size_t prefix = 0;
+        if (_samplesWritten > 0) {
+            _scratch[prefix++] = ',';
+        }
+        JsonWriter writer(_scratch + prefix, SCRATCH_SIZE - prefix);
+        JsonBuilder::writeHvacDataJson(writer, data);
+        if (writer.overflowed()) {
+            _samplesSkipped++;
+            continue;
+        }
+
+        _pendingLength = prefix + writer.size();
+        _samplesWritten++;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+#ifndef HISTORY_JSON_STREAMER_H
+#define HISTORY_JSON_STREAMER_H
+
+#include <cstddef>
+#include <cstdint>
+
+class CompactSampleStore;
+
+// Serializes the most recent samples of a CompactSampleStore as a JSON array,
+// one sample at a time, into whatever buffer the caller hands it. Memory use
+// is a fixed scratch buffer regardless of how many samples are sent, so a
+// chunked HTTP response can be produced as the socket drains instead of
+// building the whole document in heap first.
+//
+// The output is identical to serializing JsonBuilder::buildHistoryJson() for
+// the same store and sample count. The range of samples is fixed when the
+// streamer is created; samples that are evicted from the store before they
+// are reached are skipped, so the array stays well-formed.
+class HistoryJsonStreamer {
+public:
+    // Large enough for one serialized sample with every field at its widest.
+    static constexpr size_t SCRATCH_SIZE = 384;
+
+    HistoryJsonStreamer(const CompactSampleStore& store, size_t maxSamples);
+
+    // Copies up to `maxLen` bytes of output into `buffer`. Returns the number
+    // of bytes written, or 0 once the closing bracket has been delivered.
+    size_t fill(uint8_t* buffer, size_t maxLen);
+
+    [[nodiscard]] bool done() const { return _state == State::DONE && _pendingOffset == _pendingLength; }
+    [[nodiscard]] size_t samplesWritten() const { return _samplesWritten; }
+    [[nodiscard]] size_t samplesSkipped() const { return _samplesSkipped; }
+
+private:
+    enum class State { OPEN, SAMPLES, DONE };
+
+    // Serializes the next piece of output into the scratch buffer. Returns
+    // false when there is nothing left to produce.
+    bool loadNext();
+    bool loadNextSample();
+
+    const CompactSampleStore& _store;
+    uint32_t _nextSequence;
+    uint32_t _endSequence;
+    State _state;
+    size_t _samplesWritten;
+    size_t _samplesSkipped;
+
+    char _scratch[SCRATCH_SIZE];
+    size_t _pendingOffset;
+    size_t _pendingLength;
+};
+
+#endif // HISTORY_JSON_STREAMER_H
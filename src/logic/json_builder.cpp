@@ -2,6 +2,75 @@
 #include <ArduinoJson.h>
 #include "hvac_data.h"
 #include "enum_converters.h"
+#include "state/CompactSampleStore.h"
+#include "logic/json_writer.h"
+#include "logic/change_detector.h"
+#include "metrics/memory_telemetry.h"
+
+namespace {
+    // Member names for the JsonWriter paths, rendered at compile time. Keep
+    // them in sync with the string keys used by the JsonObject serializers below.
+    namespace Keys {
+        constexpr JsonKey RETURN_TEMP = JSON_KEY("returnTempC");
+        constexpr JsonKey SUPPLY_TEMP = JSON_KEY("supplyTempC");
+        constexpr JsonKey DELTA_T = JSON_KEY("deltaT");
+        constexpr JsonKey FAN_AMPS = JSON_KEY("fanAmps");
+        constexpr JsonKey COMPRESSOR_AMPS = JSON_KEY("compressorAmps");
+        constexpr JsonKey GEO_PUMPS_AMPS = JSON_KEY("geoPumpsAmps");
+        constexpr JsonKey FAN_STATUS = JSON_KEY("fanStatus");
+        constexpr JsonKey COMPRESSOR_STATUS = JSON_KEY("compressorStatus");
+        constexpr JsonKey GEO_PUMPS_STATUS = JSON_KEY("geoPumpsStatus");
+        constexpr JsonKey AIRFLOW_STATUS = JSON_KEY("airflowStatus");
+        constexpr JsonKey ALERT_STATUS = JSON_KEY("alertStatus");
+
+        constexpr JsonKey TIMESTAMP = JSON_KEY("timestamp");
+        constexpr JsonKey SAMPLE_COUNT = JSON_KEY("sampleCount");
+        constexpr JsonKey AVG_RETURN_TEMP = JSON_KEY("avgReturnTempC");
+        constexpr JsonKey MIN_RETURN_TEMP = JSON_KEY("minReturnTempC");
+        constexpr JsonKey MAX_RETURN_TEMP = JSON_KEY("maxReturnTempC");
+        constexpr JsonKey STDDEV_RETURN_TEMP = JSON_KEY("stddevReturnTempC");
+        constexpr JsonKey AVG_SUPPLY_TEMP = JSON_KEY("avgSupplyTempC");
+        constexpr JsonKey MIN_SUPPLY_TEMP = JSON_KEY("minSupplyTempC");
+        constexpr JsonKey MAX_SUPPLY_TEMP = JSON_KEY("maxSupplyTempC");
+        constexpr JsonKey STDDEV_SUPPLY_TEMP = JSON_KEY("stddevSupplyTempC");
+        constexpr JsonKey AVG_DELTA_T = JSON_KEY("avgDeltaT");
+        constexpr JsonKey MIN_DELTA_T = JSON_KEY("minDeltaT");
+        constexpr JsonKey MAX_DELTA_T = JSON_KEY("maxDeltaT");
+        constexpr JsonKey STDDEV_DELTA_T = JSON_KEY("stddevDeltaT");
+        constexpr JsonKey AVG_FAN_AMPS = JSON_KEY("avgFanAmps");
+        constexpr JsonKey MIN_FAN_AMPS = JSON_KEY("minFanAmps");
+        constexpr JsonKey MAX_FAN_AMPS = JSON_KEY("maxFanAmps");
+        constexpr JsonKey STDDEV_FAN_AMPS = JSON_KEY("stddevFanAmps");
+        constexpr JsonKey AVG_COMPRESSOR_AMPS = JSON_KEY("avgCompressorAmps");
+        constexpr JsonKey MIN_COMPRESSOR_AMPS = JSON_KEY("minCompressorAmps");
+        constexpr JsonKey MAX_COMPRESSOR_AMPS = JSON_KEY("maxCompressorAmps");
+        constexpr JsonKey STDDEV_COMPRESSOR_AMPS = JSON_KEY("stddevCompressorAmps");
+        constexpr JsonKey AVG_GEO_PUMPS_AMPS = JSON_KEY("avgGeoPumpsAmps");
+        constexpr JsonKey MIN_GEO_PUMPS_AMPS = JSON_KEY("minGeoPumpsAmps");
+        constexpr JsonKey MAX_GEO_PUMPS_AMPS = JSON_KEY("maxGeoPumpsAmps");
+        constexpr JsonKey STDDEV_GEO_PUMPS_AMPS = JSON_KEY("stddevGeoPumpsAmps");
+        constexpr JsonKey LAST_FAN_STATUS = JSON_KEY("lastFanStatus");
+        constexpr JsonKey LAST_COMPRESSOR_STATUS = JSON_KEY("lastCompressorStatus");
+        constexpr JsonKey LAST_GEO_PUMPS_STATUS = JSON_KEY("lastGeoPumpsStatus");
+
+        constexpr JsonKey VERSION = JSON_KEY("version");
+        constexpr JsonKey BUILD_DATE = JSON_KEY("buildDate");
+        constexpr JsonKey SEQUENCE = JSON_KEY("sequence");
+        constexpr JsonKey RECORDS = JSON_KEY("records");
+        constexpr JsonKey CHANGED = JSON_KEY("changed");
+        constexpr JsonKey LEVEL = JSON_KEY("level");
+        constexpr JsonKey TAG = JSON_KEY("tag");
+        constexpr JsonKey MESSAGE = JSON_KEY("message");
+
+        constexpr JsonKey UPTIME = JSON_KEY("uptime_ms");
+        constexpr JsonKey FREE_HEAP = JSON_KEY("free_heap_bytes");
+        constexpr JsonKey LARGEST_FREE_BLOCK = JSON_KEY("largest_free_block_bytes");
+        constexpr JsonKey MIN_FREE_HEAP = JSON_KEY("min_free_heap_bytes");
+        constexpr JsonKey FRAGMENTATION = JSON_KEY("fragmentation_pct");
+        constexpr JsonKey STACK_HIGH_WATER = JSON_KEY("stack_high_water_bytes");
+        constexpr JsonKey MEMORY_HISTORY = JSON_KEY("memory_history");
+    }
+}
 
 void JsonBuilder::serializeHvacDataToJson(JsonObject& doc, const HVACData& data) {
     doc["returnTempC"] = data.returnTempC;
@@ -17,33 +86,143 @@ void JsonBuilder::serializeHvacDataToJson(JsonObject& doc, const HVACData& data)
     doc["alertStatus"] = toString(data.alertStatus);
 }
 
+void JsonBuilder::writeHvacDataJson(JsonWriter& writer, const HVACData& data) {
+    writer.beginObject();
+    writeHvacDataMembers(writer, data);
+    writer.endObject();
+}
+
+void JsonBuilder::writeHvacDataMembers(JsonWriter& writer, const HVACData& data) {
+    // Keep the member order in sync with serializeHvacDataToJson().
+    writer.member(Keys::RETURN_TEMP, data.returnTempC);
+    writer.member(Keys::SUPPLY_TEMP, data.supplyTempC);
+    writer.member(Keys::DELTA_T, data.deltaT);
+    writer.member(Keys::FAN_AMPS, data.fanAmps);
+    writer.member(Keys::COMPRESSOR_AMPS, data.compressorAmps);
+    writer.member(Keys::GEO_PUMPS_AMPS, data.geoPumpsAmps);
+    writer.member(Keys::FAN_STATUS, toString(data.fanStatus));
+    writer.member(Keys::COMPRESSOR_STATUS, toString(data.compressorStatus));
+    writer.member(Keys::GEO_PUMPS_STATUS, toString(data.geoPumpsStatus));
+    writer.member(Keys::AIRFLOW_STATUS, toString(data.airflowStatus));
+    writer.member(Keys::ALERT_STATUS, toString(data.alertStatus));
+}
+
+void JsonBuilder::serializeAggregatedDataToJson(JsonObject& doc, const AggregatedHVACData& data) {
+    doc["timestamp"] = data.timestamp;
+    doc["sampleCount"] = data.sampleCount;
+    doc["avgReturnTempC"] = data.avgReturnTempC;
+    doc["minReturnTempC"] = data.minReturnTempC;
+    doc["maxReturnTempC"] = data.maxReturnTempC;
+    doc["stddevReturnTempC"] = data.stddevReturnTempC;
+    doc["avgSupplyTempC"] = data.avgSupplyTempC;
+    doc["minSupplyTempC"] = data.minSupplyTempC;
+    doc["maxSupplyTempC"] = data.maxSupplyTempC;
+    doc["stddevSupplyTempC"] = data.stddevSupplyTempC;
+    doc["avgDeltaT"] = data.avgDeltaT;
+    doc["minDeltaT"] = data.minDeltaT;
+    doc["maxDeltaT"] = data.maxDeltaT;
+    doc["stddevDeltaT"] = data.stddevDeltaT;
+    doc["avgFanAmps"] = data.avgFanAmps;
+    doc["minFanAmps"] = data.minFanAmps;
+    doc["maxFanAmps"] = data.maxFanAmps;
+    doc["stddevFanAmps"] = data.stddevFanAmps;
+    doc["avgCompressorAmps"] = data.avgCompressorAmps;
+    doc["minCompressorAmps"] = data.minCompressorAmps;
+    doc["maxCompressorAmps"] = data.maxCompressorAmps;
+    doc["stddevCompressorAmps"] = data.stddevCompressorAmps;
+    doc["avgGeoPumpsAmps"] = data.avgGeoPumpsAmps;
+    doc["minGeoPumpsAmps"] = data.minGeoPumpsAmps;
+    doc["maxGeoPumpsAmps"] = data.maxGeoPumpsAmps;
+    doc["stddevGeoPumpsAmps"] = data.stddevGeoPumpsAmps;
+    doc["lastFanStatus"] = toString(data.lastFanStatus);
+    doc["lastCompressorStatus"] = toString(data.lastCompressorStatus);
+    doc["lastGeoPumpsStatus"] = toString(data.lastGeoPumpsStatus);
+}
+
+void JsonBuilder::writeAggregatedDataMembers(JsonWriter& writer, const AggregatedHVACData& data) {
+    // Keep the member order in sync with serializeAggregatedDataToJson().
+    writer.member(Keys::TIMESTAMP, data.timestamp);
+    writer.member(Keys::SAMPLE_COUNT, data.sampleCount);
+    writer.member(Keys::AVG_RETURN_TEMP, data.avgReturnTempC);
+    writer.member(Keys::MIN_RETURN_TEMP, data.minReturnTempC);
+    writer.member(Keys::MAX_RETURN_TEMP, data.maxReturnTempC);
+    writer.member(Keys::STDDEV_RETURN_TEMP, data.stddevReturnTempC);
+    writer.member(Keys::AVG_SUPPLY_TEMP, data.avgSupplyTempC);
+    writer.member(Keys::MIN_SUPPLY_TEMP, data.minSupplyTempC);
+    writer.member(Keys::MAX_SUPPLY_TEMP, data.maxSupplyTempC);
+    writer.member(Keys::STDDEV_SUPPLY_TEMP, data.stddevSupplyTempC);
+    writer.member(Keys::AVG_DELTA_T, data.avgDeltaT);
+    writer.member(Keys::MIN_DELTA_T, data.minDeltaT);
+    writer.member(Keys::MAX_DELTA_T, data.maxDeltaT);
+    writer.member(Keys::STDDEV_DELTA_T, data.stddevDeltaT);
+    writer.member(Keys::AVG_FAN_AMPS, data.avgFanAmps);
+    writer.member(Keys::MIN_FAN_AMPS, data.minFanAmps);
+    writer.member(Keys::MAX_FAN_AMPS, data.maxFanAmps);
+    writer.member(Keys::STDDEV_FAN_AMPS, data.stddevFanAmps);
+    writer.member(Keys::AVG_COMPRESSOR_AMPS, data.avgCompressorAmps);
+    writer.member(Keys::MIN_COMPRESSOR_AMPS, data.minCompressorAmps);
+    writer.member(Keys::MAX_COMPRESSOR_AMPS, data.maxCompressorAmps);
+    writer.member(Keys::STDDEV_COMPRESSOR_AMPS, data.stddevCompressorAmps);
+    writer.member(Keys::AVG_GEO_PUMPS_AMPS, data.avgGeoPumpsAmps);
+    writer.member(Keys::MIN_GEO_PUMPS_AMPS, data.minGeoPumpsAmps);
+    writer.member(Keys::MAX_GEO_PUMPS_AMPS, data.maxGeoPumpsAmps);
+    writer.member(Keys::STDDEV_GEO_PUMPS_AMPS, data.stddevGeoPumpsAmps);
+    writer.member(Keys::LAST_FAN_STATUS, toString(data.lastFanStatus));
+    writer.member(Keys::LAST_COMPRESSOR_STATUS, toString(data.lastCompressorStatus));
+    writer.member(Keys::LAST_GEO_PUMPS_STATUS, toString(data.lastGeoPumpsStatus));
+}
+
 size_t JsonBuilder::buildPayload(const HVACData& data, const char* version, const char* buildDate, char* buffer, size_t bufferSize) {
-    // Per ArduinoJson v7, StaticJsonDocument is deprecated. JsonDocument is preferred.
-    JsonDocument doc; // Size will be adjusted automatically
-    JsonObject root = doc.to<JsonObject>();
-    serializeHvacDataToJson(root, data);
-    root["version"] = version;
-    root["buildDate"] = buildDate;
+    // Written straight into the caller's buffer: no JsonDocument, no heap.
+    JsonWriter writer(buffer, bufferSize);
+    writer.beginObject();
+    writeHvacDataMembers(writer, data);
+    writer.member(Keys::VERSION, version);
+    writer.member(Keys::BUILD_DATE, buildDate);
+    writer.endObject();
 
-    // Serialize the JSON document to the provided buffer
-    return serializeJson(doc, buffer, bufferSize);
+    return writer.overflowed() ? 0 : writer.size();
 }
 
-void JsonBuilder::buildHistoryJson(ArduinoJson::JsonArray& history, const std::array<HVACData, DATA_BUFFER_SIZE>& dataBuffer, size_t bufferIndex) {
-    // The buffer is circular. The oldest element is at the current index (if the buffer is full).
-    // We iterate from the current index, wrap around, and stop before the current index again.
-    for (size_t i = 0; i < dataBuffer.size(); ++i) {
-        size_t idx = (bufferIndex + i) % dataBuffer.size();
-        const HVACData& data = dataBuffer[idx];
+size_t JsonBuilder::buildEventPayload(const HVACData& data, uint8_t changes, char* buffer, size_t bufferSize) {
+    JsonWriter writer(buffer, bufferSize);
+    writer.beginObject();
+    writer.member(Keys::TIMESTAMP, data.timestamp);
+    writeHvacDataMembers(writer, data);
+    writer.key(Keys::CHANGED);
+    writer.beginArray();
+    if (changes & ChangeDetector::STATUS) {
+        writer.value("status");
+    }
+    if (changes & ChangeDetector::ALERT) {
+        writer.value("alert");
+    }
+    if (changes & ChangeDetector::ANALOG) {
+        writer.value("analog");
+    }
+    writer.endArray();
+    writer.endObject();
 
-        // Don't add empty/default entries if the buffer isn't full yet.
-        if (!data.isInitialized) {
-            continue;
-        }
+    return writer.overflowed() ? 0 : writer.size();
+}
 
+size_t JsonBuilder::buildLogPayload(uint32_t timestamp, const char* level, const char* tag, const char* message, char* buffer, size_t bufferSize) {
+    JsonWriter writer(buffer, bufferSize);
+    writer.beginObject();
+    writer.member(Keys::TIMESTAMP, timestamp);
+    writer.member(Keys::LEVEL, level);
+    writer.member(Keys::TAG, tag);
+    writer.member(Keys::MESSAGE, message);
+    writer.endObject();
+
+    return writer.overflowed() ? 0 : writer.size();
+}
+
+void JsonBuilder::buildHistoryJson(ArduinoJson::JsonArray& history, const CompactSampleStore& store, size_t maxSamples) {
+    store.forEachRecent(maxSamples, [&](const HVACData& data) {
         JsonObject entry = history.add<JsonObject>();
         serializeHvacDataToJson(entry, data);
-    }
+    });
 }
 
 void JsonBuilder::buildAggregatedHistoryJson(ArduinoJson::JsonArray& history, const std::array<AggregatedHVACData, AGGREGATED_DATA_BUFFER_SIZE>& dataBuffer, size_t bufferIndex) {
@@ -56,34 +235,129 @@ void JsonBuilder::buildAggregatedHistoryJson(ArduinoJson::JsonArray& history, co
             continue;
         }
 
-        JsonObject entry = history.add<JsonObject>();
-        entry["timestamp"] = data.timestamp;
-        entry["avgReturnTempC"] = data.avgReturnTempC;
-        entry["avgSupplyTempC"] = data.avgSupplyTempC;
-        entry["avgDeltaT"] = data.avgDeltaT;
-        entry["avgFanAmps"] = data.avgFanAmps;
-        entry["avgCompressorAmps"] = data.avgCompressorAmps;
-        entry["avgGeoPumpsAmps"] = data.avgGeoPumpsAmps;
-        entry["lastFanStatus"] = toString(data.lastFanStatus);
-        entry["lastCompressorStatus"] = toString(data.lastCompressorStatus);
-        entry["lastGeoPumpsStatus"] = toString(data.lastGeoPumpsStatus);
+        addAggregatedHistoryPoint(history, data);
     }
 }
 
-size_t JsonBuilder::buildPayload(const AggregatedHVACData& data, const char* version, const char* buildDate, char* buffer, size_t bufferSize) {
-    JsonDocument doc;
-    doc["timestamp"] = data.timestamp;
-    doc["avgReturnTempC"] = data.avgReturnTempC;
-    doc["avgSupplyTempC"] = data.avgSupplyTempC;
-    doc["avgDeltaT"] = data.avgDeltaT;
-    doc["avgFanAmps"] = data.avgFanAmps;
-    doc["avgCompressorAmps"] = data.avgCompressorAmps;
-    doc["avgGeoPumpsAmps"] = data.avgGeoPumpsAmps;
-    doc["lastFanStatus"] = toString(data.lastFanStatus);
-    doc["lastCompressorStatus"] = toString(data.lastCompressorStatus);
-    doc["lastGeoPumpsStatus"] = toString(data.lastGeoPumpsStatus);
-    doc["version"] = version;
-    doc["buildDate"] = buildDate;
+void JsonBuilder::addAggregatedHistoryPoint(ArduinoJson::JsonArray& history, const AggregatedHVACData& data) {
+    JsonObject entry = history.add<JsonObject>();
+    serializeAggregatedDataToJson(entry, data);
+}
 
-    return serializeJson(doc, buffer, bufferSize);
-}
\ No newline at end of file
+size_t JsonBuilder::buildPayload(const AggregatedHVACData& data, uint32_t sequence, const char* version, const char* buildDate, char* buffer, size_t bufferSize) {
+    JsonWriter writer(buffer, bufferSize);
+    writer.beginObject();
+    writeAggregatedDataMembers(writer, data);
+    writer.member(Keys::VERSION, version);
+    writer.member(Keys::BUILD_DATE, buildDate);
+    writer.member(Keys::SEQUENCE, sequence);
+    writer.endObject();
+
+    return writer.overflowed() ? 0 : writer.size();
+}
+
+namespace {
+    // "]}" to close a batch, plus the terminator.
+    constexpr size_t BATCH_CLOSING_SIZE = 3;
+}
+
+JsonBuilder::AggregatedBatch::AggregatedBatch(char* buffer, size_t bufferSize, const char* version, const char* buildDate)
+    : _buffer(buffer),
+      _bufferSize(bufferSize),
+      _length(0),
+      _count(0),
+      _valid(bufferSize > BATCH_CLOSING_SIZE)
+{
+    if (!_valid) {
+        return;
+    }
+    JsonWriter writer(_buffer, _bufferSize - BATCH_CLOSING_SIZE);
+    writer.beginObject();
+    writer.member(Keys::VERSION, version);
+    writer.member(Keys::BUILD_DATE, buildDate);
+    writer.key(Keys::RECORDS);
+    writer.beginArray();
+    _valid = !writer.overflowed();
+    _length = writer.size();
+}
+
+bool JsonBuilder::AggregatedBatch::add(const AggregatedHVACData& data, uint32_t sequence) {
+    if (!_valid) {
+        return false;
+    }
+    // Records are written past the end of what is committed, so one that does
+    // not fit is simply not counted.
+    size_t available = _bufferSize - BATCH_CLOSING_SIZE - _length;
+    size_t prefix = _count > 0 ? 1 : 0;
+    if (available <= prefix) {
+        return false;
+    }
+    JsonWriter writer(_buffer + _length + prefix, available - prefix);
+    writer.beginObject();
+    writeAggregatedDataMembers(writer, data);
+    writer.member(Keys::SEQUENCE, sequence);
+    writer.endObject();
+    if (writer.overflowed()) {
+        _buffer[_length] = '\0';
+        return false;
+    }
+
+    if (prefix > 0) {
+        _buffer[_length] = ',';
+    }
+    _length += prefix + writer.size();
+    _count++;
+    return true;
+}
+
+size_t JsonBuilder::AggregatedBatch::finish() {
+    if (!_valid || _count == 0) {
+        return 0;
+    }
+    _buffer[_length++] = ']';
+    _buffer[_length++] = '}';
+    _buffer[_length] = '\0';
+    _valid = false; // Nothing can be added once closed
+    return _length;
+}
+
+void JsonBuilder::writeMemorySample(JsonWriter& writer, const MemorySample& sample) {
+    writer.beginObject();
+    writer.member(Keys::TIMESTAMP, sample.timestamp);
+    writer.member(Keys::FREE_HEAP, sample.freeHeap);
+    writer.member(Keys::LARGEST_FREE_BLOCK, sample.largestFreeBlock);
+    writer.member(Keys::MIN_FREE_HEAP, sample.minFreeHeap);
+    writer.member(Keys::FRAGMENTATION, sample.fragmentationPercent());
+    writer.key(Keys::STACK_HIGH_WATER);
+    writer.beginObject();
+    for (size_t task = 0; task < MEMORY_TRACKED_TASK_COUNT; task++) {
+        writer.member(MEMORY_TRACKED_TASKS[task], sample.stackHighWater[task]);
+    }
+    writer.endObject();
+    writer.endObject();
+}
+
+size_t JsonBuilder::buildMemoryPayload(const MemorySample& sample, char* buffer, size_t bufferSize) {
+    JsonWriter writer(buffer, bufferSize);
+    writeMemorySample(writer, sample);
+
+    return writer.overflowed() ? 0 : writer.size();
+}
+
+size_t JsonBuilder::buildStatusPayload(uint32_t uptimeMs, uint32_t freeHeap, const MemoryTelemetry& telemetry, char* buffer, size_t bufferSize) {
+    JsonWriter writer(buffer, bufferSize);
+    writer.beginObject();
+    writer.member(Keys::UPTIME, uptimeMs);
+    writer.member(Keys::FREE_HEAP, freeHeap);
+    MemoryTelemetry::History history;
+    size_t count = telemetry.copyHistory(history);
+    writer.key(Keys::MEMORY_HISTORY);
+    writer.beginArray();
+    for (size_t i = 0; i < count; i++) {
+        writeMemorySample(writer, history[i]);
+    }
+    writer.endArray();
+    writer.endObject();
+
+    return writer.overflowed() ? 0 : writer.size();
+}
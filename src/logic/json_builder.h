@@ -2,6 +2,7 @@
 #define JSON_BUILDER_H
 
 #include <cstddef> // for size_t
+#include <cstdint>
 #include "config.h"
 #include <array>   // for std::array
 #include <ArduinoJson.h>
@@ -9,23 +10,89 @@
 // Forward declaration
 struct HVACData;
 struct AggregatedHVACData;
+class CompactSampleStore;
+class JsonWriter;
+struct MemorySample;
+class MemoryTelemetry;
 
 class JsonBuilder {
 public:
-    // Returns the number of bytes written to the buffer.
+    // Writes the payload as NUL-terminated JSON without any heap allocation.
+    // Returns the number of bytes written (excluding the terminator), or 0 if
+    // the payload did not fit in `bufferSize`.
     static size_t buildPayload(const HVACData& data, const char* version, const char* buildDate, char* buffer, size_t bufferSize);
 
-    // Populates a JsonArray with historical data from the circular buffer.
-    static void buildHistoryJson(ArduinoJson::JsonArray& history, const std::array<HVACData, DATA_BUFFER_SIZE>& dataBuffer, size_t bufferIndex);
+    // Writes a live sample for the MQTT event channel: its timestamp, the same
+    // members as the /api/data payload, and which ChangeDetector changes made
+    // it reportable ("changed":["status","alert","analog"]). Same return
+    // contract as buildPayload().
+    static size_t buildEventPayload(const HVACData& data, uint8_t changes, char* buffer, size_t bufferSize);
+
+    // Writes a log line for the MQTT log topic:
+    //   {"timestamp":...,"level":...,"tag":...,"message":...}
+    // Same return contract as buildPayload().
+    static size_t buildLogPayload(uint32_t timestamp, const char* level, const char* tag, const char* message, char* buffer, size_t bufferSize);
+
+    // Writes a memory telemetry sample for the MQTT telemetry topic:
+    //   {"timestamp":...,"free_heap_bytes":...,"largest_free_block_bytes":...,
+    //    "min_free_heap_bytes":...,"fragmentation_pct":...,
+    //    "stack_high_water_bytes":{"<task>":...}}
+    // Same return contract as buildPayload().
+    static size_t buildMemoryPayload(const MemorySample& sample, char* buffer, size_t bufferSize);
+
+    // Writes the /api/status document: uptime, the current free heap and the
+    // memory telemetry history, oldest first, with each entry shaped like
+    // buildMemoryPayload(). Same return contract as buildPayload().
+    static size_t buildStatusPayload(uint32_t uptimeMs, uint32_t freeHeap, const MemoryTelemetry& telemetry, char* buffer, size_t bufferSize);
+
+    // Populates a JsonArray with the most recent `maxSamples` entries of the compact history, oldest first.
+    static void buildHistoryJson(ArduinoJson::JsonArray& history, const CompactSampleStore& store, size_t maxSamples);
+
+    // Writes one sample as a JSON object, with the same members and formatting
+    // as the entries produced by buildHistoryJson().
+    static void writeHvacDataJson(JsonWriter& writer, const HVACData& data);
 
     // Populates a JsonArray with aggregated historical data.
     static void buildAggregatedHistoryJson(ArduinoJson::JsonArray& history, const std::array<AggregatedHVACData, AGGREGATED_DATA_BUFFER_SIZE>& dataBuffer, size_t bufferIndex);
 
-    // Overload for aggregated data payload
-    static size_t buildPayload(const AggregatedHVACData& data, const char* version, const char* buildDate, char* buffer, size_t bufferSize);
+    // Adds one aggregated history point to a JsonArray.
+    static void addAggregatedHistoryPoint(ArduinoJson::JsonArray& history, const AggregatedHVACData& data);
+
+    // Overload for aggregated data payload; same contract as above. `sequence`
+    // identifies the aggregate so the receiver can drop duplicates.
+    static size_t buildPayload(const AggregatedHVACData& data, uint32_t sequence, const char* version, const char* buildDate, char* buffer, size_t bufferSize);
+
+    // Builds a batched aggregate payload one record at a time, straight into a
+    // fixed buffer:
+    //   {"version":...,"buildDate":...,"records":[{...,"sequence":n},...]}
+    // Each record carries the same members as the single-aggregate payload.
+    class AggregatedBatch {
+    public:
+        AggregatedBatch(char* buffer, size_t bufferSize, const char* version, const char* buildDate);
+
+        // Appends a record if it fits while leaving room to close the document.
+        // Returns false, leaving the batch unchanged, if it does not.
+        bool add(const AggregatedHVACData& data, uint32_t sequence);
+
+        // Closes the document and returns its length, or 0 if it holds no records.
+        size_t finish();
+
+        [[nodiscard]] size_t count() const { return _count; }
+
+    private:
+        char* _buffer;
+        size_t _bufferSize;
+        size_t _length;
+        size_t _count;
+        bool _valid;
+    };
 
 private:
     static void serializeHvacDataToJson(JsonObject& doc, const HVACData& data);
+    static void serializeAggregatedDataToJson(JsonObject& doc, const AggregatedHVACData& data);
+    static void writeHvacDataMembers(JsonWriter& writer, const HVACData& data);
+    static void writeAggregatedDataMembers(JsonWriter& writer, const AggregatedHVACData& data);
+    static void writeMemorySample(JsonWriter& writer, const MemorySample& sample);
 };
 
 #endif // JSON_BUILDER_H
\ No newline at end of file
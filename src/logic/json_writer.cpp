@@ -0,0 +1,245 @@
+#include "json_writer.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Scales `value` into [1, 1e7) or so and returns the power of ten that was
+    // factored out. Mirrors ArduinoJson's normalize() so exponents match.
+    int16_t normalize(double& value) {
+        static const double positivePowers[] = {1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256};
+        static const double negativePowers[] = {1e-1, 1e-2, 1e-4, 1e-8, 1e-16, 1e-32, 1e-64, 1e-128, 1e-256};
+        static const double negativePowersPlusOne[] = {1e0, 1e-1, 1e-3, 1e-7, 1e-15, 1e-31, 1e-63, 1e-127, 1e-255};
+
+        int16_t powersOf10 = 0;
+        int index = 8;
+        int bit = 1 << index;
+
+        if (value >= 1e7) {
+            for (; index >= 0; index--) {
+                if (value >= positivePowers[index]) {
+                    value *= negativePowers[index];
+                    powersOf10 = static_cast<int16_t>(powersOf10 + bit);
+                }
+                bit >>= 1;
+            }
+        }
+
+        if (value > 0 && value <= 1e-5) {
+            for (; index >= 0; index--) {
+                if (value < negativePowersPlusOne[index]) {
+                    value *= positivePowers[index];
+                    powersOf10 = static_cast<int16_t>(powersOf10 - bit);
+                }
+                bit >>= 1;
+            }
+        }
+
+        return powersOf10;
+    }
+}
+
+JsonWriter::JsonWriter(char* buffer, size_t capacity)
+    : _buffer(buffer),
+      _capacity(capacity),
+      _size(0),
+      _needsComma(false),
+      _overflowed(capacity == 0)
+{
+    if (_capacity > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+void JsonWriter::reset() {
+    _size = 0;
+    _needsComma = false;
+    _overflowed = _capacity == 0;
+    if (_capacity > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+void JsonWriter::beginObject() {
+    separate();
+    writeRaw('{');
+    _needsComma = false;
+}
+
+void JsonWriter::endObject() {
+    writeRaw('}');
+    _needsComma = true;
+}
+
+void JsonWriter::beginArray() {
+    separate();
+    writeRaw('[');
+    _needsComma = false;
+}
+
+void JsonWriter::endArray() {
+    writeRaw(']');
+    _needsComma = true;
+}
+
+void JsonWriter::key(const char* name) {
+    separate();
+    writeEscaped(name);
+    writeRaw(':');
+    _needsComma = false;
+}
+
+void JsonWriter::key(const JsonKey& name) {
+    separate();
+    writeRaw(name.text, name.length);
+    _needsComma = false;
+}
+
+void JsonWriter::value(double number) {
+    separate();
+    _needsComma = true;
+
+    if (std::isnan(number) || std::isinf(number)) {
+        writeRaw("null");
+        return;
+    }
+
+    if (number < 0.0) {
+        writeRaw('-');
+        number = -number;
+    }
+
+    // Split into integral, decimal and exponent parts with at most nine
+    // decimal places in total, exactly as ArduinoJson does.
+    uint32_t maxDecimalPart = 1000000000;
+    int8_t decimalPlaces = 9;
+    int16_t exponent = normalize(number);
+
+    uint32_t integral = static_cast<uint32_t>(number);
+    for (uint32_t tmp = integral; tmp >= 10; tmp /= 10) {
+        maxDecimalPart /= 10;
+        decimalPlaces--;
+    }
+
+    double remainder = (number - static_cast<double>(integral)) * static_cast<double>(maxDecimalPart);
+    uint32_t decimal = static_cast<uint32_t>(remainder);
+    remainder = remainder - static_cast<double>(decimal);
+    decimal += static_cast<uint32_t>(remainder * 2); // Round half up
+
+    if (decimal >= maxDecimalPart) {
+        decimal = 0;
+        integral++;
+        if (exponent && integral >= 10) {
+            exponent++;
+            integral = 1;
+        }
+    }
+
+    while (decimal % 10 == 0 && decimalPlaces > 0) {
+        decimal /= 10;
+        decimalPlaces--;
+    }
+
+    writeInteger(integral, false);
+
+    if (decimalPlaces > 0) {
+        char digits[10];
+        char* end = digits + sizeof(digits);
+        char* begin = end;
+        for (int8_t i = 0; i < decimalPlaces; i++) {
+            *--begin = static_cast<char>('0' + decimal % 10);
+            decimal /= 10;
+        }
+        *--begin = '.';
+        writeRaw(begin, static_cast<size_t>(end - begin));
+    }
+
+    if (exponent) {
+        writeRaw('e');
+        if (exponent < 0) {
+            writeInteger(static_cast<uint64_t>(-exponent), true);
+        } else {
+            writeInteger(static_cast<uint64_t>(exponent), false);
+        }
+    }
+}
+
+void JsonWriter::value(const char* text) {
+    separate();
+    _needsComma = true;
+    if (text == nullptr) {
+        writeRaw("null");
+        return;
+    }
+    writeEscaped(text);
+}
+
+void JsonWriter::value(bool flag) {
+    separate();
+    _needsComma = true;
+    writeRaw(flag ? "true" : "false");
+}
+
+void JsonWriter::nullValue() {
+    separate();
+    _needsComma = true;
+    writeRaw("null");
+}
+
+void JsonWriter::separate() {
+    if (_needsComma) {
+        writeRaw(',');
+    }
+}
+
+void JsonWriter::writeInteger(uint64_t magnitude, bool negative) {
+    char digits[21];
+    char* end = digits + sizeof(digits);
+    char* begin = end;
+    do {
+        *--begin = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (negative) {
+        *--begin = '-';
+    }
+    writeRaw(begin, static_cast<size_t>(end - begin));
+}
+
+void JsonWriter::writeEscaped(const char* text) {
+    writeRaw('"');
+    for (const char* p = text; *p != '\0'; p++) {
+        switch (*p) {
+            case '"':  writeRaw("\\\"", 2); break;
+            case '\\': writeRaw("\\\\", 2); break;
+            case '\b': writeRaw("\\b", 2); break;
+            case '\f': writeRaw("\\f", 2); break;
+            case '\n': writeRaw("\\n", 2); break;
+            case '\r': writeRaw("\\r", 2); break;
+            case '\t': writeRaw("\\t", 2); break;
+            default:   writeRaw(*p); break;
+        }
+    }
+    writeRaw('"');
+}
+
+void JsonWriter::writeRaw(char c) {
+    writeRaw(&c, 1);
+}
+
+void JsonWriter::writeRaw(const char* text) {
+    writeRaw(text, strlen(text));
+}
+
+void JsonWriter::writeRaw(const char* text, size_t length) {
+    if (_overflowed) {
+        return;
+    }
+    // Keep one byte for the terminator, like serializeJson().
+    if (length >= _capacity - _size) {
+        _overflowed = true;
+        return;
+    }
+    memcpy(_buffer + _size, text, length);
+    _size += length;
+    _buffer[_size] = '\0';
+}
@@ -0,0 +1,93 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// An object key rendered at compile time as `"name":`, so writing it is a
+// single copy with no escaping. Build one with JSON_KEY("name"); the name must
+// be a string literal that needs no escaping.
+struct JsonKey {
+    const char* text;
+    size_t length;
+};
+
+#define JSON_KEY(name) JsonKey{"\"" name "\":", sizeof("\"" name "\":") - 1}
+
+// Forward-only JSON writer over a caller-supplied buffer. It never allocates,
+// so it can serialize straight into a fixed scratch or transmit buffer.
+//
+// Output is byte-for-byte what ArduinoJson's serializeJson() produces for the
+// same members in the same order, including its number formatting (up to 9
+// significant decimals, exponent outside [1e-5, 1e7), NaN/Inf as null), so
+// the two can be mixed freely behind the same API.
+//
+// Like serializeJson(), the output is always NUL-terminated and at most
+// capacity - 1 characters are written. Once something does not fit the
+// writer is marked as overflowed and ignores everything that follows.
+class JsonWriter {
+public:
+    JsonWriter(char* buffer, size_t capacity);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    // Writes an object key; the next value() call supplies its value.
+    void key(const char* name);
+    void key(const JsonKey& name);
+
+    void value(double number);
+    void value(const char* text);
+    void value(bool flag);
+    void nullValue();
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type
+    value(T number) {
+        separate();
+        _needsComma = true;
+        if (std::is_signed<T>::value && number < 0) {
+            writeInteger(0 - static_cast<uint64_t>(number), true);
+        } else {
+            writeInteger(static_cast<uint64_t>(number), false);
+        }
+    }
+
+    template <typename T>
+    void member(const char* name, T v) {
+        key(name);
+        value(v);
+    }
+
+    template <typename T>
+    void member(const JsonKey& name, T v) {
+        key(name);
+        value(v);
+    }
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] bool overflowed() const { return _overflowed; }
+    [[nodiscard]] const char* c_str() const { return _buffer; }
+
+    // Discards everything written so far.
+    void reset();
+
+private:
+    void separate();
+    void writeInteger(uint64_t magnitude, bool negative);
+    void writeRaw(char c);
+    void writeRaw(const char* text, size_t length);
+    void writeRaw(const char* text);
+    void writeEscaped(const char* text);
+
+    char* _buffer;
+    size_t _capacity;
+    size_t _size;
+    bool _needsComma;
+    bool _overflowed;
+};
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,82 @@
+#include "running_stats.h"
+#include <cmath>
+
+RunningStats::RunningStats() {
+    reset();
+}
+
+void RunningStats::add(double value, double weight) {
+    _count++;
+    _weight += weight;
+    double delta = value - _mean;
+    _mean += delta * weight / _weight;
+    _m2 += weight * delta * (value - _mean);
+
+    if (_count == 1 || value < _min) {
+        _min = value;
+    }
+    if (_count == 1 || value > _max) {
+        _max = value;
+    }
+}
+
+RunningStats RunningStats::fromSummary(size_t count, double weight, double mean, double stddev, double min, double max) {
+    RunningStats stats;
+    if (count > 0 && weight > 0) {
+        stats._count = count;
+        stats._weight = weight;
+        stats._mean = mean;
+        stats._m2 = stddev * stddev * weight;
+        stats._min = min;
+        stats._max = max;
+    }
+    return stats;
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other._count == 0) {
+        return;
+    }
+    if (_count == 0) {
+        *this = other;
+        return;
+    }
+
+    double total = _weight + other._weight;
+    double delta = other._mean - _mean;
+    _mean += delta * other._weight / total;
+    _m2 += other._m2 + delta * delta * _weight * other._weight / total;
+    if (other._min < _min) {
+        _min = other._min;
+    }
+    if (other._max > _max) {
+        _max = other._max;
+    }
+    _count += other._count;
+    _weight = total;
+}
+
+void RunningStats::reset() {
+    _count = 0;
+    _weight = 0.0;
+    _mean = 0.0;
+    _m2 = 0.0;
+    _min = 0.0;
+    _max = 0.0;
+}
+
+double RunningStats::min() const {
+    return _min;
+}
+
+double RunningStats::max() const {
+    return _max;
+}
+
+double RunningStats::variance() const {
+    return _weight > 0.0 ? _m2 / _weight : 0.0;
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
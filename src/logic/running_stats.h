@@ -0,0 +1,41 @@
+#ifndef RUNNING_STATS_H
+#define RUNNING_STATS_H
+
+#include <cstddef>
+
+// Single-pass count/mean/min/max/variance for one metric using Welford's
+// algorithm, which stays numerically stable without keeping the samples.
+// Samples may carry weights (West's extension), e.g. the time each stands for.
+class RunningStats {
+public:
+    RunningStats();
+
+    // Rebuilds the accumulator state from previously reported statistics of
+    // `count` samples whose weights sum to `weight`.
+    static RunningStats fromSummary(size_t count, double weight, double mean, double stddev, double min, double max);
+
+    // `weight` must be positive.
+    void add(double value, double weight = 1.0);
+    // Combines another set of samples into this one (Chan et al. parallel update).
+    void merge(const RunningStats& other);
+    void reset();
+
+    [[nodiscard]] size_t count() const { return _count; }
+    [[nodiscard]] double totalWeight() const { return _weight; }
+    // All of these return 0 when no samples have been added.
+    [[nodiscard]] double mean() const { return _mean; }
+    [[nodiscard]] double min() const;
+    [[nodiscard]] double max() const;
+    [[nodiscard]] double variance() const; // Weighted population variance
+    [[nodiscard]] double stddev() const;
+
+private:
+    size_t _count;
+    double _weight;
+    double _mean;
+    double _m2; // Sum of squared differences from the mean
+    double _min;
+    double _max;
+};
+
+#endif // RUNNING_STATS_H
@@ -1,5 +1,11 @@
 #include "settings_validator.h"
 
+namespace {
+    // An alert can only be raised from what the sample history still holds,
+    // which is a little over 20 minutes at the default read interval.
+    constexpr unsigned int MAX_ALERT_DURATION_S = 1200;
+}
+
 ValidationResult SettingsValidator::validateAndApply(const JsonObject& jsonObj, AppConfig& config) {
     if (!jsonObj["lowDeltaTThreshold"].isNull()) {
         float val = jsonObj["lowDeltaTThreshold"].as<float>();
@@ -11,27 +17,43 @@ ValidationResult SettingsValidator::validateAndApply(const JsonObject& jsonObj,
 
     if (!jsonObj["lowDeltaTDurationS"].isNull()) {
         unsigned int val = jsonObj["lowDeltaTDurationS"].as<unsigned int>();
-        if (val < 10 || val > 3600) {
-            return {false, "Invalid Delta T duration. Must be between 10 and 3600 seconds."};
+        if (val < 10 || val > MAX_ALERT_DURATION_S) {
+            return {false, "Invalid Delta T duration. Must be between 10 and 1200 seconds."};
         }
         config.lowDeltaTDurationS = val;
     }
 
     if (!jsonObj["noAirflowDurationS"].isNull()) {
         unsigned int val = jsonObj["noAirflowDurationS"].as<unsigned int>();
-        if (val < 10 || val > 3600) {
-            return {false, "Invalid No Airflow duration. Must be between 10 and 3600 seconds."};
+        if (val < 10 || val > MAX_ALERT_DURATION_S) {
+            return {false, "Invalid No Airflow duration. Must be between 10 and 1200 seconds."};
         }
         config.noAirflowDurationS = val;
     }
 
     if (!jsonObj["tempSensorDisconnectedDurationS"].isNull()) {
         unsigned int val = jsonObj["tempSensorDisconnectedDurationS"].as<unsigned int>();
-        if (val < 10 || val > 3600) {
-            return {false, "Invalid Temp Sensor Disconnected duration. Must be between 10 and 3600 seconds."};
+        if (val < 10 || val > MAX_ALERT_DURATION_S) {
+            return {false, "Invalid Temp Sensor Disconnected duration. Must be between 10 and 1200 seconds."};
         }
         config.tempSensorDisconnectedDurationS = val;
     }
 
+    if (!jsonObj["sensorReadIntervalMs"].isNull()) {
+        unsigned long val = jsonObj["sensorReadIntervalMs"].as<unsigned long>();
+        if (val < 1000 || val > 60000) {
+            return {false, "Invalid sensor read interval. Must be between 1000 and 60000 ms."};
+        }
+        config.sensorReadIntervalMs = val;
+    }
+
+    if (!jsonObj["adcSamplesPerChannel"].isNull()) {
+        unsigned int val = jsonObj["adcSamplesPerChannel"].as<unsigned int>();
+        if (val < 50 || val > 2000) {
+            return {false, "Invalid ADC sample count. Must be between 50 and 2000 per channel."};
+        }
+        config.adcSamplesPerChannel = val;
+    }
+
     return {true, "Settings applied."};
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "streaming_aggregator.h"
+#include "config.h"
+
+void StreamingAggregator::add(const HVACData& data) {
+    if (!data.isInitialized) {
+        return;
+    }
+    uint32_t elapsed = data.timestamp - _lastTimestamp;
+    bool later = _hasLastTimestamp && elapsed > 0 && elapsed < 0x80000000u;
+    double weight = static_cast<double>(later ? elapsed : SENSOR_READ_INTERVAL_MS);
+    _lastTimestamp = data.timestamp;
+    _hasLastTimestamp = true;
+
+    _returnTemp.add(data.returnTempC, weight);
+    _supplyTemp.add(data.supplyTempC, weight);
+    _deltaT.add(data.deltaT, weight);
+    _fanAmps.add(data.fanAmps, weight);
+    _compressorAmps.add(data.compressorAmps, weight);
+    _geoPumpsAmps.add(data.geoPumpsAmps, weight);
+}
+
+void StreamingAggregator::merge(const AggregatedHVACData& aggregate) {
+    size_t n = aggregate.sampleCount;
+    if (n == 0) {
+        return;
+    }
+    double w = aggregate.durationMs > 0 ? static_cast<double>(aggregate.durationMs)
+                                        : static_cast<double>(n) * SENSOR_READ_INTERVAL_MS;
+    _returnTemp.merge(RunningStats::fromSummary(n, w, aggregate.avgReturnTempC, aggregate.stddevReturnTempC, aggregate.minReturnTempC, aggregate.maxReturnTempC));
+    _supplyTemp.merge(RunningStats::fromSummary(n, w, aggregate.avgSupplyTempC, aggregate.stddevSupplyTempC, aggregate.minSupplyTempC, aggregate.maxSupplyTempC));
+    _deltaT.merge(RunningStats::fromSummary(n, w, aggregate.avgDeltaT, aggregate.stddevDeltaT, aggregate.minDeltaT, aggregate.maxDeltaT));
+    _fanAmps.merge(RunningStats::fromSummary(n, w, aggregate.avgFanAmps, aggregate.stddevFanAmps, aggregate.minFanAmps, aggregate.maxFanAmps));
+    _compressorAmps.merge(RunningStats::fromSummary(n, w, aggregate.avgCompressorAmps, aggregate.stddevCompressorAmps, aggregate.minCompressorAmps, aggregate.maxCompressorAmps));
+    _geoPumpsAmps.merge(RunningStats::fromSummary(n, w, aggregate.avgGeoPumpsAmps, aggregate.stddevGeoPumpsAmps, aggregate.minGeoPumpsAmps, aggregate.maxGeoPumpsAmps));
+}
+
+AggregatedHVACData StreamingAggregator::snapshot(const HVACData& lastKnownData) const {
+    AggregatedHVACData result;
+    result.sampleCount = static_cast<uint32_t>(sampleCount());
+    result.durationMs = static_cast<uint32_t>(_returnTemp.totalWeight());
+
+    result.avgReturnTempC = _returnTemp.mean();
+    result.minReturnTempC = _returnTemp.min();
+    result.maxReturnTempC = _returnTemp.max();
+    result.stddevReturnTempC = _returnTemp.stddev();
+
+    result.avgSupplyTempC = _supplyTemp.mean();
+    result.minSupplyTempC = _supplyTemp.min();
+    result.maxSupplyTempC = _supplyTemp.max();
+    result.stddevSupplyTempC = _supplyTemp.stddev();
+
+    result.avgDeltaT = _deltaT.mean();
+    result.minDeltaT = _deltaT.min();
+    result.maxDeltaT = _deltaT.max();
+    result.stddevDeltaT = _deltaT.stddev();
+
+    result.avgFanAmps = _fanAmps.mean();
+    result.minFanAmps = _fanAmps.min();
+    result.maxFanAmps = _fanAmps.max();
+    result.stddevFanAmps = _fanAmps.stddev();
+
+    result.avgCompressorAmps = _compressorAmps.mean();
+    result.minCompressorAmps = _compressorAmps.min();
+    result.maxCompressorAmps = _compressorAmps.max();
+    result.stddevCompressorAmps = _compressorAmps.stddev();
+
+    result.avgGeoPumpsAmps = _geoPumpsAmps.mean();
+    result.minGeoPumpsAmps = _geoPumpsAmps.min();
+    result.maxGeoPumpsAmps = _geoPumpsAmps.max();
+    result.stddevGeoPumpsAmps = _geoPumpsAmps.stddev();
+
+    // Capture the final state from the most recent reading
+    result.lastFanStatus = lastKnownData.fanStatus;
+    result.lastCompressorStatus = lastKnownData.compressorStatus;
+    result.lastGeoPumpsStatus = lastKnownData.geoPumpsStatus;
+
+    return result;
+}
+
+void StreamingAggregator::reset() {
+    _returnTemp.reset();
+    _supplyTemp.reset();
+    _deltaT.reset();
+    _fanAmps.reset();
+    _compressorAmps.reset();
+    _geoPumpsAmps.reset();
+}
@@ -0,0 +1,48 @@
+#ifndef STREAMING_AGGREGATOR_H
+#define STREAMING_AGGREGATOR_H
+
+#include "hvac_data.h"
+#include "logic/running_stats.h"
+
+// Accumulates statistics for every metric as samples arrive, so producing an
+// aggregate is a constant-time snapshot instead of a pass over the history
+// buffer. The aggregation period is whatever the caller decides between
+// snapshots; it is not tied to DATA_BUFFER_SIZE.
+//
+// Samples are weighted by the time since the previous one, so the statistics
+// describe the period rather than the readings when the read interval varies.
+// Merged aggregates are weighted by the time they cover (durationMs), so an
+// idle period read every 30 s counts as much as an active one of equal length.
+class StreamingAggregator {
+public:
+    // Uninitialized samples are ignored. The first sample, or one that is not
+    // later than the last, stands for SENSOR_READ_INTERVAL_MS.
+    void add(const HVACData& data);
+
+    // Merges a previously produced aggregate, e.g. to roll finer periods up
+    // into a coarser one. Aggregates with no samples are ignored; one without a
+    // duration is taken to cover SENSOR_READ_INTERVAL_MS per sample.
+    void merge(const AggregatedHVACData& aggregate);
+
+    // Statistics for every sample added since the last reset(). Component
+    // statuses are taken from `lastKnownData`.
+    [[nodiscard]] AggregatedHVACData snapshot(const HVACData& lastKnownData) const;
+
+    // Starts a new period. The last sample's timestamp is kept, so the first
+    // sample of the next period still covers the gap before it.
+    void reset();
+
+    [[nodiscard]] size_t sampleCount() const { return _returnTemp.count(); }
+
+private:
+    RunningStats _returnTemp;
+    RunningStats _supplyTemp;
+    RunningStats _deltaT;
+    RunningStats _fanAmps;
+    RunningStats _compressorAmps;
+    RunningStats _geoPumpsAmps;
+    uint32_t _lastTimestamp = 0;
+    bool _hasLastTimestamp = false;
+};
+
+#endif // STREAMING_AGGREGATOR_H
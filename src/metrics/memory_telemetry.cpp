@@ -0,0 +1,51 @@
+#include "memory_telemetry.h"
+#include "interfaces/i_memory_probe.h"
+
+MemoryTelemetry::MemoryTelemetry(IMemoryProbe& probe)
+    : _probe(probe),
+      _samples(),
+      _next(0),
+      _count(0)
+{}
+
+MemorySample MemoryTelemetry::sample(uint32_t timestamp) {
+    // The probe is read outside the lock; the stack walk takes a while.
+    MemorySample sample;
+    sample.timestamp = timestamp;
+    sample.freeHeap = _probe.freeHeap();
+    sample.largestFreeBlock = _probe.largestFreeBlock();
+    sample.minFreeHeap = _probe.minFreeHeap();
+    for (size_t task = 0; task < MEMORY_TRACKED_TASK_COUNT; task++) {
+        sample.stackHighWater[task] = _probe.stackHighWater(MEMORY_TRACKED_TASKS[task]);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _samples[_next] = sample;
+    _next = (_next + 1) % MEMORY_HISTORY_SIZE;
+    if (_count < MEMORY_HISTORY_SIZE) {
+        _count++;
+    }
+    return sample;
+}
+
+size_t MemoryTelemetry::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _count;
+}
+
+size_t MemoryTelemetry::copyHistory(History& out) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t oldest = (_next + MEMORY_HISTORY_SIZE - _count) % MEMORY_HISTORY_SIZE;
+    for (size_t i = 0; i < _count; i++) {
+        out[i] = _samples[(oldest + i) % MEMORY_HISTORY_SIZE];
+    }
+    return _count;
+}
+
+MemorySample MemoryTelemetry::latest() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_count == 0) {
+        return MemorySample();
+    }
+    return _samples[(_next + MEMORY_HISTORY_SIZE - 1) % MEMORY_HISTORY_SIZE];
+}
@@ -0,0 +1,58 @@
+#ifndef MEMORY_TELEMETRY_H
+#define MEMORY_TELEMETRY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "config.h"
+
+class IMemoryProbe;
+
+struct MemorySample {
+    uint32_t timestamp = 0;
+    uint32_t freeHeap = 0;
+    uint32_t largestFreeBlock = 0;
+    uint32_t minFreeHeap = 0;
+    // Indexed like MEMORY_TRACKED_TASKS.
+    uint32_t stackHighWater[MEMORY_TRACKED_TASK_COUNT] = {};
+
+    // How much of the free heap is unusable for one allocation, 0-100. A
+    // heap that is free but split into small blocks scores high.
+    [[nodiscard]] uint8_t fragmentationPercent() const {
+        if (freeHeap == 0 || largestFreeBlock >= freeHeap) {
+            return 0;
+        }
+        return static_cast<uint8_t>(100 - static_cast<uint64_t>(largestFreeBlock) * 100 / freeHeap);
+    }
+};
+
+// Keeps the last MEMORY_HISTORY_SIZE memory samples, so a slow leak or
+// creeping fragmentation shows as a trend rather than a single reading.
+// Samples are taken by the main loop and read by the web server, so both go
+// through one lock.
+class MemoryTelemetry {
+public:
+    explicit MemoryTelemetry(IMemoryProbe& probe);
+
+    // Reads the probe, stores the result and returns it.
+    MemorySample sample(uint32_t timestamp);
+
+    using History = std::array<MemorySample, MEMORY_HISTORY_SIZE>;
+
+    [[nodiscard]] size_t size() const;
+    // Copies the samples held into `out`, oldest first, in one consistent
+    // read. Returns how many there are.
+    size_t copyHistory(History& out) const;
+    // An all-zero sample until the first one is taken.
+    [[nodiscard]] MemorySample latest() const;
+
+private:
+    IMemoryProbe& _probe;
+    mutable std::mutex _mutex;
+    History _samples;
+    size_t _next;
+    size_t _count;
+};
+
+#endif // MEMORY_TELEMETRY_H
@@ -0,0 +1,166 @@
+#include "metrics_formatter.h"
+#include "stage_metrics.h"
+#include "concurrency/cooperative_scheduler.h"
+#include "logic/json_writer.h"
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+    const char* const STAGE_METRIC = "hvac_stage_duration_microseconds";
+    constexpr size_t LINE_SIZE = 160;
+
+    MetricStage stageAt(size_t index) {
+        return static_cast<MetricStage>(index);
+    }
+
+    // A copy of the scheduler's tasks taken under its lock: the main loop
+    // keeps running them while a request is served.
+    struct TaskTable {
+        explicit TaskTable(const CooperativeScheduler& scheduler)
+            : count(scheduler.snapshot(tasks, CooperativeScheduler::MAX_TASKS)) {}
+
+        CooperativeScheduler::TaskSnapshot tasks[CooperativeScheduler::MAX_TASKS];
+        size_t count;
+
+        const CooperativeScheduler::TaskSnapshot* begin() const { return tasks; }
+        const CooperativeScheduler::TaskSnapshot* end() const { return tasks + count; }
+    };
+
+    class LineWriter {
+    public:
+        explicit LineWriter(const MetricsFormatter::LineSink& sink) : _sink(sink) {}
+
+        void operator()(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+            va_list args;
+            va_start(args, format);
+            vsnprintf(_line, sizeof(_line), format, args);
+            va_end(args);
+            _sink(_line);
+        }
+
+    private:
+        const MetricsFormatter::LineSink& _sink;
+        char _line[LINE_SIZE];
+    };
+
+    void writeFamily(LineWriter& line, const char* name, const char* type, const char* help) {
+        line("# HELP %s %s\n", name, help);
+        line("# TYPE %s %s\n", name, type);
+    }
+}
+
+size_t MetricsFormatter::buildJson(const StageMetrics& metrics, const CooperativeScheduler* scheduler,
+                                   char* buffer, size_t bufferSize) {
+    JsonWriter writer(buffer, bufferSize);
+    writer.beginObject();
+    writer.member("enabled", static_cast<bool>(STAGE_METRICS_ENABLED));
+
+    writer.key("bucket_bounds_us");
+    writer.beginArray();
+    for (uint32_t bound : STAGE_HISTOGRAM_BOUNDS_US) {
+        writer.value(bound);
+    }
+    writer.endArray();
+
+    writer.key("stages");
+    writer.beginArray();
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        StageStats stats = metrics.snapshot(stageAt(i));
+        writer.beginObject();
+        writer.member("stage", StageMetrics::stageName(stageAt(i)));
+        writer.member("count", stats.count);
+        writer.member("min_us", stats.minUs);
+        writer.member("max_us", stats.maxUs);
+        writer.member("mean_us", stats.meanUs());
+        writer.member("total_us", stats.totalUs);
+        // Per bucket, not cumulative; the last one is everything above the last bound.
+        writer.key("buckets");
+        writer.beginArray();
+        for (uint32_t count : stats.buckets) {
+            writer.value(count);
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+
+    if (scheduler) {
+        writer.key("tasks");
+        writer.beginArray();
+        for (const CooperativeScheduler::TaskSnapshot& task : TaskTable(*scheduler)) {
+            const CooperativeScheduler::TaskStats& stats = task.stats;
+            writer.beginObject();
+            writer.member("task", task.name);
+            writer.member("runs", stats.runs);
+            writer.member("overruns", stats.overruns);
+            writer.member("missed_deadlines", stats.missedDeadlines);
+            writer.member("mean_run_us", stats.meanRunUs());
+            writer.member("max_run_us", stats.maxRunUs);
+            writer.member("max_late_ms", stats.maxLatenessMs);
+            writer.endObject();
+        }
+        writer.endArray();
+    }
+    writer.endObject();
+
+    return writer.overflowed() ? 0 : writer.size();
+}
+
+void MetricsFormatter::writePrometheus(const StageMetrics& metrics, const CooperativeScheduler* scheduler,
+                                       const LineSink& sink) {
+    LineWriter line(sink);
+    StageStats stages[METRIC_STAGE_COUNT];
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        stages[i] = metrics.snapshot(stageAt(i));
+    }
+
+    writeFamily(line, STAGE_METRIC, "histogram", "Time spent in each processing stage.");
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        const char* stage = StageMetrics::stageName(stageAt(i));
+        const StageStats& stats = stages[i];
+        uint32_t cumulative = 0;
+        for (size_t bucket = 0; bucket < STAGE_HISTOGRAM_BOUNDS; bucket++) {
+            cumulative += stats.buckets[bucket];
+            line("%s_bucket{stage=\"%s\",le=\"%" PRIu32 "\"} %" PRIu32 "\n",
+                 STAGE_METRIC, stage, STAGE_HISTOGRAM_BOUNDS_US[bucket], cumulative);
+        }
+        line("%s_bucket{stage=\"%s\",le=\"+Inf\"} %" PRIu32 "\n", STAGE_METRIC, stage, stats.count);
+        line("%s_sum{stage=\"%s\"} %" PRIu64 "\n", STAGE_METRIC, stage, stats.totalUs);
+        line("%s_count{stage=\"%s\"} %" PRIu32 "\n", STAGE_METRIC, stage, stats.count);
+    }
+
+    writeFamily(line, "hvac_stage_duration_min_microseconds", "gauge", "Shortest run of each stage since boot.");
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        line("hvac_stage_duration_min_microseconds{stage=\"%s\"} %" PRIu32 "\n",
+             StageMetrics::stageName(stageAt(i)), stages[i].minUs);
+    }
+    writeFamily(line, "hvac_stage_duration_max_microseconds", "gauge", "Longest run of each stage since boot.");
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        line("hvac_stage_duration_max_microseconds{stage=\"%s\"} %" PRIu32 "\n",
+             StageMetrics::stageName(stageAt(i)), stages[i].maxUs);
+    }
+
+    if (!scheduler) {
+        return;
+    }
+    // The scheduler starts these over at each schedule report, which
+    // Prometheus treats as a counter reset.
+    TaskTable tasks(*scheduler);
+    writeFamily(line, "hvac_task_runs_total", "counter", "Runs of each main loop task.");
+    for (const CooperativeScheduler::TaskSnapshot& task : tasks) {
+        line("hvac_task_runs_total{task=\"%s\"} %" PRIu32 "\n", task.name, task.stats.runs);
+    }
+    writeFamily(line, "hvac_task_overruns_total", "counter", "Runs that took longer than the task's period.");
+    for (const CooperativeScheduler::TaskSnapshot& task : tasks) {
+        line("hvac_task_overruns_total{task=\"%s\"} %" PRIu32 "\n", task.name, task.stats.overruns);
+    }
+    writeFamily(line, "hvac_task_missed_deadlines_total", "counter", "Periodic runs skipped because the task was late.");
+    for (const CooperativeScheduler::TaskSnapshot& task : tasks) {
+        line("hvac_task_missed_deadlines_total{task=\"%s\"} %" PRIu32 "\n", task.name, task.stats.missedDeadlines);
+    }
+    writeFamily(line, "hvac_task_run_max_microseconds", "gauge", "Longest run of each task.");
+    for (const CooperativeScheduler::TaskSnapshot& task : tasks) {
+        line("hvac_task_run_max_microseconds{task=\"%s\"} %" PRIu32 "\n", task.name, task.stats.maxRunUs);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef METRICS_FORMATTER_H
+#define METRICS_FORMATTER_H
+
+#include <cstddef>
+#include <functional>
+
+class StageMetrics;
+class CooperativeScheduler;
+
+// Renders the stage timings, and the main loop's per-task statistics when a
+// scheduler is given, for /api/metrics.
+class MetricsFormatter {
+public:
+    // Receives one NUL-terminated line of text at a time, newline included.
+    using LineSink = std::function<void(const char* line)>;
+
+    // Writes NUL-terminated JSON. Returns the number of bytes written
+    // (excluding the terminator), or 0 if it did not fit in `bufferSize`.
+    static size_t buildJson(const StageMetrics& metrics, const CooperativeScheduler* scheduler,
+                            char* buffer, size_t bufferSize);
+
+    // Writes the Prometheus text exposition format: a histogram per stage
+    // plus min/max gauges, and counters per scheduled task.
+    static void writePrometheus(const StageMetrics& metrics, const CooperativeScheduler* scheduler,
+                                const LineSink& sink);
+};
+
+#endif // METRICS_FORMATTER_H
@@ -0,0 +1,94 @@
+#include "stage_metrics.h"
+#include "adapters/system_clock.h"
+
+// Roughly 1-2.5-5 steps from 100 us, where a quick stage sits, to a second,
+// well past anything that leaves the watchdog fed.
+const uint32_t STAGE_HISTOGRAM_BOUNDS_US[STAGE_HISTOGRAM_BOUNDS] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000
+};
+
+namespace {
+    const char* const STAGE_NAMES[METRIC_STAGE_COUNT] = {
+        "loop",
+        "sensor_read",
+        "current_sampling",
+        "temperature_request",
+        "temperature_read",
+        "alert_check",
+        "aggregation",
+        "mqtt_publish",
+    };
+
+    size_t bucketFor(uint32_t durationUs) {
+        size_t bucket = 0;
+        while (bucket < STAGE_HISTOGRAM_BOUNDS && durationUs > STAGE_HISTOGRAM_BOUNDS_US[bucket]) {
+            bucket++;
+        }
+        return bucket;
+    }
+}
+
+void StageMetrics::record(MetricStage stage, uint32_t durationUs) {
+    size_t index = static_cast<size_t>(stage);
+    if (index >= METRIC_STAGE_COUNT) {
+        return;
+    }
+    size_t bucket = bucketFor(durationUs);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    StageStats& stats = _stages[index];
+    if (stats.count == 0 || durationUs < stats.minUs) {
+        stats.minUs = durationUs;
+    }
+    if (durationUs > stats.maxUs) {
+        stats.maxUs = durationUs;
+    }
+    stats.count++;
+    stats.totalUs += durationUs;
+    stats.buckets[bucket]++;
+}
+
+StageStats StageMetrics::snapshot(MetricStage stage) const {
+    size_t index = static_cast<size_t>(stage);
+    if (index >= METRIC_STAGE_COUNT) {
+        return StageStats();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stages[index];
+}
+
+void StageMetrics::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (StageStats& stats : _stages) {
+        stats = StageStats();
+    }
+}
+
+const char* StageMetrics::stageName(MetricStage stage) {
+    size_t index = static_cast<size_t>(stage);
+    return index < METRIC_STAGE_COUNT ? STAGE_NAMES[index] : "unknown";
+}
+
+StageMetrics& stageMetrics() {
+    static StageMetrics metrics;
+    return metrics;
+}
+
+StageTimer::StageTimer(StageMetrics& metrics, MetricStage stage)
+    : _metrics(metrics),
+      _stage(stage),
+      _startUs(SystemClock().nowUs())
+{}
+
+StageTimer::~StageTimer() {
+    _metrics.record(_stage, SystemClock().nowUs() - _startUs);
+}
+
+StagePartTimer::StagePartTimer(uint32_t& totalUs)
+    : _totalUs(totalUs),
+      _startUs(SystemClock().nowUs())
+{}
+
+StagePartTimer::~StagePartTimer() {
+    _totalUs += SystemClock().nowUs() - _startUs;
+}
@@ -0,0 +1,114 @@
+#ifndef STAGE_METRICS_H
+#define STAGE_METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Stage timers are compiled in unless the build sets
+// -D STAGE_METRICS_ENABLED=0, in which case STAGE_TIMER() expands to nothing.
+// /api/metrics then reports every stage as empty.
+#ifndef STAGE_METRICS_ENABLED
+#define STAGE_METRICS_ENABLED 1
+#endif
+
+// The pieces of work whose duration is recorded. Keep STAGE_NAMES in step.
+enum class MetricStage : uint8_t {
+    LOOP,                // One pass of the main loop's scheduler
+    SENSOR_READ,         // A whole read cycle, less any wait for the temperature conversion
+    CURRENT_SAMPLING,    // The CT sampling window (calcIrms)
+    TEMPERATURE_REQUEST, // Asking the DS18B20s for a conversion
+    TEMPERATURE_READ,    // Reading the converted temperatures off the bus
+    ALERT_CHECK,
+    AGGREGATION,
+    MQTT_PUBLISH,
+    COUNT
+};
+
+constexpr size_t METRIC_STAGE_COUNT = static_cast<size_t>(MetricStage::COUNT);
+
+// Upper bounds of the histogram buckets, in microseconds. One more bucket
+// counts everything above the last bound.
+constexpr size_t STAGE_HISTOGRAM_BOUNDS = 12;
+extern const uint32_t STAGE_HISTOGRAM_BOUNDS_US[STAGE_HISTOGRAM_BOUNDS];
+
+struct StageStats {
+    uint32_t count = 0;
+    uint32_t minUs = 0;
+    uint32_t maxUs = 0;
+    uint64_t totalUs = 0;
+    uint32_t buckets[STAGE_HISTOGRAM_BOUNDS + 1] = {};
+
+    [[nodiscard]] uint32_t meanUs() const {
+        return count > 0 ? static_cast<uint32_t>(totalUs / count) : 0;
+    }
+};
+
+// Duration statistics per stage. Stages are recorded from both the
+// acquisition task and the main loop, and read by the web server, so every
+// access is under one lock; a record is a handful of additions.
+class StageMetrics {
+public:
+    StageMetrics() = default;
+
+    void record(MetricStage stage, uint32_t durationUs);
+    [[nodiscard]] StageStats snapshot(MetricStage stage) const;
+    void reset();
+
+    static const char* stageName(MetricStage stage);
+
+private:
+    mutable std::mutex _mutex;
+    StageStats _stages[METRIC_STAGE_COUNT];
+};
+
+// The instance the STAGE_TIMER() macro records into.
+StageMetrics& stageMetrics();
+
+// Records the time from construction to destruction against `stage`.
+class StageTimer {
+public:
+    StageTimer(StageMetrics& metrics, MetricStage stage);
+    ~StageTimer();
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    StageMetrics& _metrics;
+    MetricStage _stage;
+    uint32_t _startUs;
+};
+
+// Adds the time from construction to destruction to `totalUs`, for a stage
+// whose work is split across calls. Record the total once the work is done.
+class StagePartTimer {
+public:
+    explicit StagePartTimer(uint32_t& totalUs);
+    ~StagePartTimer();
+
+    StagePartTimer(const StagePartTimer&) = delete;
+    StagePartTimer& operator=(const StagePartTimer&) = delete;
+
+private:
+    uint32_t& _totalUs;
+    uint32_t _startUs;
+};
+
+#define STAGE_TIMER_CONCAT_INNER(a, b) a##b
+#define STAGE_TIMER_CONCAT(a, b) STAGE_TIMER_CONCAT_INNER(a, b)
+
+// STAGE_TIMER() times the rest of the enclosing scope. STAGE_PART_TIMER()
+// adds the rest of the scope to `totalUs`, and STAGE_RECORD() records such a
+// total as one run of `stage`.
+#if STAGE_METRICS_ENABLED
+#define STAGE_TIMER(stage) StageTimer STAGE_TIMER_CONCAT(stageTimer_, __LINE__)(stageMetrics(), stage)
+#define STAGE_PART_TIMER(totalUs) StagePartTimer STAGE_TIMER_CONCAT(stagePartTimer_, __LINE__)(totalUs)
+#define STAGE_RECORD(stage, durationUs) stageMetrics().record(stage, durationUs)
+#else
+#define STAGE_TIMER(stage) do {} while (0)
+#define STAGE_PART_TIMER(totalUs) do {} while (0)
+#define STAGE_RECORD(stage, durationUs) do {} while (0)
+#endif
+
+#endif // STAGE_METRICS_H
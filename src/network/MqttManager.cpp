@@ -2,54 +2,102 @@
 #include "state/SystemState.h"
 #include "logging/log_manager.h"
 #include "logic/json_builder.h"
+#include "logic/binary_payload.h"
+#include "metrics/stage_metrics.h"
+#include "metrics/memory_telemetry.h"
 #include "network/IPubSubClient.h"
 #include "secrets.h"
 #include "version.h"
 #include "config.h"
+#include <cstdio>
+#include <cstring>
 
 #ifndef ARDUINO
 #include "mocks/Arduino.h" // For millis() mock in native tests
 #endif
 
-const long MQTT_RECONNECT_INTERVAL = 5000;
+// PubSubClient's packet buffer also holds the fixed header (up to 5 bytes) and
+// the length-prefixed topic.
+const size_t MQTT_PUBLISH_OVERHEAD = 5 + 2;
 
-MqttManager::MqttManager(SystemState& systemState, LogManager& logManager, std::unique_ptr<IPubSubClient> client)
+namespace {
+    const char* const TAG = "MQTT";
+    // Room for a full 256-byte log message plus its envelope and escapes.
+    constexpr size_t LOG_PAYLOAD_SIZE = 448;
+    // A memory sample with every figure at its widest.
+    constexpr size_t TELEMETRY_PAYLOAD_SIZE = 256;
+}
+
+MqttManager::MqttManager(SystemState& systemState, LogManager& logManager, IFileSystem& fileSystem, std::unique_ptr<IPubSubClient> client)
     : _systemState(systemState),
       _logManager(logManager),
       _client(std::move(client)),
-      _lastMqttReconnectAttempt(0) {}
+      _outbox(fileSystem, MQTT_OUTBOX_SPILL_PATH, MQTT_OUTBOX_RAM_CAPACITY, MQTT_OUTBOX_SPILL_CAPACITY),
+      _batchMaxRecords(1),
+      _batchMaxLatencyMs(0),
+      _encoding(MqttPayloadEncoding::JSON),
+      _changeDetector(MQTT_EVENT_TEMP_DEADBAND_C, MQTT_EVENT_CURRENT_DEADBAND_A,
+                      MQTT_EVENT_STATUS_DEBOUNCE_MS, MQTT_EVENT_ANALOG_MIN_INTERVAL_MS),
+      _payloadCapacity(0)
+{
+    setEncoding(MqttPayloadEncoding::JSON);
+    _payload.reset(new char[_payloadCapacity]);
+}
 
 // Define the destructor in the .cpp file where IPubSubClient is a complete type.
 // This ensures the compiler knows the size and destructor of IPubSubClient
 // when destroying the std::unique_ptr.
 MqttManager::~MqttManager() = default;
 
+void MqttManager::begin(uint32_t firstSequence) {
+    _outbox.begin(firstSequence);
+    if (!_outbox.empty()) {
+        LOG_INFO(_logManager, TAG, "%u aggregate(s) waiting to be published.", static_cast<unsigned>(_outbox.size()));
+    }
+}
+
+void MqttManager::setBatching(size_t maxRecords, unsigned long maxLatencyMs) {
+    _batchMaxRecords = maxRecords > 0 ? maxRecords : 1;
+    _batchMaxLatencyMs = maxLatencyMs;
+}
+
+void MqttManager::setEncoding(MqttPayloadEncoding encoding) {
+    _encoding = encoding;
+    const char* suffix = encoding == MqttPayloadEncoding::BINARY ? MQTT_BINARY_TOPIC_SUFFIX : "";
+    snprintf(_topic, sizeof(_topic), "%s%s", AWS_IOT_TOPIC, suffix);
+    snprintf(_eventTopic, sizeof(_eventTopic), "%s%s%s", AWS_IOT_TOPIC, MQTT_EVENT_TOPIC_SUFFIX, suffix);
+    snprintf(_logTopic, sizeof(_logTopic), "%s%s", AWS_IOT_TOPIC, MQTT_LOG_TOPIC_SUFFIX);
+    snprintf(_telemetryTopic, sizeof(_telemetryTopic), "%s%s", AWS_IOT_TOPIC, MQTT_TELEMETRY_TOPIC_SUFFIX);
+    _payloadCapacity = MQTT_BUFFER_SIZE - MQTT_PUBLISH_OVERHEAD - strlen(_topic);
+}
+
 void MqttManager::handleClient() {
     if (!_client) {
         return; // Do nothing if there is no client (e.g., in native tests)
     }
 
-    if (!_client->connected()) {
-        long now = millis();
-        if (now - _lastMqttReconnectAttempt > MQTT_RECONNECT_INTERVAL) {
-            _lastMqttReconnectAttempt = now;
-            _logManager.log("[MQTT] Attempting to connect to AWS IoT...");
-            if (_client->connect(THINGNAME)) {
-                _logManager.log("[MQTT] Connected!");
-            } else {
-                _logManager.log("[MQTT] Connection failed, rc=%d. Retrying in 5 seconds...", _client->state());
-            }
-        }
-    } else {
+    if (_client->connected()) {
         _client->loop();
+        // Send what is due, and catch up on anything queued during an outage
+        // a little per loop so sampling is not starved.
+        sendQueued();
     }
 }
 
-void MqttManager::publishAggregatedData() {
-    if (!_client || !_client->connected()) {
+void MqttManager::reconnect() {
+    if (!_client || _client->connected()) {
         return;
     }
+    LOG_DEBUG(_logManager, TAG, "Attempting to connect to AWS IoT...");
+    if (_client->connect(THINGNAME)) {
+        LOG_INFO(_logManager, TAG, "Connected!");
+    } else {
+        LOG_WARNING(_logManager, TAG, "Connection failed, rc=%d. Retrying in %lu ms...",
+                    _client->state(), MQTT_RECONNECT_INTERVAL_MS);
+    }
+}
 
+void MqttManager::publishAggregatedData() {
     // Get the most recently added aggregated data point.
     size_t latestIndex = (_systemState.getAggregatedBufferIndex() + AGGREGATED_DATA_BUFFER_SIZE - 1) % AGGREGATED_DATA_BUFFER_SIZE;
     const AggregatedHVACData& dataToPublish = _systemState.getAggregatedDataBuffer()[latestIndex];
@@ -59,17 +107,161 @@ void MqttManager::publishAggregatedData() {
         return;
     }
 
-    char payload[512];
-    size_t payload_size = JsonBuilder::buildPayload(dataToPublish, FIRMWARE_VERSION, BUILD_DATE, payload, sizeof(payload));
+    uint32_t sequence = _outbox.enqueue(dataToPublish);
 
-    if (payload_size == 0) {
-        _logManager.log("[MQTT] ERROR: Aggregated JSON serialization failed.");
+    if (!_client || !_client->connected()) {
+        LOG_INFO(_logManager, TAG, "Offline; queued aggregate #%u (%u waiting).",
+             static_cast<unsigned>(sequence), static_cast<unsigned>(_outbox.size()));
+        return;
+    }
+
+    // Send the new aggregate now unless an older backlog is still ahead of it
+    // or it is waiting for its batch to fill.
+    sendQueued();
+}
+
+void MqttManager::publishChanges(const HVACData& data) {
+    uint8_t changes = _changeDetector.check(data);
+    if (changes == 0 || !_client || !_client->connected()) {
+        return;
+    }
+
+    size_t length;
+    if (_encoding == MqttPayloadEncoding::BINARY) {
+        length = BinaryPayload::encodeEvent(data, changes, reinterpret_cast<uint8_t*>(_payload.get()), _payloadCapacity);
+    } else {
+        length = JsonBuilder::buildEventPayload(data, changes, _payload.get(), _payloadCapacity);
+    }
+    // Only what was actually sent becomes the reference for the next change.
+    if (length > 0 && publish(_eventTopic, _payload.get(), length)) {
+        _changeDetector.commit(data);
+    }
+}
+
+void MqttManager::publishLog(LogLevel level, const char* tag, const char* message) {
+    if (!_client || !_client->connected()) {
+        return;
+    }
+    // Not the shared payload buffer: this can be called while a batch is in it.
+    char payload[LOG_PAYLOAD_SIZE];
+    size_t length = JsonBuilder::buildLogPayload(millis(), LogManager::levelName(level), tag, message, payload, sizeof(payload));
+    if (length > 0) {
+        publish(_logTopic, payload, length);
+    }
+}
+
+void MqttManager::publishMemory(const MemorySample& sample) {
+    if (!_client || !_client->connected()) {
         return;
     }
+    char payload[TELEMETRY_PAYLOAD_SIZE];
+    size_t length = JsonBuilder::buildMemoryPayload(sample, payload, sizeof(payload));
+    if (length > 0) {
+        publish(_telemetryTopic, payload, length);
+    }
+}
 
-    if (!_client->publish(AWS_IOT_TOPIC, reinterpret_cast<const uint8_t*>(payload), payload_size)) {
-        _logManager.log("[MQTT] ERROR: Aggregated data publish failed. Message may be too large for MQTT buffer.");
+void MqttManager::sendQueued() {
+    for (size_t sent = 0; sent < MQTT_OUTBOX_DRAIN_PER_LOOP && !_outbox.empty(); sent++) {
+        if (_batchMaxRecords <= 1 && _encoding == MqttPayloadEncoding::JSON) {
+            size_t published = _outbox.drain(1, [this](uint32_t sequence, const AggregatedHVACData& data) {
+                return publishPayload(sequence, data);
+            });
+            if (published == 0) {
+                break;
+            }
+        } else if (!isBatchDue() || !publishBatch()) {
+            break;
+        }
+    }
+}
+
+bool MqttManager::isBatchDue() {
+    if (_outbox.size() >= _batchMaxRecords) {
+        return true;
+    }
+    // Aggregates are stamped with millis() when produced. One restored from
+    // before a reboot looks far in the future, which wraps to "overdue".
+    uint32_t oldestTimestamp = 0;
+    _outbox.peek(1, [&oldestTimestamp](uint32_t, const AggregatedHVACData& data) {
+        oldestTimestamp = data.timestamp;
+        return true;
+    });
+    return static_cast<uint32_t>(millis()) - oldestTimestamp >= _batchMaxLatencyMs;
+}
+
+template <typename Batch>
+size_t MqttManager::fillBatch(Batch& batch) {
+    return _outbox.peek(_batchMaxRecords, [&batch](uint32_t sequence, const AggregatedHVACData& data) {
+        return batch.add(data, sequence);
+    });
+}
+
+bool MqttManager::publishBatch() {
+    size_t consumed;
+    size_t records;
+    size_t length;
+    if (_encoding == MqttPayloadEncoding::BINARY) {
+        BinaryPayload::Batch batch(reinterpret_cast<uint8_t*>(_payload.get()), _payloadCapacity, FIRMWARE_VERSION, BUILD_DATE);
+        consumed = fillBatch(batch);
+        records = batch.count();
+        length = batch.finish();
     } else {
-        _logManager.log("[MQTT] Published aggregated data.");
+        JsonBuilder::AggregatedBatch batch(_payload.get(), _payloadCapacity, FIRMWARE_VERSION, BUILD_DATE);
+        consumed = fillBatch(batch);
+        records = batch.count();
+        length = batch.finish();
     }
-}
\ No newline at end of file
+
+    if (length == 0) {
+        if (consumed == 0) {
+            // Not even one record fits; it never will, so let it go.
+            LOG_ERROR(_logManager, TAG, "Aggregate does not fit in a payload; dropped.");
+            consumed = 1;
+        }
+        _outbox.discard(consumed);
+        return true;
+    }
+
+    if (!publishOrDrop(length)) {
+        return false;
+    }
+    _outbox.discard(consumed);
+    LOG_INFO(_logManager, TAG, "Published batch of %u aggregate(s).", static_cast<unsigned>(records));
+    return true;
+}
+
+bool MqttManager::publishPayload(uint32_t sequence, const AggregatedHVACData& data) {
+    size_t payload_size = JsonBuilder::buildPayload(data, sequence, FIRMWARE_VERSION, BUILD_DATE, _payload.get(), _payloadCapacity);
+
+    if (payload_size == 0) {
+        // Retrying will not make it fit; let it go rather than block the queue.
+        LOG_ERROR(_logManager, TAG, "Aggregated JSON serialization failed.");
+        return true;
+    }
+
+    if (!publishOrDrop(payload_size)) {
+        return false;
+    }
+    LOG_DEBUG(_logManager, TAG, "Published aggregated data #%u.", static_cast<unsigned>(sequence));
+    return true;
+}
+
+// Every message goes out through here, so each publish is timed.
+bool MqttManager::publish(const char* topic, const char* payload, size_t length) {
+    STAGE_TIMER(MetricStage::MQTT_PUBLISH);
+    return _client->publish(topic, reinterpret_cast<const uint8_t*>(payload), length);
+}
+
+// Returns false if the message should stay queued for the next connection.
+bool MqttManager::publishOrDrop(size_t length) {
+    if (publish(_topic, _payload.get(), length)) {
+        return true;
+    }
+    if (!_client->connected()) {
+        return false;
+    }
+    // Still connected, so the message itself was rejected and would be forever.
+    LOG_ERROR(_logManager, TAG, "Aggregated data publish failed. Message may be too large for MQTT buffer.");
+    return true;
+}
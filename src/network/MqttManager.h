@@ -1,26 +1,94 @@
 #ifndef MQTT_MANAGER_H
 #define MQTT_MANAGER_H
 
+#include <cstdint>
 #include <memory> // for std::unique_ptr
+#include "config.h"
+#include "network/MqttOutbox.h"
+#include "logic/change_detector.h"
+#include "logging/log_manager.h"
 
 // Forward declare dependencies
+struct HVACData;
 class SystemState;
-class LogManager;
 class IPubSubClient;
+class IFileSystem;
+struct AggregatedHVACData;
+struct MemorySample;
 
 class MqttManager {
 public:
-    explicit MqttManager(SystemState& systemState, LogManager& logManager, std::unique_ptr<IPubSubClient> client);
+    MqttManager(SystemState& systemState, LogManager& logManager, IFileSystem& fileSystem, std::unique_ptr<IPubSubClient> client);
     ~MqttManager();
 
+    // Restores aggregates left queued before a reboot. Sequence numbers
+    // continue from at least `firstSequence`.
+    void begin(uint32_t firstSequence);
+
+    // While connected, services the client and sends a few queued aggregates
+    // per call until the backlog is gone. Call on every loop pass.
     void handleClient();
+    // Tries to connect if the client is not connected. Call every
+    // MQTT_RECONNECT_INTERVAL_MS.
+    void reconnect();
+    // Queues the latest aggregate and sends it right away if the broker is
+    // reachable; otherwise it waits in the outbox.
     void publishAggregatedData();
 
+    // Sends `data` on the event topic if it differs materially from the last
+    // sample sent there (see ChangeDetector). Events are not queued: one that
+    // cannot be sent is superseded by the next sample.
+    void publishChanges(const HVACData& data);
+
+    // Sends a log line to the log topic. Meant as the LogManager remote sink,
+    // so that LogManager::sendRemote() calls it from the task that owns the
+    // client; lines are not queued while offline.
+    void publishLog(LogLevel level, const char* tag, const char* message);
+
+    // Sends a memory telemetry sample to the telemetry topic. Like log lines,
+    // samples are not queued while offline.
+    void publishMemory(const MemorySample& sample);
+
+    // Packs up to `maxRecords` aggregates into one message, sent once that
+    // many are queued or the oldest has waited `maxLatencyMs`. With
+    // `maxRecords` of 1 (the default) every aggregate is sent on its own.
+    // Aggregates waiting for their batch are already on flash in the outbox,
+    // so a reset while connected loses none of them.
+    void setBatching(size_t maxRecords, unsigned long maxLatencyMs);
+
+    // Selects the wire format (JSON by default). Binary payloads are always
+    // sent through the batch path, even one record at a time.
+    void setEncoding(MqttPayloadEncoding encoding);
+
+    [[nodiscard]] const MqttOutbox& getOutbox() const { return _outbox; }
+
 private:
     SystemState& _systemState;
     LogManager& _logManager;
     std::unique_ptr<IPubSubClient> _client;
-    long _lastMqttReconnectAttempt;
+    MqttOutbox _outbox;
+    size_t _batchMaxRecords;
+    unsigned long _batchMaxLatencyMs;
+    MqttPayloadEncoding _encoding;
+    char _topic[64];
+    char _eventTopic[64];
+    char _logTopic[64];
+    char _telemetryTopic[64];
+    ChangeDetector _changeDetector;
+    // Sized to what fits in the client's packet buffer next to the topic;
+    // allocated once for the shortest topic.
+    std::unique_ptr<char[]> _payload;
+    size_t _payloadCapacity;
+
+    template <typename Batch>
+    size_t fillBatch(Batch& batch);
+
+    void sendQueued();
+    bool isBatchDue();
+    bool publishBatch();
+    bool publishPayload(uint32_t sequence, const AggregatedHVACData& data);
+    bool publishOrDrop(size_t length);
+    bool publish(const char* topic, const char* payload, size_t length);
 };
 
 #endif // MQTT_MANAGER_H
\ No newline at end of file
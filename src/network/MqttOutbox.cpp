@@ -0,0 +1,341 @@
+#include "MqttOutbox.h"
+#include <cstdio>
+#include <cstring>
+#include "fs/IFileSystem.h"
+#include "storage/TimeSeriesLog.h"
+
+MqttOutbox::MqttOutbox(IFileSystem& fs, const char* spillPath, size_t ramCapacity, size_t spillCapacity)
+    : _fs(fs),
+      _spillPath(spillPath),
+      _spillCapacity(spillCapacity),
+      _ram(new Entry[ramCapacity > 0 ? ramCapacity : 1]),
+      _ramCapacity(ramCapacity > 0 ? ramCapacity : 1),
+      _ramHead(0),
+      _ramCount(0),
+      _spillRecords(0),
+      _spillReadIndex(0),
+      _flashOnly(0),
+      _nextSequence(0),
+      _dropped(0)
+{
+    snprintf(_sequencePath, sizeof(_sequencePath), "%s.seq", _spillPath);
+}
+
+void MqttOutbox::begin(uint32_t firstSequence) {
+    _ramHead = 0;
+    _ramCount = 0;
+    _spillRecords = 0;
+    _spillReadIndex = 0;
+    _flashOnly = 0;
+    _nextSequence = firstSequence;
+
+    uint32_t saved;
+    if (loadSequence(saved) && saved > _nextSequence) {
+        _nextSequence = saved;
+    }
+
+    if (!_fs.exists(_spillPath)) {
+        return;
+    }
+    auto file = _fs.open(_spillPath, "r");
+    if (!file || !*file) {
+        return;
+    }
+
+    uint8_t record[TimeSeriesLog::RECORD_SIZE];
+    size_t bytesRead;
+    bool clean = true;
+    while ((bytesRead = file->readBytes(reinterpret_cast<char*>(record), sizeof(record))) == sizeof(record)) {
+        _spillRecords++;
+        uint32_t sequence;
+        AggregatedHVACData data;
+        if (!TimeSeriesLog::decode(record, sequence, data)) {
+            clean = false;
+            _dropped++;
+            continue;
+        }
+        if (sequence + 1 > _nextSequence) {
+            _nextSequence = sequence + 1;
+        }
+    }
+    file->close();
+    _flashOnly = _spillRecords;
+
+    // A torn record would misalign later appends; keep only the valid ones.
+    if (!clean || bytesRead > 0) {
+        compactSpillFile();
+    }
+}
+
+uint32_t MqttOutbox::enqueue(const AggregatedHVACData& data) {
+    Entry entry;
+    entry.sequence = _nextSequence++;
+    entry.data = data;
+    // Saved before the entry can be published, so a reboot never hands this
+    // sequence number out again.
+    saveSequence(_nextSequence);
+
+    if (_ramCount == _ramCapacity) {
+        // The oldest entry in RAM is now only on flash, if it made it there.
+        if (_ram[_ramHead].persisted) {
+            _flashOnly++;
+        } else {
+            _dropped++;
+        }
+        popRam();
+    }
+    entry.persisted = spill(entry);
+    _ram[(_ramHead + _ramCount) % _ramCapacity] = entry;
+    _ramCount++;
+    return entry.sequence;
+}
+
+size_t MqttOutbox::drain(size_t maxMessages, const PublishCallback& publish) {
+    size_t published = 0;
+    size_t consumed = peek(maxMessages, [&](uint32_t sequence, const AggregatedHVACData& data) {
+        if (!publish(sequence, data)) {
+            return false;
+        }
+        published++;
+        return true;
+    });
+    discard(consumed);
+    return published;
+}
+
+size_t MqttOutbox::peek(size_t maxEntries, const VisitCallback& visit) {
+    size_t accepted = 0;
+    size_t consumed = 0;
+
+    // Entries only on flash are always older than the ones in RAM.
+    size_t flashOnly = _flashOnly;
+    if (flashOnly > 0 && maxEntries > 0) {
+        auto file = _fs.open(_spillPath, "r");
+        if (!file || !*file || !file->seek(_spillReadIndex * TimeSeriesLog::RECORD_SIZE)) {
+            // The file is unreadable; nothing left to send from flash.
+            if (file) {
+                file->close();
+            }
+            _dropped += flashOnly;
+            abandonSpillFile();
+        } else {
+            uint8_t record[TimeSeriesLog::RECORD_SIZE];
+            size_t position = 0;
+            bool stopped = false;
+            while (!stopped && accepted < maxEntries && position < flashOnly) {
+                if (file->readBytes(reinterpret_cast<char*>(record), sizeof(record)) != sizeof(record)) {
+                    // Shorter than expected; the rest cannot be sent.
+                    consumed = flashOnly;
+                    break;
+                }
+                position++;
+                uint32_t sequence;
+                AggregatedHVACData data;
+                if (!TimeSeriesLog::decode(record, sequence, data)) {
+                    consumed = position; // Skipped in place
+                    continue;
+                }
+                if (!visit(sequence, data)) {
+                    stopped = true;
+                    break;
+                }
+                accepted++;
+                consumed = position;
+            }
+            file->close();
+
+            if (stopped || consumed < flashOnly) {
+                return consumed;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < _ramCount && accepted < maxEntries; i++) {
+        const Entry& entry = _ram[(_ramHead + i) % _ramCapacity];
+        if (!visit(entry.sequence, entry.data)) {
+            break;
+        }
+        accepted++;
+        consumed++;
+    }
+    return consumed;
+}
+
+void MqttOutbox::discard(size_t count) {
+    size_t fromFlash = count < _flashOnly ? count : _flashOnly;
+    _spillReadIndex += fromFlash;
+    _flashOnly -= fromFlash;
+
+    size_t fromRam = count - fromFlash;
+    for (size_t i = 0; i < fromRam && _ramCount > 0; i++) {
+        if (_ram[_ramHead].persisted) {
+            _spillReadIndex++;
+        }
+        popRam();
+    }
+
+    if (_spillRecords > 0 && spilledCount() == 0) {
+        removeSpillFile();
+    }
+}
+
+bool MqttOutbox::spill(const Entry& entry) {
+    if (_spillCapacity == 0) {
+        return false;
+    }
+    while (spilledCount() >= _spillCapacity && !empty()) {
+        // Full: give up the oldest entry rather than the newest.
+        dropOldest();
+    }
+    if (_spillReadIndex >= _spillCapacity) {
+        compactSpillFile();
+    }
+
+    uint8_t record[TimeSeriesLog::RECORD_SIZE];
+    TimeSeriesLog::encode(entry.sequence, entry.data, record);
+    auto file = _fs.open(_spillPath, "a");
+    bool written = file && *file && file->write(record, sizeof(record)) == sizeof(record);
+    if (file) {
+        file->close();
+    }
+    if (!written) {
+        // Cut off any partial record so later appends stay aligned.
+        compactSpillFile();
+        return false;
+    }
+    _spillRecords++;
+    return true;
+}
+
+void MqttOutbox::dropOldest() {
+    if (_flashOnly > 0) {
+        _spillReadIndex++;
+        _flashOnly--;
+    } else {
+        if (_ram[_ramHead].persisted) {
+            _spillReadIndex++;
+        }
+        popRam();
+    }
+    _dropped++;
+}
+
+void MqttOutbox::popRam() {
+    _ramHead = (_ramHead + 1) % _ramCapacity;
+    _ramCount--;
+}
+
+void MqttOutbox::compactSpillFile() {
+    // Rewrite the live entries to a fresh file, dropping consumed, torn and
+    // corrupt records. Which entries in RAM are still on flash is worked out
+    // again from the records kept.
+    char tempPath[48];
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", _spillPath);
+    for (size_t i = 0; i < _ramCount; i++) {
+        _ram[(_ramHead + i) % _ramCapacity].persisted = false;
+    }
+
+    auto source = _fs.open(_spillPath, "r");
+    auto target = _fs.open(tempPath, "w");
+    size_t kept = 0;
+    size_t flashOnly = 0;
+    if (source && *source && target && *target) {
+        uint8_t record[TimeSeriesLog::RECORD_SIZE];
+        size_t index = 0;
+        while (source->readBytes(reinterpret_cast<char*>(record), sizeof(record)) == sizeof(record)) {
+            uint32_t sequence;
+            AggregatedHVACData data;
+            if (index++ < _spillReadIndex || !TimeSeriesLog::decode(record, sequence, data)) {
+                continue;
+            }
+            if (target->write(record, sizeof(record)) != sizeof(record)) {
+                continue;
+            }
+            kept++;
+            bool inRam = false;
+            for (size_t i = 0; i < _ramCount && !inRam; i++) {
+                Entry& entry = _ram[(_ramHead + i) % _ramCapacity];
+                if (entry.sequence == sequence) {
+                    entry.persisted = true;
+                    inRam = true;
+                }
+            }
+            if (!inRam) {
+                flashOnly++;
+            }
+        }
+    }
+    if (source) {
+        source->close();
+    }
+    if (target) {
+        target->close();
+    }
+
+    _fs.remove(_spillPath);
+    if (kept > 0) {
+        _fs.rename(tempPath, _spillPath);
+    } else {
+        _fs.remove(tempPath);
+    }
+    _spillRecords = kept;
+    _spillReadIndex = 0;
+    _flashOnly = flashOnly;
+}
+
+void MqttOutbox::removeSpillFile() {
+    if (_fs.exists(_spillPath)) {
+        _fs.remove(_spillPath);
+    }
+    _spillRecords = 0;
+    _spillReadIndex = 0;
+}
+
+void MqttOutbox::abandonSpillFile() {
+    // Entries still in RAM stay queued, but only in RAM.
+    for (size_t i = 0; i < _ramCount; i++) {
+        _ram[(_ramHead + i) % _ramCapacity].persisted = false;
+    }
+    _flashOnly = 0;
+    removeSpillFile();
+}
+
+void MqttOutbox::saveSequence(uint32_t nextSequence) {
+    // The number and a CRC over it, so a torn write is not mistaken for a
+    // smaller number.
+    uint8_t record[2 * sizeof(uint32_t)];
+    memcpy(record, &nextSequence, sizeof(nextSequence));
+    uint32_t crc = TimeSeriesLog::crc32(record, sizeof(nextSequence));
+    memcpy(record + sizeof(nextSequence), &crc, sizeof(crc));
+
+    auto file = _fs.open(_sequencePath, "w");
+    if (file && *file) {
+        file->write(record, sizeof(record));
+    }
+    if (file) {
+        file->close();
+    }
+}
+
+bool MqttOutbox::loadSequence(uint32_t& nextSequence) {
+    if (!_fs.exists(_sequencePath)) {
+        return false;
+    }
+    auto file = _fs.open(_sequencePath, "r");
+    if (!file || !*file) {
+        return false;
+    }
+    uint8_t record[2 * sizeof(uint32_t)];
+    size_t bytesRead = file->readBytes(reinterpret_cast<char*>(record), sizeof(record));
+    file->close();
+    if (bytesRead != sizeof(record)) {
+        return false;
+    }
+    uint32_t storedCrc;
+    memcpy(&storedCrc, record + sizeof(uint32_t), sizeof(storedCrc));
+    if (storedCrc != TimeSeriesLog::crc32(record, sizeof(uint32_t))) {
+        return false;
+    }
+    memcpy(&nextSequence, record, sizeof(nextSequence));
+    return true;
+}
@@ -0,0 +1,105 @@
+#ifndef MQTT_OUTBOX_H
+#define MQTT_OUTBOX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "hvac_data.h"
+
+class IFileSystem;
+
+// Bounded store-and-forward queue for aggregates waiting to be published.
+//
+// Every aggregate gets a sequence number when it is queued so the cloud side
+// can drop duplicates. Each entry is written through to a file on `fs` in the
+// TimeSeriesLog record format as it is queued, and the newest `ramCapacity`
+// entries are also kept in RAM so sending them needs no flash reads. The file
+// holds at most `spillCapacity` entries; beyond that the oldest entry is
+// dropped so an outage of any length keeps the most recent data. With a
+// `spillCapacity` of 0 nothing is written and the queue is RAM only.
+//
+// The next sequence number is saved next to the file before an entry can be
+// published, so numbers are never handed out twice, even across a reboot
+// with the queue empty.
+//
+// Entries leave the queue oldest first, and only once the publish callback
+// reports success. Queued entries survive a reboot; entries already sent
+// from a partly drained file may be sent again after one, which the sequence
+// numbers make harmless. An entry whose write failed is held in RAM only and
+// is lost to a reboot or once newer entries push it out of RAM.
+class MqttOutbox {
+public:
+    // Returns true if the entry was handed to the broker.
+    using PublishCallback = std::function<bool(uint32_t sequence, const AggregatedHVACData& data)>;
+    // Returns false to stop visiting; that entry is not counted.
+    using VisitCallback = std::function<bool(uint32_t sequence, const AggregatedHVACData& data)>;
+
+    MqttOutbox(IFileSystem& fs, const char* spillPath, size_t ramCapacity, size_t spillCapacity);
+
+    // Picks up entries queued before a reboot. Sequence numbers continue from
+    // the latest of `firstSequence`, the saved next sequence number and the
+    // entry after the last one on flash.
+    void begin(uint32_t firstSequence);
+
+    // Queues an aggregate and returns the sequence number it was given.
+    uint32_t enqueue(const AggregatedHVACData& data);
+
+    // Publishes up to `maxMessages` entries, oldest first. Stops at the first
+    // failed publish, leaving that entry at the head of the queue. Returns the
+    // number of entries published.
+    size_t drain(size_t maxMessages, const PublishCallback& publish);
+
+    // Two-step removal for callers that send several entries at once: visit
+    // up to `maxEntries` entries oldest first without removing them, then
+    // discard() what was returned once they are safely sent. The return value
+    // counts accepted entries plus any unreadable ones skipped between them.
+    size_t peek(size_t maxEntries, const VisitCallback& visit);
+    void discard(size_t count);
+
+    [[nodiscard]] size_t size() const { return _flashOnly + _ramCount; }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    // Entries on flash, including those also held in RAM.
+    [[nodiscard]] size_t spilledCount() const { return _spillRecords - _spillReadIndex; }
+    [[nodiscard]] uint32_t nextSequence() const { return _nextSequence; }
+    // Entries discarded because the spill file was full or unreadable, or
+    // pushed out of RAM before they could be written.
+    [[nodiscard]] size_t droppedCount() const { return _dropped; }
+
+private:
+    struct Entry {
+        uint32_t sequence;
+        AggregatedHVACData data;
+        bool persisted; // Also in the spill file
+    };
+
+    bool spill(const Entry& entry);
+    void dropOldest();
+    void popRam();
+    void compactSpillFile();
+    void removeSpillFile();
+    void abandonSpillFile();
+    void saveSequence(uint32_t nextSequence);
+    bool loadSequence(uint32_t& nextSequence);
+
+    IFileSystem& _fs;
+    const char* _spillPath;
+    char _sequencePath[48];
+    size_t _spillCapacity;
+
+    std::unique_ptr<Entry[]> _ram;
+    size_t _ramCapacity;
+    size_t _ramHead;  // Oldest entry
+    size_t _ramCount;
+
+    // The spill file holds _spillRecords records; the first _spillReadIndex
+    // of them have been published or dropped. The live ones are _flashOnly
+    // entries no longer in RAM followed by the persisted entries in RAM.
+    size_t _spillRecords;
+    size_t _spillReadIndex;
+    size_t _flashOnly;
+    uint32_t _nextSequence;
+    size_t _dropped;
+};
+
+#endif // MQTT_OUTBOX_H
@@ -4,8 +4,14 @@
 #include "config/config_manager.h"
 #include "config.h"
 #include "logging/log_manager.h"
+#include "logging/log_streamer.h"
 #include "logic/settings_validator.h"
+#include "logic/history_json_streamer.h"
+#include "metrics/stage_metrics.h"
+#include "metrics/metrics_formatter.h"
 #ifdef ARDUINO
+#include <cstdlib>
+#include <memory>
 #include <Esp.h>
 #include <SPIFFS.h>
 #include "version.h"
@@ -13,12 +19,43 @@
 #include <AsyncJson.h>
 #endif
 
+namespace {
+    const char* const TAG = "WEB";
+
+#ifdef ARDUINO
+    // Reads an optional count from the query string into `value`, which is
+    // left as is when the parameter is absent. Returns false unless the
+    // parameter is a plain decimal number; toInt() would let "-1" or "abc"
+    // through as a huge or zero count.
+    bool readCountParam(AsyncWebServerRequest* request, const char* name, size_t& value) {
+        if (!request->hasParam(name)) {
+            return true;
+        }
+        const String& text = request->getParam(name)->value();
+        if (text.length() == 0) {
+            return false;
+        }
+        for (size_t i = 0; i < text.length(); i++) {
+            if (text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+        }
+        value = strtoul(text.c_str(), nullptr, 10); // Saturates rather than wraps
+        return true;
+    }
+#endif
+}
+
 WebServerManager::WebServerManager(SystemState& systemState,
                                    ConfigManager& configManager,
-                                   LogManager& logManager)
+                                   LogManager& logManager,
+                                   const CooperativeScheduler& scheduler,
+                                   const MemoryTelemetry& memoryTelemetry)
     : _systemState(systemState),
       _configManager(configManager),
-      _logManager(logManager)
+      _logManager(logManager),
+      _scheduler(scheduler),
+      _memoryTelemetry(memoryTelemetry)
 #ifdef ARDUINO
       , _server(80)
 #endif
@@ -34,7 +71,7 @@ void WebServerManager::setup() {
     });
 
     _server.begin();
-    _logManager.log("HTTP server started");
+    LOG_INFO(_logManager, TAG, "HTTP server started");
 #endif
 }
 
@@ -49,6 +86,8 @@ void WebServerManager::setupSettingsRoutes() {
         root["lowDeltaTDurationS"] = config.lowDeltaTDurationS;
         root["noAirflowDurationS"] = config.noAirflowDurationS;
         root["tempSensorDisconnectedDurationS"] = config.tempSensorDisconnectedDurationS;
+        root["sensorReadIntervalMs"] = config.sensorReadIntervalMs;
+        root["adcSamplesPerChannel"] = config.adcSamplesPerChannel;
         response->setLength();
         request->send(response);
     });
@@ -77,8 +116,9 @@ void WebServerManager::setupSettingsRoutes() {
 void WebServerManager::setupSystemRoutes() {
 #ifdef ARDUINO
     // Route to trigger a device reboot
-    _server.on("/api/reboot", HTTP_POST, [](AsyncWebServerRequest *request) {
+    _server.on("/api/reboot", HTTP_POST, [this](AsyncWebServerRequest *request) {
         request->send(200, "application/json", "{\"status\":\"ok\", \"message\":\"Rebooting...\"}");
+        _logManager.flush(); // Buffered log lines would be lost on restart
         
         // Add a small delay to ensure the HTTP response is sent before rebooting
         delay(500);
@@ -90,14 +130,34 @@ void WebServerManager::setupSystemRoutes() {
         request->send(200, "application/json", "{\"status\":\"ok\", \"message\":\"Factory reset successful. Rebooting...\"}");
         
         _configManager.remove();
+        _logManager.flush();
         // Add a small delay to ensure the HTTP response is sent before rebooting
         delay(500);
         ESP.restart();
     });
 
-    // Route to get system logs
+    // Route to get system logs, oldest first across both log files.
+    // Query parameters: offset and limit (in lines), or tail for the last N lines;
+    // anything but a non-negative integer is rejected with 400.
     _server.on("/api/logs", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        request->send(200, "text/plain", _logManager.getLogs());
+        size_t offset = 0;
+        size_t limit = LogStreamer::ALL_LINES;
+        size_t tail = 0;
+        if (!readCountParam(request, "offset", offset) || !readCountParam(request, "limit", limit) ||
+            !readCountParam(request, "tail", tail)) {
+            request->send(400, "application/json",
+                          "{\"status\":\"error\", \"message\":\"offset, limit and tail must be non-negative integers.\"}");
+            return;
+        }
+
+        // Read the files through the streamer's small buffer as the socket
+        // drains, rather than loading them into one String.
+        std::shared_ptr<LogStreamer> streamer = _logManager.streamLogs(offset, limit, tail);
+        AsyncWebServerResponse * response = request->beginChunkedResponse("text/plain",
+            [streamer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return streamer->fill(buffer, maxLen);
+            });
+        request->send(response);
     });
 
     // Route to clear system logs
@@ -106,14 +166,34 @@ void WebServerManager::setupSystemRoutes() {
         request->send(200, "application/json", "{\"status\":\"ok\", \"message\":\"Logs cleared.\"}");
     });
 
-    // Route to get device status (uptime, memory)
-    _server.on("/api/status", HTTP_GET, [](AsyncWebServerRequest *request) {
-        AsyncJsonResponse * response = new AsyncJsonResponse();
-        JsonObject root = response->getRoot();
-        root["uptime_ms"] = millis();
-        root["free_heap_bytes"] = ESP.getFreeHeap();
-        response->setLength();
-        request->send(response);
+    // Route to get device status (uptime, memory and its recent history)
+    _server.on("/api/status", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        std::unique_ptr<char[]> buffer(new char[STATUS_JSON_BUFFER_SIZE]);
+        if (JsonBuilder::buildStatusPayload(millis(), ESP.getFreeHeap(), _memoryTelemetry, buffer.get(), STATUS_JSON_BUFFER_SIZE) == 0) {
+            request->send(500, "text/plain", "Payload too large");
+            return;
+        }
+        request->send(200, "application/json", buffer.get());
+    });
+
+    // Route for stage timings and main loop task statistics.
+    // Query parameter: format=prometheus for the Prometheus text format.
+    _server.on("/api/metrics", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        if (request->hasParam("format") && request->getParam("format")->value() == "prometheus") {
+            AsyncResponseStream * response = request->beginResponseStream("text/plain; version=0.0.4");
+            MetricsFormatter::writePrometheus(stageMetrics(), &_scheduler, [response](const char* line) {
+                response->print(line);
+            });
+            request->send(response);
+            return;
+        }
+
+        std::unique_ptr<char[]> buffer(new char[METRICS_JSON_BUFFER_SIZE]);
+        if (MetricsFormatter::buildJson(stageMetrics(), &_scheduler, buffer.get(), METRICS_JSON_BUFFER_SIZE) == 0) {
+            request->send(500, "text/plain", "Payload too large");
+            return;
+        }
+        request->send(200, "application/json", buffer.get());
     });
 #endif
 }
@@ -122,16 +202,41 @@ void WebServerManager::setupApiRoutes() {
 #ifdef ARDUINO
     _server.on("/api/data", HTTP_GET, [this](AsyncWebServerRequest *request) {
         char buffer[512];
-        JsonBuilder::buildPayload(_systemState.getLatestData(), FIRMWARE_VERSION, BUILD_DATE, buffer, sizeof(buffer));
+        if (JsonBuilder::buildPayload(_systemState.getLatestData(), FIRMWARE_VERSION, BUILD_DATE, buffer, sizeof(buffer)) == 0) {
+            request->send(500, "text/plain", "Payload too large");
+            return;
+        }
         request->send(200, "application/json", buffer);
     });
 
     // Route for the historical data buffer
     _server.on("/api/history", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        // Use a dynamic response to handle the larger payload of the history buffer
+        // Stream the samples straight out of the history store as the socket
+        // drains, rather than building the whole array in heap first.
+        auto streamer = std::make_shared<HistoryJsonStreamer>(_systemState.getSampleHistory(), DATA_BUFFER_SIZE);
+        AsyncWebServerResponse * response = request->beginChunkedResponse("application/json",
+            [streamer](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                return streamer->fill(buffer, maxLen);
+            });
+        request->send(response);
+    });
+
+    // Route for a time range of history at the finest resolution still retained.
+    // Query parameters: from, to (millis() since boot) and maxPoints.
+    _server.on("/api/history_range", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        uint32_t from = request->hasParam("from") ? request->getParam("from")->value().toInt() : 0;
+        uint32_t to = request->hasParam("to") ? request->getParam("to")->value().toInt() : UINT32_MAX;
+        size_t maxPoints = request->hasParam("maxPoints") ? request->getParam("maxPoints")->value().toInt() : HISTORY_QUERY_MAX_POINTS;
+        if (maxPoints == 0 || maxPoints > HISTORY_QUERY_MAX_POINTS) {
+            maxPoints = HISTORY_QUERY_MAX_POINTS;
+        }
+
         AsyncJsonResponse * response = new AsyncJsonResponse();
-        JsonArray root = response->getRoot().to<JsonArray>();
-        JsonBuilder::buildHistoryJson(root, _systemState.getDataBuffer(), _systemState.getBufferIndex());
+        JsonObject root = response->getRoot();
+        JsonArray points = root["points"].to<JsonArray>();
+        root["resolutionMs"] = _systemState.queryHistory(from, to, maxPoints, [&points](const AggregatedHVACData& point) {
+            JsonBuilder::addAggregatedHistoryPoint(points, point);
+        });
         response->setLength();
         request->send(response);
     });
@@ -9,12 +9,16 @@
 class SystemState;
 class ConfigManager;
 class LogManager;
+class CooperativeScheduler;
+class MemoryTelemetry;
 
 class WebServerManager {
 public:
     explicit WebServerManager(SystemState& systemState,
                               ConfigManager& configManager,
-                              LogManager& logManager);
+                              LogManager& logManager,
+                              const CooperativeScheduler& scheduler,
+                              const MemoryTelemetry& memoryTelemetry);
 
     void setup();
 
@@ -27,6 +31,8 @@ private:
     SystemState& _systemState;
     ConfigManager& _configManager;
     LogManager& _logManager;
+    const CooperativeScheduler& _scheduler;
+    const MemoryTelemetry& _memoryTelemetry;
 #ifdef ARDUINO
     AsyncWebServer _server;
 #endif
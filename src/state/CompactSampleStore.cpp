@@ -0,0 +1,123 @@
+#include "CompactSampleStore.h"
+#include <cmath>
+
+namespace {
+    // Bit layout of the packed status word.
+    constexpr uint16_t FAN_SHIFT = 0;         // 2 bits: ComponentStatus
+    constexpr uint16_t COMPRESSOR_SHIFT = 2;  // 2 bits: ComponentStatus
+    constexpr uint16_t PUMPS_SHIFT = 4;       // 2 bits: ComponentStatus
+    constexpr uint16_t AIRFLOW_SHIFT = 6;     // 1 bit:  AirflowStatus
+    constexpr uint16_t ALERT_SHIFT = 7;       // 2 bits: AlertStatus
+    constexpr uint16_t TWO_BITS = 0x3;
+    constexpr uint16_t ONE_BIT = 0x1;
+    static_assert(CompactSampleStore::ALERT_STATUS_BITS == (TWO_BITS << ALERT_SHIFT),
+                  "ALERT_STATUS_BITS must match the packed layout");
+    // The store took over the DRAM of the HVACData window it replaced.
+    static_assert(CompactSampleStore::CAPACITY * CompactSampleStore::BYTES_PER_SAMPLE <= DATA_BUFFER_SIZE * sizeof(HVACData),
+                  "SAMPLE_HISTORY_SIZE must fit in the old DATA_BUFFER_SIZE window");
+
+    // The DS18B20 "disconnected" reading, which must survive the round trip exactly.
+    constexpr float DISCONNECTED_TEMP_C = -127.0f;
+
+    int16_t toFixedPoint(double value, float scale) {
+        double scaled = std::round(value * scale);
+        if (scaled > INT16_MAX) {
+            return INT16_MAX;
+        }
+        if (scaled < INT16_MIN) {
+            return INT16_MIN;
+        }
+        return static_cast<int16_t>(scaled);
+    }
+}
+
+CompactSampleStore::CompactSampleStore()
+    : _head(0),
+      _count(0),
+      _totalPushed(0)
+{}
+
+void CompactSampleStore::push(const HVACData& data) {
+    if (!data.isInitialized) {
+        return;
+    }
+
+    _timestamp[_head] = data.timestamp;
+    _returnTemp[_head] = encodeTemp(data.returnTempC);
+    _supplyTemp[_head] = encodeTemp(data.supplyTempC);
+    _fanAmps[_head] = encodeCurrent(data.fanAmps);
+    _compressorAmps[_head] = encodeCurrent(data.compressorAmps);
+    _geoPumpsAmps[_head] = encodeCurrent(data.geoPumpsAmps);
+    _status[_head] = packStatus(data);
+
+    _head = (_head + 1) % CAPACITY;
+    if (_count < CAPACITY) {
+        _count++;
+    }
+    _totalPushed++;
+}
+
+void CompactSampleStore::clear() {
+    _head = 0;
+    _count = 0;
+}
+
+size_t CompactSampleStore::physicalIndex(size_t index) const {
+    // The oldest sample sits at _head once the store has wrapped.
+    return (_head + CAPACITY - _count + index) % CAPACITY;
+}
+
+HVACData CompactSampleStore::at(size_t index) const {
+    return decode(physicalIndex(index));
+}
+
+HVACData CompactSampleStore::decode(size_t idx) const {
+    HVACData data;
+    data.isInitialized = true;
+    data.timestamp = _timestamp[idx];
+    data.returnTempC = decodeTemp(_returnTemp[idx]);
+    data.supplyTempC = decodeTemp(_supplyTemp[idx]);
+    if (data.returnTempC == DISCONNECTED_TEMP_C || data.supplyTempC == DISCONNECTED_TEMP_C) {
+        data.deltaT = 0.0f;
+    } else {
+        data.deltaT = data.returnTempC - data.supplyTempC;
+    }
+    data.fanAmps = decodeCurrent(_fanAmps[idx]);
+    data.compressorAmps = decodeCurrent(_compressorAmps[idx]);
+    data.geoPumpsAmps = decodeCurrent(_geoPumpsAmps[idx]);
+    unpackStatus(_status[idx], data);
+    return data;
+}
+
+int16_t CompactSampleStore::encodeTemp(float tempC) {
+    return toFixedPoint(tempC, TEMP_SCALE);
+}
+
+float CompactSampleStore::decodeTemp(int16_t raw) {
+    return raw / TEMP_SCALE;
+}
+
+int16_t CompactSampleStore::encodeCurrent(double amps) {
+    return toFixedPoint(amps, CURRENT_SCALE);
+}
+
+double CompactSampleStore::decodeCurrent(int16_t raw) {
+    return raw / static_cast<double>(CURRENT_SCALE);
+}
+
+uint16_t CompactSampleStore::packStatus(const HVACData& data) {
+    return static_cast<uint16_t>(
+        (static_cast<uint16_t>(data.fanStatus) << FAN_SHIFT) |
+        (static_cast<uint16_t>(data.compressorStatus) << COMPRESSOR_SHIFT) |
+        (static_cast<uint16_t>(data.geoPumpsStatus) << PUMPS_SHIFT) |
+        (static_cast<uint16_t>(data.airflowStatus) << AIRFLOW_SHIFT) |
+        (static_cast<uint16_t>(data.alertStatus) << ALERT_SHIFT));
+}
+
+void CompactSampleStore::unpackStatus(uint16_t packed, HVACData& data) {
+    data.fanStatus = static_cast<ComponentStatus>((packed >> FAN_SHIFT) & TWO_BITS);
+    data.compressorStatus = static_cast<ComponentStatus>((packed >> COMPRESSOR_SHIFT) & TWO_BITS);
+    data.geoPumpsStatus = static_cast<ComponentStatus>((packed >> PUMPS_SHIFT) & TWO_BITS);
+    data.airflowStatus = static_cast<AirflowStatus>((packed >> AIRFLOW_SHIFT) & ONE_BIT);
+    data.alertStatus = static_cast<AlertStatus>((packed >> ALERT_SHIFT) & TWO_BITS);
+}
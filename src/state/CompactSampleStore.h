@@ -0,0 +1,85 @@
+#ifndef COMPACT_SAMPLE_STORE_H
+#define COMPACT_SAMPLE_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "config.h"
+#include "hvac_data.h"
+
+// Raw sample history in a compact column-major layout. Each sample is stored
+// as its timestamp, fixed-point int16 temperatures and currents and one word
+// of packed status bits: 16 bytes per sample versus ~64 for an HVACData.
+// deltaT is not stored; it is derived from the two temperatures on decode,
+// using the same disconnected-sensor rule as DataManager.
+//
+// Only initialized samples are stored. Index 0 is the oldest sample.
+class CompactSampleStore {
+public:
+    static constexpr size_t CAPACITY = SAMPLE_HISTORY_SIZE;
+    static constexpr size_t BYTES_PER_SAMPLE = sizeof(uint32_t) + 5 * sizeof(int16_t) + sizeof(uint16_t);
+
+    // Resolution of the fixed-point columns. Values outside the int16 range
+    // are clamped (±327.67 °C / A).
+    static constexpr float TEMP_SCALE = 100.0f;     // 0.01 °C
+    static constexpr float CURRENT_SCALE = 100.0f;  // 0.01 A
+
+    CompactSampleStore();
+
+    // Overwrites the oldest sample once the store is full.
+    void push(const HVACData& data);
+    void clear();
+
+    [[nodiscard]] size_t size() const { return _count; }
+    [[nodiscard]] static constexpr size_t capacity() { return CAPACITY; }
+    // Number of samples ever pushed. The sample at `index` has sequence
+    // number totalPushed() - size() + index; clear() does not reset the
+    // count, so a reader can tell which samples were evicted under it.
+    [[nodiscard]] uint32_t totalPushed() const { return _totalPushed; }
+
+    // Decodes the sample at `index`, where 0 is the oldest.
+    [[nodiscard]] HVACData at(size_t index) const;
+    [[nodiscard]] uint32_t timestampAt(size_t index) const { return _timestamp[physicalIndex(index)]; }
+
+    // Calls `fn(const HVACData&)` for the most recent `count` samples, oldest
+    // first, decoding each one on the fly.
+    template <typename Fn>
+    void forEachRecent(size_t count, Fn fn) const {
+        if (count > _count) {
+            count = _count;
+        }
+        // Walk the physical slots directly so the hot loop has no modulo.
+        size_t idx = physicalIndex(_count - count);
+        for (size_t i = 0; i < count; i++) {
+            fn(decode(idx));
+            if (++idx == CAPACITY) {
+                idx = 0;
+            }
+        }
+    }
+
+    static int16_t encodeTemp(float tempC);
+    static float decodeTemp(int16_t raw);
+    static int16_t encodeCurrent(double amps);
+    static double decodeCurrent(int16_t raw);
+    static uint16_t packStatus(const HVACData& data);
+    static void unpackStatus(uint16_t packed, HVACData& data);
+    // The bits of a packed status word that hold the alert status.
+    static constexpr uint16_t ALERT_STATUS_BITS = 0x3 << 7;
+
+private:
+    [[nodiscard]] size_t physicalIndex(size_t index) const;
+    [[nodiscard]] HVACData decode(size_t slot) const;
+
+    uint32_t _timestamp[CAPACITY];
+    int16_t _returnTemp[CAPACITY];
+    int16_t _supplyTemp[CAPACITY];
+    int16_t _fanAmps[CAPACITY];
+    int16_t _compressorAmps[CAPACITY];
+    int16_t _geoPumpsAmps[CAPACITY];
+    uint16_t _status[CAPACITY];
+    size_t _head;  // Next slot to write
+    size_t _count;
+    uint32_t _totalPushed;
+};
+
+#endif // COMPACT_SAMPLE_STORE_H
@@ -0,0 +1,160 @@
+#include "RetentionTiers.h"
+#include "state/CompactSampleStore.h"
+
+namespace {
+    // A raw sample as a rollup of one.
+    AggregatedHVACData toAggregate(const HVACData& sample) {
+        StreamingAggregator single;
+        single.add(sample);
+        AggregatedHVACData point = single.snapshot(sample);
+        point.timestamp = sample.timestamp;
+        return point;
+    }
+
+    // Generic view over either the raw history or a rollup tier.
+    struct Source {
+        const CompactSampleStore* raw;
+        const RollupStore* rollups;
+
+        size_t size() const { return raw ? raw->size() : rollups->size(); }
+        uint32_t timestampAt(size_t i) const { return raw ? raw->timestampAt(i) : rollups->timestampAt(i); }
+        AggregatedHVACData at(size_t i) const { return raw ? toAggregate(raw->at(i)) : rollups->at(i); }
+    };
+}
+
+RetentionTiers::Tier::Tier(const RetentionTierConfig& config)
+    : periodMs(config.periodMs > 0 ? config.periodMs : 1),
+      rollups(config.capacity),
+      open(),
+      lastStatuses(),
+      openPeriod(0),
+      hasOpenPeriod(false)
+{}
+
+RetentionTiers::RetentionTiers(const RetentionTierConfig (&tiers)[RETENTION_TIER_COUNT]) {
+    for (size_t i = 0; i < RETENTION_TIER_COUNT; i++) {
+        _tiers[i].reset(new Tier(tiers[i]));
+    }
+}
+
+const RollupStore& RetentionTiers::getTier(size_t tier) const {
+    return _tiers[tier]->rollups;
+}
+
+unsigned long RetentionTiers::getTierPeriod(size_t tier) const {
+    return _tiers[tier]->periodMs;
+}
+
+void RetentionTiers::addSample(const HVACData& sample) {
+    if (!sample.isInitialized) {
+        return;
+    }
+    addToTier(0, toAggregate(sample), sample.timestamp);
+}
+
+void RetentionTiers::addToTier(size_t index, const AggregatedHVACData& point, uint32_t time) {
+    Tier& tier = *_tiers[index];
+    uint32_t period = time / tier.periodMs;
+
+    if (tier.hasOpenPeriod && period != tier.openPeriod) {
+        AggregatedHVACData rollup = tier.open.snapshot(tier.lastStatuses);
+        rollup.timestamp = (tier.openPeriod + 1) * tier.periodMs;
+        tier.rollups.push(rollup);
+        tier.open.reset();
+
+        if (index + 1 < RETENTION_TIER_COUNT) {
+            // Place the rollup in the coarser tier by the last instant it covers.
+            addToTier(index + 1, rollup, rollup.timestamp - 1);
+        }
+    }
+
+    tier.open.merge(point);
+    tier.lastStatuses.fanStatus = point.lastFanStatus;
+    tier.lastStatuses.compressorStatus = point.lastCompressorStatus;
+    tier.lastStatuses.geoPumpsStatus = point.lastGeoPumpsStatus;
+    tier.openPeriod = period;
+    tier.hasOpenPeriod = true;
+}
+
+unsigned long RetentionTiers::query(const CompactSampleStore& raw, uint32_t from, uint32_t to, size_t maxPoints,
+                                    const PointCallback& emit) const {
+    // Candidate sources from finest to coarsest.
+    Source sources[RETENTION_TIER_COUNT + 1];
+    unsigned long periods[RETENTION_TIER_COUNT + 1];
+    sources[0] = {&raw, nullptr};
+    periods[0] = 0;
+    for (size_t i = 0; i < RETENTION_TIER_COUNT; i++) {
+        sources[i + 1] = {nullptr, &_tiers[i]->rollups};
+        periods[i + 1] = _tiers[i]->periodMs;
+    }
+
+    size_t chosen = RETENTION_TIER_COUNT + 1;
+    size_t fallback = RETENTION_TIER_COUNT + 1;
+    for (size_t i = 0; i <= RETENTION_TIER_COUNT; i++) {
+        if (sources[i].size() == 0) {
+            continue;
+        }
+        fallback = i;
+        if (sources[i].timestampAt(0) <= from) {
+            chosen = i;
+            break;
+        }
+    }
+    if (chosen > RETENTION_TIER_COUNT) {
+        chosen = fallback;
+    }
+    if (chosen > RETENTION_TIER_COUNT) {
+        return 0; // No data anywhere
+    }
+
+    const Source& source = sources[chosen];
+    size_t inRange = 0;
+    for (size_t i = 0; i < source.size(); i++) {
+        uint32_t ts = source.timestampAt(i);
+        if (ts >= from && ts <= to) {
+            inRange++;
+        }
+    }
+
+    // Merge consecutive points so no more than maxPoints are emitted.
+    size_t groupSize = 1;
+    if (maxPoints > 0 && inRange > maxPoints) {
+        groupSize = (inRange + maxPoints - 1) / maxPoints;
+    }
+
+    StreamingAggregator group;
+    HVACData groupStatuses;
+    uint32_t groupTimestamp = 0;
+    size_t groupCount = 0;
+    for (size_t i = 0; i < source.size(); i++) {
+        uint32_t ts = source.timestampAt(i);
+        if (ts < from || ts > to) {
+            continue;
+        }
+        AggregatedHVACData point = source.at(i);
+        if (groupSize == 1) {
+            emit(point);
+            continue;
+        }
+
+        group.merge(point);
+        groupStatuses.fanStatus = point.lastFanStatus;
+        groupStatuses.compressorStatus = point.lastCompressorStatus;
+        groupStatuses.geoPumpsStatus = point.lastGeoPumpsStatus;
+        groupTimestamp = ts;
+        if (++groupCount == groupSize) {
+            AggregatedHVACData merged = group.snapshot(groupStatuses);
+            merged.timestamp = groupTimestamp;
+            emit(merged);
+            group.reset();
+            groupCount = 0;
+        }
+    }
+    if (groupCount > 0) {
+        AggregatedHVACData merged = group.snapshot(groupStatuses);
+        merged.timestamp = groupTimestamp;
+        emit(merged);
+    }
+
+    return periods[chosen];
+}
@@ -0,0 +1,64 @@
+#ifndef RETENTION_TIERS_H
+#define RETENTION_TIERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "config.h"
+#include "hvac_data.h"
+#include "logic/streaming_aggregator.h"
+#include "state/RollupStore.h"
+
+class CompactSampleStore;
+
+// Cascading rollups behind the raw sample history. Raw samples are folded into
+// the finest tier's open period; when a sample arrives for a later period, the
+// open period is closed, stored in that tier's ring and folded into the next
+// coarser tier the same way. Memory is fixed by the per-tier capacities no
+// matter how long the device runs.
+//
+// Rollup timestamps are the end of their period (millis()), so a closed rollup
+// never has timestamp 0.
+class RetentionTiers {
+public:
+    using PointCallback = std::function<void(const AggregatedHVACData&)>;
+
+    explicit RetentionTiers(const RetentionTierConfig (&tiers)[RETENTION_TIER_COUNT]);
+
+    // Uninitialized samples are ignored.
+    void addSample(const HVACData& sample);
+
+    [[nodiscard]] const RollupStore& getTier(size_t tier) const;
+    [[nodiscard]] unsigned long getTierPeriod(size_t tier) const;
+
+    // Emits the points whose timestamps fall in [from, to], oldest first, from
+    // the finest source whose oldest point reaches back to `from`: the raw
+    // history, then each tier in turn. If no source reaches that far, the
+    // coarsest source with any data is used. When more than `maxPoints` points
+    // fall in the range, consecutive points are merged so that at most
+    // `maxPoints` are emitted (0 means no limit). Raw samples are emitted as
+    // single-sample aggregates.
+    //
+    // Returns the period in ms of the chosen source (0 for raw samples).
+    unsigned long query(const CompactSampleStore& raw, uint32_t from, uint32_t to, size_t maxPoints,
+                        const PointCallback& emit) const;
+
+private:
+    struct Tier {
+        unsigned long periodMs;
+        RollupStore rollups;
+        StreamingAggregator open; // The period currently being accumulated
+        HVACData lastStatuses;
+        uint32_t openPeriod;
+        bool hasOpenPeriod;
+
+        explicit Tier(const RetentionTierConfig& config);
+    };
+
+    void addToTier(size_t tier, const AggregatedHVACData& point, uint32_t time);
+
+    std::unique_ptr<Tier> _tiers[RETENTION_TIER_COUNT];
+};
+
+#endif // RETENTION_TIERS_H
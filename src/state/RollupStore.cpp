@@ -0,0 +1,114 @@
+#include "RollupStore.h"
+#include "state/CompactSampleStore.h" // For the fixed-point encoders
+
+namespace {
+    enum Metric { RETURN_TEMP, SUPPLY_TEMP, DELTA_T, FAN_AMPS, COMPRESSOR_AMPS, GEO_PUMPS_AMPS };
+    enum Stat { AVG, MIN, MAX, STDDEV };
+
+    constexpr uint16_t STATUS_BITS = 2;
+    constexpr uint16_t STATUS_MASK = 0x3;
+
+    void packTemp(int16_t (&out)[4], float avg, float min, float max, float stddev) {
+        out[AVG] = CompactSampleStore::encodeTemp(avg);
+        out[MIN] = CompactSampleStore::encodeTemp(min);
+        out[MAX] = CompactSampleStore::encodeTemp(max);
+        out[STDDEV] = CompactSampleStore::encodeTemp(stddev);
+    }
+
+    void packCurrent(int16_t (&out)[4], double avg, double min, double max, double stddev) {
+        out[AVG] = CompactSampleStore::encodeCurrent(avg);
+        out[MIN] = CompactSampleStore::encodeCurrent(min);
+        out[MAX] = CompactSampleStore::encodeCurrent(max);
+        out[STDDEV] = CompactSampleStore::encodeCurrent(stddev);
+    }
+}
+
+RollupStore::RollupStore(size_t capacity)
+    : _rollups(new PackedRollup[capacity > 0 ? capacity : 1]),
+      _capacity(capacity > 0 ? capacity : 1),
+      _head(0),
+      _count(0)
+{}
+
+void RollupStore::push(const AggregatedHVACData& rollup) {
+    _rollups[_head] = pack(rollup);
+
+    _head = (_head + 1) % _capacity;
+    if (_count < _capacity) {
+        _count++;
+    }
+}
+
+RollupStore::PackedRollup RollupStore::pack(const AggregatedHVACData& rollup) {
+    PackedRollup packed;
+    packed.timestamp = rollup.timestamp;
+    packed.durationMs = rollup.durationMs;
+    packed.sampleCount = rollup.sampleCount > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(rollup.sampleCount);
+    packed.lastStatuses = static_cast<uint16_t>(
+        static_cast<uint16_t>(rollup.lastFanStatus) |
+        (static_cast<uint16_t>(rollup.lastCompressorStatus) << STATUS_BITS) |
+        (static_cast<uint16_t>(rollup.lastGeoPumpsStatus) << (2 * STATUS_BITS)));
+
+    packTemp(packed.stats[RETURN_TEMP], rollup.avgReturnTempC, rollup.minReturnTempC, rollup.maxReturnTempC, rollup.stddevReturnTempC);
+    packTemp(packed.stats[SUPPLY_TEMP], rollup.avgSupplyTempC, rollup.minSupplyTempC, rollup.maxSupplyTempC, rollup.stddevSupplyTempC);
+    packTemp(packed.stats[DELTA_T], rollup.avgDeltaT, rollup.minDeltaT, rollup.maxDeltaT, rollup.stddevDeltaT);
+    packCurrent(packed.stats[FAN_AMPS], rollup.avgFanAmps, rollup.minFanAmps, rollup.maxFanAmps, rollup.stddevFanAmps);
+    packCurrent(packed.stats[COMPRESSOR_AMPS], rollup.avgCompressorAmps, rollup.minCompressorAmps, rollup.maxCompressorAmps, rollup.stddevCompressorAmps);
+    packCurrent(packed.stats[GEO_PUMPS_AMPS], rollup.avgGeoPumpsAmps, rollup.minGeoPumpsAmps, rollup.maxGeoPumpsAmps, rollup.stddevGeoPumpsAmps);
+    return packed;
+}
+
+void RollupStore::clear() {
+    _head = 0;
+    _count = 0;
+}
+
+size_t RollupStore::physicalIndex(size_t index) const {
+    return (_head + _capacity - _count + index) % _capacity;
+}
+
+uint32_t RollupStore::timestampAt(size_t index) const {
+    return _rollups[physicalIndex(index)].timestamp;
+}
+
+AggregatedHVACData RollupStore::at(size_t index) const {
+    return unpack(_rollups[physicalIndex(index)]);
+}
+
+AggregatedHVACData RollupStore::unpack(const PackedRollup& packed) {
+    const auto temp = [&](Metric m, Stat s) { return CompactSampleStore::decodeTemp(packed.stats[m][s]); };
+    const auto current = [&](Metric m, Stat s) { return CompactSampleStore::decodeCurrent(packed.stats[m][s]); };
+
+    AggregatedHVACData rollup;
+    rollup.timestamp = packed.timestamp;
+    rollup.durationMs = packed.durationMs;
+    rollup.sampleCount = packed.sampleCount;
+    rollup.avgReturnTempC = temp(RETURN_TEMP, AVG);
+    rollup.minReturnTempC = temp(RETURN_TEMP, MIN);
+    rollup.maxReturnTempC = temp(RETURN_TEMP, MAX);
+    rollup.stddevReturnTempC = temp(RETURN_TEMP, STDDEV);
+    rollup.avgSupplyTempC = temp(SUPPLY_TEMP, AVG);
+    rollup.minSupplyTempC = temp(SUPPLY_TEMP, MIN);
+    rollup.maxSupplyTempC = temp(SUPPLY_TEMP, MAX);
+    rollup.stddevSupplyTempC = temp(SUPPLY_TEMP, STDDEV);
+    rollup.avgDeltaT = temp(DELTA_T, AVG);
+    rollup.minDeltaT = temp(DELTA_T, MIN);
+    rollup.maxDeltaT = temp(DELTA_T, MAX);
+    rollup.stddevDeltaT = temp(DELTA_T, STDDEV);
+    rollup.avgFanAmps = current(FAN_AMPS, AVG);
+    rollup.minFanAmps = current(FAN_AMPS, MIN);
+    rollup.maxFanAmps = current(FAN_AMPS, MAX);
+    rollup.stddevFanAmps = current(FAN_AMPS, STDDEV);
+    rollup.avgCompressorAmps = current(COMPRESSOR_AMPS, AVG);
+    rollup.minCompressorAmps = current(COMPRESSOR_AMPS, MIN);
+    rollup.maxCompressorAmps = current(COMPRESSOR_AMPS, MAX);
+    rollup.stddevCompressorAmps = current(COMPRESSOR_AMPS, STDDEV);
+    rollup.avgGeoPumpsAmps = current(GEO_PUMPS_AMPS, AVG);
+    rollup.minGeoPumpsAmps = current(GEO_PUMPS_AMPS, MIN);
+    rollup.maxGeoPumpsAmps = current(GEO_PUMPS_AMPS, MAX);
+    rollup.stddevGeoPumpsAmps = current(GEO_PUMPS_AMPS, STDDEV);
+    rollup.lastFanStatus = static_cast<ComponentStatus>(packed.lastStatuses & STATUS_MASK);
+    rollup.lastCompressorStatus = static_cast<ComponentStatus>((packed.lastStatuses >> STATUS_BITS) & STATUS_MASK);
+    rollup.lastGeoPumpsStatus = static_cast<ComponentStatus>((packed.lastStatuses >> (2 * STATUS_BITS)) & STATUS_MASK);
+    return rollup;
+}
@@ -0,0 +1,55 @@
+#ifndef ROLLUP_STORE_H
+#define ROLLUP_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "hvac_data.h"
+
+// Ring of aggregated rollups for one retention tier. Each rollup is packed to
+// 60 bytes (fixed-point statistics in the same units as CompactSampleStore)
+// instead of the ~170 bytes of an AggregatedHVACData. The capacity is set at
+// construction; the storage is allocated once and never resized.
+class RollupStore {
+public:
+    // avg, min, max, stddev for each metric, in HVACData field order.
+    static constexpr size_t METRIC_COUNT = 6;
+    static constexpr size_t STATS_PER_METRIC = 4;
+
+    // Fixed 60-byte encoding of an AggregatedHVACData, also used on flash.
+    struct PackedRollup {
+        uint32_t timestamp;
+        uint32_t durationMs;
+        uint16_t sampleCount; // Saturates at 65535
+        uint16_t lastStatuses;
+        int16_t stats[METRIC_COUNT][STATS_PER_METRIC];
+    };
+
+    static PackedRollup pack(const AggregatedHVACData& rollup);
+    static AggregatedHVACData unpack(const PackedRollup& packed);
+
+    explicit RollupStore(size_t capacity);
+
+    // Overwrites the oldest rollup once the store is full.
+    void push(const AggregatedHVACData& rollup);
+    void clear();
+
+    [[nodiscard]] size_t size() const { return _count; }
+    [[nodiscard]] size_t capacity() const { return _capacity; }
+
+    // Decodes the rollup at `index`, where 0 is the oldest.
+    [[nodiscard]] AggregatedHVACData at(size_t index) const;
+    [[nodiscard]] uint32_t timestampAt(size_t index) const;
+
+private:
+    [[nodiscard]] size_t physicalIndex(size_t index) const;
+
+    std::unique_ptr<PackedRollup[]> _rollups;
+    size_t _capacity;
+    size_t _head; // Next slot to write
+    size_t _count;
+};
+
+static_assert(sizeof(RollupStore::PackedRollup) == 60, "PackedRollup must stay 60 bytes with no padding");
+
+#endif // ROLLUP_STORE_H
@@ -1,36 +1,55 @@
 #include "SystemState.h"
+#include "metrics/stage_metrics.h"
 
 SystemState::SystemState()
-    : _dataBufferIndex(0),
-      _aggregatedDataBufferIndex(0)
+    : _aggregatedDataBufferIndex(0),
+      _retentionTiers(RETENTION_TIERS)
 {}
 
 HVACData& SystemState::getLatestData() {
     return _hvacData;
 }
 
-const std::array<HVACData, DATA_BUFFER_SIZE>& SystemState::getDataBuffer() const {
-    return _dataBuffer;
-}
-
 const std::array<AggregatedHVACData, AGGREGATED_DATA_BUFFER_SIZE>& SystemState::getAggregatedDataBuffer() const {
     return _aggregatedDataBuffer;
 }
 
-size_t SystemState::getBufferIndex() const {
-    return _dataBufferIndex;
-}
-
 size_t SystemState::getAggregatedBufferIndex() const {
     return _aggregatedDataBufferIndex;
 }
 
+const CompactSampleStore& SystemState::getSampleHistory() const {
+    return _sampleHistory;
+}
+
+const RetentionTiers& SystemState::getRetentionTiers() const {
+    return _retentionTiers;
+}
+
+unsigned long SystemState::queryHistory(uint32_t from, uint32_t to, size_t maxPoints,
+                                        const RetentionTiers::PointCallback& emit) const {
+    return _retentionTiers.query(_sampleHistory, from, to, maxPoints, emit);
+}
+
 void SystemState::recordLatestData() {
-    _dataBuffer[_dataBufferIndex] = _hvacData;
-    _dataBufferIndex = (_dataBufferIndex + 1) % DATA_BUFFER_SIZE;
+    _aggregator.add(_hvacData);
+    _sampleHistory.push(_hvacData);
+    _alertEvaluator.onSamplePushed(_sampleHistory);
+    _retentionTiers.addSample(_hvacData);
 }
 
 void SystemState::addAggregatedData(const AggregatedHVACData& data) {
     _aggregatedDataBuffer[_aggregatedDataBufferIndex] = data;
     _aggregatedDataBufferIndex = (_aggregatedDataBufferIndex + 1) % AGGREGATED_DATA_BUFFER_SIZE;
+}
+
+AggregatedHVACData SystemState::takeAggregate() {
+    AggregatedHVACData aggregate = _aggregator.snapshot(_hvacData);
+    _aggregator.reset();
+    return aggregate;
+}
+
+AlertStatus SystemState::evaluateAlerts(const AppConfig& config) {
+    STAGE_TIMER(MetricStage::ALERT_CHECK);
+    return _alertEvaluator.evaluate(_sampleHistory, config);
 }
\ No newline at end of file
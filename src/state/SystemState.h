@@ -3,6 +3,10 @@
 
 #include "hvac_data.h"
 #include "config.h"
+#include "logic/alert_evaluator.h"
+#include "logic/streaming_aggregator.h"
+#include "state/CompactSampleStore.h"
+#include "state/RetentionTiers.h"
 #include <array>
 
 class SystemState {
@@ -11,21 +15,37 @@ public:
 
     // Methods to access data
     [[nodiscard]] HVACData& getLatestData();
-    [[nodiscard]] const std::array<HVACData, DATA_BUFFER_SIZE>& getDataBuffer() const;
     [[nodiscard]] const std::array<AggregatedHVACData, AGGREGATED_DATA_BUFFER_SIZE>& getAggregatedDataBuffer() const;
-    [[nodiscard]] size_t getBufferIndex() const;
     [[nodiscard]] size_t getAggregatedBufferIndex() const;
+    [[nodiscard]] const CompactSampleStore& getSampleHistory() const;
+    [[nodiscard]] const RetentionTiers& getRetentionTiers() const;
+
+    // Emits history points in [from, to] (millis()) from the finest tier that
+    // covers the range, merged down to at most `maxPoints`. Returns the
+    // resolution of the chosen tier in ms (0 for raw samples).
+    unsigned long queryHistory(uint32_t from, uint32_t to, size_t maxPoints,
+                               const RetentionTiers::PointCallback& emit) const;
 
     // Methods to modify state
     void recordLatestData();
     void addAggregatedData(const AggregatedHVACData& data);
 
+    // Statistics for every sample recorded since the previous call, which
+    // starts a new aggregation period. The timestamp is left for the caller.
+    [[nodiscard]] AggregatedHVACData takeAggregate();
+
+    // Alert status over the last AlertManager::windowMs(config) of history.
+    // Constant time per call unless the alert settings changed since the last.
+    [[nodiscard]] AlertStatus evaluateAlerts(const AppConfig& config);
+
 private:
     HVACData _hvacData;
-    std::array<HVACData, DATA_BUFFER_SIZE> _dataBuffer;
-    size_t _dataBufferIndex;
     std::array<AggregatedHVACData, AGGREGATED_DATA_BUFFER_SIZE> _aggregatedDataBuffer;
     size_t _aggregatedDataBufferIndex;
+    AlertEvaluator _alertEvaluator;
+    StreamingAggregator _aggregator;
+    CompactSampleStore _sampleHistory;
+    RetentionTiers _retentionTiers;
 };
 
 #endif // SYSTEM_STATE_H
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "TimeSeriesLog.h"
+#include "fs/IFileSystem.h"
+#include <cstdio>
+#include <cstring>
+
+TimeSeriesLog::TimeSeriesLog(IFileSystem& fs, const char* basePath, size_t segmentCount,
+                             size_t recordsPerSegment, size_t pageSize)
+    : _fs(fs),
+      _basePath(basePath),
+      _segmentCount(segmentCount < 2 ? 2 : (segmentCount > MAX_SEGMENTS ? MAX_SEGMENTS : segmentCount)),
+      _recordsPerSegment(recordsPerSegment > 0 ? recordsPerSegment : 1),
+      _recordsPerPage(pageSize / RECORD_SIZE),
+      _segments(),
+      _currentSlot(0),
+      _nextSequence(0),
+      _corruptRecords(0),
+      _pendingRecords(0) {
+    if (_recordsPerPage == 0) {
+        _recordsPerPage = 1;
+    }
+    if (_recordsPerPage > MAX_RECORDS_PER_PAGE) {
+        _recordsPerPage = MAX_RECORDS_PER_PAGE;
+    }
+}
+
+void TimeSeriesLog::segmentPath(size_t slot, char* path, size_t pathSize) const {
+    snprintf(path, pathSize, "%s_%u.bin", _basePath, static_cast<unsigned>(slot));
+}
+
+uint32_t TimeSeriesLog::crc32(const uint8_t* data, size_t length) {
+    // Standard reflected CRC-32 (IEEE 802.3), bitwise to avoid a 1 KB table.
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+void TimeSeriesLog::encode(uint32_t sequence, const AggregatedHVACData& data, uint8_t* out) {
+    // Records are written in the device's native byte order.
+    RollupStore::PackedRollup packed = RollupStore::pack(data);
+    memcpy(out, &sequence, sizeof(sequence));
+    memcpy(out + sizeof(sequence), &packed, sizeof(packed));
+    uint32_t crc = crc32(out, sizeof(sequence) + sizeof(packed));
+    memcpy(out + sizeof(sequence) + sizeof(packed), &crc, sizeof(crc));
+}
+
+bool TimeSeriesLog::decode(const uint8_t* in, uint32_t& sequence, AggregatedHVACData& data) {
+    RollupStore::PackedRollup packed;
+    uint32_t storedCrc;
+    memcpy(&storedCrc, in + sizeof(sequence) + sizeof(packed), sizeof(storedCrc));
+    if (crc32(in, sizeof(sequence) + sizeof(packed)) != storedCrc) {
+        return false;
+    }
+    memcpy(&sequence, in, sizeof(sequence));
+    memcpy(&packed, in + sizeof(sequence), sizeof(packed));
+    data = RollupStore::unpack(packed);
+    return true;
+}
+
+TimeSeriesLog::SegmentInfo TimeSeriesLog::scanSegment(size_t slot, size_t* corrupt) const {
+    SegmentInfo info = {};
+    info.clean = true;
+
+    char path[32];
+    segmentPath(slot, path, sizeof(path));
+    if (!_fs.exists(path)) {
+        return info;
+    }
+    auto file = _fs.open(path, "r");
+    if (!file || !*file) {
+        return info;
+    }
+    info.present = true;
+
+    uint8_t record[RECORD_SIZE];
+    size_t bytesRead;
+    while ((bytesRead = file->readBytes(reinterpret_cast<char*>(record), RECORD_SIZE)) == RECORD_SIZE) {
+        info.records++;
+        uint32_t sequence;
+        AggregatedHVACData data;
+        if (!decode(record, sequence, data)) {
+            info.clean = false;
+            if (corrupt) {
+                (*corrupt)++;
+            }
+            continue;
+        }
+        if (info.validRecords == 0) {
+            info.firstSequence = sequence;
+        }
+        info.lastSequence = sequence;
+        info.validRecords++;
+    }
+    if (bytesRead > 0) {
+        // A record cut short by a reset during the write.
+        info.clean = false;
+        if (corrupt) {
+            (*corrupt)++;
+        }
+    }
+    file->close();
+    return info;
+}
+
+void TimeSeriesLog::begin() {
+    _corruptRecords = 0;
+    _pendingRecords = 0;
+
+    bool found = false;
+    uint32_t lastSequence = 0;
+    for (size_t slot = 0; slot < _segmentCount; slot++) {
+        _segments[slot] = scanSegment(slot, &_corruptRecords);
+        const SegmentInfo& info = _segments[slot];
+        if (info.validRecords > 0 && (!found || info.lastSequence > lastSequence)) {
+            found = true;
+            lastSequence = info.lastSequence;
+            _currentSlot = slot;
+        }
+    }
+
+    if (!found) {
+        _nextSequence = 0;
+        _currentSlot = _segmentCount - 1; // So the first segment used is slot 0
+        startNewSegment();
+        return;
+    }
+
+    _nextSequence = lastSequence + 1;
+    const SegmentInfo& current = _segments[_currentSlot];
+    if (!current.clean || current.records >= _recordsPerSegment) {
+        startNewSegment();
+    }
+}
+
+void TimeSeriesLog::startNewSegment() {
+    _currentSlot = (_currentSlot + 1) % _segmentCount;
+    char path[32];
+    segmentPath(_currentSlot, path, sizeof(path));
+    if (_fs.exists(path)) {
+        _fs.remove(path);
+    }
+    _segments[_currentSlot] = SegmentInfo();
+    _segments[_currentSlot].clean = true;
+}
+
+void TimeSeriesLog::append(const AggregatedHVACData& data) {
+    encode(_nextSequence++, data, _page + _pendingRecords * RECORD_SIZE);
+    _pendingRecords++;
+
+    // Flush on a full page, and never let a batch run past the end of a segment.
+    const SegmentInfo& current = _segments[_currentSlot];
+    if (_pendingRecords >= _recordsPerPage || current.records + _pendingRecords >= _recordsPerSegment) {
+        flush();
+    }
+}
+
+bool TimeSeriesLog::flush() {
+    if (_pendingRecords == 0) {
+        return true;
+    }
+
+    char path[32];
+    segmentPath(_currentSlot, path, sizeof(path));
+    auto file = _fs.open(path, "a");
+    if (!file || !*file) {
+        return false;
+    }
+    size_t bytes = _pendingRecords * RECORD_SIZE;
+    size_t written = file->write(_page, bytes);
+    file->close();
+    if (written != bytes) {
+        // Whatever made it out is now misaligned; keep later records clear of it.
+        _pendingRecords = 0;
+        startNewSegment();
+        return false;
+    }
+
+    SegmentInfo& current = _segments[_currentSlot];
+    uint32_t firstPending = _nextSequence - _pendingRecords;
+    if (current.validRecords == 0) {
+        current.firstSequence = firstPending;
+    }
+    current.present = true;
+    current.lastSequence = _nextSequence - 1;
+    current.records += _pendingRecords;
+    current.validRecords += _pendingRecords;
+    _pendingRecords = 0;
+
+    if (current.records >= _recordsPerSegment) {
+        startNewSegment();
+    }
+    return true;
+}
+
+size_t TimeSeriesLog::replay(size_t maxRecords, const RecordCallback& emit) const {
+    // Order the segments holding valid records by their first sequence number.
+    size_t order[MAX_SEGMENTS];
+    size_t used = 0;
+    uint32_t lastOnFlash = 0;
+    for (size_t slot = 0; slot < _segmentCount; slot++) {
+        const SegmentInfo& info = _segments[slot];
+        if (info.validRecords == 0) {
+            continue;
+        }
+        if (used == 0 || info.lastSequence > lastOnFlash) {
+            lastOnFlash = info.lastSequence;
+        }
+        size_t pos = used++;
+        while (pos > 0 && _segments[order[pos - 1]].firstSequence > info.firstSequence) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = slot;
+    }
+    if (used == 0 || maxRecords == 0) {
+        return 0;
+    }
+
+    uint32_t firstWanted = (lastOnFlash + 1 > maxRecords) ? lastOnFlash + 1 - maxRecords : 0;
+    size_t emitted = 0;
+    bool anyEmitted = false;
+    uint32_t lastEmitted = 0;
+    uint8_t record[RECORD_SIZE];
+
+    for (size_t i = 0; i < used; i++) {
+        const SegmentInfo& info = _segments[order[i]];
+        if (info.lastSequence < firstWanted) {
+            continue;
+        }
+        char path[32];
+        segmentPath(order[i], path, sizeof(path));
+        auto file = _fs.open(path, "r");
+        if (!file || !*file) {
+            continue;
+        }
+        while (file->readBytes(reinterpret_cast<char*>(record), RECORD_SIZE) == RECORD_SIZE) {
+            uint32_t sequence;
+            AggregatedHVACData data;
+            if (!decode(record, sequence, data) || sequence < firstWanted) {
+                continue;
+            }
+            if (anyEmitted && sequence <= lastEmitted) {
+                continue;
+            }
+            emit(data);
+            emitted++;
+            anyEmitted = true;
+            lastEmitted = sequence;
+        }
+        file->close();
+    }
+    return emitted;
+}
@@ -0,0 +1,91 @@
+#ifndef TIME_SERIES_LOG_H
+#define TIME_SERIES_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "hvac_data.h"
+#include "state/RollupStore.h"
+
+class IFileSystem;
+
+// Append-only binary log of aggregated data that survives reboots.
+//
+// Records are a fixed RECORD_SIZE bytes: a sequence number, the 60-byte packed
+// rollup and a CRC-32 over both. Appends are buffered in RAM and written a
+// flash page at a time; a reset loses whatever is still buffered, so callers
+// that cannot afford that flush() after each append.
+//
+// The log is split into `segmentCount` files used as a ring; when the current
+// segment holds `recordsPerSegment` records the oldest segment file is
+// replaced.
+//
+// A record torn by a reset mid-write fails its CRC (or is short) and is
+// skipped. The segment it is in is closed, so later appends start record-
+// aligned in a fresh segment.
+class TimeSeriesLog {
+public:
+    static constexpr size_t RECORD_SIZE = sizeof(uint32_t) + sizeof(RollupStore::PackedRollup) + sizeof(uint32_t);
+
+    using RecordCallback = std::function<void(const AggregatedHVACData&)>;
+
+    TimeSeriesLog(IFileSystem& fs, const char* basePath, size_t segmentCount,
+                  size_t recordsPerSegment, size_t pageSize);
+
+    // Scans the existing segments to find where to continue appending.
+    void begin();
+
+    // Buffers a record; writes the buffer out once it fills a page.
+    void append(const AggregatedHVACData& data);
+
+    // Writes any buffered records now. Returns false if the write failed.
+    bool flush();
+
+    // Emits the newest `maxRecords` valid records on flash, oldest first.
+    // Records still buffered in RAM are not included.
+    size_t replay(size_t maxRecords, const RecordCallback& emit) const;
+
+    [[nodiscard]] uint32_t nextSequence() const { return _nextSequence; }
+    [[nodiscard]] size_t pendingRecords() const { return _pendingRecords; }
+    // Records rejected by their CRC or truncated during the last begin().
+    [[nodiscard]] size_t corruptRecordsFound() const { return _corruptRecords; }
+
+    static uint32_t crc32(const uint8_t* data, size_t length);
+
+    // Record codec, shared with other on-flash queues of aggregates.
+    static void encode(uint32_t sequence, const AggregatedHVACData& data, uint8_t* out);
+    static bool decode(const uint8_t* in, uint32_t& sequence, AggregatedHVACData& data);
+
+private:
+    static constexpr size_t MAX_SEGMENTS = 16;
+    static constexpr size_t MAX_RECORDS_PER_PAGE = 8;
+
+    struct SegmentInfo {
+        bool present;
+        uint32_t firstSequence;
+        uint32_t lastSequence;
+        size_t records;      // Whole records in the file, valid or not
+        size_t validRecords;
+        bool clean;          // No torn or corrupt records
+    };
+
+    void segmentPath(size_t slot, char* path, size_t pathSize) const;
+    SegmentInfo scanSegment(size_t slot, size_t* corrupt) const;
+    void startNewSegment();
+
+    IFileSystem& _fs;
+    const char* _basePath;
+    size_t _segmentCount;
+    size_t _recordsPerSegment;
+    size_t _recordsPerPage;
+
+    SegmentInfo _segments[MAX_SEGMENTS];
+    size_t _currentSlot;
+    uint32_t _nextSequence;
+    size_t _corruptRecords;
+
+    uint8_t _page[RECORD_SIZE * MAX_RECORDS_PER_PAGE];
+    size_t _pendingRecords;
+};
+
+#endif // TIME_SERIES_LOG_H
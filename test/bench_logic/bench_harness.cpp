@@ -0,0 +1,70 @@
+#include "bench_harness.h"
+#include "version.h"
+#include <atomic>
+#include <new>
+
+namespace {
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+
+    void* countedMalloc(size_t size) {
+        allocationCount++;
+        allocatedBytes += size;
+        return std::malloc(size ? size : 1);
+    }
+
+    class CountingAllocator : public ArduinoJson::Allocator {
+    public:
+        void* allocate(size_t size) override {
+            return countedMalloc(size);
+        }
+        void deallocate(void* ptr) override {
+            std::free(ptr);
+        }
+        void* reallocate(void* ptr, size_t newSize) override {
+            allocationCount++;
+            allocatedBytes += newSize;
+            return std::realloc(ptr, newSize);
+        }
+    };
+}
+
+void* operator new(size_t size) {
+    if (void* ptr = countedMalloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+AllocationCounts benchAllocations() {
+    return AllocationCounts{allocationCount.load(), allocatedBytes.load()};
+}
+
+ArduinoJson::Allocator& benchAllocator() {
+    static CountingAllocator allocator;
+    return allocator;
+}
+
+void benchReport(const BenchResult& result) {
+    char line[256];
+    snprintf(line, sizeof(line),
+             "{\"name\":\"%s\",\"version\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,\"bytes_per_op\":%.1f}",
+             result.name, FIRMWARE_VERSION, static_cast<unsigned long long>(result.iterations),
+             result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+    printf("BENCH %s\n", line);
+
+    if (const char* path = std::getenv("BENCH_RESULTS")) {
+        if (FILE* file = fopen(path, "a")) {
+            fprintf(file, "%s\n", line);
+            fclose(file);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <ArduinoJson.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// A small benchmark harness for the native_bench environment.
+//
+// Each benchmark is warmed up, then run in batches that double in size until
+// a batch takes at least BENCH_MIN_BATCH_NS, and the figures come from that
+// last batch. Heap use is counted through the global operator new defined in
+// bench_harness.cpp and through benchAllocator(), which benchmarks hand to
+// any JsonDocument they create, since ArduinoJson does not use new.
+//
+// Every result is printed as one line,
+//   BENCH {"name":...,"version":...,"iterations":...,"ns_per_op":...,"allocs_per_op":...,"bytes_per_op":...}
+// and also appended to the file named by the BENCH_RESULTS environment
+// variable, if set, so runs on different commits can be compared.
+
+struct BenchResult {
+    const char* name = nullptr;
+    uint64_t iterations = 0;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+};
+
+struct AllocationCounts {
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+// Allocations made so far through operator new and benchAllocator().
+AllocationCounts benchAllocations();
+
+// For JsonDocuments created inside a benchmark: JsonDocument doc(&benchAllocator()).
+ArduinoJson::Allocator& benchAllocator();
+
+// Prints `result` and appends it to $BENCH_RESULTS.
+void benchReport(const BenchResult& result);
+
+constexpr uint64_t BENCH_WARMUP_ITERATIONS = 100;
+constexpr int64_t BENCH_MIN_BATCH_NS = 200 * 1000 * 1000; // 200 ms
+constexpr uint64_t BENCH_MAX_ITERATIONS = 1ull << 30;
+
+// Runs `op` (a callable taking no arguments) and reports the result.
+template <typename Op>
+BenchResult benchRun(const char* name, Op op) {
+    using Clock = std::chrono::steady_clock;
+    for (uint64_t i = 0; i < BENCH_WARMUP_ITERATIONS; i++) {
+        op();
+    }
+
+    BenchResult result;
+    result.name = name;
+    for (uint64_t iterations = 1; iterations <= BENCH_MAX_ITERATIONS; iterations *= 2) {
+        AllocationCounts before = benchAllocations();
+        auto start = Clock::now();
+        for (uint64_t i = 0; i < iterations; i++) {
+            op();
+        }
+        int64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        AllocationCounts after = benchAllocations();
+
+        result.iterations = iterations;
+        result.nsPerOp = static_cast<double>(elapsedNs) / iterations;
+        result.allocsPerOp = static_cast<double>(after.allocations - before.allocations) / iterations;
+        result.bytesPerOp = static_cast<double>(after.bytes - before.bytes) / iterations;
+        if (elapsedNs >= BENCH_MIN_BATCH_NS) {
+            break;
+        }
+    }
+    benchReport(result);
+    return result;
+}
+
+// Keeps the compiler from discarding a result that is otherwise unused.
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif // BENCH_HARNESS_H
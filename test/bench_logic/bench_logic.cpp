@@ -0,0 +1,231 @@
+#include <unity.h>
+#include "bench_harness.h"
+#include "config.h"
+#include "config/config_manager.h"
+#include "hvac_data.h"
+#include "logic/alert_evaluator.h"
+#include "logic/alert_manager.h"
+#include "logic/data_aggregator.h"
+#include "logic/history_json_streamer.h"
+#include "logic/json_builder.h"
+#include "logic/settings_validator.h"
+#include "logic/streaming_aggregator.h"
+#include "state/CompactSampleStore.h"
+#include "version.h"
+#include <ArduinoJson.h>
+#include <array>
+#include <memory>
+#include <random>
+
+// Benchmarks for the logic layer. Run with `pio test -e native_bench`; the
+// regular native environment skips them. Besides timings, each one asserts
+// the allocation count where the code is meant to allocate nothing.
+
+namespace {
+    // A heat pump cycling through off, fan-only and heating runs with a few
+    // minutes per phase, read at the default interval.
+    class HvacSampleStream {
+    public:
+        explicit HvacSampleStream(unsigned int seed) : _rng(seed) {}
+
+        HVACData next() {
+            if (_phaseRemaining == 0) {
+                _phase = std::uniform_int_distribution<int>(0, 2)(_rng);
+                _phaseRemaining = std::uniform_int_distribution<int>(12, 120)(_rng);
+            }
+            _phaseRemaining--;
+
+            HVACData data;
+            data.isInitialized = true;
+            data.fanStatus = _phase > 0 ? ComponentStatus::ON : ComponentStatus::OFF;
+            data.compressorStatus = _phase == 2 ? ComponentStatus::ON : ComponentStatus::OFF;
+            data.geoPumpsStatus = data.compressorStatus;
+            data.airflowStatus = AirflowStatus::OK;
+            data.fanAmps = _phase > 0 ? 2.0f + noise(0.1f) : noise(0.02f);
+            data.compressorAmps = _phase == 2 ? 11.0f + noise(0.5f) : noise(0.02f);
+            data.geoPumpsAmps = _phase == 2 ? 3.0f + noise(0.1f) : noise(0.02f);
+            data.returnTempC = 21.0f + noise(0.3f);
+            data.supplyTempC = data.returnTempC - (_phase == 2 ? 4.5f + noise(0.5f) : noise(0.2f));
+            data.deltaT = data.returnTempC - data.supplyTempC;
+            _timestamp += SENSOR_READ_INTERVAL_MS;
+            data.timestamp = _timestamp;
+            return data;
+        }
+
+    private:
+        float noise(float amplitude) {
+            return std::uniform_real_distribution<float>(-amplitude, amplitude)(_rng);
+        }
+
+        std::mt19937 _rng;
+        int _phase = 0;
+        int _phaseRemaining = 0;
+        uint32_t _timestamp = 0;
+    };
+
+    AppConfig benchConfig() {
+        AppConfig config;
+        config.lowDeltaTThreshold = 2.0f;
+        config.lowDeltaTDurationS = 300;
+        config.noAirflowDurationS = 60;
+        config.tempSensorDisconnectedDurationS = 30;
+        config.sensorReadIntervalMs = SENSOR_READ_INTERVAL_MS;
+        config.adcSamplesPerChannel = ADC_SAMPLES_PER_CHANNEL;
+        return config;
+    }
+
+    // A full sample history, as on a unit that has been up for a while.
+    std::unique_ptr<CompactSampleStore> fullHistory() {
+        std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+        HvacSampleStream stream(42);
+        for (int i = 0; i < SAMPLE_HISTORY_SIZE; i++) {
+            store->push(stream.next());
+        }
+        return store;
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void bench_checkAlerts_full_window() {
+    std::unique_ptr<CompactSampleStore> store = fullHistory();
+    AppConfig config = benchConfig();
+    size_t window = AlertManager::windowSamples(*store, AlertManager::windowMs(config));
+
+    BenchResult result = benchRun("alert_manager.check_alerts", [&]() {
+        benchKeep(AlertManager::checkAlerts(*store, window, config));
+    });
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, result.allocsPerOp);
+}
+
+void bench_alert_evaluator_per_sample() {
+    std::unique_ptr<CompactSampleStore> store = fullHistory();
+    AppConfig config = benchConfig();
+    AlertEvaluator evaluator;
+    evaluator.rebuild(*store, config.lowDeltaTThreshold, config.sensorReadIntervalMs, AlertManager::windowMs(config));
+    HvacSampleStream stream(7);
+
+    // The path taken on every read: push the sample, then evaluate.
+    BenchResult result = benchRun("alert_evaluator.push_and_evaluate", [&]() {
+        store->push(stream.next());
+        evaluator.onSamplePushed(*store);
+        benchKeep(evaluator.evaluate(*store, config));
+    });
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, result.allocsPerOp);
+}
+
+void bench_data_aggregator() {
+    std::unique_ptr<std::array<HVACData, DATA_BUFFER_SIZE>> buffer(new std::array<HVACData, DATA_BUFFER_SIZE>());
+    HvacSampleStream stream(3);
+    for (HVACData& data : *buffer) {
+        data = stream.next();
+    }
+    HVACData last = buffer->back();
+
+    BenchResult result = benchRun("data_aggregator.aggregate", [&]() {
+        benchKeep(DataAggregator::aggregate(*buffer, last));
+    });
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, result.allocsPerOp);
+}
+
+void bench_streaming_aggregator_add() {
+    std::unique_ptr<std::array<HVACData, DATA_BUFFER_SIZE>> buffer(new std::array<HVACData, DATA_BUFFER_SIZE>());
+    HvacSampleStream stream(3);
+    for (HVACData& data : *buffer) {
+        data = stream.next();
+    }
+    StreamingAggregator aggregator;
+    size_t next = 0;
+
+    // The per-read cost that replaced aggregating the buffer at period end.
+    BenchResult result = benchRun("streaming_aggregator.add", [&]() {
+        aggregator.add((*buffer)[next]);
+        next = (next + 1) % buffer->size();
+    });
+    benchKeep(aggregator.sampleCount());
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, result.allocsPerOp);
+}
+
+void bench_streaming_aggregator_snapshot() {
+    HvacSampleStream stream(3);
+    StreamingAggregator aggregator;
+    HVACData last;
+    for (int i = 0; i < DATA_BUFFER_SIZE; i++) {
+        last = stream.next();
+        aggregator.add(last);
+    }
+
+    BenchResult result = benchRun("streaming_aggregator.snapshot", [&]() {
+        benchKeep(aggregator.snapshot(last));
+    });
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, result.allocsPerOp);
+}
+
+void bench_buildPayload() {
+    HvacSampleStream stream(5);
+    HVACData data = stream.next();
+    char buffer[512];
+
+    BenchResult result = benchRun("json_builder.build_payload", [&]() {
+        benchKeep(JsonBuilder::buildPayload(data, FIRMWARE_VERSION, BUILD_DATE, buffer, sizeof(buffer)));
+    });
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, result.allocsPerOp);
+}
+
+void bench_buildHistoryJson() {
+    std::unique_ptr<CompactSampleStore> store = fullHistory();
+    std::unique_ptr<char[]> output(new char[32768]);
+
+    // Building the document and serializing it, as /api/history once did.
+    benchRun("json_builder.build_history_json", [&]() {
+        JsonDocument doc(&benchAllocator());
+        JsonArray history = doc.to<JsonArray>();
+        JsonBuilder::buildHistoryJson(history, *store, DATA_BUFFER_SIZE);
+        benchKeep(serializeJson(doc, output.get(), 32768));
+    });
+}
+
+void bench_history_streamer() {
+    std::unique_ptr<CompactSampleStore> store = fullHistory();
+    uint8_t chunk[1460]; // One TCP segment, as the web server asks for
+
+    BenchResult result = benchRun("history_json_streamer.fill", [&]() {
+        HistoryJsonStreamer streamer(*store, DATA_BUFFER_SIZE);
+        size_t total = 0;
+        size_t n;
+        while ((n = streamer.fill(chunk, sizeof(chunk))) > 0) {
+            total += n;
+        }
+        benchKeep(total);
+    });
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, result.allocsPerOp);
+}
+
+void bench_settings_validator() {
+    JsonDocument doc;
+    deserializeJson(doc, "{\"lowDeltaTThreshold\":2.5,\"lowDeltaTDurationS\":300,\"noAirflowDurationS\":60,"
+                         "\"tempSensorDisconnectedDurationS\":30,\"sensorReadIntervalMs\":5000,\"adcSamplesPerChannel\":1000}");
+    JsonObject settings = doc.as<JsonObject>();
+
+    BenchResult result = benchRun("settings_validator.validate_and_apply", [&]() {
+        AppConfig config = benchConfig();
+        ValidationResult validation = SettingsValidator::validateAndApply(settings, config);
+        benchKeep(validation.success);
+    });
+    TEST_ASSERT_TRUE(result.iterations > 0);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(bench_checkAlerts_full_window);
+    RUN_TEST(bench_alert_evaluator_per_sample);
+    RUN_TEST(bench_data_aggregator);
+    RUN_TEST(bench_streaming_aggregator_add);
+    RUN_TEST(bench_streaming_aggregator_snapshot);
+    RUN_TEST(bench_buildPayload);
+    RUN_TEST(bench_buildHistoryJson);
+    RUN_TEST(bench_history_streamer);
+    RUN_TEST(bench_settings_validator);
+    return UNITY_END();
+}
@@ -1,11 +1,14 @@
 #include "Arduino.h"
+#include <atomic>
 
-static unsigned long mock_time = 0;
+// Atomic so tests that run a producer task on a std::thread can advance the
+// clock from the test thread.
+static std::atomic<unsigned long> mock_time(0);
 
 unsigned long millis() {
-    return mock_time;
+    return mock_time.load();
 }
 
 void set_mock_millis(unsigned long time) {
-    mock_time = time;
-}
\ No newline at end of file
+    mock_time.store(time);
+}
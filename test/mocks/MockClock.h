@@ -0,0 +1,21 @@
+#ifndef MOCK_CLOCK_H
+#define MOCK_CLOCK_H
+
+#include "interfaces/i_clock.h"
+
+// A clock that only moves when the test moves it. Kept in microseconds so
+// both views stay consistent.
+class MockClock : public IClock {
+public:
+    // Test control
+    uint64_t micros = 0;
+
+    void setMs(uint32_t ms) { micros = static_cast<uint64_t>(ms) * 1000; }
+    void advanceMs(uint32_t ms) { micros += static_cast<uint64_t>(ms) * 1000; }
+    void advanceUs(uint32_t us) { micros += us; }
+
+    [[nodiscard]] uint32_t nowMs() const override { return static_cast<uint32_t>(micros / 1000); }
+    [[nodiscard]] uint32_t nowUs() const override { return static_cast<uint32_t>(micros); }
+};
+
+#endif // MOCK_CLOCK_H
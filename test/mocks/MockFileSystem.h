@@ -2,14 +2,26 @@
 #define MOCK_FILE_SYSTEM_H
 
 #include "fs/IFileSystem.h"
+#include <cstring>
 #include <map>
 #include <string>
 #include <sstream>
 #include <memory>
 
+// Filesystem traffic counters, for tests that measure flash access.
+struct MockFileStats {
+    size_t open_calls = 0;
+    size_t close_calls = 0;
+    size_t bytes_written = 0;
+    size_t exists_calls = 0;
+    size_t remove_calls = 0;
+    size_t rename_calls = 0;
+};
+
 class MockFile : public IFile {
 public:
-    MockFile(std::string& content, const std::string& mode) : _content(content), _mode(mode), _valid(true) {
+    MockFile(std::string& content, const std::string& mode, MockFileStats* stats = nullptr)
+        : _content(content), _mode(mode), _valid(true), _stats(stats) {
         if (_mode == "r" || _mode == "a") {
             _buffer << _content;
         }
@@ -20,12 +32,14 @@ public:
     size_t write(uint8_t c) override {
         if (!_valid || (_mode != "w" && _mode != "a")) return 0;
         _buffer.put(c);
+        countWrite(1);
         return 1;
     }
 
     size_t write(const uint8_t *buf, size_t size) override {
         if (!_valid || (_mode != "w" && _mode != "a")) return 0;
         _buffer.write(reinterpret_cast<const char*>(buf), size);
+        countWrite(size);
         return size;
     }
 
@@ -35,15 +49,34 @@ public:
         return _buffer.gcount();
     }
 
-    void print(const char* content) override { if (_valid && (_mode == "w" || _mode == "a")) _buffer << content; }
-    void println(const char* content) override { if (_valid && (_mode == "w" || _mode == "a")) _buffer << content << "\n"; }
+    void print(const char* content) override {
+        if (_valid && (_mode == "w" || _mode == "a")) {
+            _buffer << content;
+            countWrite(strlen(content));
+        }
+    }
+    void println(const char* content) override {
+        if (_valid && (_mode == "w" || _mode == "a")) {
+            _buffer << content << "\n";
+            countWrite(strlen(content) + 1);
+        }
+    }
     String readString() override { return _buffer.str(); }
+    bool seek(size_t position) override {
+        if (!_valid || position > _content.size()) return false;
+        _buffer.clear();
+        _buffer.seekg(position);
+        return !_buffer.fail();
+    }
     size_t size() override { return _content.size(); }
 
     void close() override {
         if (_valid && (_mode == "w" || _mode == "a")) {
             _content = _buffer.str();
         }
+        if (_valid && _stats) {
+            _stats->close_calls++;
+        }
         _valid = false;
     }
 
@@ -53,7 +86,14 @@ private:
     std::string& _content;
     std::string _mode;
     bool _valid;
+    MockFileStats* _stats;
     std::stringstream _buffer;
+
+    void countWrite(size_t bytes) {
+        if (_stats) {
+            _stats->bytes_written += bytes;
+        }
+    }
 };
 
 class MockFileSystem : public IFileSystem {
@@ -61,10 +101,18 @@ public:
     MockFileSystem() = default;
 
     bool begin() override { return true; }
-    bool exists(const char* path) override { return _fs_data.count(path); }
-    bool remove(const char* path) override { return _fs_data.erase(path); }
+    bool exists(const char* path) override {
+        stats.exists_calls++;
+        return _fs_data.count(path);
+    }
+    bool remove(const char* path) override {
+        stats.remove_calls++;
+        return _fs_data.erase(path);
+    }
     bool rename(const char* pathFrom, const char* pathTo) override {
-        if (!_fs_data.count(pathFrom)) return false;
+        stats.rename_calls++;
+        // Like SPIFFS, refuse to replace an existing file.
+        if (!_fs_data.count(pathFrom) || _fs_data.count(pathTo)) return false;
         _fs_data[pathTo] = _fs_data[pathFrom];
         _fs_data.erase(pathFrom);
         return true;
@@ -72,11 +120,12 @@ public:
 
     std::unique_ptr<IFile> open(const char* path, const char* mode) override {
         std::string smode(mode);
-        if (smode == "r" && !exists(path)) {
+        if (smode == "r" && !_fs_data.count(path)) {
             return nullptr;
         }
+        stats.open_calls++;
         // Ensure the file entry exists so MockFile can get a reference to its content.
-        return std::make_unique<MockFile>(_fs_data[path], smode);
+        return std::make_unique<MockFile>(_fs_data[path], smode, &stats);
     }
 
     // --- Test Helper Methods ---
@@ -90,8 +139,11 @@ public:
 
     void reset() {
         _fs_data.clear();
+        stats = MockFileStats();
     }
 
+    MockFileStats stats;
+
 private:
     std::map<std::string, std::string> _fs_data;
 };
@@ -0,0 +1,25 @@
+#ifndef MOCK_MEMORY_PROBE_H
+#define MOCK_MEMORY_PROBE_H
+
+#include "interfaces/i_memory_probe.h"
+#include <map>
+#include <string>
+
+class MockMemoryProbe : public IMemoryProbe {
+public:
+    // Test control
+    uint32_t free = 0;
+    uint32_t largest = 0;
+    uint32_t minimum = 0;
+    std::map<std::string, uint32_t> stacks; // Tasks not listed do not exist
+
+    uint32_t freeHeap() override { return free; }
+    uint32_t largestFreeBlock() override { return largest; }
+    uint32_t minFreeHeap() override { return minimum; }
+    uint32_t stackHighWater(const char* taskName) override {
+        auto it = stacks.find(taskName);
+        return it == stacks.end() ? 0 : it->second;
+    }
+};
+
+#endif // MOCK_MEMORY_PROBE_H
@@ -18,6 +18,7 @@ public:
     // Test inspection variables
     std::string last_topic;
     std::string last_payload;
+    std::vector<std::string> published_payloads; // Every successful publish, in order
     bool loop_called = false;
     bool connect_called = false;
 
@@ -33,8 +34,14 @@ public:
     };
 
     bool publish(const char* topic, const uint8_t* payload, unsigned int plength) override {
+        if (!_connected) {
+            return false; // Like PubSubClient, nothing is sent without a connection
+        }
         last_topic = topic;
         last_payload = std::string(reinterpret_cast<const char*>(payload), plength);
+        if (publish_retval) {
+            published_payloads.push_back(last_payload);
+        }
         return publish_retval;
     };
 };
@@ -0,0 +1,248 @@
+#include <unity.h>
+#include "acquisition/AcquisitionPipeline.h"
+#include "concurrency/spsc_ring_buffer.h"
+#include "concurrency/thread_task_runner.h"
+#include "DataManager.h"
+#include "hardware/IHardwareManager.h"
+#include "config.h"
+#include "interfaces/i_temperature_sensor.h"
+#include "interfaces/i_current_sensor.h"
+#include "interfaces/i_multi_channel_current_sensor.h"
+#include "mocks/Arduino.h"
+
+// --- Mocks for Dependencies ---
+
+// Every reading is derived from a sequence number that advances once per read
+// cycle. A sample whose fields do not all agree on the same sequence number
+// was torn between two cycles.
+class SequencedTemperatureSensor : public ITemperatureSensor {
+public:
+    int sequence = 0;
+
+    void requestTemperatures() override { sequence++; }
+    void startConversion() override { sequence++; }
+    bool isConversionComplete() override { return true; }
+
+    float getTempC(const DeviceAddress& deviceAddress) override {
+        if (deviceAddress[7] == returnAirSensorAddress[7]) {
+            return static_cast<float>(sequence) + 10.0f;
+        }
+        return static_cast<float>(sequence);
+    }
+};
+
+class SequencedCurrentSampler : public IMultiChannelCurrentSensor {
+public:
+    explicit SequencedCurrentSampler(const SequencedTemperatureSensor& temps) : _temps(temps) {}
+
+    unsigned int lastSamples = 0;
+
+    void calcIrms(unsigned int samples, double (&irms)[CURRENT_CHANNEL_COUNT]) override {
+        lastSamples = samples;
+        for (size_t ch = 0; ch < CURRENT_CHANNEL_COUNT; ch++) {
+            irms[ch] = _temps.sequence;
+        }
+    }
+
+private:
+    const SequencedTemperatureSensor& _temps;
+};
+
+class UnusedCurrentSensor : public ICurrentSensor {
+public:
+    double calcIrms(unsigned int samples) override { return 0.0; }
+};
+
+class MockHardwareManager : public IHardwareManager {
+public:
+    SequencedTemperatureSensor tempSensor;
+    SequencedCurrentSampler currentSampler{tempSensor};
+    UnusedCurrentSensor unusedSensor;
+
+    void setup() override {}
+
+    ITemperatureSensor& getTempAdapter() override { return tempSensor; }
+    ICurrentSensor& getFanAdapter() override { return unusedSensor; }
+    ICurrentSensor& getCompressorAdapter() override { return unusedSensor; }
+    ICurrentSensor& getPumpsAdapter() override { return unusedSensor; }
+    IMultiChannelCurrentSensor& getCurrentSampler() override { return currentSampler; }
+};
+
+void setUp(void) {
+    set_mock_millis(0);
+}
+
+void tearDown(void) {}
+
+// --- SpscRingBuffer ---
+
+void test_ring_buffer_is_fifo() {
+    SpscRingBuffer<int, 4> ring;
+    TEST_ASSERT_TRUE(ring.empty());
+
+    TEST_ASSERT_TRUE(ring.push(1));
+    TEST_ASSERT_TRUE(ring.push(2));
+    TEST_ASSERT_TRUE(ring.push(3));
+    TEST_ASSERT_EQUAL_UINT(3, ring.size());
+
+    int value = 0;
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_INT(1, value);
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_INT(2, value);
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_INT(3, value);
+    TEST_ASSERT_FALSE(ring.pop(value));
+}
+
+void test_ring_buffer_rejects_push_when_full_and_wraps() {
+    SpscRingBuffer<int, 3> ring;
+    int value = 0;
+
+    // Cycle through the slots several times so the indices wrap.
+    for (int round = 0; round < 5; round++) {
+        TEST_ASSERT_TRUE(ring.push(round * 10 + 1));
+        TEST_ASSERT_TRUE(ring.push(round * 10 + 2));
+        TEST_ASSERT_TRUE(ring.push(round * 10 + 3));
+        TEST_ASSERT_FALSE(ring.push(99)); // Full
+        TEST_ASSERT_EQUAL_UINT(3, ring.size());
+
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL_INT(round * 10 + 1, value);
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL_INT(round * 10 + 3, value);
+        TEST_ASSERT_TRUE(ring.empty());
+    }
+}
+
+// --- AcquisitionPipeline ---
+
+void test_step_publishes_sample_only_when_interval_elapsed() {
+    // Arrange
+    MockHardwareManager hardware;
+    DataManager dataManager(hardware, returnAirSensorAddress, supplyAirSensorAddress);
+    AcquisitionPipeline pipeline(dataManager, 5000, 3, 0.5f);
+    HVACData sample;
+
+    // Act & Assert: nothing is due before the first interval
+    set_mock_millis(4999);
+    pipeline.step();
+    TEST_ASSERT_FALSE(pipeline.popSample(sample));
+
+    set_mock_millis(5000);
+    pipeline.step();
+    TEST_ASSERT_TRUE(pipeline.popSample(sample));
+    TEST_ASSERT_TRUE(sample.isInitialized);
+    TEST_ASSERT_EQUAL_FLOAT(11.0f, sample.returnTempC);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, sample.deltaT);
+    TEST_ASSERT_FALSE(pipeline.popSample(sample));
+
+    // The next read waits for another full interval
+    set_mock_millis(9999);
+    pipeline.step();
+    TEST_ASSERT_FALSE(pipeline.popSample(sample));
+}
+
+void test_setSampling_changes_interval_and_sample_count() {
+    // Arrange
+    MockHardwareManager hardware;
+    DataManager dataManager(hardware, returnAirSensorAddress, supplyAirSensorAddress);
+    AcquisitionPipeline pipeline(dataManager, 5000, 3, 0.5f);
+    HVACData sample;
+
+    set_mock_millis(5000);
+    pipeline.step();
+    TEST_ASSERT_TRUE(pipeline.popSample(sample));
+    TEST_ASSERT_EQUAL_UINT(1, hardware.currentSampler.lastSamples); // 3 split across the channels
+
+    // Act
+    pipeline.setSampling(1000, 150 * CURRENT_CHANNEL_COUNT);
+
+    // Assert: the next read is due a new interval after the last one started
+    set_mock_millis(5999);
+    pipeline.step();
+    TEST_ASSERT_FALSE(pipeline.popSample(sample));
+
+    set_mock_millis(6000);
+    pipeline.step();
+    TEST_ASSERT_TRUE(pipeline.popSample(sample));
+    TEST_ASSERT_EQUAL_UINT(150, hardware.currentSampler.lastSamples);
+}
+
+void test_step_counts_dropped_samples_when_consumer_falls_behind() {
+    // Arrange
+    MockHardwareManager hardware;
+    DataManager dataManager(hardware, returnAirSensorAddress, supplyAirSensorAddress);
+    AcquisitionPipeline pipeline(dataManager, 0, 3, 0.5f);
+
+    // Act
+    for (size_t i = 0; i < AcquisitionPipeline::QUEUE_CAPACITY + 3; i++) {
+        pipeline.step();
+    }
+
+    // Assert: the oldest samples are kept, the overflow is counted
+    TEST_ASSERT_EQUAL_UINT32(3, pipeline.getDroppedSampleCount());
+    HVACData sample;
+    TEST_ASSERT_TRUE(pipeline.popSample(sample));
+    TEST_ASSERT_EQUAL_FLOAT(11.0f, sample.returnTempC);
+}
+
+void test_threaded_pipeline_delivers_untorn_samples_in_order() {
+    // Arrange
+    MockHardwareManager hardware;
+    DataManager dataManager(hardware, returnAirSensorAddress, supplyAirSensorAddress);
+    AcquisitionPipeline pipeline(dataManager, 0, 3, 0.5f); // Read as fast as possible
+    ThreadTaskRunner runner;
+    const unsigned long samplesWanted = 20000;
+
+    // Act
+    TEST_ASSERT_TRUE(pipeline.start(runner, 0));
+    TEST_ASSERT_TRUE(runner.isRunning());
+
+    unsigned long received = 0;
+    int lastSequence = 0;
+    bool ordered = true;
+    bool consistent = true;
+    auto check = [&](const HVACData& sample) {
+        int sequence = static_cast<int>(sample.supplyTempC);
+        ordered = ordered && sequence > lastSequence;
+        consistent = consistent &&
+                     sample.returnTempC == sample.supplyTempC + 10.0f &&
+                     sample.deltaT == 10.0f &&
+                     sample.fanAmps == sequence &&
+                     sample.compressorAmps == sequence &&
+                     sample.geoPumpsAmps == sequence;
+        lastSequence = sequence;
+        received++;
+    };
+
+    HVACData sample;
+    while (received < samplesWanted) {
+        if (pipeline.popSample(sample)) {
+            check(sample);
+        }
+    }
+    runner.stop();
+    while (pipeline.popSample(sample)) {
+        check(sample);
+    }
+
+    // Assert
+    TEST_ASSERT_FALSE(runner.isRunning());
+    TEST_ASSERT_TRUE_MESSAGE(consistent, "A sample mixed fields from different read cycles");
+    TEST_ASSERT_TRUE_MESSAGE(ordered, "Samples arrived out of order");
+    // Every completed read was either delivered or counted as dropped.
+    TEST_ASSERT_EQUAL_UINT32(hardware.tempSensor.sequence, received + pipeline.getDroppedSampleCount());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_buffer_is_fifo);
+    RUN_TEST(test_ring_buffer_rejects_push_when_full_and_wraps);
+    RUN_TEST(test_step_publishes_sample_only_when_interval_elapsed);
+    RUN_TEST(test_setSampling_changes_interval_and_sample_count);
+    RUN_TEST(test_step_counts_dropped_samples_when_consumer_falls_behind);
+    RUN_TEST(test_threaded_pipeline_delivers_untorn_samples_in_order);
+    return UNITY_END();
+}
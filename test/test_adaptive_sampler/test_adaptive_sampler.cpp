@@ -0,0 +1,231 @@
+#include <unity.h>
+#include "config.h"
+#include "config/config_manager.h"
+#include "hvac_data.h"
+#include "logic/alert_manager.h"
+#include "logic/adaptive_sampler.h"
+#include "state/SystemState.h"
+#include <cmath>
+#include <memory>
+
+namespace {
+    constexpr unsigned long IDLE_MS = 30000;
+    constexpr uint32_t SETTLE_MS = 120000;
+    constexpr unsigned long ACTIVE_MS = 5000;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+HVACData idle_sample(uint32_t timestamp) {
+    HVACData data;
+    data.isInitialized = true;
+    data.timestamp = timestamp;
+    data.fanStatus = ComponentStatus::OFF;
+    data.compressorStatus = ComponentStatus::OFF;
+    data.geoPumpsStatus = ComponentStatus::OFF;
+    data.airflowStatus = AirflowStatus::OK;
+    data.returnTempC = 20.0f;
+    data.supplyTempC = 20.0f;
+    data.deltaT = 0.0f;
+    return data;
+}
+
+void test_slows_down_only_after_settling() {
+    AdaptiveSampler sampler(IDLE_MS, SETTLE_MS);
+    TEST_ASSERT_EQUAL_UINT32(ACTIVE_MS, sampler.readIntervalMs(ACTIVE_MS));
+
+    uint32_t t = 0;
+    for (; t < SETTLE_MS; t += ACTIVE_MS) {
+        TEST_ASSERT_FALSE(sampler.update(idle_sample(t)));
+        TEST_ASSERT_FALSE(sampler.isIdle());
+    }
+    TEST_ASSERT_TRUE(sampler.update(idle_sample(t)));
+    TEST_ASSERT_TRUE(sampler.isIdle());
+    TEST_ASSERT_EQUAL_UINT32(IDLE_MS, sampler.readIntervalMs(ACTIVE_MS));
+
+    // Staying idle is not a change.
+    TEST_ASSERT_FALSE(sampler.update(idle_sample(t + IDLE_MS)));
+}
+
+void test_any_activity_resumes_at_once() {
+    HVACData fanOn = idle_sample(0);
+    fanOn.fanStatus = ComponentStatus::ON;
+    HVACData alert = idle_sample(0);
+    alert.alertStatus = AlertStatus::TEMP_SENSOR_DISCONNECTED;
+    HVACData airflow = idle_sample(0);
+    airflow.airflowStatus = AirflowStatus::NA; // A status change with everything off
+    const HVACData triggers[] = {fanOn, alert, airflow};
+
+    for (const HVACData& trigger : triggers) {
+        AdaptiveSampler sampler(IDLE_MS, SETTLE_MS);
+        uint32_t t = 0;
+        for (; t <= SETTLE_MS; t += ACTIVE_MS) {
+            sampler.update(idle_sample(t));
+        }
+        TEST_ASSERT_TRUE(sampler.isIdle());
+
+        HVACData sample = trigger;
+        sample.timestamp = t;
+        TEST_ASSERT_TRUE(sampler.update(sample));
+        TEST_ASSERT_FALSE(sampler.isIdle());
+        TEST_ASSERT_EQUAL_UINT32(ACTIVE_MS, sampler.readIntervalMs(ACTIVE_MS));
+
+        // Back to quiet, it waits the full settling time again.
+        t += ACTIVE_MS;
+        sampler.update(idle_sample(t));
+        TEST_ASSERT_FALSE(sampler.update(idle_sample(t + SETTLE_MS - 1)));
+        TEST_ASSERT_TRUE(sampler.update(idle_sample(t + SETTLE_MS)));
+    }
+}
+
+void test_disconnected_probe_resumes_the_active_rate() {
+    AdaptiveSampler sampler(IDLE_MS, SETTLE_MS);
+    uint32_t t = 0;
+    for (; t <= SETTLE_MS; t += ACTIVE_MS) {
+        sampler.update(idle_sample(t));
+    }
+    TEST_ASSERT_TRUE(sampler.isIdle());
+
+    // Not yet disconnected long enough to alert, but alerts need reads at the
+    // active rate to confirm it.
+    HVACData probe = idle_sample(t);
+    probe.supplyTempC = -127.0f;
+    TEST_ASSERT_TRUE(sampler.update(probe));
+    TEST_ASSERT_EQUAL_UINT32(ACTIVE_MS, sampler.readIntervalMs(ACTIVE_MS));
+    TEST_ASSERT_FALSE(sampler.update(idle_sample(t + SETTLE_MS - 1)));
+    TEST_ASSERT_TRUE(sampler.update(idle_sample(t + SETTLE_MS)));
+}
+
+void test_idle_interval_is_never_faster_than_the_configured_one() {
+    AdaptiveSampler sampler(IDLE_MS, 0);
+    sampler.update(idle_sample(0));
+    sampler.update(idle_sample(ACTIVE_MS));
+    TEST_ASSERT_TRUE(sampler.isIdle());
+    TEST_ASSERT_EQUAL_UINT32(IDLE_MS, sampler.readIntervalMs(ACTIVE_MS));
+    TEST_ASSERT_EQUAL_UINT32(60000, sampler.readIntervalMs(60000));
+
+    // Uninitialized samples change nothing.
+    TEST_ASSERT_FALSE(sampler.update(HVACData()));
+    TEST_ASSERT_TRUE(sampler.isIdle());
+}
+
+// --- Simulation ---
+
+// Two hours: off, a 15-minute cooling run, off, 10 minutes of the fan running
+// with no airflow, off.
+constexpr uint32_t MINUTE = 60000;
+constexpr uint32_t RUN_START = 30 * MINUTE;
+constexpr uint32_t RUN_END = 45 * MINUTE;
+constexpr uint32_t FAULT_START = 75 * MINUTE;
+constexpr uint32_t FAULT_END = 85 * MINUTE;
+constexpr uint32_t SIMULATION_END = 120 * MINUTE;
+
+HVACData profile(uint32_t t) {
+    HVACData data = idle_sample(t);
+    if (t >= RUN_START && t < RUN_END) {
+        data.fanStatus = ComponentStatus::ON;
+        data.compressorStatus = ComponentStatus::ON;
+        data.geoPumpsStatus = ComponentStatus::ON;
+        data.returnTempC = 30.0f;
+        data.supplyTempC = 22.0f;
+        data.deltaT = 8.0f;
+    } else if (t >= FAULT_START && t < FAULT_END) {
+        data.fanStatus = ComponentStatus::ON;
+        data.airflowStatus = AirflowStatus::NA;
+    }
+    return data;
+}
+
+struct SimulationResult {
+    int samples = 0;
+    int runSamples = 0;
+    int idleReads = 0;
+    long firstAlertAt = -1;
+    long lastAlertAt = -1;
+    AggregatedHVACData aggregate;
+};
+
+// Reads on the sampler's schedule the way Application does: store the sample,
+// evaluate alerts, then let the sampler see the result.
+SimulationResult simulate(const AppConfig& config) {
+    std::unique_ptr<SystemState> state(new SystemState());
+    AdaptiveSampler sampler(IDLE_SENSOR_READ_INTERVAL_MS, IDLE_SETTLE_MS);
+    SimulationResult result;
+
+    uint32_t t = 0;
+    while (t < SIMULATION_END) {
+        state->getLatestData() = profile(t);
+        state->recordLatestData();
+        HVACData& latest = state->getLatestData();
+        latest.alertStatus = state->evaluateAlerts(config);
+        sampler.update(latest);
+
+        result.samples++;
+        if (t >= RUN_START && t < RUN_END) {
+            result.runSamples++;
+        }
+        if (latest.alertStatus == AlertStatus::FAN_NO_AIRFLOW) {
+            if (result.firstAlertAt < 0) {
+                result.firstAlertAt = t;
+            }
+            result.lastAlertAt = t;
+        } else {
+            TEST_ASSERT_EQUAL(AlertStatus::NONE, latest.alertStatus);
+        }
+        if (sampler.isIdle()) {
+            result.idleReads++;
+        }
+        t += sampler.readIntervalMs(config.sensorReadIntervalMs);
+    }
+    result.aggregate = state->takeAggregate();
+    return result;
+}
+
+void test_simulated_duty_cycle_sample_counts_and_alert_timing() {
+    AppConfig config;
+    config.lowDeltaTThreshold = LOW_DELTA_T_THRESHOLD;
+    config.lowDeltaTDurationS = LOW_DELTA_T_DURATION_S;
+    config.noAirflowDurationS = NO_AIRFLOW_DURATION_S;
+    config.tempSensorDisconnectedDurationS = TEMP_SENSOR_DISCONNECTED_DURATION_S;
+    config.sensorReadIntervalMs = SENSOR_READ_INTERVAL_MS;
+    config.adcSamplesPerChannel = ADC_SAMPLES_PER_CHANNEL;
+
+    SimulationResult result = simulate(config);
+
+    // The run is noticed within one idle interval and then read at full rate.
+    int fullRate = static_cast<int>((RUN_END - RUN_START) / SENSOR_READ_INTERVAL_MS);
+    int missedAtStart = static_cast<int>(IDLE_SENSOR_READ_INTERVAL_MS / SENSOR_READ_INTERVAL_MS);
+    TEST_ASSERT_TRUE(result.runSamples <= fullRate);
+    TEST_ASSERT_TRUE(result.runSamples >= fullRate - missedAtStart);
+
+    // Well under half the reads of a fixed 5 s cadence, most of them idle.
+    int fixedRate = static_cast<int>(SIMULATION_END / SENSOR_READ_INTERVAL_MS);
+    TEST_ASSERT_TRUE(result.samples < fixedRate / 2);
+    TEST_ASSERT_TRUE(result.idleReads > result.samples / 4);
+    TEST_ASSERT_EQUAL_UINT32(result.samples, result.aggregate.sampleCount);
+
+    // The alert is raised after the configured duration, give or take the
+    // idle read that first saw the fault, and clears once the fault has left
+    // the alert window.
+    long due = static_cast<long>(FAULT_START) + static_cast<long>(NO_AIRFLOW_DURATION_S) * 1000;
+    TEST_ASSERT_TRUE(result.firstAlertAt >= due - static_cast<long>(IDLE_SENSOR_READ_INTERVAL_MS));
+    TEST_ASSERT_TRUE(result.firstAlertAt <= due + static_cast<long>(SENSOR_READ_INTERVAL_MS));
+    TEST_ASSERT_TRUE(result.lastAlertAt >= static_cast<long>(FAULT_END));
+    TEST_ASSERT_TRUE(result.lastAlertAt < static_cast<long>(FAULT_END + AlertManager::windowMs(config)));
+
+    // Averages are over time, not over readings: the run is an eighth of the
+    // period however many more reads it got.
+    float timeAverage = (15.0f * 30.0f + 105.0f * 20.0f) / 120.0f;
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, timeAverage, result.aggregate.avgReturnTempC);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_slows_down_only_after_settling);
+    RUN_TEST(test_any_activity_resumes_at_once);
+    RUN_TEST(test_disconnected_probe_resumes_the_active_rate);
+    RUN_TEST(test_idle_interval_is_never_faster_than_the_configured_one);
+    RUN_TEST(test_simulated_duty_cycle_sample_counts_and_alert_timing);
+    return UNITY_END();
+}
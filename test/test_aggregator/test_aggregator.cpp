@@ -1,6 +1,10 @@
 #include <unity.h>
 #include "config.h"
 #include "logic/data_aggregator.h"
+#include "logic/running_stats.h"
+#include "logic/streaming_aggregator.h"
+#include "state/RollupStore.h"
+#include "state/SystemState.h"
 #include "hvac_data.h"
 #include <array>
 
@@ -79,11 +83,149 @@ void test_aggregate_captures_last_known_status() {
     TEST_ASSERT_EQUAL(ComponentStatus::UNKNOWN, result.lastGeoPumpsStatus);
 }
 
+void test_running_stats_computes_mean_min_max_and_stddev() {
+    RunningStats stats;
+    const double values[] = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+    for (double v : values) {
+        stats.add(v);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(8, stats.count());
+    TEST_ASSERT_EQUAL_FLOAT(5.0, stats.mean());
+    TEST_ASSERT_EQUAL_FLOAT(2.0, stats.min());
+    TEST_ASSERT_EQUAL_FLOAT(9.0, stats.max());
+    TEST_ASSERT_EQUAL_FLOAT(2.0, stats.stddev()); // Population standard deviation
+}
+
+void test_running_stats_is_zero_when_empty_or_reset() {
+    RunningStats stats;
+    TEST_ASSERT_EQUAL_FLOAT(0.0, stats.mean());
+    TEST_ASSERT_EQUAL_FLOAT(0.0, stats.stddev());
+
+    stats.add(-3.0);
+    stats.reset();
+
+    TEST_ASSERT_EQUAL_UINT32(0, stats.count());
+    TEST_ASSERT_EQUAL_FLOAT(0.0, stats.min());
+    TEST_ASSERT_EQUAL_FLOAT(0.0, stats.max());
+
+    // A negative first sample after a reset must become both min and max.
+    stats.add(-1.0);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0, stats.min());
+    TEST_ASSERT_EQUAL_FLOAT(-1.0, stats.max());
+}
+
+void test_streaming_aggregator_matches_buffer_averages() {
+    // 1. Arrange
+    std::array<HVACData, DATA_BUFFER_SIZE> buffer;
+    buffer.fill(HVACData());
+    StreamingAggregator aggregator;
+
+    for (int i = 0; i < 10; i++) {
+        HVACData d;
+        d.isInitialized = true;
+        d.returnTempC = 20.0f + i;
+        d.supplyTempC = 15.0f + i * 0.5f;
+        d.deltaT = d.returnTempC - d.supplyTempC;
+        d.fanAmps = 1.0 + i * 0.1;
+        d.compressorAmps = 5.0 - i * 0.2;
+        d.geoPumpsAmps = 2.0;
+        buffer[i] = d;
+        aggregator.add(d);
+    }
+    aggregator.add(HVACData()); // Uninitialized samples are skipped
+
+    // 2. Act
+    AggregatedHVACData expected = DataAggregator::aggregate(buffer, HVACData());
+    AggregatedHVACData result = aggregator.snapshot(HVACData());
+
+    // 3. Assert
+    TEST_ASSERT_EQUAL_UINT32(10, result.sampleCount);
+    TEST_ASSERT_EQUAL_FLOAT(expected.avgReturnTempC, result.avgReturnTempC);
+    TEST_ASSERT_EQUAL_FLOAT(expected.avgSupplyTempC, result.avgSupplyTempC);
+    TEST_ASSERT_EQUAL_FLOAT(expected.avgDeltaT, result.avgDeltaT);
+    TEST_ASSERT_EQUAL_FLOAT(expected.avgFanAmps, result.avgFanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(expected.avgCompressorAmps, result.avgCompressorAmps);
+    TEST_ASSERT_EQUAL_FLOAT(expected.avgGeoPumpsAmps, result.avgGeoPumpsAmps);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, result.minReturnTempC);
+    TEST_ASSERT_EQUAL_FLOAT(29.0f, result.maxReturnTempC);
+    TEST_ASSERT_EQUAL_FLOAT(3.2, result.minCompressorAmps);
+    TEST_ASSERT_EQUAL_FLOAT(0.0, result.stddevGeoPumpsAmps); // Constant signal
+}
+
+void test_merge_weighs_aggregates_by_the_time_they_cover() {
+    // 1. Arrange: an idle minute read every 30 s, then an active minute read
+    // every 5 s, at different fan currents.
+    StreamingAggregator period;
+    HVACData d;
+    d.isInitialized = true;
+    d.timestamp = 0;
+    period.add(d);
+    period.reset();
+    d.fanAmps = 1.0;
+    for (uint32_t t = 30000; t <= 60000; t += 30000) {
+        d.timestamp = t;
+        period.add(d);
+    }
+    AggregatedHVACData idle = period.snapshot(d);
+    period.reset();
+    d.fanAmps = 3.0;
+    for (uint32_t t = 65000; t <= 120000; t += 5000) {
+        d.timestamp = t;
+        period.add(d);
+    }
+    AggregatedHVACData active = period.snapshot(d);
+
+    // 2. Act
+    StreamingAggregator merged;
+    merged.merge(RollupStore::unpack(RollupStore::pack(idle)));
+    merged.merge(active);
+    AggregatedHVACData result = merged.snapshot(d);
+
+    // 3. Assert: equal lengths count equally, however often they were read.
+    TEST_ASSERT_EQUAL_UINT32(2, idle.sampleCount);
+    TEST_ASSERT_EQUAL_UINT32(12, active.sampleCount);
+    TEST_ASSERT_EQUAL_UINT32(60000, idle.durationMs);
+    TEST_ASSERT_EQUAL_UINT32(60000, active.durationMs);
+    TEST_ASSERT_EQUAL_UINT32(14, result.sampleCount);
+    TEST_ASSERT_EQUAL_UINT32(120000, result.durationMs);
+    TEST_ASSERT_EQUAL_FLOAT(2.0, result.avgFanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(1.0, result.stddevFanAmps);
+}
+
+void test_system_state_take_aggregate_starts_new_period() {
+    // 1. Arrange
+    SystemState state;
+    state.getLatestData().isInitialized = true;
+    state.getLatestData().fanAmps = 2.0;
+    state.recordLatestData();
+    state.getLatestData().fanAmps = 4.0;
+    state.getLatestData().fanStatus = ComponentStatus::ON;
+    state.recordLatestData();
+
+    // 2. Act
+    AggregatedHVACData first = state.takeAggregate();
+    AggregatedHVACData second = state.takeAggregate();
+
+    // 3. Assert
+    TEST_ASSERT_EQUAL_UINT32(2, first.sampleCount);
+    TEST_ASSERT_EQUAL_FLOAT(3.0, first.avgFanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(1.0, first.stddevFanAmps);
+    TEST_ASSERT_EQUAL(ComponentStatus::ON, first.lastFanStatus);
+    TEST_ASSERT_EQUAL_UINT32(0, second.sampleCount);
+    TEST_ASSERT_EQUAL_FLOAT(0.0, second.avgFanAmps);
+}
+
 int main(int argc, char **argv) {
     UNITY_BEGIN();
     RUN_TEST(test_aggregate_calculates_averages_correctly);
     RUN_TEST(test_aggregate_handles_partially_filled_buffer);
     RUN_TEST(test_aggregate_handles_empty_buffer);
     RUN_TEST(test_aggregate_captures_last_known_status);
+    RUN_TEST(test_running_stats_computes_mean_min_max_and_stddev);
+    RUN_TEST(test_running_stats_is_zero_when_empty_or_reset);
+    RUN_TEST(test_streaming_aggregator_matches_buffer_averages);
+    RUN_TEST(test_merge_weighs_aggregates_by_the_time_they_cover);
+    RUN_TEST(test_system_state_take_aggregate_starts_new_period);
     return UNITY_END();
 }
\ No newline at end of file
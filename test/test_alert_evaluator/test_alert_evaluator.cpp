@@ -0,0 +1,174 @@
+#include <unity.h>
+#include "config.h"
+#include "logic/alert_manager.h"
+#include "logic/alert_evaluator.h"
+#include "state/SystemState.h"
+#include "hvac_data.h"
+#include "config/config_manager.h"
+#include "state/CompactSampleStore.h"
+#include <memory>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Short durations so that random streams cross every alert threshold.
+AppConfig create_test_config() {
+    AppConfig config;
+    config.lowDeltaTThreshold = 2.0f;
+    config.lowDeltaTDurationS = 75;
+    config.noAirflowDurationS = 100;
+    config.tempSensorDisconnectedDurationS = 150;
+    config.sensorReadIntervalMs = SENSOR_READ_INTERVAL_MS;
+    config.adcSamplesPerChannel = ADC_SAMPLES_PER_CHANNEL;
+    return config;
+}
+
+// Produces samples that stay in one fault regime for a random run length, so
+// the window repeatedly fills up with and drains out of each condition. Reads
+// arrive at the given interval with some jitter.
+class RandomSampleStream {
+public:
+    explicit RandomSampleStream(unsigned int seed) : _rng(seed) {}
+
+    HVACData next(unsigned long intervalMs = SENSOR_READ_INTERVAL_MS) {
+        if (_runRemaining == 0) {
+            _regime = std::uniform_int_distribution<int>(0, 4)(_rng);
+            _runRemaining = std::uniform_int_distribution<int>(1, DATA_BUFFER_SIZE)(_rng);
+        }
+        _runRemaining--;
+
+        HVACData data;
+        data.isInitialized = chance(0.98);
+        data.fanStatus = (_regime == 1 || chance(0.7)) ? ComponentStatus::ON : ComponentStatus::OFF;
+        data.airflowStatus = (_regime == 1 || chance(0.1)) ? AirflowStatus::NA : AirflowStatus::OK;
+        data.compressorStatus = (_regime == 2 || chance(0.5)) ? ComponentStatus::ON : ComponentStatus::OFF;
+        data.returnTempC = (_regime == 3 || chance(0.05)) ? -127.0f : 25.0f;
+        data.supplyTempC = (_regime == 3 && chance(0.5)) ? -127.0f : 20.0f;
+        data.deltaT = std::uniform_real_distribution<float>(_regime == 2 ? 0.0f : 1.0f, 6.0f)(_rng);
+        // deltaT is derived from the temperatures once stored.
+        if (data.returnTempC != -127.0f && data.supplyTempC != -127.0f) {
+            data.supplyTempC = data.returnTempC - data.deltaT;
+        }
+        _timestamp += static_cast<uint32_t>(intervalMs) + std::uniform_int_distribution<uint32_t>(0, 500)(_rng);
+        data.timestamp = _timestamp;
+        return data;
+    }
+
+private:
+    bool chance(double p) { return std::uniform_real_distribution<double>(0.0, 1.0)(_rng) < p; }
+
+    std::mt19937 _rng;
+    int _regime = 0;
+    int _runRemaining = 0;
+    uint32_t _timestamp = 0;
+};
+
+AlertStatus full_scan(const CompactSampleStore& history, const AppConfig& config) {
+    return AlertManager::checkAlerts(history, AlertManager::windowSamples(history, AlertManager::windowMs(config)), config);
+}
+
+void test_evaluator_matches_full_scan_on_random_streams() {
+    const int seeds = 20;
+    // Long enough for the history to wrap.
+    const int samplesPerSeed = CompactSampleStore::CAPACITY + DATA_BUFFER_SIZE * 10;
+    const unsigned long intervals[] = {SENSOR_READ_INTERVAL_MS, 1000, 15000};
+
+    for (int seed = 1; seed <= seeds; seed++) {
+        AppConfig config = create_test_config();
+        std::unique_ptr<SystemState> state(new SystemState());
+        RandomSampleStream stream(seed);
+        int alertsSeen = 0;
+
+        for (int i = 0; i < samplesPerSeed; i++) {
+            // Change the threshold now and then to exercise the rebuild path.
+            if (i % (DATA_BUFFER_SIZE * 3) == DATA_BUFFER_SIZE) {
+                config.lowDeltaTThreshold = (config.lowDeltaTThreshold == 2.0f) ? 3.0f : 2.0f;
+            }
+            // ...and the read interval, which resizes the window.
+            if (i % (DATA_BUFFER_SIZE * 4) == DATA_BUFFER_SIZE * 2) {
+                config.sensorReadIntervalMs = intervals[(i / (DATA_BUFFER_SIZE * 4) + seed) % 3];
+            }
+            // ...and the longest duration, which does too.
+            if (i % (DATA_BUFFER_SIZE * 5) == DATA_BUFFER_SIZE * 3) {
+                config.tempSensorDisconnectedDurationS = (config.tempSensorDisconnectedDurationS == 150) ? 300 : 150;
+            }
+
+            state->getLatestData() = stream.next(config.sensorReadIntervalMs);
+            state->recordLatestData();
+
+            AlertStatus expected = full_scan(state->getSampleHistory(), config);
+            AlertStatus actual = state->evaluateAlerts(config);
+            if (expected != actual) {
+                char message[64];
+                snprintf(message, sizeof(message), "Mismatch at seed %d, sample %d", seed, i);
+                TEST_FAIL_MESSAGE(message);
+            }
+            if (actual != AlertStatus::NONE) {
+                alertsSeen++;
+            }
+        }
+
+        // Make sure the stream is actually exercising the alert paths.
+        TEST_ASSERT_TRUE(alertsSeen > 0);
+        TEST_ASSERT_TRUE(alertsSeen < samplesPerSeed);
+    }
+}
+
+void test_evaluator_rebuild_matches_full_scan() {
+    AppConfig config = create_test_config();
+    std::unique_ptr<CompactSampleStore> history(new CompactSampleStore());
+    RandomSampleStream stream(42);
+    for (int i = 0; i < DATA_BUFFER_SIZE * 3; i++) {
+        history->push(stream.next());
+    }
+
+    AlertEvaluator evaluator;
+    evaluator.rebuild(*history, config.lowDeltaTThreshold, config.sensorReadIntervalMs, AlertManager::windowMs(config));
+
+    TEST_ASSERT_EQUAL(full_scan(*history, config), evaluator.evaluate(*history, config));
+}
+
+void test_benchmark_evaluator_against_full_scan() {
+    AppConfig config = create_test_config();
+    std::unique_ptr<SystemState> state(new SystemState());
+    RandomSampleStream stream(7);
+    const int iterations = 20000;
+    volatile int sink = 0;
+
+    using Clock = std::chrono::steady_clock;
+
+    auto scanStart = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        state->getLatestData() = stream.next();
+        state->recordLatestData();
+        sink = sink + static_cast<int>(full_scan(state->getSampleHistory(), config));
+    }
+    auto scanNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - scanStart).count();
+
+    auto incrementalStart = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        state->getLatestData() = stream.next();
+        state->recordLatestData();
+        sink = sink + static_cast<int>(state->evaluateAlerts(config));
+    }
+    auto incrementalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - incrementalStart).count();
+
+    char message[128];
+    snprintf(message, sizeof(message), "window=%d full scan: %lld ns/cycle, incremental: %lld ns/cycle",
+             static_cast<int>(AlertManager::windowSamples(state->getSampleHistory(), AlertManager::windowMs(config))),
+             static_cast<long long>(scanNs / iterations),
+             static_cast<long long>(incrementalNs / iterations));
+    // Reported only; wall-clock timings are too noisy to assert on in CI.
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_evaluator_matches_full_scan_on_random_streams);
+    RUN_TEST(test_evaluator_rebuild_matches_full_scan);
+    RUN_TEST(test_benchmark_evaluator_against_full_scan);
+    return UNITY_END();
+}
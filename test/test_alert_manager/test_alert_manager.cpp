@@ -3,7 +3,7 @@
 #include "logic/alert_manager.h"
 #include "hvac_data.h"
 #include "config/config_manager.h"
-#include <array>
+#include "state/CompactSampleStore.h"
 
 void setUp(void) {}
 void tearDown(void) {}
@@ -15,99 +15,248 @@ AppConfig create_test_config() {
     config.lowDeltaTDurationS = 300;
     config.noAirflowDurationS = 60;
     config.tempSensorDisconnectedDurationS = 30;
+    config.sensorReadIntervalMs = SENSOR_READ_INTERVAL_MS;
+    config.adcSamplesPerChannel = ADC_SAMPLES_PER_CHANNEL;
     return config;
 }
 
-// Helper to fill the buffer with a baseline of normal, initialized data
-void fill_buffer_with_normal_data(std::array<HVACData, DATA_BUFFER_SIZE>& buffer) {
-    for (auto& data : buffer) {
-        data.isInitialized = true;
-        data.fanStatus = ComponentStatus::ON;
-        data.airflowStatus = AirflowStatus::OK;
-        data.compressorStatus = ComponentStatus::ON;
-        data.deltaT = 5.0f;
-        data.returnTempC = 25.0f;
-        data.supplyTempC = 20.0f;
+// A baseline of normal, initialized data
+HVACData normal_sample() {
+    HVACData data;
+    data.isInitialized = true;
+    data.fanStatus = ComponentStatus::ON;
+    data.airflowStatus = AirflowStatus::OK;
+    data.compressorStatus = ComponentStatus::ON;
+    data.returnTempC = 25.0f;
+    data.supplyTempC = 20.0f;
+    data.deltaT = 5.0f;
+    return data;
+}
+
+// Fills a whole window at the configured read interval, plus the sample
+// before it, with copies of `data`.
+void fill_window(CompactSampleStore& store, const HVACData& data, const AppConfig& config) {
+    HVACData sample = data;
+    size_t count = AlertManager::windowMs(config) / config.sensorReadIntervalMs + 1;
+    for (size_t i = 0; i < count; i++) {
+        sample.timestamp = static_cast<uint32_t>(i * config.sensorReadIntervalMs);
+        store.push(sample);
     }
 }
 
+size_t window_samples(const CompactSampleStore& store, const AppConfig& config) {
+    return AlertManager::windowSamples(store, AlertManager::windowMs(config));
+}
+
+AlertStatus check(const CompactSampleStore& store, const AppConfig& config) {
+    return AlertManager::checkAlerts(store, window_samples(store, config), config);
+}
+
 void test_checkAlerts_no_alert_on_normal_conditions() {
     AppConfig config = create_test_config();
-    std::array<HVACData, DATA_BUFFER_SIZE> buffer;
-    fill_buffer_with_normal_data(buffer);
+    CompactSampleStore store;
+    fill_window(store, normal_sample(), config);
 
-    AlertStatus result = AlertManager::checkAlerts(buffer, config);
+    AlertStatus result = check(store, config);
 
     TEST_ASSERT_EQUAL(AlertStatus::NONE, result);
 }
 
 void test_checkAlerts_triggers_fan_no_airflow_alert() {
     AppConfig config = create_test_config();
-    config.noAirflowDurationS = (DATA_BUFFER_SIZE * SENSOR_READ_INTERVAL_MS / 1000) - 1; // Ensure duration is met
-
-    std::array<HVACData, DATA_BUFFER_SIZE> buffer;
-    fill_buffer_with_normal_data(buffer);
+    config.noAirflowDurationS = 300; // As long as the longest setting
 
     // Introduce the fault condition
-    for (auto& data : buffer) {
-        data.airflowStatus = AirflowStatus::NA;
-    }
+    HVACData fault = normal_sample();
+    fault.airflowStatus = AirflowStatus::NA;
+    CompactSampleStore store;
+    fill_window(store, fault, config);
 
-    AlertStatus result = AlertManager::checkAlerts(buffer, config);
+    AlertStatus result = check(store, config);
 
     TEST_ASSERT_EQUAL(AlertStatus::FAN_NO_AIRFLOW, result);
 }
 
 void test_checkAlerts_triggers_low_delta_t_alert() {
     AppConfig config = create_test_config();
-    config.lowDeltaTDurationS = (DATA_BUFFER_SIZE * SENSOR_READ_INTERVAL_MS / 1000) - 1; // Ensure duration is met
-
-    std::array<HVACData, DATA_BUFFER_SIZE> buffer;
-    fill_buffer_with_normal_data(buffer);
+    config.lowDeltaTDurationS = 300; // The longest setting
 
     // Introduce the fault condition
-    for (auto& data : buffer) {
-        data.compressorStatus = ComponentStatus::ON;
-        data.deltaT = config.lowDeltaTThreshold - 0.5f; // Below threshold
-    }
+    HVACData fault = normal_sample();
+    fault.supplyTempC = fault.returnTempC - (config.lowDeltaTThreshold - 0.5f); // Below threshold
+    CompactSampleStore store;
+    fill_window(store, fault, config);
 
-    AlertStatus result = AlertManager::checkAlerts(buffer, config);
+    AlertStatus result = check(store, config);
 
     TEST_ASSERT_EQUAL(AlertStatus::LOW_DELTA_T, result);
 }
 
 void test_checkAlerts_does_not_trigger_if_duration_is_too_short() {
     AppConfig config = create_test_config();
-    std::array<HVACData, DATA_BUFFER_SIZE> buffer;
-    fill_buffer_with_normal_data(buffer);
+    CompactSampleStore store;
+    fill_window(store, normal_sample(), config);
 
     // Simulate a problem for only one sample
-    buffer[0].isInitialized = true;
-    buffer[0].fanStatus = ComponentStatus::ON;
-    buffer[0].airflowStatus = AirflowStatus::NA;
+    HVACData fault = normal_sample();
+    fault.airflowStatus = AirflowStatus::NA;
+    fault.timestamp = store.timestampAt(store.size() - 1) + config.sensorReadIntervalMs;
+    store.push(fault);
 
-    AlertStatus result = AlertManager::checkAlerts(buffer, config);
+    AlertStatus result = check(store, config);
 
     TEST_ASSERT_EQUAL(AlertStatus::NONE, result);
 }
 
 void test_checkAlerts_triggers_temp_sensor_disconnected_alert() {
     AppConfig config = create_test_config();
-    config.tempSensorDisconnectedDurationS = (DATA_BUFFER_SIZE * SENSOR_READ_INTERVAL_MS / 1000) - 1; // Ensure duration is met
-
-    std::array<HVACData, DATA_BUFFER_SIZE> buffer;
-    fill_buffer_with_normal_data(buffer);
+    config.tempSensorDisconnectedDurationS = 300; // As long as the longest setting
 
     // Introduce the fault condition
-    for (auto& data : buffer) {
-        data.returnTempC = -127.0f; // Disconnected
-    }
+    HVACData fault = normal_sample();
+    fault.returnTempC = -127.0f; // Disconnected
+    CompactSampleStore store;
+    fill_window(store, fault, config);
 
-    AlertStatus result = AlertManager::checkAlerts(buffer, config);
+    AlertStatus result = check(store, config);
 
     TEST_ASSERT_EQUAL(AlertStatus::TEMP_SENSOR_DISCONNECTED, result);
 }
 
+void test_checkAlerts_duration_does_not_depend_on_read_interval() {
+    HVACData fault = normal_sample();
+    fault.airflowStatus = AirflowStatus::NA;
+
+    const unsigned long intervals[] = {1000, SENSOR_READ_INTERVAL_MS, 15000};
+    for (unsigned long interval : intervals) {
+        AppConfig config = create_test_config();
+        config.sensorReadIntervalMs = interval;
+        config.noAirflowDurationS = 120;
+
+        // 119 s of fault is not enough, 120 s is, at any cadence.
+        CompactSampleStore store;
+        fill_window(store, normal_sample(), config);
+        uint32_t start = store.timestampAt(store.size() - 1);
+        for (uint32_t elapsed = interval; elapsed < 120000; elapsed += interval) {
+            fault.timestamp = start + elapsed;
+            store.push(fault);
+        }
+        TEST_ASSERT_EQUAL(AlertStatus::NONE, check(store, config));
+
+        fault.timestamp = start + 120000;
+        store.push(fault);
+        TEST_ASSERT_EQUAL(AlertStatus::FAN_NO_AIRFLOW, check(store, config));
+    }
+}
+
+void test_checkAlerts_weighs_samples_by_their_timestamps() {
+    AppConfig config = create_test_config();
+    config.noAirflowDurationS = 60;
+    CompactSampleStore store;
+    fill_window(store, normal_sample(), config);
+
+    // A read a little late stands for the time since the one before...
+    HVACData fault = normal_sample();
+    fault.airflowStatus = AirflowStatus::NA;
+    fault.timestamp = store.timestampAt(store.size() - 1) + config.sensorReadIntervalMs - 1000;
+    store.push(fault);
+    AlertManager::AlertDurations durations = AlertManager::sumDurations(
+        store, window_samples(store, config), config.lowDeltaTThreshold, config.sensorReadIntervalMs);
+    TEST_ASSERT_EQUAL(config.sensorReadIntervalMs - 1000, durations.fanOnNoAirflowMs);
+
+    // ...but one delayed by a minute for no more than one read interval.
+    fault.timestamp += 60000;
+    store.push(fault);
+    durations = AlertManager::sumDurations(
+        store, window_samples(store, config), config.lowDeltaTThreshold, config.sensorReadIntervalMs);
+    TEST_ASSERT_EQUAL(2 * config.sensorReadIntervalMs - 1000, durations.fanOnNoAirflowMs);
+    TEST_ASSERT_EQUAL(AlertStatus::NONE, check(store, config));
+}
+
+void test_checkAlerts_single_glitch_at_idle_cadence_does_not_alert() {
+    AppConfig config = create_test_config();
+    CompactSampleStore store;
+    HVACData idle = normal_sample();
+    idle.fanStatus = ComponentStatus::OFF;
+    idle.compressorStatus = ComponentStatus::OFF;
+    uint32_t timestamp = 0;
+    for (uint32_t i = 0; i <= AlertManager::windowMs(config) / IDLE_SENSOR_READ_INTERVAL_MS; i++) {
+        idle.timestamp = timestamp;
+        store.push(idle);
+        timestamp += IDLE_SENSOR_READ_INTERVAL_MS;
+    }
+
+    // One bad read, as long after the last as the threshold, then good ones.
+    HVACData glitch = idle;
+    glitch.supplyTempC = -127.0f;
+    glitch.timestamp = timestamp;
+    store.push(glitch);
+    TEST_ASSERT_TRUE(IDLE_SENSOR_READ_INTERVAL_MS >= config.tempSensorDisconnectedDurationS * 1000UL);
+    TEST_ASSERT_EQUAL(AlertStatus::NONE, check(store, config));
+    idle.timestamp = timestamp + IDLE_SENSOR_READ_INTERVAL_MS;
+    store.push(idle);
+    TEST_ASSERT_EQUAL(AlertStatus::NONE, check(store, config));
+
+    // A probe that stays disconnected still alerts once enough reads agree.
+    uint32_t reads = config.tempSensorDisconnectedDurationS * 1000UL / config.sensorReadIntervalMs;
+    for (uint32_t i = 1; i <= reads; i++) {
+        glitch.timestamp = idle.timestamp + i * IDLE_SENSOR_READ_INTERVAL_MS;
+        store.push(glitch);
+    }
+    TEST_ASSERT_EQUAL(AlertStatus::TEMP_SENSOR_DISCONNECTED, check(store, config));
+}
+
+void test_checkAlerts_durations_longer_than_five_minutes_can_alert() {
+    AppConfig config = create_test_config();
+    config.lowDeltaTDurationS = 600;
+    TEST_ASSERT_EQUAL_UINT32(605000, AlertManager::windowMs(config));
+
+    HVACData fault = normal_sample();
+    fault.supplyTempC = fault.returnTempC - (config.lowDeltaTThreshold - 0.5f);
+    CompactSampleStore store;
+    fill_window(store, normal_sample(), config);
+    uint32_t start = store.timestampAt(store.size() - 1);
+
+    // Reads that run a little early need one more of them, not a shorter fault.
+    uint32_t elapsed = 0;
+    while (elapsed + 4900 < 600000) {
+        elapsed += 4900;
+        fault.timestamp = start + elapsed;
+        store.push(fault);
+    }
+    TEST_ASSERT_EQUAL(AlertStatus::NONE, check(store, config));
+
+    fault.timestamp = start + elapsed + 4900;
+    store.push(fault);
+    TEST_ASSERT_EQUAL(AlertStatus::LOW_DELTA_T, check(store, config));
+}
+
+void test_windowSamples_covers_the_alert_window() {
+    AppConfig config = create_test_config();
+    CompactSampleStore store;
+    TEST_ASSERT_EQUAL(0, window_samples(store, config));
+
+    config.sensorReadIntervalMs = 5000;
+    fill_window(store, normal_sample(), config);
+    TEST_ASSERT_EQUAL(AlertManager::windowMs(config) / 5000, window_samples(store, config));
+
+    // Slower reads after faster ones: the window is bounded by time, not count.
+    HVACData sample = normal_sample();
+    for (int i = 1; i <= 3; i++) {
+        sample.timestamp = store.timestampAt(store.size() - 1) + 60000;
+        store.push(sample);
+    }
+    TEST_ASSERT_EQUAL(3 + (AlertManager::windowMs(config) - 180000) / 5000, window_samples(store, config));
+
+    // Never the oldest stored sample.
+    CompactSampleStore young;
+    sample.timestamp = 0;
+    young.push(sample);
+    sample.timestamp = 1000;
+    young.push(sample);
+    TEST_ASSERT_EQUAL(1, window_samples(young, config));
+}
+
 int main(int argc, char **argv) {
     UNITY_BEGIN();
     RUN_TEST(test_checkAlerts_no_alert_on_normal_conditions);
@@ -115,5 +264,10 @@ int main(int argc, char **argv) {
     RUN_TEST(test_checkAlerts_triggers_low_delta_t_alert);
     RUN_TEST(test_checkAlerts_does_not_trigger_if_duration_is_too_short);
     RUN_TEST(test_checkAlerts_triggers_temp_sensor_disconnected_alert);
+    RUN_TEST(test_checkAlerts_duration_does_not_depend_on_read_interval);
+    RUN_TEST(test_checkAlerts_weighs_samples_by_their_timestamps);
+    RUN_TEST(test_checkAlerts_single_glitch_at_idle_cadence_does_not_alert);
+    RUN_TEST(test_checkAlerts_durations_longer_than_five_minutes_can_alert);
+    RUN_TEST(test_windowSamples_covers_the_alert_window);
     return UNITY_END();
-}
\ No newline at end of file
+}
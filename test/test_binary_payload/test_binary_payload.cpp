@@ -0,0 +1,210 @@
+#include <unity.h>
+#include "hvac_data.h"
+#include "logic/binary_payload.h"
+#include "logic/json_builder.h"
+#include <ArduinoJson.h>
+#include <cstring>
+#include <vector>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+AggregatedHVACData make_aggregate(uint32_t i) {
+    AggregatedHVACData data;
+    data.timestamp = 300000 * (i + 1);
+    data.sampleCount = 60;
+    data.avgReturnTempC = 21.37f + i;
+    data.minReturnTempC = 20.5f;
+    data.maxReturnTempC = 22.25f;
+    data.stddevReturnTempC = 0.41f;
+    data.avgSupplyTempC = 13.02f;
+    data.minSupplyTempC = -127.0f; // Sensor fault sentinel
+    data.maxSupplyTempC = 14.5f;
+    data.avgDeltaT = 8.35f;
+    data.maxDeltaT = 9.1f;
+    data.avgFanAmps = 2.48;
+    data.maxFanAmps = 2.61;
+    data.avgCompressorAmps = 17.93;
+    data.stddevCompressorAmps = 0.22;
+    data.avgGeoPumpsAmps = 3.3;
+    data.lastFanStatus = ComponentStatus::ON;
+    data.lastCompressorStatus = ComponentStatus::OFF;
+    data.lastGeoPumpsStatus = ComponentStatus::UNKNOWN;
+    return data;
+}
+
+struct Decoded {
+    uint32_t sequence;
+    AggregatedHVACData data;
+};
+
+std::vector<Decoded> decode_all(const uint8_t* payload, size_t length) {
+    std::vector<Decoded> records;
+    bool ok = BinaryPayload::decode(payload, length, [&](uint32_t sequence, const AggregatedHVACData& data) {
+        records.push_back({sequence, data});
+    });
+    TEST_ASSERT_TRUE(ok);
+    return records;
+}
+
+void test_binary_payload_round_trips_within_quantization() {
+    uint8_t buffer[1024];
+    BinaryPayload::Batch batch(buffer, sizeof(buffer), "v1.2.3", "2024-01-01");
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(batch.add(make_aggregate(i), 40 + i));
+    }
+    size_t length = batch.finish();
+    TEST_ASSERT_EQUAL(4 + strlen("v1.2.3") + strlen("2024-01-01") + 3 * BinaryPayload::RECORD_SIZE, length);
+    TEST_ASSERT_EQUAL_UINT8(BinaryPayload::SCHEMA_VERSION, buffer[0]);
+    const size_t buildDateAt = 3 + strlen("v1.2.3");
+    TEST_ASSERT_EQUAL_UINT8(strlen("2024-01-01"), buffer[buildDateAt]);
+    TEST_ASSERT_EQUAL_MEMORY("2024-01-01", buffer + buildDateAt + 1, strlen("2024-01-01"));
+
+    std::vector<Decoded> records = decode_all(buffer, length);
+    TEST_ASSERT_EQUAL(3, records.size());
+    for (uint32_t i = 0; i < 3; i++) {
+        AggregatedHVACData expected = make_aggregate(i);
+        const AggregatedHVACData& actual = records[i].data;
+        TEST_ASSERT_EQUAL_UINT32(40 + i, records[i].sequence);
+        TEST_ASSERT_EQUAL_UINT32(expected.timestamp, actual.timestamp);
+        TEST_ASSERT_EQUAL_UINT32(expected.sampleCount, actual.sampleCount);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.avgReturnTempC, actual.avgReturnTempC);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.stddevReturnTempC, actual.stddevReturnTempC);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.minSupplyTempC, actual.minSupplyTempC);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.maxDeltaT, actual.maxDeltaT);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.avgFanAmps, actual.avgFanAmps);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.avgCompressorAmps, actual.avgCompressorAmps);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.stddevCompressorAmps, actual.stddevCompressorAmps);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, expected.avgGeoPumpsAmps, actual.avgGeoPumpsAmps);
+        TEST_ASSERT_TRUE(actual.lastFanStatus == ComponentStatus::ON);
+        TEST_ASSERT_TRUE(actual.lastCompressorStatus == ComponentStatus::OFF);
+        TEST_ASSERT_TRUE(actual.lastGeoPumpsStatus == ComponentStatus::UNKNOWN);
+    }
+}
+
+void test_json_batch_round_trips() {
+    char buffer[4096];
+    JsonBuilder::AggregatedBatch batch(buffer, sizeof(buffer), "v1.2.3", "2024-01-01");
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(batch.add(make_aggregate(i), 40 + i));
+    }
+    TEST_ASSERT_GREATER_THAN(0, batch.finish());
+
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, buffer));
+    JsonArray records = doc["records"].as<JsonArray>();
+    TEST_ASSERT_EQUAL(3, records.size());
+    for (uint32_t i = 0; i < 3; i++) {
+        AggregatedHVACData expected = make_aggregate(i);
+        JsonObject record = records[i].as<JsonObject>();
+        TEST_ASSERT_EQUAL_UINT32(40 + i, record["sequence"].as<uint32_t>());
+        TEST_ASSERT_EQUAL_UINT32(expected.timestamp, record["timestamp"].as<uint32_t>());
+        TEST_ASSERT_FLOAT_WITHIN(0.0001f, expected.avgReturnTempC, record["avgReturnTempC"].as<float>());
+        TEST_ASSERT_FLOAT_WITHIN(0.0001f, expected.avgCompressorAmps, record["avgCompressorAmps"].as<float>());
+        TEST_ASSERT_EQUAL_STRING("ON", record["lastFanStatus"].as<const char*>());
+    }
+}
+
+void test_binary_payload_is_less_than_half_the_json_size() {
+    char json[8192];
+    uint8_t binary[8192];
+    JsonBuilder::AggregatedBatch jsonBatch(json, sizeof(json), "v1.2.3", "2024-01-01");
+    BinaryPayload::Batch binaryBatch(binary, sizeof(binary), "v1.2.3", "2024-01-01");
+
+    for (uint32_t records = 1; records <= 6; records++) {
+        TEST_ASSERT_TRUE(jsonBatch.add(make_aggregate(records), records));
+        TEST_ASSERT_TRUE(binaryBatch.add(make_aggregate(records), records));
+    }
+    size_t jsonLength = jsonBatch.finish();
+    size_t binaryLength = binaryBatch.finish();
+    TEST_ASSERT_TRUE(binaryLength * 2 < jsonLength);
+
+    // A lone record pays for the whole envelope, the worst case for the saving.
+    char singleJson[1024];
+    uint8_t singleBinary[128];
+    BinaryPayload::Batch single(singleBinary, sizeof(singleBinary), "v1.2.3", "2024-01-01");
+    TEST_ASSERT_TRUE(single.add(make_aggregate(0), 0));
+    size_t singleJsonLength = JsonBuilder::buildPayload(make_aggregate(0), 0, "v1.2.3", "2024-01-01", singleJson, sizeof(singleJson));
+    TEST_ASSERT_TRUE(single.finish() * 2 < singleJsonLength);
+}
+
+void test_binary_batch_stops_at_buffer_capacity() {
+    uint8_t buffer[4 + 2 + 2 + 2 * BinaryPayload::RECORD_SIZE + 10];
+    BinaryPayload::Batch batch(buffer, sizeof(buffer), "v1", "d1");
+    TEST_ASSERT_TRUE(batch.add(make_aggregate(0), 0));
+    TEST_ASSERT_TRUE(batch.add(make_aggregate(1), 1));
+    TEST_ASSERT_FALSE(batch.add(make_aggregate(2), 2));
+    TEST_ASSERT_EQUAL(2, batch.count());
+    TEST_ASSERT_EQUAL(2, decode_all(buffer, batch.finish()).size());
+
+    uint8_t tiny[2];
+    BinaryPayload::Batch empty(tiny, sizeof(tiny), "v1", "d1");
+    TEST_ASSERT_FALSE(empty.add(make_aggregate(0), 0));
+    TEST_ASSERT_EQUAL(0, empty.finish());
+}
+
+void test_binary_decode_rejects_malformed_payloads() {
+    uint8_t buffer[256];
+    BinaryPayload::Batch batch(buffer, sizeof(buffer), "v1", "d1");
+    batch.add(make_aggregate(0), 0);
+    size_t length = batch.finish();
+    const auto ignore = [](uint32_t, const AggregatedHVACData&) {};
+
+    TEST_ASSERT_TRUE(BinaryPayload::decode(buffer, length, ignore));
+    TEST_ASSERT_FALSE(BinaryPayload::decode(buffer, length - 1, ignore));   // Truncated
+    TEST_ASSERT_FALSE(BinaryPayload::decode(buffer, 2, ignore));            // Header only
+    buffer[3 + strlen("v1")] = 200;
+    TEST_ASSERT_FALSE(BinaryPayload::decode(buffer, length, ignore));       // Build date overruns
+    buffer[3 + strlen("v1")] = strlen("d1");
+    buffer[0] = BinaryPayload::SCHEMA_VERSION + 1;
+    TEST_ASSERT_FALSE(BinaryPayload::decode(buffer, length, ignore));       // Unknown schema
+    const uint8_t json[] = "{\"records\":[]}";
+    TEST_ASSERT_FALSE(BinaryPayload::decode(json, sizeof(json) - 1, ignore));
+}
+
+void test_binary_event_round_trips() {
+    HVACData sample;
+    sample.timestamp = 123456789;
+    sample.returnTempC = 22.37f;
+    sample.supplyTempC = -127.0f;
+    sample.deltaT = sample.returnTempC - sample.supplyTempC;
+    sample.fanAmps = 2.48;
+    sample.compressorAmps = 17.93;
+    sample.geoPumpsAmps = 3.3;
+    sample.fanStatus = ComponentStatus::ON;
+    sample.compressorStatus = ComponentStatus::UNKNOWN;
+    sample.airflowStatus = AirflowStatus::OK;
+    sample.alertStatus = AlertStatus::TEMP_SENSOR_DISCONNECTED;
+
+    uint8_t buffer[BinaryPayload::EVENT_SIZE];
+    TEST_ASSERT_EQUAL(0, BinaryPayload::encodeEvent(sample, 0x3, buffer, sizeof(buffer) - 1));
+    TEST_ASSERT_EQUAL(BinaryPayload::EVENT_SIZE, BinaryPayload::encodeEvent(sample, 0x3, buffer, sizeof(buffer)));
+
+    HVACData decoded;
+    uint8_t changes = 0;
+    TEST_ASSERT_TRUE(BinaryPayload::decodeEvent(buffer, sizeof(buffer), decoded, changes));
+    TEST_ASSERT_EQUAL_UINT8(0x3, changes);
+    TEST_ASSERT_EQUAL_UINT32(sample.timestamp, decoded.timestamp);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, sample.returnTempC, decoded.returnTempC);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, sample.supplyTempC, decoded.supplyTempC);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, sample.deltaT, decoded.deltaT);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, sample.fanAmps, decoded.fanAmps);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, sample.compressorAmps, decoded.compressorAmps);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, sample.geoPumpsAmps, decoded.geoPumpsAmps);
+    TEST_ASSERT_TRUE(decoded.fanStatus == ComponentStatus::ON);
+    TEST_ASSERT_TRUE(decoded.compressorStatus == ComponentStatus::UNKNOWN);
+    TEST_ASSERT_TRUE(decoded.airflowStatus == AirflowStatus::OK);
+    TEST_ASSERT_TRUE(decoded.alertStatus == AlertStatus::TEMP_SENSOR_DISCONNECTED);
+    TEST_ASSERT_FALSE(BinaryPayload::decodeEvent(buffer, sizeof(buffer) - 1, decoded, changes));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_binary_payload_round_trips_within_quantization);
+    RUN_TEST(test_json_batch_round_trips);
+    RUN_TEST(test_binary_payload_is_less_than_half_the_json_size);
+    RUN_TEST(test_binary_batch_stops_at_buffer_capacity);
+    RUN_TEST(test_binary_decode_rejects_malformed_payloads);
+    RUN_TEST(test_binary_event_round_trips);
+    return UNITY_END();
+}
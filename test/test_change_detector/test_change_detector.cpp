@@ -0,0 +1,158 @@
+#include <unity.h>
+#include "logic/change_detector.h"
+
+static const float TEMP_DEADBAND = 0.5f;
+static const float CURRENT_DEADBAND = 0.5f;
+static const uint32_t DEBOUNCE_MS = 10000;
+static const uint32_t ANALOG_INTERVAL_MS = 60000;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+HVACData make_sample(uint32_t timestamp) {
+    HVACData data;
+    data.isInitialized = true;
+    data.timestamp = timestamp;
+    data.returnTempC = 22.0f;
+    data.supplyTempC = 14.0f;
+    data.deltaT = 8.0f;
+    data.fanAmps = 2.5;
+    data.compressorAmps = 0.1;
+    data.geoPumpsAmps = 0.0;
+    data.fanStatus = ComponentStatus::ON;
+    data.airflowStatus = AirflowStatus::OK;
+    return data;
+}
+
+// Checks a sample and, like MqttManager, commits it if it was reportable.
+uint8_t report(ChangeDetector& detector, const HVACData& sample) {
+    uint8_t changes = detector.check(sample);
+    if (changes != 0) {
+        detector.commit(sample);
+    }
+    return changes;
+}
+
+ChangeDetector make_detector() {
+    return ChangeDetector(TEMP_DEADBAND, CURRENT_DEADBAND, DEBOUNCE_MS, ANALOG_INTERVAL_MS);
+}
+
+void test_first_sample_reports_everything() {
+    ChangeDetector detector = make_detector();
+    uint8_t changes = report(detector, make_sample(5000));
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::STATUS | ChangeDetector::ALERT | ChangeDetector::ANALOG, changes);
+    TEST_ASSERT_EQUAL_UINT8(0, report(detector, make_sample(10000)));
+}
+
+void test_analog_changes_inside_the_deadband_are_ignored() {
+    ChangeDetector detector = make_detector();
+    report(detector, make_sample(0));
+
+    // Drift that stays inside the deadband never reports, however long it lasts.
+    for (uint32_t t = 1; t <= 100; t++) {
+        HVACData sample = make_sample(t * 5000);
+        sample.returnTempC = 22.0f + ((t % 2) ? 0.45f : -0.45f);
+        sample.fanAmps = 2.5 + 0.4;
+        TEST_ASSERT_EQUAL_UINT8(0, report(detector, sample));
+    }
+
+    HVACData moved = make_sample(505000);
+    moved.supplyTempC = 14.6f;
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::ANALOG, report(detector, moved));
+}
+
+void test_deadband_is_measured_from_the_last_reported_value() {
+    ChangeDetector detector = make_detector();
+    report(detector, make_sample(0));
+
+    // Small steps add up: the third is more than a deadband from the reference.
+    float temps[] = {22.2f, 22.4f, 22.6f};
+    uint8_t results[3];
+    for (int i = 0; i < 3; i++) {
+        HVACData sample = make_sample(ANALOG_INTERVAL_MS * (i + 1));
+        sample.returnTempC = temps[i];
+        results[i] = report(detector, sample);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, results[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, results[1]);
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::ANALOG, results[2]);
+}
+
+void test_analog_changes_are_rate_limited() {
+    ChangeDetector detector = make_detector();
+    report(detector, make_sample(0));
+
+    HVACData sample = make_sample(5000);
+    sample.compressorAmps = 18.0;
+    TEST_ASSERT_EQUAL_UINT8(0, report(detector, sample)); // Too soon after the last report
+
+    sample.timestamp = ANALOG_INTERVAL_MS;
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::ANALOG, report(detector, sample));
+}
+
+void test_status_change_is_debounced() {
+    ChangeDetector detector = make_detector();
+    report(detector, make_sample(0));
+
+    HVACData on = make_sample(100000);
+    on.compressorStatus = ComponentStatus::ON;
+    TEST_ASSERT_EQUAL_UINT8(0, report(detector, on));
+    on.timestamp = 105000;
+    TEST_ASSERT_EQUAL_UINT8(0, report(detector, on));
+    on.timestamp = 110000; // Held for the full debounce time
+    TEST_ASSERT_TRUE(report(detector, on) & ChangeDetector::STATUS);
+
+    on.timestamp = 115000;
+    TEST_ASSERT_EQUAL_UINT8(0, report(detector, on));
+}
+
+void test_status_flicker_is_not_reported() {
+    ChangeDetector detector = make_detector();
+    report(detector, make_sample(0));
+
+    // The fan drops out for one read at a time, never long enough to count.
+    for (uint32_t t = 1; t <= 20; t++) {
+        HVACData sample = make_sample(100000 + t * 5000);
+        sample.fanStatus = (t % 2) ? ComponentStatus::OFF : ComponentStatus::ON;
+        TEST_ASSERT_EQUAL_UINT8(0, report(detector, sample) & ChangeDetector::STATUS);
+    }
+}
+
+void test_alert_change_is_reported_immediately() {
+    ChangeDetector detector = make_detector();
+    report(detector, make_sample(0));
+
+    HVACData alert = make_sample(5000);
+    alert.alertStatus = AlertStatus::LOW_DELTA_T;
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::ALERT, report(detector, alert));
+
+    HVACData cleared = make_sample(10000);
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::ALERT, report(detector, cleared));
+}
+
+void test_uncommitted_change_keeps_being_reported() {
+    ChangeDetector detector = make_detector();
+    report(detector, make_sample(0));
+
+    HVACData alert = make_sample(5000);
+    alert.alertStatus = AlertStatus::FAN_NO_AIRFLOW;
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::ALERT, detector.check(alert)); // Not sent, e.g. offline
+    alert.timestamp = 10000;
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::ALERT, detector.check(alert));
+
+    detector.reset();
+    TEST_ASSERT_EQUAL_UINT8(ChangeDetector::STATUS | ChangeDetector::ALERT | ChangeDetector::ANALOG, detector.check(alert));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_reports_everything);
+    RUN_TEST(test_analog_changes_inside_the_deadband_are_ignored);
+    RUN_TEST(test_deadband_is_measured_from_the_last_reported_value);
+    RUN_TEST(test_analog_changes_are_rate_limited);
+    RUN_TEST(test_status_change_is_debounced);
+    RUN_TEST(test_status_flicker_is_not_reported);
+    RUN_TEST(test_alert_change_is_reported_immediately);
+    RUN_TEST(test_uncommitted_change_keeps_being_reported);
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+#include <unity.h>
+#include "config.h"
+#include "hvac_data.h"
+#include "state/CompactSampleStore.h"
+#include "logic/alert_manager.h"
+#include "logic/json_builder.h"
+#include "config/config_manager.h"
+#include <ArduinoJson.h>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Values chosen on the 0.01 grid so they survive the fixed-point round trip.
+HVACData make_sample(int i) {
+    HVACData data;
+    data.isInitialized = true;
+    data.timestamp = 5000u * (i + 1);
+    data.returnTempC = 20.0f + (i % 10) * 0.25f;
+    data.supplyTempC = 18.5f + (i % 7) * 0.5f;
+    data.deltaT = data.returnTempC - data.supplyTempC;
+    data.fanAmps = 1.25 + (i % 3);
+    data.compressorAmps = (i % 4 == 0) ? 0.0 : 12.5;
+    data.geoPumpsAmps = 3.75;
+    data.fanStatus = (i % 2 == 0) ? ComponentStatus::ON : ComponentStatus::OFF;
+    data.compressorStatus = (i % 4 == 0) ? ComponentStatus::OFF : ComponentStatus::ON;
+    data.geoPumpsStatus = (i % 5 == 0) ? ComponentStatus::UNKNOWN : ComponentStatus::ON;
+    data.airflowStatus = (i % 3 == 0) ? AirflowStatus::NA : AirflowStatus::OK;
+    data.alertStatus = static_cast<AlertStatus>(i % 4);
+    return data;
+}
+
+void assert_samples_equal(const HVACData& expected, const HVACData& actual) {
+    TEST_ASSERT_TRUE(actual.isInitialized);
+    TEST_ASSERT_EQUAL_UINT32(expected.timestamp, actual.timestamp);
+    TEST_ASSERT_EQUAL_FLOAT(expected.returnTempC, actual.returnTempC);
+    TEST_ASSERT_EQUAL_FLOAT(expected.supplyTempC, actual.supplyTempC);
+    TEST_ASSERT_EQUAL_FLOAT(expected.deltaT, actual.deltaT);
+    TEST_ASSERT_EQUAL_FLOAT(expected.fanAmps, actual.fanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(expected.compressorAmps, actual.compressorAmps);
+    TEST_ASSERT_EQUAL_FLOAT(expected.geoPumpsAmps, actual.geoPumpsAmps);
+    TEST_ASSERT_EQUAL(expected.fanStatus, actual.fanStatus);
+    TEST_ASSERT_EQUAL(expected.compressorStatus, actual.compressorStatus);
+    TEST_ASSERT_EQUAL(expected.geoPumpsStatus, actual.geoPumpsStatus);
+    TEST_ASSERT_EQUAL(expected.airflowStatus, actual.airflowStatus);
+    TEST_ASSERT_EQUAL(expected.alertStatus, actual.alertStatus);
+}
+
+void test_store_round_trips_samples() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+
+    for (int i = 0; i < 20; i++) {
+        store->push(make_sample(i));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(20, store->size());
+    for (int i = 0; i < 20; i++) {
+        assert_samples_equal(make_sample(i), store->at(i));
+    }
+}
+
+void test_store_overwrites_oldest_when_full() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    const int extra = 25;
+
+    for (int i = 0; i < static_cast<int>(CompactSampleStore::CAPACITY) + extra; i++) {
+        store->push(make_sample(i));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(CompactSampleStore::CAPACITY, store->size());
+    assert_samples_equal(make_sample(extra), store->at(0));
+    assert_samples_equal(make_sample(CompactSampleStore::CAPACITY + extra - 1), store->at(store->size() - 1));
+}
+
+void test_store_skips_uninitialized_samples() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    store->push(HVACData());
+    TEST_ASSERT_EQUAL_UINT32(0, store->size());
+}
+
+void test_store_preserves_disconnected_sensor_and_clamps_out_of_range() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    HVACData data = make_sample(1);
+    data.returnTempC = -127.0f;
+    data.deltaT = 0.0f;
+    data.compressorAmps = 1000.0; // Beyond the int16 range at 0.01 A
+    store->push(data);
+
+    HVACData decoded = store->at(0);
+    TEST_ASSERT_EQUAL_FLOAT(-127.0f, decoded.returnTempC);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, decoded.deltaT);
+    TEST_ASSERT_EQUAL_FLOAT(327.67, decoded.compressorAmps);
+}
+
+void test_checkAlerts_on_store_matches_scan_of_original_samples() {
+    AppConfig config;
+    config.lowDeltaTThreshold = 2.0f;
+    config.lowDeltaTDurationS = 600;
+    config.noAirflowDurationS = 600;
+    config.tempSensorDisconnectedDurationS = 300;
+    config.sensorReadIntervalMs = 15000; // Below some of the gaps, so weights get capped
+
+    const size_t windowSize = DATA_BUFFER_SIZE;
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    std::deque<HVACData> recent; // The window and the sample before it
+
+    uint32_t timestamp = 0;
+    for (int i = 0; i < DATA_BUFFER_SIZE * 3; i++) {
+        HVACData data = make_sample(i * 7);
+        if (i % 11 == 0) {
+            data.supplyTempC = -127.0f;
+            data.deltaT = 0.0f;
+        }
+        // Uneven gaps, as after changes of read interval.
+        timestamp += 1000 + (i % 5) * 7000;
+        data.timestamp = timestamp;
+        store->push(data);
+        recent.push_back(data);
+        if (recent.size() > windowSize + 1) {
+            recent.pop_front();
+        }
+
+        AlertManager::AlertDurations expected;
+        for (size_t j = 1; j < recent.size(); j++) {
+            long weight = static_cast<long>(recent[j].timestamp - recent[j - 1].timestamp);
+            if (weight > static_cast<long>(config.sensorReadIntervalMs)) {
+                weight = static_cast<long>(config.sensorReadIntervalMs);
+            }
+            AlertManager::accumulate(expected, recent[j], config.lowDeltaTThreshold, weight);
+        }
+        AlertManager::AlertDurations actual = AlertManager::sumDurations(*store, windowSize, config.lowDeltaTThreshold,
+                                                                           config.sensorReadIntervalMs);
+
+        TEST_ASSERT_EQUAL(expected.fanOnNoAirflowMs, actual.fanOnNoAirflowMs);
+        TEST_ASSERT_EQUAL(expected.lowDeltaTMs, actual.lowDeltaTMs);
+        TEST_ASSERT_EQUAL(expected.tempSensorDisconnectedMs, actual.tempSensorDisconnectedMs);
+        TEST_ASSERT_EQUAL(AlertManager::statusFromDurations(expected, config),
+                          AlertManager::checkAlerts(*store, windowSize, config));
+    }
+}
+
+void test_buildHistoryJson_from_store_emits_most_recent_samples() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    for (int i = 0; i < 10; i++) {
+        store->push(make_sample(i));
+    }
+
+    JsonDocument doc;
+    JsonArray history = doc.to<JsonArray>();
+    JsonBuilder::buildHistoryJson(history, *store, 3);
+
+    TEST_ASSERT_EQUAL(3, history.size());
+    TEST_ASSERT_EQUAL_FLOAT(make_sample(7).returnTempC, history[0]["returnTempC"].as<float>());
+    TEST_ASSERT_EQUAL_FLOAT(make_sample(9).fanAmps, history[2]["fanAmps"].as<double>());
+    TEST_ASSERT_EQUAL_STRING("OK", history[1]["airflowStatus"]);
+}
+
+void test_benchmark_compact_store_against_array_of_structs() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    std::unique_ptr<std::array<HVACData, SAMPLE_HISTORY_SIZE>> aos(new std::array<HVACData, SAMPLE_HISTORY_SIZE>());
+    for (int i = 0; i < SAMPLE_HISTORY_SIZE; i++) {
+        store->push(make_sample(i));
+        (*aos)[i] = make_sample(i);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const int passes = 50;
+    volatile double sink = 0.0;
+
+    auto aosStart = Clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        double sum = 0.0;
+        for (const auto& data : *aos) {
+            sum += data.deltaT + data.compressorAmps;
+        }
+        sink = sink + sum;
+    }
+    auto aosNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - aosStart).count();
+
+    auto compactStart = Clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        double sum = 0.0;
+        store->forEachRecent(store->size(), [&](const HVACData& data) {
+            sum += data.deltaT + data.compressorAmps;
+        });
+        sink = sink + sum;
+    }
+    auto compactNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - compactStart).count();
+
+    const double samplesScanned = static_cast<double>(passes) * SAMPLE_HISTORY_SIZE;
+    char message[160];
+    snprintf(message, sizeof(message), "AoS: %u bytes/sample, %.1f Msamples/s | compact: %u bytes/sample, %.1f Msamples/s",
+             static_cast<unsigned>(sizeof(HVACData)), samplesScanned * 1000.0 / aosNs,
+             static_cast<unsigned>(CompactSampleStore::BYTES_PER_SAMPLE), samplesScanned * 1000.0 / compactNs);
+    // Reported only; wall-clock timings are too noisy to assert on in CI.
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(16, CompactSampleStore::BYTES_PER_SAMPLE);
+    TEST_ASSERT_TRUE(sizeof(CompactSampleStore) < SAMPLE_HISTORY_SIZE * sizeof(HVACData) / 4);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_store_round_trips_samples);
+    RUN_TEST(test_store_overwrites_oldest_when_full);
+    RUN_TEST(test_store_skips_uninitialized_samples);
+    RUN_TEST(test_store_preserves_disconnected_sensor_and_clamps_out_of_range);
+    RUN_TEST(test_checkAlerts_on_store_matches_scan_of_original_samples);
+    RUN_TEST(test_buildHistoryJson_from_store_emits_most_recent_samples);
+    RUN_TEST(test_benchmark_compact_store_against_array_of_structs);
+    return UNITY_END();
+}
@@ -32,6 +32,8 @@ void test_load_parses_existing_file() {
     doc["lowDeltaTDurationS"] = 500;
     doc["noAirflowDurationS"] = 100;
     doc["tempSensorDisconnectedDurationS"] = 40;
+    doc["sensorReadIntervalMs"] = 15000;
+    doc["adcSamplesPerChannel"] = 250;
     std::string json_string;
     serializeJson(doc, json_string);
     mockFS.setFileContent("/config.json", json_string);
@@ -42,6 +44,20 @@ void test_load_parses_existing_file() {
     TEST_ASSERT_EQUAL_UINT(500, cm.getConfig().lowDeltaTDurationS);
     TEST_ASSERT_EQUAL_UINT(100, cm.getConfig().noAirflowDurationS);
     TEST_ASSERT_EQUAL_UINT(40, cm.getConfig().tempSensorDisconnectedDurationS);
+    TEST_ASSERT_EQUAL_UINT32(15000, cm.getConfig().sensorReadIntervalMs);
+    TEST_ASSERT_EQUAL_UINT(250, cm.getConfig().adcSamplesPerChannel);
+}
+
+void test_load_defaults_sampling_settings_missing_from_older_files() {
+    MockFileSystem mockFS;
+    ConfigManager cm(mockFS);
+    mockFS.setFileContent("/config.json", "{\"lowDeltaTThreshold\":3.5}");
+
+    cm.load();
+
+    TEST_ASSERT_EQUAL_FLOAT(3.5f, cm.getConfig().lowDeltaTThreshold);
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_READ_INTERVAL_MS, cm.getConfig().sensorReadIntervalMs);
+    TEST_ASSERT_EQUAL_UINT(ADC_SAMPLES_PER_CHANNEL, cm.getConfig().adcSamplesPerChannel);
 }
 
 void test_save_writes_correct_json() {
@@ -74,6 +90,7 @@ int main(int argc, char **argv) {
     UNITY_BEGIN();
     RUN_TEST(test_load_creates_default_file_if_not_exists);
     RUN_TEST(test_load_parses_existing_file);
+    RUN_TEST(test_load_defaults_sampling_settings_missing_from_older_files);
     RUN_TEST(test_save_writes_correct_json);
     RUN_TEST(test_remove_deletes_file);
     return UNITY_END();
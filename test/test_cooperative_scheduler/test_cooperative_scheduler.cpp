@@ -0,0 +1,320 @@
+#include <unity.h>
+#include "concurrency/cooperative_scheduler.h"
+#include "mocks/MockClock.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_periodic_task_first_runs_one_period_after_registration() {
+    MockClock clock;
+    clock.setMs(500);
+    CooperativeScheduler scheduler(clock);
+    int runs = 0;
+    CooperativeScheduler::TaskId id = scheduler.addPeriodic("tick", 1000, 0, [&]() { runs++; });
+    TEST_ASSERT_EQUAL(0, id);
+
+    TEST_ASSERT_EQUAL(0, scheduler.runDue());
+    clock.setMs(1499);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(0, runs);
+    clock.setMs(1500);
+    TEST_ASSERT_EQUAL(1, scheduler.runDue());
+    scheduler.runDue(); // Not due again until the next period
+    TEST_ASSERT_EQUAL(1, runs);
+
+    // A late start does not shift the cadence.
+    clock.setMs(2700);
+    scheduler.runDue();
+    clock.setMs(3499);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(2, runs);
+    clock.setMs(3500);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(3, runs);
+    TEST_ASSERT_EQUAL(200, scheduler.stats(id).maxLatenessMs);
+    TEST_ASSERT_EQUAL(0, scheduler.stats(id).missedDeadlines);
+}
+
+void test_due_tasks_run_by_priority_then_registration_order() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    std::string order;
+    scheduler.addPeriodic("low", 100, 0, [&]() { order += "L"; });
+    scheduler.addPeriodic("high-a", 100, 2, [&]() { order += "A"; });
+    scheduler.addPeriodic("mid", 100, 1, [&]() { order += "M"; });
+    scheduler.addPeriodic("high-b", 100, 2, [&]() { order += "B"; });
+
+    clock.setMs(100);
+    TEST_ASSERT_EQUAL(4, scheduler.runDue());
+    TEST_ASSERT_EQUAL_STRING("ABML", order.c_str());
+}
+
+void test_zero_period_task_runs_on_every_pass() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    int every = 0;
+    int slow = 0;
+    scheduler.addPeriodic("every", 0, 0, [&]() { every++; });
+    scheduler.addPeriodic("slow", 1000, 0, [&]() { slow++; });
+
+    for (int i = 0; i < 5; i++) {
+        scheduler.runDue();
+    }
+    TEST_ASSERT_EQUAL(5, every);
+    TEST_ASSERT_EQUAL(0, slow);
+    TEST_ASSERT_EQUAL(0, scheduler.msUntilNextDue());
+}
+
+void test_one_shot_runs_once_and_frees_its_slot() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    int runs = 0;
+    CooperativeScheduler::TaskId once = scheduler.addOneShot("once", 250, 0, [&]() { runs++; });
+    scheduler.addPeriodic("other", 1000, 0, []() {});
+
+    clock.setMs(250);
+    scheduler.runDue();
+    clock.setMs(5000);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(1, runs);
+    TEST_ASSERT_FALSE(scheduler.isActive(once));
+
+    // The freed slot is taken before a new one.
+    CooperativeScheduler::TaskId next = scheduler.addOneShot("next", 0, 0, []() {});
+    TEST_ASSERT_EQUAL(once, next);
+    TEST_ASSERT_EQUAL(2, scheduler.taskSlots());
+    TEST_ASSERT_EQUAL_STRING("next", scheduler.name(next));
+}
+
+void test_late_periodic_task_skips_missed_runs() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    int runs = 0;
+    CooperativeScheduler::TaskId id = scheduler.addPeriodic("tick", 100, 0, [&]() { runs++; });
+
+    // Due at 100; stalled until 450, so 200, 300 and 400 went by.
+    clock.setMs(450);
+    scheduler.runDue();
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(1, runs);
+    TEST_ASSERT_EQUAL(3, scheduler.stats(id).missedDeadlines);
+    TEST_ASSERT_EQUAL(350, scheduler.stats(id).maxLatenessMs);
+
+    clock.setMs(499);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(1, runs);
+    clock.setMs(500);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(2, runs);
+}
+
+void test_run_time_and_overruns_are_recorded() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    uint32_t costUs = 300;
+    CooperativeScheduler::TaskId quick = scheduler.addPeriodic("quick", 10, 0, [&]() { clock.advanceUs(costUs); });
+    CooperativeScheduler::TaskId every = scheduler.addPeriodic("every", 0, 0, [&]() { clock.advanceUs(50000); });
+
+    clock.setMs(10);
+    scheduler.runDue();
+    clock.setMs(20);
+    costUs = 12000; // Longer than the 10 ms period
+    scheduler.runDue();
+
+    const CooperativeScheduler::TaskStats& stats = scheduler.stats(quick);
+    TEST_ASSERT_EQUAL(2, stats.runs);
+    TEST_ASSERT_EQUAL(12000, stats.lastRunUs);
+    TEST_ASSERT_EQUAL(12000, stats.maxRunUs);
+    TEST_ASSERT_EQUAL(6150, stats.meanRunUs());
+    TEST_ASSERT_EQUAL(1, stats.overruns);
+
+    // A task without a period cannot overrun it.
+    TEST_ASSERT_EQUAL(2, scheduler.stats(every).runs);
+    TEST_ASSERT_EQUAL(0, scheduler.stats(every).overruns);
+
+    scheduler.resetStats();
+    TEST_ASSERT_EQUAL(0, scheduler.stats(quick).runs);
+    TEST_ASSERT_EQUAL(0, scheduler.stats(quick).maxRunUs);
+}
+
+void test_trigger_and_cancel() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    int runs = 0;
+    int selfRuns = 0;
+    CooperativeScheduler::TaskId id = scheduler.addPeriodic("tick", 1000, 0, [&]() { runs++; });
+    CooperativeScheduler::TaskId self = CooperativeScheduler::INVALID_TASK;
+    self = scheduler.addPeriodic("self", 0, 0, [&]() {
+        selfRuns++;
+        scheduler.cancel(self);
+    });
+
+    scheduler.trigger(id);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(1, runs);
+    TEST_ASSERT_EQUAL(1, selfRuns);
+    TEST_ASSERT_FALSE(scheduler.isActive(self));
+
+    // Triggering does not move the following run later.
+    clock.setMs(1000);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(2, runs);
+
+    scheduler.cancel(id);
+    clock.setMs(5000);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(2, runs);
+    TEST_ASSERT_EQUAL(1, selfRuns);
+    scheduler.trigger(id); // Ignored once cancelled
+    TEST_ASSERT_EQUAL(0, scheduler.runDue());
+}
+
+void test_task_cancelled_by_an_earlier_task_does_not_run() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    int runs = 0;
+    CooperativeScheduler::TaskId victim = CooperativeScheduler::INVALID_TASK;
+    scheduler.addPeriodic("first", 100, 1, [&]() { scheduler.cancel(victim); });
+    victim = scheduler.addPeriodic("second", 100, 0, [&]() { runs++; });
+
+    clock.setMs(100);
+    TEST_ASSERT_EQUAL(1, scheduler.runDue());
+    TEST_ASSERT_EQUAL(0, runs);
+}
+
+void test_setPeriod_takes_effect_from_the_next_due_time() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    int runs = 0;
+    CooperativeScheduler::TaskId id = scheduler.addPeriodic("tick", 1000, 0, [&]() { runs++; });
+
+    scheduler.setPeriod(id, 200);
+    TEST_ASSERT_EQUAL(200, scheduler.period(id));
+    clock.setMs(999);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(0, runs);
+    clock.setMs(1000);
+    scheduler.runDue();
+    clock.setMs(1200);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(2, runs);
+}
+
+void test_msUntilNextDue_reports_the_soonest_task() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    TEST_ASSERT_EQUAL(0, scheduler.msUntilNextDue());
+
+    scheduler.addPeriodic("slow", 1000, 0, []() {});
+    CooperativeScheduler::TaskId fast = scheduler.addPeriodic("fast", 300, 0, []() {});
+    clock.setMs(100);
+    TEST_ASSERT_EQUAL(200, scheduler.msUntilNextDue());
+    scheduler.cancel(fast);
+    TEST_ASSERT_EQUAL(900, scheduler.msUntilNextDue());
+    clock.setMs(1000);
+    TEST_ASSERT_EQUAL(0, scheduler.msUntilNextDue());
+}
+
+void test_due_times_survive_the_clock_wrapping() {
+    MockClock clock;
+    clock.setMs(0xFFFFFF00u);
+    CooperativeScheduler scheduler(clock);
+    int runs = 0;
+    scheduler.addPeriodic("tick", 0x200, 0, [&]() { runs++; });
+
+    clock.setMs(0xFFFFFFF0u);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(0, runs);
+    clock.micros = static_cast<uint64_t>(0x100) * 1000; // 0xFFFFFF00 + 0x200, wrapped
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(1, runs);
+}
+
+void test_registration_fails_when_every_slot_is_taken() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    for (size_t i = 0; i < CooperativeScheduler::MAX_TASKS; i++) {
+        TEST_ASSERT_NOT_EQUAL(CooperativeScheduler::INVALID_TASK, scheduler.addPeriodic("task", 100, 0, []() {}));
+    }
+    TEST_ASSERT_EQUAL(CooperativeScheduler::INVALID_TASK, scheduler.addOneShot("extra", 0, 0, []() {}));
+    TEST_ASSERT_FALSE(scheduler.isActive(CooperativeScheduler::INVALID_TASK));
+    TEST_ASSERT_EQUAL(0, scheduler.stats(CooperativeScheduler::INVALID_TASK).runs);
+
+    scheduler.cancel(3);
+    TEST_ASSERT_EQUAL(3, scheduler.addOneShot("extra", 0, 0, []() {}));
+}
+
+void test_snapshot_copies_the_active_tasks() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    scheduler.addPeriodic("first", 10, 0, [&]() { clock.advanceUs(200); });
+    CooperativeScheduler::TaskId gone = scheduler.addPeriodic("gone", 10, 0, []() {});
+    scheduler.addPeriodic("last", 10, 0, []() {});
+    clock.setMs(10);
+    scheduler.runDue();
+    scheduler.cancel(gone);
+
+    CooperativeScheduler::TaskSnapshot tasks[CooperativeScheduler::MAX_TASKS];
+    TEST_ASSERT_EQUAL(2, scheduler.snapshot(tasks, CooperativeScheduler::MAX_TASKS));
+    TEST_ASSERT_EQUAL_STRING("first", tasks[0].name);
+    TEST_ASSERT_EQUAL(1, tasks[0].stats.runs);
+    TEST_ASSERT_EQUAL(200, tasks[0].stats.maxRunUs);
+    TEST_ASSERT_EQUAL_STRING("last", tasks[1].name);
+
+    // The copy does not follow later runs.
+    clock.setMs(20);
+    scheduler.runDue();
+    TEST_ASSERT_EQUAL(1, tasks[0].stats.runs);
+
+    TEST_ASSERT_EQUAL(1, scheduler.snapshot(tasks, 1));
+    TEST_ASSERT_EQUAL_STRING("first", tasks[0].name);
+}
+
+void test_snapshot_from_another_thread_sees_whole_runs() {
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    const uint32_t costUs = 100;
+    scheduler.addPeriodic("busy", 0, 0, [&]() { clock.advanceUs(costUs); });
+
+    std::atomic<bool> done(false);
+    bool consistent = true;
+    std::thread reader([&]() {
+        CooperativeScheduler::TaskSnapshot tasks[CooperativeScheduler::MAX_TASKS];
+        while (!done) {
+            if (scheduler.snapshot(tasks, CooperativeScheduler::MAX_TASKS) == 1 &&
+                tasks[0].stats.totalRunUs != static_cast<uint64_t>(tasks[0].stats.runs) * costUs) {
+                consistent = false;
+            }
+        }
+    });
+    for (int pass = 0; pass < 20000; pass++) {
+        scheduler.runDue();
+    }
+    done = true;
+    reader.join();
+
+    TEST_ASSERT_TRUE(consistent);
+    TEST_ASSERT_EQUAL(20000, scheduler.stats(0).runs);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_periodic_task_first_runs_one_period_after_registration);
+    RUN_TEST(test_due_tasks_run_by_priority_then_registration_order);
+    RUN_TEST(test_zero_period_task_runs_on_every_pass);
+    RUN_TEST(test_one_shot_runs_once_and_frees_its_slot);
+    RUN_TEST(test_late_periodic_task_skips_missed_runs);
+    RUN_TEST(test_run_time_and_overruns_are_recorded);
+    RUN_TEST(test_trigger_and_cancel);
+    RUN_TEST(test_task_cancelled_by_an_earlier_task_does_not_run);
+    RUN_TEST(test_setPeriod_takes_effect_from_the_next_due_time);
+    RUN_TEST(test_msUntilNextDue_reports_the_soonest_task);
+    RUN_TEST(test_due_times_survive_the_clock_wrapping);
+    RUN_TEST(test_registration_fails_when_every_slot_is_taken);
+    RUN_TEST(test_snapshot_copies_the_active_tasks);
+    RUN_TEST(test_snapshot_from_another_thread_sees_whole_runs);
+    return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <unity.h>
+#include "adapters/multi_channel_current_sampler.h"
+#include "interfaces/i_adc_sample_source.h"
+#include <cmath>
+#include <vector>
+
+const int FAN_PIN = 34;
+const int COMPRESSOR_PIN = 35;
+const int PUMPS_PIN = 32;
+const double CALIBRATION = 60.606;
+const double PI_VALUE = 3.14159265358979323846;
+
+// Generates a 60 Hz sine wave per pin. Every readSample() call advances time by
+// one ADC conversion, so interleaved reads see time-aligned waveforms.
+class SineWaveSampleSource : public IAdcSampleSource {
+public:
+    double fanAmplitude = 0.0;
+    double compressorAmplitude = 0.0;
+    double pumpsAmplitude = 0.0;
+    double dcOffset = 512.0;
+    double sampleIntervalS = 20e-6;
+    std::vector<int> pinsRead;
+
+    int readSample(int pin) override {
+        pinsRead.push_back(pin);
+        double t = _reads++ * sampleIntervalS;
+        double amplitude = (pin == FAN_PIN) ? fanAmplitude : (pin == COMPRESSOR_PIN) ? compressorAmplitude : pumpsAmplitude;
+        return static_cast<int>(std::lround(dcOffset + amplitude * std::sin(2.0 * PI_VALUE * 60.0 * t)));
+    }
+
+private:
+    unsigned long _reads = 0;
+};
+
+// The RMS current EmonLib's scaling reports for a sine of the given amplitude in ADC counts.
+double expectedIrms(double amplitudeCounts) {
+    double ratio = CALIBRATION * (MultiChannelCurrentSampler::DEFAULT_SUPPLY_VOLTAGE / MultiChannelCurrentSampler::DEFAULT_ADC_COUNTS);
+    return ratio * amplitudeCounts / std::sqrt(2.0);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_calcIrms_measures_each_channel_in_one_pass() {
+    // Arrange
+    SineWaveSampleSource source;
+    source.fanAmplitude = 100.0;
+    source.compressorAmplitude = 300.0;
+    source.pumpsAmplitude = 0.0;
+    MultiChannelCurrentSampler sampler(source, FAN_PIN, COMPRESSOR_PIN, PUMPS_PIN, CALIBRATION);
+    double irms[CURRENT_CHANNEL_COUNT];
+
+    // Act: 500 samples per channel at 60 us per round covers whole mains cycles
+    sampler.calcIrms(500, irms);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(expectedIrms(100.0) * 0.02, expectedIrms(100.0), irms[FAN_CURRENT_CHANNEL]);
+    TEST_ASSERT_FLOAT_WITHIN(expectedIrms(300.0) * 0.02, expectedIrms(300.0), irms[COMPRESSOR_CURRENT_CHANNEL]);
+    TEST_ASSERT_FLOAT_WITHIN(0.1, 0.0, irms[PUMPS_CURRENT_CHANNEL]);
+    TEST_ASSERT_EQUAL(500 * CURRENT_CHANNEL_COUNT, source.pinsRead.size());
+}
+
+void test_calcIrms_reads_pins_round_robin() {
+    SineWaveSampleSource source;
+    MultiChannelCurrentSampler sampler(source, FAN_PIN, COMPRESSOR_PIN, PUMPS_PIN, CALIBRATION);
+    double irms[CURRENT_CHANNEL_COUNT];
+
+    sampler.calcIrms(4, irms);
+
+    TEST_ASSERT_EQUAL(12, source.pinsRead.size());
+    for (size_t i = 0; i < source.pinsRead.size(); i += CURRENT_CHANNEL_COUNT) {
+        TEST_ASSERT_EQUAL(FAN_PIN, source.pinsRead[i]);
+        TEST_ASSERT_EQUAL(COMPRESSOR_PIN, source.pinsRead[i + 1]);
+        TEST_ASSERT_EQUAL(PUMPS_PIN, source.pinsRead[i + 2]);
+    }
+}
+
+void test_calcIrms_offset_filter_tracks_dc_bias() {
+    // Arrange: the bias is well away from the filter's mid-scale starting point
+    SineWaveSampleSource source;
+    source.fanAmplitude = 200.0;
+    source.dcOffset = 620.0;
+    MultiChannelCurrentSampler sampler(source, FAN_PIN, COMPRESSOR_PIN, PUMPS_PIN, CALIBRATION);
+    double irms[CURRENT_CHANNEL_COUNT];
+
+    // Act: the filter state carries over between passes, like EmonLib's offsetI
+    for (int pass = 0; pass < 20; pass++) {
+        sampler.calcIrms(500, irms);
+    }
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(expectedIrms(200.0) * 0.02, expectedIrms(200.0), irms[FAN_CURRENT_CHANNEL]);
+    TEST_ASSERT_FLOAT_WITHIN(0.1, 0.0, irms[COMPRESSOR_CURRENT_CHANNEL]);
+}
+
+void test_channel_view_samples_only_its_own_pin() {
+    SineWaveSampleSource source;
+    source.compressorAmplitude = 150.0;
+    MultiChannelCurrentSampler sampler(source, FAN_PIN, COMPRESSOR_PIN, PUMPS_PIN, CALIBRATION);
+
+    double amps = sampler.channel(COMPRESSOR_CURRENT_CHANNEL).calcIrms(1500);
+
+    TEST_ASSERT_FLOAT_WITHIN(expectedIrms(150.0) * 0.02, expectedIrms(150.0), amps);
+    for (int pin : source.pinsRead) {
+        TEST_ASSERT_EQUAL(COMPRESSOR_PIN, pin);
+    }
+}
+
+void test_calcIrms_with_zero_samples_returns_zero() {
+    SineWaveSampleSource source;
+    source.fanAmplitude = 100.0;
+    MultiChannelCurrentSampler sampler(source, FAN_PIN, COMPRESSOR_PIN, PUMPS_PIN, CALIBRATION);
+    double irms[CURRENT_CHANNEL_COUNT] = {1.0, 1.0, 1.0};
+
+    sampler.calcIrms(0, irms);
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0, irms[FAN_CURRENT_CHANNEL]);
+    TEST_ASSERT_EQUAL(0, source.pinsRead.size());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_calcIrms_measures_each_channel_in_one_pass);
+    RUN_TEST(test_calcIrms_reads_pins_round_robin);
+    RUN_TEST(test_calcIrms_offset_filter_tracks_dc_bias);
+    RUN_TEST(test_channel_view_samples_only_its_own_pin);
+    RUN_TEST(test_calcIrms_with_zero_samples_returns_zero);
+    return UNITY_END();
+}
@@ -4,6 +4,9 @@
 #include "config.h" // For device addresses
 #include "interfaces/i_temperature_sensor.h"
 #include "interfaces/i_current_sensor.h"
+#include "interfaces/i_multi_channel_current_sensor.h"
+#include "metrics/stage_metrics.h"
+#include "mocks/Arduino.h"
 
 // --- Mocks for Dependencies ---
 
@@ -12,12 +15,28 @@ public:
     float returnTemp = 0.0f;
     float supplyTemp = 0.0f;
     bool requestTemperaturesCalled = false;
+    bool startConversionCalled = false;
+    int notReadyPolls = 0; // Number of polls that report "not ready" before completing
+    int getTempCCalls = 0;
 
     void requestTemperatures() override {
         requestTemperaturesCalled = true;
     }
 
+    void startConversion() override {
+        startConversionCalled = true;
+    }
+
+    bool isConversionComplete() override {
+        if (notReadyPolls > 0) {
+            notReadyPolls--;
+            return false;
+        }
+        return true;
+    }
+
     float getTempC(const DeviceAddress& deviceAddress) override {
+        getTempCCalls++;
         // A simple way to distinguish between the two sensors for the mock
         // In a real scenario, we might compare the full address.
         if (deviceAddress[7] == returnAirSensorAddress[7]) {
@@ -33,12 +52,36 @@ public:
 class MockCurrentSensor : public ICurrentSensor {
 public:
     double amps = 0.0;
+    int calcIrmsCalls = 0;
 
     double calcIrms(unsigned int samples) override {
+        calcIrmsCalls++;
         return amps;
     }
 };
 
+// Delegates each channel to its single-channel mock so tests can keep setting
+// per-component amps.
+class MockCurrentSampler : public IMultiChannelCurrentSensor {
+public:
+    MockCurrentSampler(MockCurrentSensor& fan, MockCurrentSensor& compressor, MockCurrentSensor& pumps)
+        : _channels{&fan, &compressor, &pumps} {}
+
+    unsigned int lastSamples = 0;
+    unsigned long durationMs = 0; // How far the mock clock moves per call
+
+    void calcIrms(unsigned int samples, double (&irms)[CURRENT_CHANNEL_COUNT]) override {
+        lastSamples = samples;
+        set_mock_millis(millis() + durationMs);
+        for (size_t ch = 0; ch < CURRENT_CHANNEL_COUNT; ch++) {
+            irms[ch] = _channels[ch]->calcIrms(samples);
+        }
+    }
+
+private:
+    MockCurrentSensor* _channels[CURRENT_CHANNEL_COUNT];
+};
+
 // --- Test Suite ---
 
 class MockHardwareManager : public IHardwareManager {
@@ -47,6 +90,7 @@ public:
     MockCurrentSensor mockFanSensor;
     MockCurrentSensor mockCompressorSensor;
     MockCurrentSensor mockPumpsSensor;
+    MockCurrentSampler mockCurrentSampler{mockFanSensor, mockCompressorSensor, mockPumpsSensor};
 
     void setup() override {}
 
@@ -54,9 +98,12 @@ public:
     ICurrentSensor& getFanAdapter() override { return mockFanSensor; }
     ICurrentSensor& getCompressorAdapter() override { return mockCompressorSensor; }
     ICurrentSensor& getPumpsAdapter() override { return mockPumpsSensor; }
+    IMultiChannelCurrentSensor& getCurrentSampler() override { return mockCurrentSampler; }
 };
 
-void setUp(void) {}
+void setUp(void) {
+    set_mock_millis(0);
+}
 
 void tearDown(void) {}
 
@@ -129,11 +176,130 @@ void test_readAndProcessData_sets_isInitialized_flag() {
     TEST_ASSERT_TRUE(data.isInitialized);
 }
 
+void test_startReadCycle_samples_currents_without_reading_temperatures() {
+    // Arrange
+    MockHardwareManager mockHardwareManager;
+    DataManager dataManager(mockHardwareManager, returnAirSensorAddress, supplyAirSensorAddress);
+    HVACData data;
+    mockHardwareManager.mockFanSensor.amps = 1.0;
+
+    // Act
+    dataManager.startReadCycle(data, 1, 0.5f);
+
+    // Assert
+    TEST_ASSERT_TRUE(mockHardwareManager.mockTempSensor.startConversionCalled);
+    TEST_ASSERT_FALSE(mockHardwareManager.mockTempSensor.requestTemperaturesCalled);
+    TEST_ASSERT_EQUAL(0, mockHardwareManager.mockTempSensor.getTempCCalls);
+    TEST_ASSERT_EQUAL(1, mockHardwareManager.mockFanSensor.calcIrmsCalls);
+    TEST_ASSERT_EQUAL(ComponentStatus::ON, data.fanStatus);
+    TEST_ASSERT_TRUE(dataManager.isReadInProgress());
+    TEST_ASSERT_FALSE(data.isInitialized);
+}
+
+void test_pollReadCycle_waits_until_conversion_is_complete() {
+    // Arrange
+    MockHardwareManager mockHardwareManager;
+    DataManager dataManager(mockHardwareManager, returnAirSensorAddress, supplyAirSensorAddress);
+    HVACData data;
+    mockHardwareManager.mockTempSensor.returnTemp = 25.0f;
+    mockHardwareManager.mockTempSensor.supplyTemp = 20.0f;
+    mockHardwareManager.mockTempSensor.notReadyPolls = 3;
+    dataManager.startReadCycle(data, 1, 0.5f);
+
+    // Act & Assert: the first three polls report "not ready"
+    for (int i = 0; i < 3; i++) {
+        set_mock_millis(100 * (i + 1));
+        TEST_ASSERT_FALSE(dataManager.pollReadCycle(data));
+        TEST_ASSERT_TRUE(dataManager.isReadInProgress());
+    }
+    TEST_ASSERT_EQUAL(0, mockHardwareManager.mockTempSensor.getTempCCalls);
+
+    TEST_ASSERT_TRUE(dataManager.pollReadCycle(data));
+    TEST_ASSERT_FALSE(dataManager.isReadInProgress());
+    TEST_ASSERT_TRUE(data.isInitialized);
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, data.deltaT);
+    TEST_ASSERT_EQUAL(1, mockHardwareManager.mockFanSensor.calcIrmsCalls); // CTs are not resampled
+}
+
+void test_pollReadCycle_reads_temperatures_after_timeout() {
+    // Arrange
+    MockHardwareManager mockHardwareManager;
+    DataManager dataManager(mockHardwareManager, returnAirSensorAddress, supplyAirSensorAddress);
+    HVACData data;
+    mockHardwareManager.mockTempSensor.notReadyPolls = 1000; // Never becomes ready in practice
+    dataManager.startReadCycle(data, 1, 0.5f);
+
+    // Act & Assert
+    set_mock_millis(TEMP_CONVERSION_TIMEOUT_MS - 1);
+    TEST_ASSERT_FALSE(dataManager.pollReadCycle(data));
+
+    set_mock_millis(TEMP_CONVERSION_TIMEOUT_MS);
+    TEST_ASSERT_TRUE(dataManager.pollReadCycle(data));
+    TEST_ASSERT_TRUE(data.isInitialized);
+    TEST_ASSERT_EQUAL_UINT32(TEMP_CONVERSION_TIMEOUT_MS, data.timestamp); // Stamped when the read completes
+}
+
+void test_pollReadCycle_returns_false_when_no_cycle_is_running() {
+    // Arrange
+    MockHardwareManager mockHardwareManager;
+    DataManager dataManager(mockHardwareManager, returnAirSensorAddress, supplyAirSensorAddress);
+    HVACData data;
+
+    // Act & Assert
+    TEST_ASSERT_FALSE(dataManager.pollReadCycle(data));
+    TEST_ASSERT_EQUAL(0, mockHardwareManager.mockTempSensor.getTempCCalls);
+
+    dataManager.startReadCycle(data, 1, 0.5f);
+    TEST_ASSERT_TRUE(dataManager.pollReadCycle(data));
+    TEST_ASSERT_FALSE(dataManager.pollReadCycle(data)); // Already collected
+}
+
+void test_readAndProcessData_splits_sample_budget_across_channels() {
+    // Arrange
+    MockHardwareManager mockHardwareManager;
+    DataManager dataManager(mockHardwareManager, returnAirSensorAddress, supplyAirSensorAddress);
+    HVACData data;
+
+    // Act
+    dataManager.readAndProcessData(data, 1480, 0.5f);
+
+    // Assert
+    TEST_ASSERT_EQUAL_UINT(1480 / CURRENT_CHANNEL_COUNT, mockHardwareManager.mockCurrentSampler.lastSamples);
+}
+
+void test_read_cycle_is_timed_once_without_the_conversion_wait() {
+    // Arrange
+    MockHardwareManager mockHardwareManager;
+    DataManager dataManager(mockHardwareManager, returnAirSensorAddress, supplyAirSensorAddress);
+    HVACData data;
+    mockHardwareManager.mockCurrentSampler.durationMs = 200;
+    mockHardwareManager.mockTempSensor.notReadyPolls = 1;
+    stageMetrics().reset();
+
+    // Act
+    dataManager.startReadCycle(data, 1, 0.5f);
+    set_mock_millis(700);
+    dataManager.pollReadCycle(data);
+    set_mock_millis(800);
+    TEST_ASSERT_TRUE(dataManager.pollReadCycle(data));
+
+    // Assert: one run, covering the CT sampling but not the 600 ms in between
+    StageStats stats = stageMetrics().snapshot(MetricStage::SENSOR_READ);
+    TEST_ASSERT_EQUAL(STAGE_METRICS_ENABLED ? 1 : 0, stats.count);
+    TEST_ASSERT_EQUAL(STAGE_METRICS_ENABLED ? 200000 : 0, stats.maxUs);
+}
+
 int main(int argc, char **argv) {
     UNITY_BEGIN();
     RUN_TEST(test_readAndProcessData_calculates_deltaT_correctly);
     RUN_TEST(test_readAndProcessData_sets_component_status_correctly);
     RUN_TEST(test_readAndProcessData_handles_disconnected_sensor);
     RUN_TEST(test_readAndProcessData_sets_isInitialized_flag);
+    RUN_TEST(test_startReadCycle_samples_currents_without_reading_temperatures);
+    RUN_TEST(test_pollReadCycle_waits_until_conversion_is_complete);
+    RUN_TEST(test_pollReadCycle_reads_temperatures_after_timeout);
+    RUN_TEST(test_pollReadCycle_returns_false_when_no_cycle_is_running);
+    RUN_TEST(test_readAndProcessData_splits_sample_budget_across_channels);
+    RUN_TEST(test_read_cycle_is_timed_once_without_the_conversion_wait);
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include <unity.h>
+#include "config.h"
+#include "hvac_data.h"
+#include "state/CompactSampleStore.h"
+#include "logic/json_builder.h"
+#include "logic/json_writer.h"
+#include "logic/history_json_streamer.h"
+#include <ArduinoJson.h>
+#include <cmath>
+#include <memory>
+#include <string>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Deliberately off the 0.01 grid and spread over a wide range so the decoded
+// floats exercise the number formatting.
+HVACData make_sample(int i) {
+    HVACData data;
+    data.isInitialized = true;
+    data.timestamp = 5000u * (i + 1);
+    data.returnTempC = (i % 13 == 0) ? -127.0f : 15.0f + (i % 97) * 0.137f;
+    data.supplyTempC = -3.3f + (i % 31) * 1.013f;
+    data.deltaT = data.returnTempC - data.supplyTempC;
+    data.fanAmps = (i % 3) * 0.3333;
+    data.compressorAmps = (i % 4 == 0) ? 0.0 : 12.345 + i * 0.01;
+    data.geoPumpsAmps = (i % 7 == 0) ? 400.0 : 3.757;
+    data.fanStatus = (i % 2 == 0) ? ComponentStatus::ON : ComponentStatus::OFF;
+    data.compressorStatus = (i % 4 == 0) ? ComponentStatus::OFF : ComponentStatus::ON;
+    data.geoPumpsStatus = (i % 5 == 0) ? ComponentStatus::UNKNOWN : ComponentStatus::ON;
+    data.airflowStatus = (i % 3 == 0) ? AirflowStatus::NA : AirflowStatus::OK;
+    data.alertStatus = static_cast<AlertStatus>(i % 4);
+    return data;
+}
+
+std::string expected_history(const CompactSampleStore& store, size_t maxSamples) {
+    JsonDocument doc;
+    JsonArray history = doc.to<JsonArray>();
+    JsonBuilder::buildHistoryJson(history, store, maxSamples);
+    std::string json;
+    serializeJson(doc, json);
+    return json;
+}
+
+std::string stream_history(HistoryJsonStreamer& streamer, size_t chunkSize) {
+    std::string json;
+    std::unique_ptr<uint8_t[]> chunk(new uint8_t[chunkSize]);
+    size_t n;
+    while ((n = streamer.fill(chunk.get(), chunkSize)) > 0) {
+        TEST_ASSERT_TRUE(n <= chunkSize);
+        json.append(reinterpret_cast<const char*>(chunk.get()), n);
+    }
+    return json;
+}
+
+void test_streamer_matches_buildHistoryJson() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    for (int i = 0; i < 150; i++) {
+        store->push(make_sample(i));
+    }
+
+    HistoryJsonStreamer streamer(*store, DATA_BUFFER_SIZE);
+    std::string actual = stream_history(streamer, 1460);
+    std::string expected = expected_history(*store, DATA_BUFFER_SIZE);
+
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+    TEST_ASSERT_TRUE(streamer.done());
+    TEST_ASSERT_EQUAL_UINT32(DATA_BUFFER_SIZE, streamer.samplesWritten());
+}
+
+void test_streamer_output_does_not_depend_on_chunk_size() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    // Wrap the store so the range starts in the middle of the ring.
+    for (int i = 0; i < static_cast<int>(CompactSampleStore::CAPACITY) + 37; i++) {
+        store->push(make_sample(i));
+    }
+
+    const std::string expected = expected_history(*store, 40);
+    const size_t chunkSizes[] = {1, 2, 7, 64, HistoryJsonStreamer::SCRATCH_SIZE + 1};
+    for (size_t chunkSize : chunkSizes) {
+        HistoryJsonStreamer streamer(*store, 40);
+        std::string actual = stream_history(streamer, chunkSize);
+        TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+    }
+}
+
+void test_streamer_emits_empty_array_for_empty_store() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    HistoryJsonStreamer streamer(*store, DATA_BUFFER_SIZE);
+
+    std::string actual = stream_history(streamer, 64);
+    TEST_ASSERT_EQUAL_STRING("[]", actual.c_str());
+    std::string expected = expected_history(*store, DATA_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, streamer.fill(nullptr, 0));
+}
+
+void test_streamer_skips_samples_evicted_mid_stream() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    const int total = static_cast<int>(CompactSampleStore::CAPACITY);
+    for (int i = 0; i < total; i++) {
+        store->push(make_sample(i));
+    }
+
+    // Send the whole store, but let the producer overwrite the oldest 100
+    // samples after the first chunk has gone out.
+    HistoryJsonStreamer streamer(*store, CompactSampleStore::CAPACITY);
+    uint8_t chunk[256];
+    std::string actual(reinterpret_cast<const char*>(chunk), streamer.fill(chunk, sizeof(chunk)));
+    for (int i = total; i < total + 100; i++) {
+        store->push(make_sample(i));
+    }
+    actual += stream_history(streamer, sizeof(chunk));
+
+    TEST_ASSERT_TRUE(streamer.samplesSkipped() > 0);
+    TEST_ASSERT_EQUAL_UINT32(CompactSampleStore::CAPACITY, streamer.samplesWritten() + streamer.samplesSkipped());
+
+    // Still a well-formed array, ending with the last sample that existed
+    // when the request arrived.
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, actual.c_str()));
+    JsonArray history = doc.as<JsonArray>();
+    TEST_ASSERT_EQUAL(streamer.samplesWritten(), history.size());
+    HVACData last = make_sample(total - 1);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, last.supplyTempC, history[history.size() - 1]["supplyTempC"].as<float>());
+}
+
+void test_streamer_stops_cleanly_when_store_is_cleared() {
+    std::unique_ptr<CompactSampleStore> store(new CompactSampleStore());
+    for (int i = 0; i < 10; i++) {
+        store->push(make_sample(i));
+    }
+
+    HistoryJsonStreamer streamer(*store, DATA_BUFFER_SIZE);
+    uint8_t chunk[8];
+    std::string actual(reinterpret_cast<const char*>(chunk), streamer.fill(chunk, sizeof(chunk)));
+    store->clear();
+    actual += stream_history(streamer, sizeof(chunk));
+
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, actual.c_str()));
+    TEST_ASSERT_EQUAL(1, doc.as<JsonArray>().size()); // Only the sample already started
+    TEST_ASSERT_EQUAL_UINT32(9, streamer.samplesSkipped());
+}
+
+void test_json_writer_formats_numbers_like_arduinojson() {
+    const double values[] = {0.0, -0.0, 1.0, -1.5, 0.1, 25.1f, -127.0f, 3.757, 123456.789, 9999999.0, 1e7, 12345678.9,
+                             1e-5, 2.5e-6, -4.2e-9, 1e300, 0.999999999, 4294967295.0, 6.02e23, NAN, INFINITY, -INFINITY};
+
+    JsonDocument doc;
+    JsonArray array = doc.to<JsonArray>();
+    char buffer[1024];
+    JsonWriter writer(buffer, sizeof(buffer));
+    writer.beginArray();
+    for (double value : values) {
+        array.add(value);
+        writer.value(value);
+    }
+    array.add(4294967295u);
+    writer.value(4294967295u);
+    array.add(-2147483647 - 1);
+    writer.value(-2147483647 - 1);
+    array.add(true);
+    writer.value(true);
+    array.add("quote\" slash\\ tab\t nl\n");
+    writer.value("quote\" slash\\ tab\t nl\n");
+    writer.endArray();
+
+    std::string expected;
+    serializeJson(doc, expected);
+    TEST_ASSERT_FALSE(writer.overflowed());
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), buffer);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), writer.size());
+}
+
+void test_json_writer_reports_overflow() {
+    char buffer[18];
+    JsonWriter writer(buffer, sizeof(buffer));
+    writer.beginObject();
+    writer.member("status", "NONE");
+    writer.endObject();
+    TEST_ASSERT_FALSE(writer.overflowed());
+    TEST_ASSERT_EQUAL_STRING("{\"status\":\"NONE\"}", buffer);
+    TEST_ASSERT_EQUAL_UINT32(17, writer.size()); // One byte kept for the terminator
+
+    writer.reset();
+    writer.beginObject();
+    writer.member("returnTempC", 21.5f);
+    writer.endObject();
+    TEST_ASSERT_TRUE(writer.overflowed());
+    TEST_ASSERT_TRUE(writer.size() < sizeof(buffer));
+    TEST_ASSERT_EQUAL('\0', buffer[writer.size()]);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_streamer_matches_buildHistoryJson);
+    RUN_TEST(test_streamer_output_does_not_depend_on_chunk_size);
+    RUN_TEST(test_streamer_emits_empty_array_for_empty_store);
+    RUN_TEST(test_streamer_skips_samples_evicted_mid_stream);
+    RUN_TEST(test_streamer_stops_cleanly_when_store_is_cleared);
+    RUN_TEST(test_json_writer_formats_numbers_like_arduinojson);
+    RUN_TEST(test_json_writer_reports_overflow);
+    return UNITY_END();
+}
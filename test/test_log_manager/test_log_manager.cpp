@@ -1,8 +1,20 @@
 #include <unity.h>
+// Pinned so the compile-time filtering test does not depend on build flags.
+#undef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
 #include "logging/log_manager.h"
+#include "logging/log_streamer.h"
 #include "mocks/MockFileSystem.h"
+#include "mocks/Arduino.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
 
-void setUp(void) {}
+void setUp(void) {
+    set_mock_millis(0);
+}
 
 void tearDown(void) {}
 
@@ -11,33 +23,47 @@ void test_log_writes_to_file() {
     LogManager lm(mockFS);
 
     lm.log("Test message %d", 123);
+    lm.flush();
 
     std::string content = mockFS.getFileContent("/system.log");
     TEST_ASSERT_TRUE(content.find("Test message 123") != std::string::npos);
     TEST_ASSERT_TRUE(content.find("[") == 0); // Starts with a timestamp
 }
 
-void test_getLogs_reads_file_content() {
+std::string read_logs(LogManager& lm) {
+    std::unique_ptr<LogStreamer> streamer = lm.streamLogs(0, LogStreamer::ALL_LINES);
+    std::string logs;
+    uint8_t chunk[64];
+    size_t n;
+    while ((n = streamer->fill(chunk, sizeof(chunk))) > 0) {
+        logs.append(reinterpret_cast<const char*>(chunk), n);
+    }
+    return logs;
+}
+
+void test_streamLogs_reads_file_content() {
     MockFileSystem mockFS;
     LogManager lm(mockFS);
     mockFS.setFileContent("/system.log", "Hello Log");
 
-    String logs = lm.getLogs();
+    std::string logs = read_logs(lm);
 
-    TEST_ASSERT_EQUAL_STRING("Hello Log", logs.c_str());
+    TEST_ASSERT_EQUAL_STRING("Hello Log\n", logs.c_str());
 }
 
 void test_clearLogs_removes_files() {
     MockFileSystem mockFS;
     LogManager lm(mockFS);
     mockFS.setFileContent("/system.log", "data");
-    mockFS.setFileContent("/system.log.old", "old_data");
+    mockFS.setFileContent("/system.log.1", "old_data");
+    mockFS.setFileContent("/system.log.3", "older_data");
 
     lm.clearLogs();
 
     // The clearLogs function also logs a message, so a new file is created.
     TEST_ASSERT_TRUE(mockFS.exists("/system.log"));
-    TEST_ASSERT_FALSE(mockFS.exists("/system.log.old"));
+    TEST_ASSERT_FALSE(mockFS.exists("/system.log.1"));
+    TEST_ASSERT_FALSE(mockFS.exists("/system.log.3"));
     TEST_ASSERT_TRUE(mockFS.getFileContent("/system.log").find("Logs cleared") != std::string::npos);
 }
 
@@ -45,17 +71,18 @@ void test_log_rotation_works_correctly() {
     MockFileSystem mockFS;
     LogManager lm(mockFS);
 
-    // Create a log content that is already over the max size to guarantee rotation.
-    // The check is `size > MAX_LOG_SIZE`, so we make it slightly larger.
-    std::string large_content(MAX_LOG_SIZE + 1, 'A');
+    // Create a log that is already at the size limit, so the next line cannot fit.
+    TEST_ASSERT_EQUAL(LOG_SIZE_BUDGET / (LOG_GENERATIONS + 1), lm.fileLimit());
+    std::string large_content(lm.fileLimit(), 'A');
     mockFS.setFileContent("/system.log", large_content);
 
-    // This log should trigger rotation
+    // Rotation is decided when the entry is flushed
     lm.log("This is the new log entry.");
+    lm.flush();
 
-    // Check that the old log file was created and has the old content
-    TEST_ASSERT_TRUE(mockFS.exists("/system.log.old"));
-    std::string old_content = mockFS.getFileContent("/system.log.old");
+    // Check that the archive was created and has the old content
+    TEST_ASSERT_TRUE(mockFS.exists("/system.log.1"));
+    std::string old_content = mockFS.getFileContent("/system.log.1");
     TEST_ASSERT_EQUAL_STRING(large_content.c_str(), old_content.c_str());
 
     // Check that the new log file has only the new entry
@@ -64,11 +91,434 @@ void test_log_rotation_works_correctly() {
     TEST_ASSERT_TRUE(new_content.length() < 100); // Should be small
 }
 
+void test_log_lines_are_buffered_until_high_water() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+
+    lm.log("First line");
+    lm.log("Second line");
+    TEST_ASSERT_EQUAL(0, mockFS.stats.open_calls);
+    TEST_ASSERT_FALSE(mockFS.exists(LOG_FILE));
+
+    // Keep logging until the buffer passes its high-water mark.
+    size_t lines = 2;
+    while (mockFS.stats.open_calls == 0) {
+        lm.log("Filler line %u with some text to take up space", static_cast<unsigned>(lines++));
+        TEST_ASSERT_TRUE(lines < LOG_BUFFER_SIZE);
+    }
+    TEST_ASSERT_EQUAL(1, mockFS.stats.open_calls);
+    TEST_ASSERT_EQUAL(1, mockFS.stats.close_calls);
+    TEST_ASSERT_EQUAL(0, lm.pendingBytes());
+
+    std::string content = mockFS.getFileContent(LOG_FILE);
+    TEST_ASSERT_TRUE(content.size() >= LOG_FLUSH_HIGH_WATER);
+    TEST_ASSERT_EQUAL(0, content.find("[0] I First line\n[0] I Second line\n"));
+}
+
+void test_update_flushes_once_the_interval_has_passed() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+
+    set_mock_millis(1000);
+    lm.log("Waiting line");
+    set_mock_millis(1000 + LOG_FLUSH_INTERVAL_MS - 1);
+    lm.update();
+    TEST_ASSERT_EQUAL(0, mockFS.stats.open_calls);
+
+    set_mock_millis(1000 + LOG_FLUSH_INTERVAL_MS);
+    lm.update();
+    TEST_ASSERT_EQUAL(1, mockFS.stats.open_calls);
+    TEST_ASSERT_TRUE(mockFS.getFileContent(LOG_FILE).find("Waiting line") != std::string::npos);
+
+    lm.update(); // Nothing pending: no further flash access
+    TEST_ASSERT_EQUAL(1, mockFS.stats.open_calls);
+}
+
+void test_critical_line_is_written_immediately_with_earlier_lines() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+
+    lm.log("Routine line");
+    lm.logCritical("ERROR: something failed, code=%d", 7);
+
+    std::string content = mockFS.getFileContent(LOG_FILE);
+    TEST_ASSERT_EQUAL(1, mockFS.stats.open_calls);
+    TEST_ASSERT_EQUAL_STRING("[0] I Routine line\n[0] C ERROR: something failed, code=7\n", content.c_str());
+}
+
+void test_streamLogs_includes_buffered_lines() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+
+    lm.log("Not yet on flash");
+    std::string logs = read_logs(lm);
+
+    TEST_ASSERT_TRUE(logs.find("Not yet on flash") != std::string::npos);
+}
+
+// Logs numbered lines until at least `count` flushes have reached flash.
+int log_numbered_lines(LogManager& lm, MockFileSystem& fs, size_t flushes) {
+    int line = 0;
+    size_t start = fs.stats.open_calls;
+    while (fs.stats.open_calls - start < flushes) {
+        lm.log("Numbered line %06d with padding to fill the buffer quickly", line++);
+    }
+    lm.flush();
+    return line;
+}
+
+void test_rotation_keeps_generations_within_the_budget() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    lm.setRotation(3, 8192);
+    TEST_ASSERT_EQUAL(2048, lm.fileLimit());
+
+    int lines = log_numbered_lines(lm, mockFS, 40);
+
+    char path[32];
+    size_t total = 0;
+    for (size_t generation = 0; generation <= 3; generation++) {
+        std::string content = mockFS.getFileContent(LogManager::logPath(generation, path, sizeof(path)));
+        TEST_ASSERT_TRUE(content.size() > 0);
+        TEST_ASSERT_TRUE(content.size() <= lm.fileLimit());
+        total += content.size();
+    }
+    TEST_ASSERT_TRUE(total <= 8192);
+    TEST_ASSERT_FALSE(mockFS.exists(LogManager::logPath(4, path, sizeof(path))));
+
+    // Oldest first, the kept lines are an unbroken run ending at the last one.
+    std::string logs = read_logs(lm);
+    size_t previous = std::string::npos;
+    size_t count = 0;
+    for (size_t at = logs.find("line "); at != std::string::npos; at = logs.find("line ", at + 1)) {
+        size_t number = std::stoul(logs.substr(at + 5, 6));
+        TEST_ASSERT_TRUE(previous == std::string::npos || number == previous + 1);
+        previous = number;
+        count++;
+    }
+    TEST_ASSERT_EQUAL(lines - 1, previous);
+    TEST_ASSERT_TRUE(count * 80 > 3 * lm.fileLimit()); // Spread over the archives
+}
+
+void test_rotation_uses_cached_metadata() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    lm.setRotation(3, 8192);
+
+    log_numbered_lines(lm, mockFS, 1); // Loads the metadata
+    MockFileStats before = mockFS.stats;
+    log_numbered_lines(lm, mockFS, 40);
+
+    // Every flush is one open and close, with no file probed. A rotation is
+    // at most one remove and one rename per generation, none of them failing.
+    size_t flushes = mockFS.stats.open_calls - before.open_calls;
+    size_t renames = mockFS.stats.rename_calls - before.rename_calls;
+    size_t removes = mockFS.stats.remove_calls - before.remove_calls;
+    TEST_ASSERT_EQUAL(0, mockFS.stats.exists_calls - before.exists_calls);
+    TEST_ASSERT_EQUAL(flushes, mockFS.stats.close_calls - before.close_calls);
+    TEST_ASSERT_TRUE(renames > 0);
+    TEST_ASSERT_TRUE(removes < renames);
+    TEST_ASSERT_TRUE(renames <= 3 * (removes + 3));
+    TEST_ASSERT_TRUE(mockFS.exists("/system.log.3"));
+}
+
+void test_failed_rotation_keeps_the_files_and_retries() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    std::string large_content(lm.fileLimit() - 100, 'A');
+    mockFS.setFileContent("/system.log", large_content);
+    lm.log("First");
+    lm.flush(); // Loads the metadata: a nearly full live file and no archives
+
+    // An archive the cache does not know about makes the rename fail.
+    mockFS.setFileContent("/system.log.1", "[0] I stray\n");
+    lm.log("Kept despite the failure %s", std::string(120, '.').c_str());
+    lm.flush();
+
+    TEST_ASSERT_EQUAL_STRING("[0] I stray\n", mockFS.getFileContent("/system.log.1").c_str());
+    TEST_ASSERT_FALSE(mockFS.exists("/system.log.2"));
+    std::string live = mockFS.getFileContent("/system.log");
+    TEST_ASSERT_EQUAL(0, live.find(large_content));
+    TEST_ASSERT_TRUE(live.find("Kept despite the failure") != std::string::npos);
+
+    // The next flush sees the files as they are and rotates past the stray one.
+    lm.log("After");
+    lm.flush();
+    TEST_ASSERT_EQUAL_STRING("[0] I stray\n", mockFS.getFileContent("/system.log.2").c_str());
+    TEST_ASSERT_TRUE(mockFS.getFileContent("/system.log.1").find("Kept despite the failure") != std::string::npos);
+    std::string after = mockFS.getFileContent("/system.log");
+    TEST_ASSERT_TRUE(after.find("After") != std::string::npos);
+    TEST_ASSERT_TRUE(after.find("Kept") == std::string::npos);
+}
+
+void test_shrinking_generations_prunes_archives() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    for (const char* path : {"/system.log.1", "/system.log.2", "/system.log.3"}) {
+        mockFS.setFileContent(path, "[0] I archived\n");
+    }
+
+    lm.setRotation(1, 8192);
+    lm.log("Next");
+    lm.flush();
+
+    TEST_ASSERT_TRUE(mockFS.exists("/system.log.1"));
+    TEST_ASSERT_FALSE(mockFS.exists("/system.log.2"));
+    TEST_ASSERT_FALSE(mockFS.exists("/system.log.3"));
+}
+
+void test_legacy_archive_is_adopted() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    mockFS.setFileContent("/system.log.old", "[0] I from the old firmware\n");
+    mockFS.setFileContent("/system.log", "[0] I current\n");
+
+    std::string logs = read_logs(lm);
+
+    TEST_ASSERT_FALSE(mockFS.exists("/system.log.old"));
+    TEST_ASSERT_EQUAL_STRING("[0] I from the old firmware\n[0] I current\n", logs.c_str());
+}
+
+// Counts how often a log argument is evaluated.
+int evaluations = 0;
+int counted(int value) {
+    evaluations++;
+    return value;
+}
+
+void test_tag_and_level_appear_in_the_line() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+
+    LOG_WARNING(lm, "MQTT", "Connection failed, rc=%d", -2);
+    lm.write(LogLevel::ERROR, nullptr, "Untagged");
+    lm.flush();
+
+    std::string content = mockFS.getFileContent(LOG_FILE);
+    TEST_ASSERT_EQUAL_STRING("[0] W [MQTT] Connection failed, rc=-2\n[0] E Untagged\n", content.c_str());
+}
+
+void test_filtered_calls_are_never_formatted() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    lm.setLevel(LogSink::CONSOLE, LogLevel::WARNING);
+    lm.setLevel(LogSink::FLASH, LogLevel::WARNING);
+    evaluations = 0;
+
+    for (int i = 0; i < 100; i++) {
+        LOG_INFO(lm, "APP", "Routine %d", counted(i));
+    }
+    TEST_ASSERT_EQUAL(0, evaluations);
+    TEST_ASSERT_EQUAL(0, lm.formattedCount());
+    TEST_ASSERT_FALSE(lm.isEnabled(LogLevel::INFO));
+
+    LOG_WARNING(lm, "APP", "Unusual %d", counted(1));
+    TEST_ASSERT_EQUAL(1, evaluations);
+    TEST_ASSERT_EQUAL(1, lm.formattedCount());
+
+    // Direct calls skip the formatting too, though their arguments are evaluated.
+    lm.log("Routine %d", 2);
+    TEST_ASSERT_EQUAL(1, lm.formattedCount());
+    lm.flush();
+    TEST_ASSERT_TRUE(mockFS.getFileContent(LOG_FILE).find("Routine") == std::string::npos);
+}
+
+void test_debug_calls_are_compiled_out_below_the_compile_level() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    lm.setLevel(LogSink::FLASH, LogLevel::DEBUG);
+    TEST_ASSERT_TRUE(lm.isEnabled(LogLevel::DEBUG)); // Would pass the runtime check
+    evaluations = 0;
+
+    LOG_DEBUG(lm, "APP", "Detail %d", counted(1));
+    TEST_ASSERT_EQUAL(0, evaluations);
+    TEST_ASSERT_EQUAL(0, lm.formattedCount());
+
+    // The same level still works when asked for at runtime.
+    LOG_AT(lm, LogLevel::DEBUG, "APP", "Detail %d", counted(2));
+    TEST_ASSERT_EQUAL(1, evaluations);
+    TEST_ASSERT_EQUAL(1, lm.formattedCount());
+}
+
+void test_sink_levels_are_independent() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    std::vector<std::string> remote;
+    lm.setRemoteSink([&](LogLevel level, const char* tag, const char* message) {
+        remote.push_back(std::string(LogManager::levelName(level)) + " " + tag + " " + message);
+    });
+    lm.setLevel(LogSink::CONSOLE, LogLevel::NONE);
+    lm.setLevel(LogSink::FLASH, LogLevel::INFO);
+    lm.setLevel(LogSink::REMOTE, LogLevel::ERROR);
+
+    LOG_INFO(lm, "WEB", "Request");
+    LOG_ERROR(lm, "MQTT", "Publish failed");
+    lm.flush();
+    lm.sendRemote();
+
+    std::string content = mockFS.getFileContent(LOG_FILE);
+    TEST_ASSERT_TRUE(content.find("Request") != std::string::npos);
+    TEST_ASSERT_TRUE(content.find("Publish failed") != std::string::npos);
+    TEST_ASSERT_EQUAL(1, remote.size());
+    TEST_ASSERT_EQUAL_STRING("ERROR MQTT Publish failed", remote[0].c_str());
+
+    // With flash and remote both raised, INFO is no longer formatted at all.
+    lm.setLevel(LogSink::FLASH, LogLevel::WARNING);
+    size_t formatted = lm.formattedCount();
+    LOG_INFO(lm, "WEB", "Request");
+    TEST_ASSERT_EQUAL(formatted, lm.formattedCount());
+}
+
+void test_critical_lines_reach_flash_whatever_the_level() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    lm.setLevel(LogSink::CONSOLE, LogLevel::NONE);
+    lm.setLevel(LogSink::FLASH, LogLevel::NONE);
+
+    LOG_ERROR(lm, "APP", "Dropped");
+    LOG_CRITICAL(lm, "APP", "Kept");
+
+    std::string content = mockFS.getFileContent(LOG_FILE);
+    TEST_ASSERT_EQUAL_STRING("[0] C [APP] Kept\n", content.c_str());
+}
+
+void test_remote_sink_that_logs_does_not_recurse() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    int calls = 0;
+    lm.setRemoteSink([&](LogLevel, const char*, const char*) {
+        calls++;
+        LOG_ERROR(lm, "MQTT", "Publish of log line failed");
+    });
+
+    LOG_WARNING(lm, "APP", "Something odd");
+    TEST_ASSERT_EQUAL(1, lm.sendRemote());
+    TEST_ASSERT_EQUAL(0, lm.sendRemote());
+    lm.flush();
+
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_TRUE(mockFS.getFileContent(LOG_FILE).find("Publish of log line failed") != std::string::npos);
+}
+
+void test_remote_lines_are_sent_from_the_draining_task() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    std::vector<std::thread::id> callers;
+    lm.setRemoteSink([&](LogLevel, const char*, const char*) {
+        callers.push_back(std::this_thread::get_id());
+    });
+
+    // Logged from another task, as the web server does when clearing logs.
+    std::thread other([&lm]() { lm.clearLogs(); });
+    other.join();
+    TEST_ASSERT_TRUE(callers.empty());
+
+    TEST_ASSERT_EQUAL(1, lm.sendRemote());
+    TEST_ASSERT_EQUAL(1, callers.size());
+    TEST_ASSERT_TRUE(callers[0] == std::this_thread::get_id());
+}
+
+void test_remote_queue_is_bounded() {
+    MockFileSystem mockFS;
+    LogManager lm(mockFS);
+    std::vector<std::string> remote;
+    lm.setRemoteSink([&](LogLevel, const char*, const char* message) { remote.push_back(message); });
+
+    const size_t logged = LOG_REMOTE_QUEUE_LINES + 5;
+    for (size_t i = 0; i < logged; i++) {
+        LOG_WARNING(lm, "APP", "Line %u", static_cast<unsigned>(i));
+    }
+    TEST_ASSERT_EQUAL(5, lm.droppedRemoteLines());
+
+    TEST_ASSERT_EQUAL(LOG_REMOTE_QUEUE_LINES, lm.sendRemote());
+    TEST_ASSERT_EQUAL_STRING("Line 0", remote.front().c_str());
+    char last[16];
+    snprintf(last, sizeof(last), "Line %u", static_cast<unsigned>(LOG_REMOTE_QUEUE_LINES - 1));
+    TEST_ASSERT_EQUAL_STRING(last, remote.back().c_str());
+}
+
+// The pre-buffering behaviour: open, check the size, append and close for
+// every line.
+void reference_log(MockFileSystem& fs, const char* message) {
+    const char* oldLogFile = "/system.log.old";
+    auto logFile = fs.open(LOG_FILE, "a");
+    if (logFile && logFile->size() > 4096) {
+        logFile->close();
+        if (fs.exists(oldLogFile)) {
+            fs.remove(oldLogFile);
+        }
+        if (fs.exists(LOG_FILE)) {
+            fs.rename(LOG_FILE, oldLogFile);
+        }
+        logFile = fs.open(LOG_FILE, "a");
+    }
+    if (logFile) {
+        logFile->print("[0] I ");
+        logFile->println(message);
+        logFile->close();
+    }
+}
+
+void test_benchmark_buffered_log_against_per_line_writes() {
+    const int calls = 1000;
+    char message[64];
+
+    MockFileSystem referenceFS;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) {
+        snprintf(message, sizeof(message), "[MQTT] Published aggregated data #%d.", i);
+        reference_log(referenceFS, message);
+    }
+    auto referenceNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    MockFileSystem bufferedFS;
+    LogManager lm(bufferedFS);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) {
+        lm.log("[MQTT] Published aggregated data #%d.", i);
+    }
+    lm.flush();
+    auto bufferedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    const MockFileStats& ref = referenceFS.stats;
+    const MockFileStats& buf = bufferedFS.stats;
+    char report[256];
+    snprintf(report, sizeof(report),
+             "per %d lines | per-line: %zu opens, %zu closes, %zu bytes, %lld ns | buffered: %zu opens, %zu closes, %zu bytes, %lld ns",
+             calls, ref.open_calls, ref.close_calls, ref.bytes_written, static_cast<long long>(referenceNs),
+             buf.open_calls, buf.close_calls, buf.bytes_written, static_cast<long long>(bufferedNs));
+    TEST_MESSAGE(report);
+
+    // Same bytes reach flash in a small fraction of the file operations.
+    TEST_ASSERT_EQUAL(ref.bytes_written, buf.bytes_written);
+    TEST_ASSERT_TRUE(buf.open_calls * 10 < ref.open_calls);
+    TEST_ASSERT_EQUAL(buf.open_calls, buf.close_calls);
+    TEST_ASSERT_EQUAL(0, lm.droppedLines());
+}
+
 int main(int argc, char **argv) {
     UNITY_BEGIN();
     RUN_TEST(test_log_writes_to_file);
-    RUN_TEST(test_getLogs_reads_file_content);
+    RUN_TEST(test_streamLogs_reads_file_content);
     RUN_TEST(test_clearLogs_removes_files);
     RUN_TEST(test_log_rotation_works_correctly);
+    RUN_TEST(test_rotation_keeps_generations_within_the_budget);
+    RUN_TEST(test_rotation_uses_cached_metadata);
+    RUN_TEST(test_failed_rotation_keeps_the_files_and_retries);
+    RUN_TEST(test_shrinking_generations_prunes_archives);
+    RUN_TEST(test_legacy_archive_is_adopted);
+    RUN_TEST(test_log_lines_are_buffered_until_high_water);
+    RUN_TEST(test_update_flushes_once_the_interval_has_passed);
+    RUN_TEST(test_critical_line_is_written_immediately_with_earlier_lines);
+    RUN_TEST(test_streamLogs_includes_buffered_lines);
+    RUN_TEST(test_tag_and_level_appear_in_the_line);
+    RUN_TEST(test_filtered_calls_are_never_formatted);
+    RUN_TEST(test_debug_calls_are_compiled_out_below_the_compile_level);
+    RUN_TEST(test_sink_levels_are_independent);
+    RUN_TEST(test_critical_lines_reach_flash_whatever_the_level);
+    RUN_TEST(test_remote_sink_that_logs_does_not_recurse);
+    RUN_TEST(test_remote_lines_are_sent_from_the_draining_task);
+    RUN_TEST(test_remote_queue_is_bounded);
+    RUN_TEST(test_benchmark_buffered_log_against_per_line_writes);
     return UNITY_END();
 }
\ No newline at end of file
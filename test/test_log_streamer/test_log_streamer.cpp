@@ -0,0 +1,176 @@
+#include <unity.h>
+#include "logging/log_manager.h"
+#include "logging/log_streamer.h"
+#include "mocks/MockFileSystem.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// The newest archive; most of these tests keep only this one.
+const char* const ARCHIVE = "/system.log.1";
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Lines "line 0".."line <count - 1>", the first `oldCount` in the rotated file.
+std::string fill_logs(MockFileSystem& fs, int oldCount, int count) {
+    std::string oldContent;
+    std::string content;
+    char line[32];
+    for (int i = 0; i < count; i++) {
+        snprintf(line, sizeof(line), "[%d] I line %d\n", i * 1000, i);
+        (i < oldCount ? oldContent : content) += line;
+    }
+    if (oldCount > 0) {
+        fs.setFileContent(ARCHIVE, oldContent);
+    }
+    if (count > oldCount) {
+        fs.setFileContent(LOG_FILE, content);
+    }
+    return oldContent + content;
+}
+
+std::string stream_logs(LogStreamer& streamer, size_t chunkSize) {
+    std::string logs;
+    std::unique_ptr<uint8_t[]> chunk(new uint8_t[chunkSize]);
+    size_t n;
+    while ((n = streamer.fill(chunk.get(), chunkSize)) > 0) {
+        TEST_ASSERT_TRUE(n <= chunkSize);
+        logs.append(reinterpret_cast<const char*>(chunk.get()), n);
+    }
+    TEST_ASSERT_TRUE(streamer.done());
+    return logs;
+}
+
+std::string lines(const std::string& logs, size_t first, size_t count) {
+    size_t begin = 0;
+    for (size_t i = 0; i < first && begin != std::string::npos; i++) {
+        begin = logs.find('\n', begin);
+        begin = begin == std::string::npos ? begin : begin + 1;
+    }
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = begin;
+    for (size_t i = 0; i < count && end < logs.size(); i++) {
+        end = logs.find('\n', end) + 1;
+    }
+    return logs.substr(begin, end - begin);
+}
+
+void test_streams_both_files_oldest_first_at_any_chunk_size() {
+    MockFileSystem fs;
+    std::string expected = fill_logs(fs, 60, 100);
+
+    const size_t chunkSizes[] = {1, 7, LogStreamer::READ_SIZE, 4096};
+    for (size_t chunkSize : chunkSizes) {
+        LogStreamer streamer(fs, 1, 0, LogStreamer::ALL_LINES);
+        std::string actual = stream_logs(streamer, chunkSize);
+        TEST_ASSERT_EQUAL(expected.size(), actual.size());
+        TEST_ASSERT_TRUE(expected == actual);
+        TEST_ASSERT_EQUAL(100, streamer.linesWritten());
+    }
+}
+
+void test_pages_cover_every_line_once() {
+    MockFileSystem fs;
+    std::string expected = fill_logs(fs, 25, 40);
+
+    std::string paged;
+    for (size_t offset = 0; offset < 45; offset += 6) {
+        LogStreamer streamer(fs, 1, offset, 6);
+        std::string page = stream_logs(streamer, 10);
+        std::string expectedPage = lines(expected, offset, 6);
+        TEST_ASSERT_EQUAL_STRING(expectedPage.c_str(), page.c_str());
+        paged += page;
+    }
+    TEST_ASSERT_TRUE(expected == paged);
+
+    LogStreamer empty(fs, 1, 0, 0);
+    TEST_ASSERT_EQUAL(0, stream_logs(empty, 64).size());
+}
+
+void test_tail_returns_the_last_lines_across_files() {
+    MockFileSystem fs;
+    std::string expected = fill_logs(fs, 30, 35);
+
+    LogStreamer streamer(fs, 1, 0, LogStreamer::ALL_LINES, 8);
+    std::string tail = stream_logs(streamer, 64);
+    std::string expectedTail = lines(expected, 27, 8);
+    TEST_ASSERT_EQUAL_STRING(expectedTail.c_str(), tail.c_str());
+
+    // The tail can be paged like any other range.
+    LogStreamer limited(fs, 1, 0, 2, 8);
+    std::string firstTwo = stream_logs(limited, 64);
+    std::string expectedFirstTwo = lines(expected, 27, 2);
+    TEST_ASSERT_EQUAL_STRING(expectedFirstTwo.c_str(), firstTwo.c_str());
+
+    LogStreamer everything(fs, 1, 0, LogStreamer::ALL_LINES, 1000);
+    TEST_ASSERT_TRUE(expected == stream_logs(everything, 64));
+}
+
+void test_unterminated_file_does_not_merge_lines() {
+    MockFileSystem fs;
+    fs.setFileContent(ARCHIVE, "[1] I complete\n[2] I trunc");
+    fs.setFileContent(LOG_FILE, "[3] I next\n");
+
+    LogStreamer streamer(fs, 1, 0, LogStreamer::ALL_LINES);
+    std::string all = stream_logs(streamer, 5);
+    TEST_ASSERT_EQUAL_STRING("[1] I complete\n[2] I trunc\n[3] I next\n", all.c_str());
+
+    LogStreamer second(fs, 1, 1, 1);
+    std::string truncated = stream_logs(second, 64);
+    TEST_ASSERT_EQUAL_STRING("[2] I trunc\n", truncated.c_str());
+
+    LogStreamer tail(fs, 1, 0, LogStreamer::ALL_LINES, 2);
+    std::string lastTwo = stream_logs(tail, 64);
+    TEST_ASSERT_EQUAL_STRING("[2] I trunc\n[3] I next\n", lastTwo.c_str());
+}
+
+void test_missing_files_stream_nothing() {
+    MockFileSystem fs;
+    LogStreamer streamer(fs, 1, 0, LogStreamer::ALL_LINES, 10);
+    TEST_ASSERT_EQUAL(0, stream_logs(streamer, 64).size());
+
+    fs.setFileContent(LOG_FILE, "[5] I only current\n");
+    LogStreamer current(fs, 1, 0, LogStreamer::ALL_LINES);
+    std::string logs = stream_logs(current, 64);
+    TEST_ASSERT_EQUAL_STRING("[5] I only current\n", logs.c_str());
+}
+
+void test_reading_stops_at_the_end_of_the_range() {
+    MockFileSystem fs;
+    fill_logs(fs, 20, 40);
+    fs.stats = MockFileStats();
+
+    LogStreamer streamer(fs, 1, 2, 3);
+    stream_logs(streamer, 64);
+    TEST_ASSERT_EQUAL(3, streamer.linesWritten());
+    // The range ends inside the rotated file, so the current one is never opened.
+    TEST_ASSERT_EQUAL(1, fs.stats.open_calls);
+    TEST_ASSERT_EQUAL(1, fs.stats.close_calls);
+}
+
+void test_archives_are_streamed_oldest_first() {
+    MockFileSystem fs;
+    fs.setFileContent("/system.log.3", "[1] I oldest\n");
+    fs.setFileContent("/system.log.1", "[3] I newest archive\n");
+    fs.setFileContent("/system.log", "[4] I current\n");
+    fs.setFileContent("/system.log.4", "[0] I beyond the generation count\n");
+
+    LogStreamer streamer(fs, 3, 0, LogStreamer::ALL_LINES);
+    std::string logs = stream_logs(streamer, 16);
+    TEST_ASSERT_EQUAL_STRING("[1] I oldest\n[3] I newest archive\n[4] I current\n", logs.c_str());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_streams_both_files_oldest_first_at_any_chunk_size);
+    RUN_TEST(test_pages_cover_every_line_once);
+    RUN_TEST(test_tail_returns_the_last_lines_across_files);
+    RUN_TEST(test_unterminated_file_does_not_merge_lines);
+    RUN_TEST(test_missing_files_stream_nothing);
+    RUN_TEST(test_reading_stops_at_the_end_of_the_range);
+    RUN_TEST(test_archives_are_streamed_oldest_first);
+    return UNITY_END();
+}
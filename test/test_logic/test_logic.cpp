@@ -1,7 +1,55 @@
 #include <unity.h>
 #include "hvac_data.h"
 #include "logic/json_builder.h"
+#include "logic/enum_converters.h"
+#include "config.h"
 #include <ArduinoJson.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+
+// Counts every heap allocation made through operator new in this binary, so
+// the benchmark can report allocations per payload.
+static std::atomic<size_t> g_newCalls{0};
+
+void* operator new(size_t size) {
+    g_newCalls++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// ArduinoJson allocates through its Allocator interface rather than new.
+class CountingAllocator : public ArduinoJson::Allocator {
+public:
+    size_t allocations = 0;
+
+    void* allocate(size_t size) override {
+        allocations++;
+        return std::malloc(size);
+    }
+    void deallocate(void* ptr) override {
+        std::free(ptr);
+    }
+    void* reallocate(void* ptr, size_t newSize) override {
+        allocations++;
+        return std::realloc(ptr, newSize);
+    }
+};
 
 // The setUp and tearDown functions are called before and after each test.
 void setUp(void) {
@@ -58,11 +106,202 @@ void test_buildPayload_creates_correct_json(void) {
     TEST_ASSERT_EQUAL_STRING("2024-01-01", doc["buildDate"]);
 }
 
+HVACData make_payload_sample() {
+    HVACData data;
+    data.isInitialized = true;
+    data.returnTempC = 24.37f;
+    data.supplyTempC = -127.0f;
+    data.deltaT = 0.0f;
+    data.fanAmps = 1.2345678;
+    data.compressorAmps = 12345678.9;
+    data.geoPumpsAmps = 0.000001;
+    data.fanStatus = ComponentStatus::ON;
+    data.compressorStatus = ComponentStatus::UNKNOWN;
+    data.geoPumpsStatus = ComponentStatus::OFF;
+    data.airflowStatus = AirflowStatus::NA;
+    data.alertStatus = AlertStatus::TEMP_SENSOR_DISCONNECTED;
+    return data;
+}
+
+// The JsonDocument-based payload that buildPayload used to produce; kept as
+// the reference for output and cost.
+size_t build_reference_payload(const HVACData& data, const char* version, const char* buildDate,
+                               char* buffer, size_t bufferSize, ArduinoJson::Allocator* allocator) {
+    JsonDocument doc(allocator);
+    JsonObject root = doc.to<JsonObject>();
+    root["returnTempC"] = data.returnTempC;
+    root["supplyTempC"] = data.supplyTempC;
+    root["deltaT"] = data.deltaT;
+    root["fanAmps"] = data.fanAmps;
+    root["compressorAmps"] = data.compressorAmps;
+    root["geoPumpsAmps"] = data.geoPumpsAmps;
+    root["fanStatus"] = toString(data.fanStatus);
+    root["compressorStatus"] = toString(data.compressorStatus);
+    root["geoPumpsStatus"] = toString(data.geoPumpsStatus);
+    root["airflowStatus"] = toString(data.airflowStatus);
+    root["alertStatus"] = toString(data.alertStatus);
+    root["version"] = version;
+    root["buildDate"] = buildDate;
+    return serializeJson(doc, buffer, bufferSize);
+}
+
+void test_buildPayload_matches_arduinojson_output(void) {
+    HVACData data = make_payload_sample();
+    char expected[512];
+    char actual[512];
+
+    size_t expectedLength = build_reference_payload(data, "v-test", "2024-01-01", expected, sizeof(expected), nullptr);
+    size_t length = JsonBuilder::buildPayload(data, "v-test", "2024-01-01", actual, sizeof(actual));
+
+    TEST_ASSERT_EQUAL_STRING(expected, actual);
+    TEST_ASSERT_EQUAL_UINT32(expectedLength, length);
+}
+
+void test_buildPayload_aggregated_matches_arduinojson_output(void) {
+    AggregatedHVACData data;
+    data.timestamp = 4000000000u;
+    data.sampleCount = 60;
+    data.avgReturnTempC = 22.123f;
+    data.minReturnTempC = -127.0f;
+    data.stddevReturnTempC = 0.0001f;
+    data.avgFanAmps = 3.3333333333;
+    data.maxCompressorAmps = 99.99;
+    data.lastFanStatus = ComponentStatus::ON;
+    data.lastGeoPumpsStatus = ComponentStatus::OFF;
+
+    // Build the reference from the JsonObject serializer used by the history routes.
+    std::array<AggregatedHVACData, AGGREGATED_DATA_BUFFER_SIZE> buffer;
+    buffer[0] = data;
+    JsonDocument doc;
+    JsonArray history = doc.to<JsonArray>();
+    JsonBuilder::buildAggregatedHistoryJson(history, buffer, 0);
+    JsonObject entry = history[0].as<JsonObject>();
+    entry["version"] = "v-test";
+    entry["buildDate"] = "2024-01-01";
+    entry["sequence"] = 4294967295u;
+    std::string expected;
+    serializeJson(entry, expected);
+
+    char actual[1024];
+    size_t length = JsonBuilder::buildPayload(data, 4294967295u, "v-test", "2024-01-01", actual, sizeof(actual));
+
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), length);
+}
+
+void test_buildPayload_returns_zero_when_truncated(void) {
+    HVACData data = make_payload_sample();
+    char buffer[512];
+    size_t length = JsonBuilder::buildPayload(data, "v-test", "2024-01-01", buffer, sizeof(buffer));
+    TEST_ASSERT_GREATER_THAN(0, length);
+
+    // Exactly enough room for the payload and its terminator.
+    char exact[512];
+    TEST_ASSERT_EQUAL_UINT32(length, JsonBuilder::buildPayload(data, "v-test", "2024-01-01", exact, length + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, exact);
+
+    char small[512];
+    TEST_ASSERT_EQUAL_UINT32(0, JsonBuilder::buildPayload(data, "v-test", "2024-01-01", small, length));
+    TEST_ASSERT_EQUAL('\0', small[length - 1]);
+}
+
+void test_aggregated_batch_holds_records_that_fit(void) {
+    AggregatedHVACData data;
+    data.timestamp = 5000;
+    data.sampleCount = 60;
+    data.avgReturnTempC = 21.5f;
+    data.lastFanStatus = ComponentStatus::ON;
+
+    // Each record matches the single-message payload, minus the envelope.
+    char single[1024];
+    size_t singleLength = JsonBuilder::buildPayload(data, 7, "v-test", "2024-01-01", single, sizeof(single));
+    TEST_ASSERT_GREATER_THAN(0, singleLength);
+
+    // Room for the envelope and two records, but not three.
+    char buffer[2048];
+    size_t capacity = 64 + 2 * singleLength;
+    JsonBuilder::AggregatedBatch batch(buffer, capacity, "v-test", "2024-01-01");
+    TEST_ASSERT_TRUE(batch.add(data, 7));
+    TEST_ASSERT_TRUE(batch.add(data, 8));
+    TEST_ASSERT_FALSE(batch.add(data, 9));
+    TEST_ASSERT_EQUAL(2, batch.count());
+
+    size_t length = batch.finish();
+    TEST_ASSERT_EQUAL_UINT32(strlen(buffer), length);
+    TEST_ASSERT_TRUE(length < capacity);
+
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, buffer));
+    TEST_ASSERT_EQUAL_STRING("v-test", doc["version"].as<const char*>());
+    JsonArray records = doc["records"].as<JsonArray>();
+    TEST_ASSERT_EQUAL(2, records.size());
+    TEST_ASSERT_EQUAL_UINT32(8, records[1]["sequence"].as<uint32_t>());
+
+    std::string expected(single);
+    const std::string envelope = "\"version\":\"v-test\",\"buildDate\":\"2024-01-01\",";
+    expected.erase(expected.find(envelope), envelope.size());
+    std::string actual;
+    serializeJson(records[0], actual);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), actual.c_str());
+}
+
+void test_aggregated_batch_is_empty_when_nothing_fits(void) {
+    AggregatedHVACData data;
+    data.timestamp = 5000;
+    char buffer[96];
+    JsonBuilder::AggregatedBatch batch(buffer, sizeof(buffer), "v-test", "2024-01-01");
+    TEST_ASSERT_FALSE(batch.add(data, 1));
+    TEST_ASSERT_EQUAL(0, batch.count());
+    TEST_ASSERT_EQUAL_UINT32(0, batch.finish());
+}
+
+void test_benchmark_buildPayload_against_arduinojson(void) {
+    using Clock = std::chrono::steady_clock;
+    const int iterations = 20000;
+    HVACData data = make_payload_sample();
+    char buffer[512];
+    volatile size_t sink = 0;
+
+    CountingAllocator allocator;
+    size_t newCallsBefore = g_newCalls;
+    auto referenceStart = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        data.fanAmps = 1.0 + i * 0.001;
+        sink = sink + build_reference_payload(data, "v-test", "2024-01-01", buffer, sizeof(buffer), &allocator);
+    }
+    auto referenceNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - referenceStart).count();
+    size_t referenceAllocations = allocator.allocations + (g_newCalls - newCallsBefore);
+
+    newCallsBefore = g_newCalls;
+    auto writerStart = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        data.fanAmps = 1.0 + i * 0.001;
+        sink = sink + JsonBuilder::buildPayload(data, "v-test", "2024-01-01", buffer, sizeof(buffer));
+    }
+    auto writerNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - writerStart).count();
+    size_t writerAllocations = g_newCalls - newCallsBefore;
+
+    char message[160];
+    snprintf(message, sizeof(message), "JsonDocument: %.0f ns/payload, %.2f allocs/payload | JsonWriter: %.0f ns/payload, %.2f allocs/payload",
+             static_cast<double>(referenceNs) / iterations, static_cast<double>(referenceAllocations) / iterations,
+             static_cast<double>(writerNs) / iterations, static_cast<double>(writerAllocations) / iterations);
+    // Timings are reported only; they are too noisy to assert on in CI.
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(0, writerAllocations);
+}
+
 // This main function is the entry point for this specific test suite.
 int main(int argc, char **argv) {
     UNITY_BEGIN();
     // Run JsonBuilder tests
     RUN_TEST(test_buildPayload_creates_correct_json);
+    RUN_TEST(test_buildPayload_matches_arduinojson_output);
+    RUN_TEST(test_buildPayload_aggregated_matches_arduinojson_output);
+    RUN_TEST(test_buildPayload_returns_zero_when_truncated);
+    RUN_TEST(test_aggregated_batch_holds_records_that_fit);
+    RUN_TEST(test_aggregated_batch_is_empty_when_nothing_fits);
+    RUN_TEST(test_benchmark_buildPayload_against_arduinojson);
 
     return UNITY_END();
 }
\ No newline at end of file
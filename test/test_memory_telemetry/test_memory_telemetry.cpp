@@ -0,0 +1,124 @@
+#include <unity.h>
+#include "metrics/memory_telemetry.h"
+#include "logic/json_builder.h"
+#include "mocks/MockMemoryProbe.h"
+#include "config.h"
+#include <ArduinoJson.h>
+#include <memory>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_sample_reads_every_figure_from_the_probe() {
+    MockMemoryProbe probe;
+    probe.free = 120000;
+    probe.largest = 90000;
+    probe.minimum = 80000;
+    probe.stacks[MEMORY_TRACKED_TASKS[0]] = 3000;
+    probe.stacks[MEMORY_TRACKED_TASKS[2]] = 1500;
+    MemoryTelemetry telemetry(probe);
+    TEST_ASSERT_EQUAL(0, telemetry.size());
+    TEST_ASSERT_EQUAL(0, telemetry.latest().freeHeap);
+
+    MemorySample sample = telemetry.sample(5000);
+    TEST_ASSERT_EQUAL(5000, sample.timestamp);
+    TEST_ASSERT_EQUAL(120000, sample.freeHeap);
+    TEST_ASSERT_EQUAL(90000, sample.largestFreeBlock);
+    TEST_ASSERT_EQUAL(80000, sample.minFreeHeap);
+    TEST_ASSERT_EQUAL(3000, sample.stackHighWater[0]);
+    TEST_ASSERT_EQUAL(0, sample.stackHighWater[1]); // Not running
+    TEST_ASSERT_EQUAL(1500, sample.stackHighWater[2]);
+    TEST_ASSERT_EQUAL(1, telemetry.size());
+    TEST_ASSERT_EQUAL(120000, telemetry.latest().freeHeap);
+}
+
+void test_fragmentation_is_the_share_of_free_heap_outside_the_largest_block() {
+    MemorySample sample;
+    TEST_ASSERT_EQUAL(0, sample.fragmentationPercent()); // Nothing free
+    sample.freeHeap = 100000;
+    sample.largestFreeBlock = 100000;
+    TEST_ASSERT_EQUAL(0, sample.fragmentationPercent());
+    sample.largestFreeBlock = 25000;
+    TEST_ASSERT_EQUAL(75, sample.fragmentationPercent());
+    sample.freeHeap = 3000000000u; // No overflow at large sizes
+    sample.largestFreeBlock = 2000000000u;
+    TEST_ASSERT_EQUAL(34, sample.fragmentationPercent());
+}
+
+void test_history_keeps_the_newest_samples_oldest_first() {
+    MockMemoryProbe probe;
+    MemoryTelemetry telemetry(probe);
+    const size_t taken = MEMORY_HISTORY_SIZE + 5;
+    for (size_t i = 0; i < taken; i++) {
+        probe.free = 100000 - static_cast<uint32_t>(i);
+        telemetry.sample(static_cast<uint32_t>(i * 1000));
+    }
+
+    MemoryTelemetry::History history;
+    TEST_ASSERT_EQUAL(MEMORY_HISTORY_SIZE, telemetry.copyHistory(history));
+    for (size_t i = 0; i < MEMORY_HISTORY_SIZE; i++) {
+        size_t expected = taken - MEMORY_HISTORY_SIZE + i;
+        TEST_ASSERT_EQUAL(expected * 1000, history[i].timestamp);
+        TEST_ASSERT_EQUAL(100000 - expected, history[i].freeHeap);
+    }
+    TEST_ASSERT_EQUAL((taken - 1) * 1000, telemetry.latest().timestamp);
+}
+
+void test_memory_payload_names_each_tracked_task() {
+    MemorySample sample;
+    sample.timestamp = 60000;
+    sample.freeHeap = 100000;
+    sample.largestFreeBlock = 60000;
+    sample.minFreeHeap = 70000;
+    for (size_t task = 0; task < MEMORY_TRACKED_TASK_COUNT; task++) {
+        sample.stackHighWater[task] = 1000 + static_cast<uint32_t>(task);
+    }
+
+    char buffer[256];
+    TEST_ASSERT_TRUE(JsonBuilder::buildMemoryPayload(sample, buffer, sizeof(buffer)) > 0);
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, buffer));
+    TEST_ASSERT_EQUAL(60000, doc["timestamp"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(100000, doc["free_heap_bytes"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(60000, doc["largest_free_block_bytes"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(70000, doc["min_free_heap_bytes"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(40, doc["fragmentation_pct"].as<int>());
+    for (size_t task = 0; task < MEMORY_TRACKED_TASK_COUNT; task++) {
+        TEST_ASSERT_EQUAL(1000 + task, doc["stack_high_water_bytes"][MEMORY_TRACKED_TASKS[task]].as<uint32_t>());
+    }
+}
+
+void test_status_payload_fits_its_buffer_with_a_full_history() {
+    MockMemoryProbe probe;
+    probe.free = UINT32_MAX;
+    probe.largest = 1;
+    probe.minimum = UINT32_MAX;
+    for (size_t task = 0; task < MEMORY_TRACKED_TASK_COUNT; task++) {
+        probe.stacks[MEMORY_TRACKED_TASKS[task]] = UINT32_MAX;
+    }
+    MemoryTelemetry telemetry(probe);
+    for (size_t i = 0; i < MEMORY_HISTORY_SIZE; i++) {
+        telemetry.sample(UINT32_MAX);
+    }
+
+    std::unique_ptr<char[]> buffer(new char[STATUS_JSON_BUFFER_SIZE]);
+    TEST_ASSERT_TRUE(JsonBuilder::buildStatusPayload(UINT32_MAX, UINT32_MAX, telemetry, buffer.get(), STATUS_JSON_BUFFER_SIZE) > 0);
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, buffer.get()));
+    TEST_ASSERT_EQUAL(UINT32_MAX, doc["uptime_ms"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(MEMORY_HISTORY_SIZE, doc["memory_history"].size());
+
+    // The widest single sample also fits the MQTT telemetry payload.
+    char payload[256];
+    TEST_ASSERT_TRUE(JsonBuilder::buildMemoryPayload(telemetry.latest(), payload, sizeof(payload)) > 0);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_reads_every_figure_from_the_probe);
+    RUN_TEST(test_fragmentation_is_the_share_of_free_heap_outside_the_largest_block);
+    RUN_TEST(test_history_keeps_the_newest_samples_oldest_first);
+    RUN_TEST(test_memory_payload_names_each_tracked_task);
+    RUN_TEST(test_status_payload_fits_its_buffer_with_a_full_history);
+    return UNITY_END();
+}
@@ -6,6 +6,12 @@
 #include "mocks/Arduino.h"
 #include "secrets.h"
 #include "mocks/MockMqttClient.h"
+#include "config.h"
+#include "logic/binary_payload.h"
+#include "metrics/memory_telemetry.h"
+#include <ArduinoJson.h>
+#include <cstring>
+#include <vector>
 
 void setUp(void) {
     // Reset mock time before each test
@@ -14,7 +20,7 @@ void setUp(void) {
 
 void tearDown(void) {}
 
-void test_handleClient_attempts_reconnect_when_disconnected() {
+void test_reconnect_attempts_connection_when_disconnected() {
     // Arrange
     SystemState systemState;
     MockFileSystem mockFS;
@@ -22,15 +28,21 @@ void test_handleClient_attempts_reconnect_when_disconnected() {
     auto mockMqttClient = std::make_unique<MockMqttClient>();
     MockMqttClient* mockClientPtr = mockMqttClient.get(); // Get raw pointer for inspection
     mockClientPtr->_connected = false;
-    // Advance time to ensure the reconnect interval is exceeded
-    set_mock_millis(6000);
-    MqttManager mqttManager(systemState, logManager, std::move(mockMqttClient));
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
 
-    // Act
+    // Act: the per-loop work leaves reconnecting to its own scheduled task
     mqttManager.handleClient();
+    TEST_ASSERT_FALSE(mockClientPtr->connect_called);
+    TEST_ASSERT_FALSE(mockClientPtr->loop_called);
+    mqttManager.reconnect();
 
     // Assert
     TEST_ASSERT_TRUE(mockClientPtr->connect_called);
+
+    // Nothing to do once connected.
+    mockClientPtr->connect_called = false;
+    mqttManager.reconnect();
+    TEST_ASSERT_FALSE(mockClientPtr->connect_called);
 }
 
 void test_handleClient_calls_loop_when_connected() {
@@ -41,7 +53,7 @@ void test_handleClient_calls_loop_when_connected() {
     auto mockMqttClient = std::make_unique<MockMqttClient>();
     MockMqttClient* mockClientPtr = mockMqttClient.get(); // Get raw pointer for inspection
     mockClientPtr->_connected = true;
-    MqttManager mqttManager(systemState, logManager, std::move(mockMqttClient));
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
 
     // Act
     mqttManager.handleClient();
@@ -59,7 +71,7 @@ void test_publishAggregatedData_sends_correct_payload() {
     auto mockMqttClient = std::make_unique<MockMqttClient>();
     MockMqttClient* mockClientPtr = mockMqttClient.get(); // Get a raw pointer for inspection before moving
     mockClientPtr->_connected = true; // Corrected: client must be connected to publish
-    MqttManager mqttManager(systemState, logManager, std::move(mockMqttClient));
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
     AggregatedHVACData aggData;
     aggData.avgReturnTempC = 22.5f;
     aggData.timestamp = 12345;
@@ -73,10 +85,484 @@ void test_publishAggregatedData_sends_correct_payload() {
     TEST_ASSERT_TRUE(mockClientPtr->last_payload.find("\"avgReturnTempC\":22.5") != std::string::npos);
 }
 
+// Adds an aggregate to the system state and hands it to the manager, as
+// Application::performAggregation() does.
+void produce_aggregate(SystemState& systemState, MqttManager& mqttManager, uint32_t timestamp) {
+    AggregatedHVACData aggData;
+    aggData.timestamp = timestamp;
+    aggData.sampleCount = 60;
+    aggData.avgDeltaT = 5.25f;
+    systemState.addAggregatedData(aggData);
+    mqttManager.publishAggregatedData();
+}
+
+std::vector<uint32_t> published_sequences(const MockMqttClient& client) {
+    std::vector<uint32_t> sequences;
+    for (const auto& payload : client.published_payloads) {
+        JsonDocument doc;
+        TEST_ASSERT_FALSE(deserializeJson(doc, payload.c_str()));
+        sequences.push_back(doc["sequence"].as<uint32_t>());
+    }
+    return sequences;
+}
+
+// Sequences of every record in every batch, in publish order.
+std::vector<uint32_t> batched_sequences(const MockMqttClient& client) {
+    std::vector<uint32_t> sequences;
+    for (const auto& payload : client.published_payloads) {
+        JsonDocument doc;
+        TEST_ASSERT_FALSE(deserializeJson(doc, payload.c_str()));
+        TEST_ASSERT_TRUE(doc["version"].is<const char*>());
+        JsonArray records = doc["records"].as<JsonArray>();
+        TEST_ASSERT_TRUE(records.size() > 0);
+        for (JsonVariant record : records) {
+            sequences.push_back(record["sequence"].as<uint32_t>());
+        }
+    }
+    return sequences;
+}
+
+// Reconnects and runs handleClient() until the backlog is gone, checking the
+// per-loop rate limit on the way.
+void drain_after_reconnect(MqttManager& mqttManager, MockMqttClient& client) {
+    client._connected = true;
+    size_t loops = 0;
+    while (!mqttManager.getOutbox().empty()) {
+        size_t before = client.published_payloads.size();
+        mqttManager.handleClient();
+        TEST_ASSERT_TRUE(client.published_payloads.size() - before <= MQTT_OUTBOX_DRAIN_PER_LOOP);
+        TEST_ASSERT_TRUE(++loops < 10000);
+    }
+}
+
+void test_publishAggregatedData_numbers_payloads_from_begin_sequence() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    mockClientPtr->_connected = true;
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(100);
+
+    for (uint32_t i = 1; i <= 3; i++) {
+        produce_aggregate(systemState, mqttManager, i * 1000);
+    }
+
+    std::vector<uint32_t> sequences = published_sequences(*mockClientPtr);
+    TEST_ASSERT_EQUAL(3, sequences.size());
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT32(100 + i, sequences[i]);
+    }
+    TEST_ASSERT_TRUE(mqttManager.getOutbox().empty());
+}
+
+void test_outages_of_varying_length_are_replayed_in_order() {
+    // Sent from RAM, read back from flash, and longer than the outbox holds.
+    const uint32_t capacity = MQTT_OUTBOX_SPILL_CAPACITY;
+    const uint32_t outages[] = {1, MQTT_OUTBOX_RAM_CAPACITY, 40, capacity + 25};
+
+    for (uint32_t outage : outages) {
+        SystemState systemState;
+        MockFileSystem mockFS;
+        LogManager logManager(mockFS);
+        auto mockMqttClient = std::make_unique<MockMqttClient>();
+        MockMqttClient* mockClientPtr = mockMqttClient.get();
+        mockClientPtr->_connected = true;
+        MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+        mqttManager.begin(0);
+
+        produce_aggregate(systemState, mqttManager, 1000); // Sequence 0 goes straight out
+
+        mockClientPtr->_connected = false;
+        for (uint32_t i = 0; i < outage; i++) {
+            produce_aggregate(systemState, mqttManager, 2000 + i);
+        }
+        TEST_ASSERT_EQUAL(1, mockClientPtr->published_payloads.size());
+
+        drain_after_reconnect(mqttManager, *mockClientPtr);
+
+        // The newest aggregates survive; anything beyond capacity is the oldest lost.
+        uint32_t kept = outage < capacity ? outage : capacity;
+        std::vector<uint32_t> sequences = published_sequences(*mockClientPtr);
+        TEST_ASSERT_EQUAL(1 + kept, sequences.size());
+        TEST_ASSERT_EQUAL_UINT32(0, sequences[0]);
+        for (uint32_t i = 1; i < sequences.size(); i++) {
+            TEST_ASSERT_EQUAL_UINT32(outage - kept + i, sequences[i]);
+        }
+        TEST_ASSERT_EQUAL(outage - kept, mqttManager.getOutbox().droppedCount());
+        TEST_ASSERT_FALSE(mockFS.exists(MQTT_OUTBOX_SPILL_PATH));
+    }
+}
+
+void test_connection_lost_mid_drain_resumes_without_gaps() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+
+    for (uint32_t i = 0; i < 30; i++) {
+        produce_aggregate(systemState, mqttManager, 1000 + i);
+    }
+
+    mockClientPtr->_connected = true;
+    for (int i = 0; i < 5; i++) {
+        mqttManager.handleClient();
+    }
+    mockClientPtr->_connected = false;
+    set_mock_millis(60000);
+    mockClientPtr->connect_retval = false;
+    mqttManager.reconnect(); // Fails
+    mqttManager.handleClient();
+    produce_aggregate(systemState, mqttManager, 5000);
+
+    drain_after_reconnect(mqttManager, *mockClientPtr);
+
+    std::vector<uint32_t> sequences = published_sequences(*mockClientPtr);
+    TEST_ASSERT_EQUAL(31, sequences.size());
+    for (uint32_t i = 0; i < sequences.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, sequences[i]);
+    }
+}
+
+void test_queued_aggregates_survive_a_reboot() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    const uint32_t produced = MQTT_OUTBOX_RAM_CAPACITY + 12;
+    {
+        auto offlineClient = std::make_unique<MockMqttClient>();
+        MqttManager mqttManager(systemState, logManager, mockFS, std::move(offlineClient));
+        mqttManager.begin(0);
+        for (uint32_t i = 0; i < produced; i++) {
+            produce_aggregate(systemState, mqttManager, 1000 + i);
+        }
+    } // Power lost: every queued aggregate was written through to flash
+
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+    TEST_ASSERT_EQUAL(produced, mqttManager.getOutbox().size());
+    TEST_ASSERT_EQUAL_UINT32(produced, mqttManager.getOutbox().nextSequence());
+
+    drain_after_reconnect(mqttManager, *mockClientPtr);
+    produce_aggregate(systemState, mqttManager, 9000);
+
+    std::vector<uint32_t> sequences = published_sequences(*mockClientPtr);
+    TEST_ASSERT_EQUAL(produced + 1, sequences.size());
+    for (uint32_t i = 0; i < produced; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, sequences[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(produced, sequences[produced]); // Numbering carries on after the restored entries
+}
+
+void test_batch_is_sent_once_it_is_full() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    mockClientPtr->_connected = true;
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+    mqttManager.setBatching(4, 60000);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        set_mock_millis(1000 + i);
+        produce_aggregate(systemState, mqttManager, 1000 + i);
+        mqttManager.handleClient();
+    }
+    TEST_ASSERT_EQUAL(0, mockClientPtr->published_payloads.size());
+
+    set_mock_millis(1003);
+    produce_aggregate(systemState, mqttManager, 1003);
+    TEST_ASSERT_EQUAL(1, mockClientPtr->published_payloads.size());
+    for (uint32_t i = 4; i < 9; i++) {
+        set_mock_millis(1000 + i);
+        produce_aggregate(systemState, mqttManager, 1000 + i);
+    }
+    TEST_ASSERT_EQUAL(2, mockClientPtr->published_payloads.size());
+    TEST_ASSERT_EQUAL(1, mqttManager.getOutbox().size()); // The ninth waits for the next batch
+
+    std::vector<uint32_t> sequences = batched_sequences(*mockClientPtr);
+    TEST_ASSERT_EQUAL(8, sequences.size());
+    for (uint32_t i = 0; i < sequences.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, sequences[i]);
+    }
+}
+
+void test_partial_batch_is_sent_at_the_latency_deadline() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    mockClientPtr->_connected = true;
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+    mqttManager.setBatching(6, 10000);
+
+    set_mock_millis(5000);
+    produce_aggregate(systemState, mqttManager, 5000);
+    set_mock_millis(8000);
+    produce_aggregate(systemState, mqttManager, 8000);
+
+    set_mock_millis(14999); // The oldest has waited just under the limit
+    mqttManager.handleClient();
+    TEST_ASSERT_EQUAL(0, mockClientPtr->published_payloads.size());
+
+    set_mock_millis(15000);
+    mqttManager.handleClient();
+    TEST_ASSERT_EQUAL(1, mockClientPtr->published_payloads.size());
+    TEST_ASSERT_EQUAL(2, batched_sequences(*mockClientPtr).size());
+    TEST_ASSERT_TRUE(mqttManager.getOutbox().empty());
+}
+
+void test_batches_are_split_to_fit_the_mqtt_buffer() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+    // Far more records per batch than one message can carry.
+    mqttManager.setBatching(1000, 0);
+
+    const uint32_t outage = 60;
+    for (uint32_t i = 0; i < outage; i++) {
+        produce_aggregate(systemState, mqttManager, 1000 + i);
+    }
+    drain_after_reconnect(mqttManager, *mockClientPtr);
+
+    const size_t maxPayload = MQTT_BUFFER_SIZE - 7 - strlen(AWS_IOT_TOPIC);
+    TEST_ASSERT_TRUE(mockClientPtr->published_payloads.size() > 1);
+    for (const auto& payload : mockClientPtr->published_payloads) {
+        TEST_ASSERT_TRUE(payload.size() < maxPayload);
+    }
+    std::vector<uint32_t> sequences = batched_sequences(*mockClientPtr);
+    TEST_ASSERT_EQUAL(outage, sequences.size());
+    for (uint32_t i = 0; i < sequences.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, sequences[i]);
+    }
+}
+
+void test_backlog_leaves_a_partial_batch_waiting() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+    mqttManager.setBatching(3, 60000);
+
+    set_mock_millis(1005);
+    for (uint32_t i = 0; i < 5; i++) {
+        produce_aggregate(systemState, mqttManager, 1000 + i);
+    }
+    TEST_ASSERT_EQUAL(5, mqttManager.getOutbox().size());
+
+    mockClientPtr->_connected = true;
+    mqttManager.handleClient(); // One full batch; the remaining two wait
+    TEST_ASSERT_EQUAL(1, mockClientPtr->published_payloads.size());
+    TEST_ASSERT_EQUAL(2, mqttManager.getOutbox().size());
+    TEST_ASSERT_EQUAL_UINT32(3, batched_sequences(*mockClientPtr).size());
+}
+
+void test_partial_batch_survives_a_reboot_while_connected() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    {
+        auto mockMqttClient = std::make_unique<MockMqttClient>();
+        mockMqttClient->_connected = true;
+        MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+        mqttManager.begin(0);
+        mqttManager.setBatching(6, 60000);
+        for (uint32_t i = 0; i < 4; i++) {
+            set_mock_millis(1000 + i);
+            produce_aggregate(systemState, mqttManager, 1000 + i);
+            mqttManager.handleClient();
+        }
+        TEST_ASSERT_EQUAL(4, mqttManager.getOutbox().size());
+    } // Reset while the batch was still filling
+
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    mockClientPtr->_connected = true;
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+    mqttManager.setBatching(6, 60000);
+    set_mock_millis(500); // Restarted clock; the restored batch is overdue
+    mqttManager.handleClient();
+    produce_aggregate(systemState, mqttManager, 500);
+
+    TEST_ASSERT_EQUAL(1, mockClientPtr->published_payloads.size());
+    std::vector<uint32_t> sequences = batched_sequences(*mockClientPtr);
+    TEST_ASSERT_EQUAL(4, sequences.size());
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, sequences[i]);
+    }
+    TEST_ASSERT_EQUAL(1, mqttManager.getOutbox().size());
+    TEST_ASSERT_EQUAL_UINT32(5, mqttManager.getOutbox().nextSequence());
+}
+
+void test_binary_encoding_publishes_to_the_binary_topic() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    mockClientPtr->_connected = true;
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.begin(0);
+    mqttManager.setEncoding(MqttPayloadEncoding::BINARY);
+
+    produce_aggregate(systemState, mqttManager, 1000); // Sent on its own without batching
+    mqttManager.setBatching(3, 60000);
+    for (uint32_t i = 1; i <= 3; i++) {
+        set_mock_millis(1000 + i);
+        produce_aggregate(systemState, mqttManager, 1000 + i);
+    }
+
+    std::string expectedTopic = std::string(AWS_IOT_TOPIC) + MQTT_BINARY_TOPIC_SUFFIX;
+    TEST_ASSERT_EQUAL_STRING(expectedTopic.c_str(), mockClientPtr->last_topic.c_str());
+    TEST_ASSERT_EQUAL(2, mockClientPtr->published_payloads.size());
+    std::vector<uint32_t> sequences;
+    for (const auto& payload : mockClientPtr->published_payloads) {
+        bool ok = BinaryPayload::decode(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(),
+                                        [&](uint32_t sequence, const AggregatedHVACData& data) {
+            TEST_ASSERT_EQUAL_UINT32(1000 + sequence, data.timestamp);
+            TEST_ASSERT_FLOAT_WITHIN(0.005f, 5.25f, data.avgDeltaT);
+            sequences.push_back(sequence);
+        });
+        TEST_ASSERT_TRUE(ok);
+    }
+    TEST_ASSERT_EQUAL(4, sequences.size());
+    TEST_ASSERT_EQUAL_UINT32(3, sequences[3]);
+}
+
+void test_publishChanges_sends_transitions_on_the_event_topic() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+
+    HVACData sample;
+    sample.timestamp = 5000;
+    sample.returnTempC = 22.0f;
+    sample.fanStatus = ComponentStatus::ON;
+    mqttManager.publishChanges(sample); // Offline: nothing is sent or remembered
+    TEST_ASSERT_EQUAL(0, mockClientPtr->published_payloads.size());
+
+    mockClientPtr->_connected = true;
+    sample.timestamp = 10000;
+    mqttManager.publishChanges(sample);
+    std::string eventTopic = std::string(AWS_IOT_TOPIC) + MQTT_EVENT_TOPIC_SUFFIX;
+    TEST_ASSERT_EQUAL_STRING(eventTopic.c_str(), mockClientPtr->last_topic.c_str());
+    TEST_ASSERT_EQUAL(1, mockClientPtr->published_payloads.size());
+
+    // An unchanged reading is not sent again; an alert is sent straight away.
+    sample.timestamp = 15000;
+    mqttManager.publishChanges(sample);
+    TEST_ASSERT_EQUAL(1, mockClientPtr->published_payloads.size());
+    sample.timestamp = 20000;
+    sample.alertStatus = AlertStatus::LOW_DELTA_T;
+    mqttManager.publishChanges(sample);
+    TEST_ASSERT_EQUAL(2, mockClientPtr->published_payloads.size());
+
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, mockClientPtr->last_payload.c_str()));
+    TEST_ASSERT_EQUAL_UINT32(20000, doc["timestamp"].as<uint32_t>());
+    TEST_ASSERT_EQUAL_STRING("LOW_DELTA_T", doc["alertStatus"].as<const char*>());
+    TEST_ASSERT_EQUAL(1, doc["changed"].as<JsonArray>().size());
+    TEST_ASSERT_EQUAL_STRING("alert", doc["changed"][0].as<const char*>());
+}
+
+void test_remote_log_sink_publishes_on_the_log_topic() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    logManager.setRemoteSink([&](LogLevel level, const char* tag, const char* message) {
+        mqttManager.publishLog(level, tag, message);
+    });
+
+    mockClientPtr->_connected = false;
+    LOG_ERROR(logManager, "APP", "Offline");
+    logManager.sendRemote();
+    TEST_ASSERT_TRUE(mockClientPtr->last_topic.empty()); // Not queued
+
+    mockClientPtr->_connected = true;
+    set_mock_millis(4000);
+    LOG_INFO(logManager, "APP", "Below the remote level");
+    LOG_WARNING(logManager, "APP", "Quote \"this\"");
+    TEST_ASSERT_TRUE(mockClientPtr->last_topic.empty()); // Only once the MQTT task sends it
+    logManager.sendRemote();
+
+    std::string topic = std::string(AWS_IOT_TOPIC) + MQTT_LOG_TOPIC_SUFFIX;
+    TEST_ASSERT_EQUAL_STRING(topic.c_str(), mockClientPtr->last_topic.c_str());
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, mockClientPtr->last_payload.c_str()));
+    TEST_ASSERT_EQUAL_UINT32(4000, doc["timestamp"].as<uint32_t>());
+    TEST_ASSERT_EQUAL_STRING("WARNING", doc["level"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("APP", doc["tag"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("Quote \"this\"", doc["message"].as<const char*>());
+}
+
+void test_publishMemory_sends_the_sample_on_the_telemetry_topic() {
+    SystemState systemState;
+    MockFileSystem mockFS;
+    LogManager logManager(mockFS);
+    auto mockMqttClient = std::make_unique<MockMqttClient>();
+    MockMqttClient* mockClientPtr = mockMqttClient.get();
+    MqttManager mqttManager(systemState, logManager, mockFS, std::move(mockMqttClient));
+    mqttManager.setEncoding(MqttPayloadEncoding::BINARY); // Telemetry stays JSON
+
+    MemorySample sample;
+    sample.timestamp = 60000;
+    sample.freeHeap = 150000;
+    sample.largestFreeBlock = 110000;
+    mockClientPtr->_connected = false;
+    mqttManager.publishMemory(sample);
+    TEST_ASSERT_TRUE(mockClientPtr->last_topic.empty()); // Not queued
+
+    mockClientPtr->_connected = true;
+    mqttManager.publishMemory(sample);
+    std::string topic = std::string(AWS_IOT_TOPIC) + MQTT_TELEMETRY_TOPIC_SUFFIX;
+    TEST_ASSERT_EQUAL_STRING(topic.c_str(), mockClientPtr->last_topic.c_str());
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, mockClientPtr->last_payload.c_str()));
+    TEST_ASSERT_EQUAL_UINT32(60000, doc["timestamp"].as<uint32_t>());
+    TEST_ASSERT_EQUAL_UINT32(110000, doc["largest_free_block_bytes"].as<uint32_t>());
+}
+
 int main(int argc, char **argv) {
     UNITY_BEGIN();
-    RUN_TEST(test_handleClient_attempts_reconnect_when_disconnected);
+    RUN_TEST(test_reconnect_attempts_connection_when_disconnected);
     RUN_TEST(test_handleClient_calls_loop_when_connected);
     RUN_TEST(test_publishAggregatedData_sends_correct_payload);
+    RUN_TEST(test_publishAggregatedData_numbers_payloads_from_begin_sequence);
+    RUN_TEST(test_outages_of_varying_length_are_replayed_in_order);
+    RUN_TEST(test_connection_lost_mid_drain_resumes_without_gaps);
+    RUN_TEST(test_queued_aggregates_survive_a_reboot);
+    RUN_TEST(test_batch_is_sent_once_it_is_full);
+    RUN_TEST(test_partial_batch_is_sent_at_the_latency_deadline);
+    RUN_TEST(test_batches_are_split_to_fit_the_mqtt_buffer);
+    RUN_TEST(test_backlog_leaves_a_partial_batch_waiting);
+    RUN_TEST(test_partial_batch_survives_a_reboot_while_connected);
+    RUN_TEST(test_binary_encoding_publishes_to_the_binary_topic);
+    RUN_TEST(test_publishChanges_sends_transitions_on_the_event_topic);
+    RUN_TEST(test_remote_log_sink_publishes_on_the_log_topic);
+    RUN_TEST(test_publishMemory_sends_the_sample_on_the_telemetry_topic);
     return UNITY_END();
 }
\ No newline at end of file
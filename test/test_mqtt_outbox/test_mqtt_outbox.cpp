@@ -0,0 +1,207 @@
+#include <unity.h>
+#include "network/MqttOutbox.h"
+#include "storage/TimeSeriesLog.h"
+#include "mocks/MockFileSystem.h"
+#include <string>
+#include <vector>
+
+static const char* SPILL_PATH = "/outbox_test.bin";
+
+void setUp(void) {}
+void tearDown(void) {}
+
+AggregatedHVACData make_aggregate(uint32_t i) {
+    AggregatedHVACData data;
+    data.timestamp = 1000 + i;
+    data.sampleCount = 60;
+    data.avgReturnTempC = 20.0f + i * 0.25f;
+    data.avgFanAmps = 1.5;
+    data.lastFanStatus = ComponentStatus::ON;
+    return data;
+}
+
+std::vector<uint32_t> drain_all(MqttOutbox& outbox) {
+    std::vector<uint32_t> sequences;
+    outbox.drain(SIZE_MAX, [&](uint32_t sequence, const AggregatedHVACData& data) {
+        TEST_ASSERT_EQUAL_UINT32(1000 + sequence, data.timestamp);
+        sequences.push_back(sequence);
+        return true;
+    });
+    return sequences;
+}
+
+void test_outbox_writes_entries_through_but_sends_recent_ones_from_ram() {
+    MockFileSystem fs;
+    MqttOutbox outbox(fs, SPILL_PATH, 4, 16);
+    outbox.begin(0);
+
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, outbox.enqueue(make_aggregate(i)));
+    }
+
+    TEST_ASSERT_EQUAL(4, outbox.size());
+    TEST_ASSERT_EQUAL(4, outbox.spilledCount());
+    TEST_ASSERT_EQUAL(4 * TimeSeriesLog::RECORD_SIZE, fs.getFileContent(SPILL_PATH).size());
+
+    size_t opensBefore = fs.stats.open_calls;
+    TEST_ASSERT_EQUAL(4, drain_all(outbox).size());
+    TEST_ASSERT_EQUAL(opensBefore, fs.stats.open_calls);
+    TEST_ASSERT_TRUE(outbox.empty());
+    TEST_ASSERT_FALSE(fs.exists(SPILL_PATH));
+}
+
+void test_outbox_failed_publish_leaves_entry_at_head() {
+    MockFileSystem fs;
+    MqttOutbox outbox(fs, SPILL_PATH, 2, 16);
+    outbox.begin(0);
+    for (uint32_t i = 0; i < 5; i++) {
+        outbox.enqueue(make_aggregate(i));
+    }
+
+    int calls = 0;
+    size_t sent = outbox.drain(10, [&](uint32_t sequence, const AggregatedHVACData&) {
+        return ++calls <= 2; // The third publish fails
+    });
+
+    TEST_ASSERT_EQUAL(2, sent);
+    std::vector<uint32_t> rest = drain_all(outbox);
+    TEST_ASSERT_EQUAL(3, rest.size());
+    TEST_ASSERT_EQUAL_UINT32(2, rest[0]);
+    TEST_ASSERT_EQUAL_UINT32(4, rest[2]);
+}
+
+void test_outbox_drops_oldest_and_bounds_the_spill_file() {
+    MockFileSystem fs;
+    const size_t spillCapacity = 10;
+    MqttOutbox outbox(fs, SPILL_PATH, 2, spillCapacity);
+    outbox.begin(0);
+
+    for (uint32_t i = 0; i < 100; i++) {
+        outbox.enqueue(make_aggregate(i));
+        // Compaction keeps the file within twice the spill capacity.
+        TEST_ASSERT_TRUE(fs.getFileContent(SPILL_PATH).size() <= 2 * spillCapacity * TimeSeriesLog::RECORD_SIZE);
+    }
+
+    TEST_ASSERT_EQUAL(spillCapacity, outbox.size());
+    TEST_ASSERT_EQUAL(100 - spillCapacity, outbox.droppedCount());
+    std::vector<uint32_t> sequences = drain_all(outbox);
+    TEST_ASSERT_EQUAL(spillCapacity, sequences.size());
+    for (size_t i = 0; i < sequences.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(100 - sequences.size() + i, sequences[i]);
+    }
+}
+
+void test_outbox_restore_skips_torn_and_corrupt_records() {
+    MockFileSystem fs;
+    {
+        MqttOutbox outbox(fs, SPILL_PATH, 1, 16);
+        outbox.begin(0);
+        for (uint32_t i = 0; i < 6; i++) {
+            outbox.enqueue(make_aggregate(i));
+        }
+    }
+    std::string content = fs.getFileContent(SPILL_PATH);
+    TEST_ASSERT_EQUAL(6 * TimeSeriesLog::RECORD_SIZE, content.size());
+    content[2 * TimeSeriesLog::RECORD_SIZE + 10] ^= 0x5A;       // Corrupt sequence 2
+    content += std::string(TimeSeriesLog::RECORD_SIZE / 2, 'x'); // Torn write
+    fs.setFileContent(SPILL_PATH, content);
+
+    MqttOutbox restored(fs, SPILL_PATH, 1, 16);
+    restored.begin(0);
+
+    TEST_ASSERT_EQUAL(5, restored.size());
+    TEST_ASSERT_EQUAL_UINT32(6, restored.nextSequence());
+    TEST_ASSERT_EQUAL(5 * TimeSeriesLog::RECORD_SIZE, fs.getFileContent(SPILL_PATH).size());
+
+    // New entries land record-aligned after the repaired file.
+    restored.enqueue(make_aggregate(6));
+    restored.enqueue(make_aggregate(7));
+    std::vector<uint32_t> sequences = drain_all(restored);
+    const uint32_t expected[] = {0, 1, 3, 4, 5, 6, 7};
+    TEST_ASSERT_EQUAL(7, sequences.size());
+    for (size_t i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL_UINT32(expected[i], sequences[i]);
+    }
+}
+
+void test_outbox_entries_held_in_ram_survive_a_reboot() {
+    MockFileSystem fs;
+    {
+        MqttOutbox outbox(fs, SPILL_PATH, 8, 16);
+        outbox.begin(0);
+        for (uint32_t i = 0; i < 5; i++) {
+            outbox.enqueue(make_aggregate(i));
+        }
+        TEST_ASSERT_EQUAL(5, outbox.size());
+    }
+
+    MqttOutbox restored(fs, SPILL_PATH, 8, 16);
+    restored.begin(0);
+    TEST_ASSERT_EQUAL_UINT32(5, restored.nextSequence());
+    std::vector<uint32_t> sequences = drain_all(restored);
+    TEST_ASSERT_EQUAL(5, sequences.size());
+    TEST_ASSERT_EQUAL_UINT32(0, sequences[0]);
+    TEST_ASSERT_EQUAL_UINT32(4, sequences[4]);
+}
+
+void test_outbox_sequence_keeps_rising_across_a_reboot_with_the_queue_empty() {
+    MockFileSystem fs;
+    {
+        MqttOutbox outbox(fs, SPILL_PATH, 4, 16);
+        outbox.begin(0);
+        for (uint32_t i = 0; i < 3; i++) {
+            outbox.enqueue(make_aggregate(i));
+        }
+        TEST_ASSERT_EQUAL(3, drain_all(outbox).size());
+        TEST_ASSERT_FALSE(fs.exists(SPILL_PATH));
+    }
+
+    // A lower floor than what was handed out does not wind the sequence back.
+    MqttOutbox restored(fs, SPILL_PATH, 4, 16);
+    restored.begin(1);
+    TEST_ASSERT_EQUAL_UINT32(3, restored.nextSequence());
+    TEST_ASSERT_EQUAL_UINT32(3, restored.enqueue(make_aggregate(3)));
+
+    // A damaged sequence file falls back to the floor.
+    std::string saved = fs.getFileContent("/outbox_test.bin.seq");
+    TEST_ASSERT_EQUAL(8, saved.size());
+    saved[0] ^= 0x01;
+    fs.setFileContent("/outbox_test.bin.seq", saved);
+    MqttOutbox damaged(fs, SPILL_PATH, 4, 16);
+    damaged.begin(10);
+    TEST_ASSERT_EQUAL_UINT32(10, damaged.nextSequence());
+}
+
+void test_outbox_sends_a_long_backlog_in_order_a_few_at_a_time() {
+    MockFileSystem fs;
+    MqttOutbox outbox(fs, SPILL_PATH, 2, 64);
+    outbox.begin(0);
+    for (uint32_t i = 0; i < 40; i++) {
+        outbox.enqueue(make_aggregate(i));
+    }
+
+    std::vector<uint32_t> sequences;
+    while (!outbox.empty()) {
+        outbox.drain(3, [&](uint32_t sequence, const AggregatedHVACData& data) {
+            TEST_ASSERT_EQUAL_UINT32(1000 + sequence, data.timestamp);
+            sequences.push_back(sequence);
+            return true;
+        });
+    }
+    TEST_ASSERT_EQUAL(40, sequences.size());
+    for (uint32_t i = 0; i < 40; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, sequences[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_outbox_writes_entries_through_but_sends_recent_ones_from_ram);
+    RUN_TEST(test_outbox_failed_publish_leaves_entry_at_head);
+    RUN_TEST(test_outbox_drops_oldest_and_bounds_the_spill_file);
+    RUN_TEST(test_outbox_restore_skips_torn_and_corrupt_records);
+    RUN_TEST(test_outbox_entries_held_in_ram_survive_a_reboot);
+    RUN_TEST(test_outbox_sequence_keeps_rising_across_a_reboot_with_the_queue_empty);
+    RUN_TEST(test_outbox_sends_a_long_backlog_in_order_a_few_at_a_time);
+    return UNITY_END();
+}
@@ -0,0 +1,196 @@
+#include <unity.h>
+#include "config.h"
+#include "hvac_data.h"
+#include "logic/running_stats.h"
+#include "state/CompactSampleStore.h"
+#include "state/RetentionTiers.h"
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// Smaller than the production tiers so the tests can fill and wrap them
+// quickly, but the minute tier still reaches further back than the raw store.
+const RetentionTierConfig TEST_TIERS[RETENTION_TIER_COUNT] = {
+    {60000UL, 240},   // 1 minute x 240
+    {900000UL, 8},    // 15 minutes x 8
+    {3600000UL, 4},   // 1 hour x 4
+};
+
+const uint32_t SAMPLE_INTERVAL_MS = 5000;
+
+std::unique_ptr<CompactSampleStore> raw;
+std::unique_ptr<RetentionTiers> tiers;
+
+void setUp(void) {
+    raw.reset(new CompactSampleStore());
+    tiers.reset(new RetentionTiers(TEST_TIERS));
+}
+
+void tearDown(void) {}
+
+// A slowly varying signal on the 0.01 grid so fixed-point storage is exact.
+HVACData make_sample(uint32_t n) {
+    HVACData data;
+    data.isInitialized = true;
+    data.timestamp = n * SAMPLE_INTERVAL_MS;
+    data.returnTempC = 20.0f + (n % 8) * 0.25f;
+    data.supplyTempC = 15.0f;
+    data.deltaT = data.returnTempC - data.supplyTempC;
+    data.fanAmps = (n % 2) ? 1.5 : 2.5;
+    data.compressorAmps = 10.0;
+    data.geoPumpsAmps = 0.0;
+    data.fanStatus = ComponentStatus::ON;
+    return data;
+}
+
+void feed_samples(uint32_t first, uint32_t last) {
+    for (uint32_t n = first; n <= last; n++) {
+        HVACData sample = make_sample(n);
+        raw->push(sample);
+        tiers->addSample(sample);
+    }
+}
+
+std::vector<AggregatedHVACData> run_query(uint32_t from, uint32_t to, size_t maxPoints, unsigned long* resolution = nullptr) {
+    std::vector<AggregatedHVACData> points;
+    unsigned long res = tiers->query(*raw, from, to, maxPoints, [&points](const AggregatedHVACData& point) {
+        points.push_back(point);
+    });
+    if (resolution) {
+        *resolution = res;
+    }
+    return points;
+}
+
+void test_running_stats_merge_matches_single_pass() {
+    RunningStats all;
+    RunningStats first;
+    RunningStats second;
+    for (int i = 0; i < 20; i++) {
+        double value = std::sin(i) * 10.0;
+        all.add(value);
+        (i < 7 ? first : second).add(value);
+    }
+
+    first.merge(second);
+
+    TEST_ASSERT_EQUAL_UINT32(all.count(), first.count());
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, all.mean(), first.mean());
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, all.stddev(), first.stddev());
+    TEST_ASSERT_EQUAL_FLOAT(all.min(), first.min());
+    TEST_ASSERT_EQUAL_FLOAT(all.max(), first.max());
+}
+
+void test_finest_tier_closes_a_rollup_per_period() {
+    // 12 samples per minute; the 13th sample opens the second minute.
+    feed_samples(0, 12);
+
+    const RollupStore& minutes = tiers->getTier(0);
+    TEST_ASSERT_EQUAL_UINT32(1, minutes.size());
+
+    AggregatedHVACData rollup = minutes.at(0);
+    TEST_ASSERT_EQUAL_UINT32(60000, rollup.timestamp); // End of the period
+    TEST_ASSERT_EQUAL_UINT32(12, rollup.sampleCount);
+    TEST_ASSERT_EQUAL_FLOAT(2.0, rollup.avgFanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(1.5, rollup.minFanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(2.5, rollup.maxFanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(0.5, rollup.stddevFanAmps);
+    TEST_ASSERT_EQUAL(ComponentStatus::ON, rollup.lastFanStatus);
+}
+
+void test_rollups_cascade_into_coarser_tiers() {
+    // A coarse period closes once the finer tier emits a rollup for the next
+    // one, so closing the first hour needs samples into minute 76.
+    feed_samples(0, 76 * 12);
+
+    const RollupStore& quarterHours = tiers->getTier(1);
+    TEST_ASSERT_EQUAL_UINT32(5, quarterHours.size());
+    TEST_ASSERT_EQUAL_UINT32(180, quarterHours.at(0).sampleCount);
+    TEST_ASSERT_EQUAL_UINT32(900000, quarterHours.at(0).timestamp);
+
+    const RollupStore& hours = tiers->getTier(2);
+    TEST_ASSERT_EQUAL_UINT32(1, hours.size());
+    AggregatedHVACData rollup = hours.at(0);
+    TEST_ASSERT_EQUAL_UINT32(3600000, rollup.timestamp);
+    TEST_ASSERT_EQUAL_UINT32(720, rollup.sampleCount);
+    TEST_ASSERT_EQUAL_FLOAT(2.0, rollup.avgFanAmps);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0.5, rollup.stddevFanAmps);
+    TEST_ASSERT_EQUAL_FLOAT(1.5, rollup.minFanAmps);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 20.875f, rollup.avgReturnTempC); // Mean of 20.00..21.75, stored at 0.01 C
+}
+
+void test_tiers_keep_only_their_capacity() {
+    feed_samples(0, 6 * 3600000 / SAMPLE_INTERVAL_MS);
+
+    TEST_ASSERT_EQUAL_UINT32(240, tiers->getTier(0).size());
+    TEST_ASSERT_EQUAL_UINT32(8, tiers->getTier(1).size());
+    TEST_ASSERT_EQUAL_UINT32(4, tiers->getTier(2).size());
+    // The newest minute rollup is the one that closed last.
+    TEST_ASSERT_EQUAL_UINT32(6 * 3600000, tiers->getTier(0).at(239).timestamp);
+}
+
+void test_query_uses_raw_samples_when_they_cover_the_range() {
+    feed_samples(0, 100);
+
+    unsigned long resolution = 1;
+    std::vector<AggregatedHVACData> points = run_query(50 * SAMPLE_INTERVAL_MS, 59 * SAMPLE_INTERVAL_MS, 0, &resolution);
+
+    TEST_ASSERT_EQUAL_UINT32(0, resolution);
+    TEST_ASSERT_EQUAL_UINT32(10, points.size());
+    TEST_ASSERT_EQUAL_UINT32(50 * SAMPLE_INTERVAL_MS, points[0].timestamp);
+    TEST_ASSERT_EQUAL_UINT32(1, points[0].sampleCount);
+    TEST_ASSERT_EQUAL_FLOAT(make_sample(50).returnTempC, points[0].avgReturnTempC);
+}
+
+void test_query_falls_back_to_the_finest_tier_that_covers_the_range() {
+    // More samples than the raw store holds, so early history is only in the
+    // tiers, and enough for the hour tier to have closed a rollup.
+    const uint32_t last = CompactSampleStore::CAPACITY + 1200;
+    feed_samples(0, last);
+    uint32_t rawOldest = raw->timestampAt(0);
+    uint32_t minutesOldest = tiers->getTier(0).timestampAt(0);
+
+    unsigned long resolution = 0;
+    std::vector<AggregatedHVACData> points = run_query(minutesOldest, last * SAMPLE_INTERVAL_MS, 0, &resolution);
+    TEST_ASSERT_TRUE(minutesOldest < rawOldest);
+    TEST_ASSERT_EQUAL_UINT32(60000, resolution);
+    TEST_ASSERT_EQUAL_UINT32(tiers->getTier(0).size(), points.size());
+
+    // Nothing reaches back to 0, so the coarsest tier with data is used.
+    run_query(0, last * SAMPLE_INTERVAL_MS, 0, &resolution);
+    TEST_ASSERT_EQUAL_UINT32(3600000, resolution);
+}
+
+void test_query_merges_points_down_to_max_points() {
+    feed_samples(0, 100);
+
+    std::vector<AggregatedHVACData> points = run_query(0, 99 * SAMPLE_INTERVAL_MS, 10);
+
+    TEST_ASSERT_EQUAL_UINT32(10, points.size());
+    uint32_t total = 0;
+    for (const auto& point : points) {
+        TEST_ASSERT_EQUAL_UINT32(10, point.sampleCount);
+        total += point.sampleCount;
+    }
+    TEST_ASSERT_EQUAL_UINT32(100, total);
+    TEST_ASSERT_EQUAL_UINT32(9 * SAMPLE_INTERVAL_MS, points[0].timestamp); // Last point of the group
+    TEST_ASSERT_EQUAL_FLOAT(2.0, points[0].avgFanAmps);
+}
+
+void test_query_with_no_data_emits_nothing() {
+    std::vector<AggregatedHVACData> points = run_query(0, UINT32_MAX, 10);
+    TEST_ASSERT_EQUAL_UINT32(0, points.size());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_running_stats_merge_matches_single_pass);
+    RUN_TEST(test_finest_tier_closes_a_rollup_per_period);
+    RUN_TEST(test_rollups_cascade_into_coarser_tiers);
+    RUN_TEST(test_tiers_keep_only_their_capacity);
+    RUN_TEST(test_query_uses_raw_samples_when_they_cover_the_range);
+    RUN_TEST(test_query_falls_back_to_the_finest_tier_that_covers_the_range);
+    RUN_TEST(test_query_merges_points_down_to_max_points);
+    RUN_TEST(test_query_with_no_data_emits_nothing);
+    return UNITY_END();
+}
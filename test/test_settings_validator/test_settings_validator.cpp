@@ -53,7 +53,7 @@ void test_validateAndApply_rejects_low_duration() {
     ValidationResult result = SettingsValidator::validateAndApply(doc.as<JsonObject>(), config);
 
     TEST_ASSERT_FALSE(result.success);
-    TEST_ASSERT_EQUAL_STRING("Invalid Delta T duration. Must be between 10 and 3600 seconds.", result.message.c_str());
+    TEST_ASSERT_EQUAL_STRING("Invalid Delta T duration. Must be between 10 and 1200 seconds.", result.message.c_str());
 }
 
 void test_validateAndApply_rejects_high_duration() {
@@ -64,7 +64,7 @@ void test_validateAndApply_rejects_high_duration() {
     ValidationResult result = SettingsValidator::validateAndApply(doc.as<JsonObject>(), config);
 
     TEST_ASSERT_FALSE(result.success);
-    TEST_ASSERT_EQUAL_STRING("Invalid No Airflow duration. Must be between 10 and 3600 seconds.", result.message.c_str());
+    TEST_ASSERT_EQUAL_STRING("Invalid No Airflow duration. Must be between 10 and 1200 seconds.", result.message.c_str());
 }
 
 void test_validateAndApply_rejects_high_temp_sensor_duration() {
@@ -75,7 +75,26 @@ void test_validateAndApply_rejects_high_temp_sensor_duration() {
     ValidationResult result = SettingsValidator::validateAndApply(doc.as<JsonObject>(), config);
 
     TEST_ASSERT_FALSE(result.success);
-    TEST_ASSERT_EQUAL_STRING("Invalid Temp Sensor Disconnected duration. Must be between 10 and 3600 seconds.", result.message.c_str());
+    TEST_ASSERT_EQUAL_STRING("Invalid Temp Sensor Disconnected duration. Must be between 10 and 1200 seconds.", result.message.c_str());
+}
+
+void test_validateAndApply_bounds_durations_by_the_sample_history() {
+    AppConfig config = {2.0f, 300, 60, 30};
+    JsonDocument doc;
+    doc["lowDeltaTDurationS"] = 600;
+
+    ValidationResult result = SettingsValidator::validateAndApply(doc.as<JsonObject>(), config);
+
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL_UINT(600, config.lowDeltaTDurationS);
+
+    JsonDocument tooLong;
+    tooLong["lowDeltaTDurationS"] = 1201;
+    result = SettingsValidator::validateAndApply(tooLong.as<JsonObject>(), config);
+
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_EQUAL_STRING("Invalid Delta T duration. Must be between 10 and 1200 seconds.", result.message.c_str());
+    TEST_ASSERT_EQUAL_UINT(600, config.lowDeltaTDurationS);
 }
 
 void test_validateAndApply_handles_partial_update() {
@@ -93,6 +112,40 @@ void test_validateAndApply_handles_partial_update() {
     TEST_ASSERT_EQUAL_UINT(30, config.tempSensorDisconnectedDurationS); // Should be unchanged
 }
 
+void test_validateAndApply_accepts_sampling_settings() {
+    AppConfig config = {2.0f, 300, 60, 30, 5000, 493};
+    JsonDocument doc;
+    doc["sensorReadIntervalMs"] = 1000;
+    doc["adcSamplesPerChannel"] = 200;
+
+    ValidationResult result = SettingsValidator::validateAndApply(doc.as<JsonObject>(), config);
+
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL_UINT32(1000, config.sensorReadIntervalMs);
+    TEST_ASSERT_EQUAL_UINT(200, config.adcSamplesPerChannel);
+    TEST_ASSERT_EQUAL_UINT(300, config.lowDeltaTDurationS); // Unchanged
+}
+
+void test_validateAndApply_rejects_out_of_range_sampling_settings() {
+    AppConfig config = {2.0f, 300, 60, 30, 5000, 493};
+    JsonDocument doc;
+    doc["sensorReadIntervalMs"] = 500;
+
+    ValidationResult result = SettingsValidator::validateAndApply(doc.as<JsonObject>(), config);
+
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_EQUAL_STRING("Invalid sensor read interval. Must be between 1000 and 60000 ms.", result.message.c_str());
+    TEST_ASSERT_EQUAL_UINT32(5000, config.sensorReadIntervalMs);
+
+    JsonDocument samples;
+    samples["adcSamplesPerChannel"] = 5000;
+    result = SettingsValidator::validateAndApply(samples.as<JsonObject>(), config);
+
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_EQUAL_STRING("Invalid ADC sample count. Must be between 50 and 2000 per channel.", result.message.c_str());
+    TEST_ASSERT_EQUAL_UINT(493, config.adcSamplesPerChannel);
+}
+
 int main(int argc, char **argv) {
     UNITY_BEGIN();
     RUN_TEST(test_validateAndApply_accepts_valid_data);
@@ -101,6 +154,9 @@ int main(int argc, char **argv) {
     RUN_TEST(test_validateAndApply_rejects_low_duration);
     RUN_TEST(test_validateAndApply_rejects_high_duration);
     RUN_TEST(test_validateAndApply_rejects_high_temp_sensor_duration);
+    RUN_TEST(test_validateAndApply_bounds_durations_by_the_sample_history);
     RUN_TEST(test_validateAndApply_handles_partial_update);
+    RUN_TEST(test_validateAndApply_accepts_sampling_settings);
+    RUN_TEST(test_validateAndApply_rejects_out_of_range_sampling_settings);
     return UNITY_END();
 }
\ No newline at end of file
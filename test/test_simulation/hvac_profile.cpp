@@ -0,0 +1,133 @@
+#include "hvac_profile.h"
+#include <cmath>
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr uint32_t DAY_MS = 24UL * 60 * 60 * 1000;
+
+    // Return air swings around this over the day.
+    constexpr float RETURN_AIR_MEAN_C = 23.5f;
+    constexpr float RETURN_AIR_SWING_C = 1.5f;
+    // Supply air relative to return air once a mode has settled.
+    constexpr float COOLING_DROP_C = 9.0f;
+    constexpr float HEATING_RISE_C = 14.0f;
+    // With the fan stopped, air at the supply probe barely moves.
+    constexpr float STALLED_AIR_DROP_C = 0.5f;
+    constexpr float SUPPLY_AIR_LAG_MS = 90000.0f;
+
+    // Running currents.
+    constexpr double FAN_AMPS = 2.2;
+    constexpr double COMPRESSOR_AMPS = 11.5;
+    constexpr double PUMPS_AMPS = 3.1;
+    // What a CT reads with nothing running.
+    constexpr double CT_FLOOR_NOISE_AMPS = 0.02;
+
+    // DS18B20s at 12-bit resolution.
+    constexpr float PROBE_RESOLUTION_C = 0.0625f;
+
+    float quantize(float tempC) {
+        return std::round(tempC / PROBE_RESOLUTION_C) * PROBE_RESOLUTION_C;
+    }
+}
+
+HvacProfile::HvacProfile(uint32_t seed)
+    : _rng(seed),
+      _cycleLengthMs(0),
+      _currentNoiseAmps(0.0),
+      _lastReadMs(0),
+      _supplyTempC(RETURN_AIR_MEAN_C)
+{}
+
+HvacProfile& HvacProfile::cycle(const std::vector<ProfilePhase>& phases) {
+    _phases = phases;
+    _cycleLengthMs = 0;
+    for (const ProfilePhase& phase : _phases) {
+        _cycleLengthMs += phase.durationMs;
+    }
+    return *this;
+}
+
+HvacProfile& HvacProfile::sensorDropout(TempProbe probe, uint32_t startMs, uint32_t durationMs) {
+    std::vector<Window>& windows = probe == TempProbe::RETURN_AIR ? _returnDropouts : _supplyDropouts;
+    windows.push_back({startMs, startMs + durationMs});
+    return *this;
+}
+
+HvacProfile& HvacProfile::stuckCompressor(uint32_t startMs, uint32_t durationMs) {
+    _stuckCompressor.push_back({startMs, startMs + durationMs});
+    return *this;
+}
+
+HvacProfile& HvacProfile::currentNoise(double amps) {
+    _currentNoiseAmps = amps;
+    return *this;
+}
+
+HvacMode HvacProfile::modeAt(uint32_t nowMs) const {
+    if (_cycleLengthMs == 0) {
+        return HvacMode::OFF;
+    }
+    uint32_t offset = nowMs % _cycleLengthMs;
+    for (const ProfilePhase& phase : _phases) {
+        if (offset < phase.durationMs) {
+            return phase.mode;
+        }
+        offset -= phase.durationMs;
+    }
+    return HvacMode::OFF;
+}
+
+bool HvacProfile::isCompressorStuck(uint32_t nowMs) const {
+    for (const Window& window : _stuckCompressor) {
+        if (window.contains(nowMs)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HvacProfile::isDisconnected(TempProbe probe, uint32_t nowMs) const {
+    const std::vector<Window>& windows = probe == TempProbe::RETURN_AIR ? _returnDropouts : _supplyDropouts;
+    for (const Window& window : windows) {
+        if (window.contains(nowMs)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PlantReading HvacProfile::read(uint32_t nowMs) {
+    HvacMode mode = modeAt(nowMs);
+    bool stuck = isCompressorStuck(nowMs);
+    bool fanOn = !stuck && mode != HvacMode::OFF;
+    bool compressorOn = stuck || mode == HvacMode::COOLING || mode == HvacMode::HEATING;
+    bool pumpsOn = !stuck && compressorOn;
+
+    float returnTempC = RETURN_AIR_MEAN_C + RETURN_AIR_SWING_C *
+        static_cast<float>(std::sin(2.0 * PI * (nowMs % DAY_MS) / DAY_MS));
+    float targetC = returnTempC;
+    if (stuck) {
+        targetC -= STALLED_AIR_DROP_C;
+    } else if (mode == HvacMode::COOLING) {
+        targetC -= COOLING_DROP_C;
+    } else if (mode == HvacMode::HEATING) {
+        targetC += HEATING_RISE_C;
+    }
+    float elapsedMs = static_cast<float>(nowMs - _lastReadMs);
+    _supplyTempC = targetC + (_supplyTempC - targetC) * std::exp(-elapsedMs / SUPPLY_AIR_LAG_MS);
+    _lastReadMs = nowMs;
+
+    PlantReading reading;
+    reading.returnTempC = isDisconnected(TempProbe::RETURN_AIR, nowMs) ? -127.0f : quantize(returnTempC);
+    reading.supplyTempC = isDisconnected(TempProbe::SUPPLY_AIR, nowMs) ? -127.0f : quantize(_supplyTempC);
+    reading.fanAmps = ctReading(fanOn ? FAN_AMPS : 0.0);
+    reading.compressorAmps = ctReading(compressorOn ? COMPRESSOR_AMPS : 0.0);
+    reading.pumpsAmps = ctReading(pumpsOn ? PUMPS_AMPS : 0.0);
+    return reading;
+}
+
+double HvacProfile::ctReading(double amps) {
+    // An RMS reading: noise never takes it below zero.
+    std::normal_distribution<double> noise(0.0, CT_FLOOR_NOISE_AMPS + _currentNoiseAmps);
+    return std::fabs(amps + noise(_rng));
+}
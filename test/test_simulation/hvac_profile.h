@@ -0,0 +1,75 @@
+#ifndef HVAC_PROFILE_H
+#define HVAC_PROFILE_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+enum class HvacMode { OFF, FAN_ONLY, COOLING, HEATING };
+enum class TempProbe { RETURN_AIR, SUPPLY_AIR };
+
+struct ProfilePhase {
+    HvacMode mode;
+    uint32_t durationMs;
+};
+
+// What the sensors would report at one instant.
+struct PlantReading {
+    float returnTempC = 0.0f;
+    float supplyTempC = 0.0f;
+    double fanAmps = 0.0;
+    double compressorAmps = 0.0;
+    double pumpsAmps = 0.0;
+};
+
+// A scripted heat pump: a repeating cycle of operating modes, with faults
+// laid over it at fixed times. Times are the simulated millis().
+//
+// The return air follows a slow daily swing; the supply air approaches the
+// temperature the current mode would give with a first-order lag, so delta T
+// builds up over a minute or two after a start. All randomness comes from the
+// seed, so a run with the same script is the same run.
+class HvacProfile {
+public:
+    explicit HvacProfile(uint32_t seed = 1);
+
+    // The phases repeat from the first once the last one ends. Without a
+    // cycle the system stays off.
+    HvacProfile& cycle(const std::vector<ProfilePhase>& phases);
+    // The probe reads as disconnected (-127 C) for the given time.
+    HvacProfile& sensorDropout(TempProbe probe, uint32_t startMs, uint32_t durationMs);
+    // The compressor keeps running with the fan and pumps off, whatever the
+    // cycle asks for.
+    HvacProfile& stuckCompressor(uint32_t startMs, uint32_t durationMs);
+    // Gaussian noise of this standard deviation on every CT reading.
+    HvacProfile& currentNoise(double amps);
+
+    [[nodiscard]] HvacMode modeAt(uint32_t nowMs) const;
+    [[nodiscard]] bool isCompressorStuck(uint32_t nowMs) const;
+    [[nodiscard]] bool isDisconnected(TempProbe probe, uint32_t nowMs) const;
+
+    // Moves the plant on to `nowMs` and reads it. Time must not go backwards.
+    PlantReading read(uint32_t nowMs);
+
+private:
+    struct Window {
+        uint32_t startMs;
+        uint32_t endMs;
+        bool contains(uint32_t ms) const { return ms >= startMs && ms < endMs; }
+    };
+
+    double ctReading(double amps);
+
+    std::mt19937 _rng;
+    std::vector<ProfilePhase> _phases;
+    uint32_t _cycleLengthMs;
+    std::vector<Window> _returnDropouts;
+    std::vector<Window> _supplyDropouts;
+    std::vector<Window> _stuckCompressor;
+    double _currentNoiseAmps;
+
+    uint32_t _lastReadMs;
+    float _supplyTempC;
+};
+
+#endif // HVAC_PROFILE_H
@@ -0,0 +1,36 @@
+#include "hvac_simulator.h"
+#include "mocks/Arduino.h"
+#include <chrono>
+#include <memory>
+
+HvacSimulator::HvacSimulator(HvacProfile& profile, IFileSystem& fileSystem, uint32_t tickMs)
+    : _hardware(profile),
+      _broker(new SimulatedBroker()),
+      _app(_hardware, fileSystem, std::unique_ptr<IPubSubClient>(_broker)),
+      _tickMs(tickMs),
+      _nowMs(0)
+{}
+
+void HvacSimulator::boot(uint32_t startMs) {
+    _nowMs = startMs;
+    set_mock_millis(_nowMs);
+    _app.setup();
+}
+
+void HvacSimulator::runFor(uint32_t durationMs) {
+    uint32_t readsBefore = _hardware.currentReads();
+    auto started = std::chrono::steady_clock::now();
+
+    uint32_t endMs = _nowMs + durationMs;
+    while (_nowMs < endMs) {
+        _app.loop();
+        _stats.loopPasses++;
+        _nowMs += _tickMs;
+        set_mock_millis(_nowMs);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    _stats.wallNs += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    _stats.simulatedMs += durationMs;
+    _stats.sensorReads += _hardware.currentReads() - readsBefore;
+}
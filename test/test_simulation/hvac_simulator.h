@@ -0,0 +1,56 @@
+#ifndef HVAC_SIMULATOR_H
+#define HVAC_SIMULATOR_H
+
+#include "application.h"
+#include "hvac_profile.h"
+#include "simulated_broker.h"
+#include "simulated_hardware.h"
+#include <cstdint>
+
+class IFileSystem;
+
+struct SimulationStats {
+    uint32_t simulatedMs = 0;
+    uint64_t loopPasses = 0;
+    uint32_t sensorReads = 0;
+    uint64_t wallNs = 0;
+
+    [[nodiscard]] double nsPerSensorRead() const {
+        return sensorReads == 0 ? 0.0 : static_cast<double>(wallNs) / sensorReads;
+    }
+};
+
+// Runs the whole Application on the host against a scripted plant, a broker
+// that keeps what it receives and the given filesystem.
+//
+// Time is the mock millis(), moved on by `tickMs` after every loop() pass, so
+// a run depends only on the profile's script and seed. The tick stands in for
+// how long a pass takes on the device; it has to stay well below the
+// shortest scheduler period and sensor conversion for the run to match one
+// on hardware.
+class HvacSimulator {
+public:
+    static constexpr uint32_t DEFAULT_TICK_MS = 50;
+
+    HvacSimulator(HvacProfile& profile, IFileSystem& fileSystem, uint32_t tickMs = DEFAULT_TICK_MS);
+
+    // Sets the clock to `startMs` and runs Application::setup(). A second
+    // simulator on the same filesystem, booted after the first is gone, is a
+    // reboot.
+    void boot(uint32_t startMs = 0);
+    void runFor(uint32_t durationMs);
+
+    [[nodiscard]] uint32_t nowMs() const { return _nowMs; }
+    [[nodiscard]] SimulatedBroker& broker() { return *_broker; }
+    [[nodiscard]] const SimulationStats& stats() const { return _stats; }
+
+private:
+    SimulatedHardware _hardware;
+    SimulatedBroker* _broker; // Owned by _app
+    Application _app;
+    uint32_t _tickMs;
+    uint32_t _nowMs;
+    SimulationStats _stats;
+};
+
+#endif // HVAC_SIMULATOR_H
@@ -0,0 +1,92 @@
+#ifndef SIMULATED_BROKER_H
+#define SIMULATED_BROKER_H
+
+#include "network/IPubSubClient.h"
+#include "mocks/Arduino.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// An MQTT client whose broker keeps every message it receives, and which
+// loses its connection during scripted outages. Times are the simulated
+// millis().
+class SimulatedBroker : public IPubSubClient {
+public:
+    struct Message {
+        uint32_t timeMs;
+        std::string topic;
+        std::string payload;
+    };
+
+    // PubSubClient's state() codes.
+    static constexpr int STATE_CONNECTION_LOST = -3;
+    static constexpr int STATE_CONNECTED = 0;
+
+    void addOutage(uint32_t startMs, uint32_t durationMs) {
+        _outages.push_back({startMs, startMs + durationMs});
+    }
+
+    bool connect(const char* /*id*/) override {
+        _connectAttempts++;
+        _connected = isReachable();
+        return _connected;
+    }
+
+    bool connected() override {
+        if (_connected && !isReachable()) {
+            _connected = false;
+        }
+        return _connected;
+    }
+
+    void loop() override {}
+
+    bool publish(const char* topic, const uint8_t* payload, unsigned int plength) override {
+        if (!connected()) {
+            return false;
+        }
+        _messages.push_back({static_cast<uint32_t>(millis()), topic,
+                             std::string(reinterpret_cast<const char*>(payload), plength)});
+        return true;
+    }
+
+    int state() override { return _connected ? STATE_CONNECTED : STATE_CONNECTION_LOST; }
+
+    [[nodiscard]] const std::vector<Message>& messages() const { return _messages; }
+    [[nodiscard]] uint32_t connectAttempts() const { return _connectAttempts; }
+
+    // Messages whose topic ends in `suffix`; "" matches the data topic only.
+    [[nodiscard]] std::vector<const Message*> on(const char* topicBase, const char* suffix) const {
+        std::string topic = std::string(topicBase) + suffix;
+        std::vector<const Message*> matching;
+        for (const Message& message : _messages) {
+            if (message.topic == topic) {
+                matching.push_back(&message);
+            }
+        }
+        return matching;
+    }
+
+private:
+    struct Outage {
+        uint32_t startMs;
+        uint32_t endMs;
+    };
+
+    bool isReachable() const {
+        uint32_t now = static_cast<uint32_t>(millis());
+        for (const Outage& outage : _outages) {
+            if (now >= outage.startMs && now < outage.endMs) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<Outage> _outages;
+    std::vector<Message> _messages;
+    bool _connected = false;
+    uint32_t _connectAttempts = 0;
+};
+
+#endif // SIMULATED_BROKER_H
@@ -0,0 +1,47 @@
+#include "simulated_hardware.h"
+#include "config.h"
+#include "mocks/Arduino.h"
+#include <cstring>
+
+SimulatedHardware::SimulatedHardware(HvacProfile& profile)
+    : _profile(profile),
+      _temperatures(profile),
+      _currents(*this),
+      _fan(*this, FAN_CURRENT_CHANNEL),
+      _compressor(*this, COMPRESSOR_CURRENT_CHANNEL),
+      _pumps(*this, PUMPS_CURRENT_CHANNEL),
+      _currentReads(0)
+{}
+
+void SimulatedHardware::TemperatureBus::startConversion() {
+    _conversionStartMs = millis();
+}
+
+bool SimulatedHardware::TemperatureBus::isConversionComplete() {
+    return millis() - _conversionStartMs >= CONVERSION_TIME_MS;
+}
+
+float SimulatedHardware::TemperatureBus::getTempC(const DeviceAddress& address) {
+    PlantReading reading = _profile.read(millis());
+    if (memcmp(address, returnAirSensorAddress, sizeof(DeviceAddress)) == 0) {
+        return reading.returnTempC;
+    }
+    if (memcmp(address, supplyAirSensorAddress, sizeof(DeviceAddress)) == 0) {
+        return reading.supplyTempC;
+    }
+    return -127.0f; // No such device on the bus
+}
+
+void SimulatedHardware::CurrentSampler::calcIrms(unsigned int /*samples*/, double (&irms)[CURRENT_CHANNEL_COUNT]) {
+    PlantReading reading = _owner._profile.read(millis());
+    irms[FAN_CURRENT_CHANNEL] = reading.fanAmps;
+    irms[COMPRESSOR_CURRENT_CHANNEL] = reading.compressorAmps;
+    irms[PUMPS_CURRENT_CHANNEL] = reading.pumpsAmps;
+    _owner._currentReads++;
+}
+
+double SimulatedHardware::ChannelView::calcIrms(unsigned int samples) {
+    double irms[CURRENT_CHANNEL_COUNT];
+    _owner._currents.calcIrms(samples, irms);
+    return irms[_index];
+}
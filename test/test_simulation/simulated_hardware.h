@@ -0,0 +1,70 @@
+#ifndef SIMULATED_HARDWARE_H
+#define SIMULATED_HARDWARE_H
+
+#include "hardware/IHardwareManager.h"
+#include "interfaces/i_current_sensor.h"
+#include "interfaces/i_multi_channel_current_sensor.h"
+#include "interfaces/i_temperature_sensor.h"
+#include "hvac_profile.h"
+#include <cstdint>
+
+// Sensors that read an HvacProfile at the simulated millis(). The probes
+// are told apart by the addresses in config.cpp, and a conversion takes as
+// long as a DS18B20's does.
+class SimulatedHardware : public IHardwareManager {
+public:
+    static constexpr uint32_t CONVERSION_TIME_MS = 750;
+
+    explicit SimulatedHardware(HvacProfile& profile);
+
+    void setup() override {}
+
+    [[nodiscard]] ITemperatureSensor& getTempAdapter() override { return _temperatures; }
+    [[nodiscard]] ICurrentSensor& getFanAdapter() override { return _fan; }
+    [[nodiscard]] ICurrentSensor& getCompressorAdapter() override { return _compressor; }
+    [[nodiscard]] ICurrentSensor& getPumpsAdapter() override { return _pumps; }
+    [[nodiscard]] IMultiChannelCurrentSensor& getCurrentSampler() override { return _currents; }
+
+    // Number of times the CTs were sampled, i.e. read cycles started.
+    [[nodiscard]] uint32_t currentReads() const { return _currentReads; }
+
+private:
+    class TemperatureBus : public ITemperatureSensor {
+    public:
+        explicit TemperatureBus(HvacProfile& profile) : _profile(profile), _conversionStartMs(0) {}
+        void requestTemperatures() override {}
+        void startConversion() override;
+        bool isConversionComplete() override;
+        float getTempC(const DeviceAddress& address) override;
+    private:
+        HvacProfile& _profile;
+        uint32_t _conversionStartMs;
+    };
+
+    class CurrentSampler : public IMultiChannelCurrentSensor {
+    public:
+        explicit CurrentSampler(SimulatedHardware& owner) : _owner(owner) {}
+        void calcIrms(unsigned int samples, double (&irms)[CURRENT_CHANNEL_COUNT]) override;
+    private:
+        SimulatedHardware& _owner;
+    };
+
+    class ChannelView : public ICurrentSensor {
+    public:
+        ChannelView(SimulatedHardware& owner, size_t index) : _owner(owner), _index(index) {}
+        double calcIrms(unsigned int samples) override;
+    private:
+        SimulatedHardware& _owner;
+        size_t _index;
+    };
+
+    HvacProfile& _profile;
+    TemperatureBus _temperatures;
+    CurrentSampler _currents;
+    ChannelView _fan;
+    ChannelView _compressor;
+    ChannelView _pumps;
+    uint32_t _currentReads;
+};
+
+#endif // SIMULATED_HARDWARE_H
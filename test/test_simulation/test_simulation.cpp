@@ -0,0 +1,303 @@
+#include <unity.h>
+#include "hvac_profile.h"
+#include "hvac_simulator.h"
+#include "mocks/MockFileSystem.h"
+#include "config.h"
+#include "config/config_manager.h"
+#include "logic/alert_manager.h"
+#include "secrets.h"
+#include <ArduinoJson.h>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr uint32_t MINUTE_MS = 60UL * 1000;
+    constexpr uint32_t HOUR_MS = 60 * MINUTE_MS;
+    constexpr uint32_t DAY_MS = 24 * HOUR_MS;
+
+    struct AlertChange {
+        uint32_t timeMs;
+        std::string alert;
+    };
+
+    // Alert transitions, in order, from the event topic. The first event
+    // after boot counts as one, whatever the alert.
+    std::vector<AlertChange> alertChanges(const SimulatedBroker& broker) {
+        std::vector<AlertChange> changes;
+        for (const SimulatedBroker::Message* message : broker.on(AWS_IOT_TOPIC, MQTT_EVENT_TOPIC_SUFFIX)) {
+            JsonDocument doc;
+            TEST_ASSERT_FALSE(deserializeJson(doc, message->payload));
+            JsonArray changed = doc["changed"].as<JsonArray>();
+            for (size_t i = 0; i < changed.size(); i++) {
+                if (strcmp(changed[i].as<const char*>(), "alert") == 0) {
+                    changes.push_back({message->timeMs, doc["alertStatus"].as<const char*>()});
+                }
+            }
+        }
+        return changes;
+    }
+
+    struct Aggregate {
+        uint32_t sequence;
+        uint32_t timestamp;
+        double avgCompressorAmps;
+        std::string lastCompressorStatus;
+    };
+
+    Aggregate toAggregate(JsonVariant record) {
+        return {record["sequence"].as<uint32_t>(), record["timestamp"].as<uint32_t>(),
+                record["avgCompressorAmps"].as<double>(), record["lastCompressorStatus"].as<const char*>()};
+    }
+
+    // Every aggregate received on the data topic, unpacked from its batch
+    // when batching is configured.
+    std::vector<Aggregate> aggregates(const SimulatedBroker& broker) {
+        std::vector<Aggregate> received;
+        for (const SimulatedBroker::Message* message : broker.on(AWS_IOT_TOPIC, "")) {
+            JsonDocument doc;
+            TEST_ASSERT_FALSE(deserializeJson(doc, message->payload));
+            if (doc["records"].isNull()) {
+                received.push_back(toAggregate(doc.as<JsonVariant>()));
+                continue;
+            }
+            JsonArray records = doc["records"].as<JsonArray>();
+            for (size_t i = 0; i < records.size(); i++) {
+                received.push_back(toAggregate(records[i]));
+            }
+        }
+        return received;
+    }
+
+    void assertConsecutive(const std::vector<Aggregate>& received, uint32_t firstSequence) {
+        for (size_t i = 0; i < received.size(); i++) {
+            TEST_ASSERT_EQUAL_UINT32(firstSequence + i, received[i].sequence);
+        }
+    }
+
+    // Aggregation periods completed before `nowMs`, less those that can still be
+    // waiting for their batch to fill.
+    size_t minimumDelivered(uint32_t nowMs) {
+        return (nowMs - 1) / AGGREGATION_INTERVAL_MS - (MQTT_BATCH_MAX_RECORDS - 1);
+    }
+
+    // The first change to `alert` at or after `fromMs`.
+    const AlertChange* findAlert(const std::vector<AlertChange>& changes, const char* alert, uint32_t fromMs) {
+        for (const AlertChange& change : changes) {
+            if (change.timeMs >= fromMs && change.alert == alert) {
+                return &change;
+            }
+        }
+        return nullptr;
+    }
+
+    // A system that stays off, for the fault scenarios: nothing sets the
+    // airflow status yet, so any fan run longer than NO_AIRFLOW_DURATION_S
+    // raises FAN_NO_AIRFLOW, which would mask LOW_DELTA_T.
+    std::vector<ProfilePhase> idleSystem() {
+        return {{HvacMode::OFF, HOUR_MS}};
+    }
+
+    std::vector<ProfilePhase> coolingCalls() {
+        return {{HvacMode::FAN_ONLY, 5 * MINUTE_MS}, {HvacMode::COOLING, 20 * MINUTE_MS}, {HvacMode::OFF, 35 * MINUTE_MS}};
+    }
+
+    void printStats(const char* name, const SimulationStats& stats) {
+        printf("SIM {\"name\":\"%s\",\"simulated_s\":%u,\"loop_passes\":%llu,\"sensor_reads\":%u,"
+               "\"wall_ms\":%.1f,\"ns_per_read\":%.0f}\n",
+               name, static_cast<unsigned>(stats.simulatedMs / 1000), static_cast<unsigned long long>(stats.loopPasses),
+               static_cast<unsigned>(stats.sensorReads), stats.wallNs / 1e6, stats.nsPerSensorRead());
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_days_of_cycling_deliver_every_aggregate_in_order() {
+    HvacProfile profile(1);
+    profile.cycle(coolingCalls());
+    MockFileSystem fs;
+    std::unique_ptr<HvacSimulator> sim(new HvacSimulator(profile, fs));
+    sim->boot();
+    sim->runFor(2 * DAY_MS);
+
+    // Prints the whole loop's cost per sensor read, for comparing commits.
+    const SimulationStats& stats = sim->stats();
+    printStats("cooling_cycles_2d", stats);
+    TEST_ASSERT_TRUE(stats.loopPasses == 2 * DAY_MS / HvacSimulator::DEFAULT_TICK_MS);
+    // Between the idle and the active read rate.
+    TEST_ASSERT_TRUE(stats.sensorReads >= 2 * DAY_MS / IDLE_SENSOR_READ_INTERVAL_MS);
+    TEST_ASSERT_TRUE(stats.sensorReads <= 2 * DAY_MS / SENSOR_READ_INTERVAL_MS);
+
+    std::vector<Aggregate> received = aggregates(sim->broker());
+    TEST_ASSERT_TRUE(received.size() >= minimumDelivered(sim->nowMs()));
+    assertConsecutive(received, 0);
+}
+
+// The alert window of the default settings the simulated device runs with.
+unsigned long defaultAlertWindowMs() {
+    MockFileSystem fs;
+    ConfigManager config(fs);
+    config.load();
+    return AlertManager::windowMs(config.getConfig());
+}
+
+void test_supply_probe_dropout_raises_and_clears_disconnected_alert() {
+    const uint32_t dropoutMs = HOUR_MS;
+    const uint32_t lengthMs = 2 * MINUTE_MS;
+    HvacProfile profile(3);
+    profile.cycle(idleSystem()).sensorDropout(TempProbe::SUPPLY_AIR, dropoutMs, lengthMs);
+    MockFileSystem fs;
+    std::unique_ptr<HvacSimulator> sim(new HvacSimulator(profile, fs));
+    sim->boot();
+    sim->runFor(2 * HOUR_MS);
+
+    std::vector<AlertChange> changes = alertChanges(sim->broker());
+    // The first disconnected reading at the idle rate brings back the active
+    // rate, whose reads then have to confirm it for the full duration.
+    const AlertChange* raised = findAlert(changes, "TEMP_SENSOR_DISCONNECTED", dropoutMs);
+    TEST_ASSERT_NOT_NULL(raised);
+    TEST_ASSERT_TRUE(raised->timeMs >= dropoutMs + TEMP_SENSOR_DISCONNECTED_DURATION_S * 1000 - SENSOR_READ_INTERVAL_MS);
+    TEST_ASSERT_TRUE(raised->timeMs <= dropoutMs + TEMP_SENSOR_DISCONNECTED_DURATION_S * 1000 + IDLE_SENSOR_READ_INTERVAL_MS);
+
+    // Cleared once the disconnected readings have mostly left the window.
+    const AlertChange* cleared = findAlert(changes, "NONE", raised->timeMs);
+    TEST_ASSERT_NOT_NULL(cleared);
+    TEST_ASSERT_TRUE(cleared->timeMs >= dropoutMs + lengthMs);
+    TEST_ASSERT_TRUE(cleared->timeMs <= dropoutMs + lengthMs + defaultAlertWindowMs());
+    TEST_ASSERT_NULL(findAlert(changes, "TEMP_SENSOR_DISCONNECTED", cleared->timeMs));
+}
+
+void test_stuck_compressor_raises_low_delta_t() {
+    const uint32_t stuckMs = 3 * HOUR_MS;
+    const uint32_t lengthMs = 15 * MINUTE_MS;
+    HvacProfile profile(4);
+    profile.cycle(idleSystem()).stuckCompressor(stuckMs, lengthMs);
+    MockFileSystem fs;
+    std::unique_ptr<HvacSimulator> sim(new HvacSimulator(profile, fs));
+    sim->boot();
+    sim->runFor(4 * HOUR_MS);
+
+    std::vector<AlertChange> changes = alertChanges(sim->broker());
+    const AlertChange* early = findAlert(changes, "LOW_DELTA_T", 0);
+    TEST_ASSERT_TRUE(early == nullptr || early->timeMs >= stuckMs);
+    const AlertChange* raised = findAlert(changes, "LOW_DELTA_T", stuckMs);
+    TEST_ASSERT_NOT_NULL(raised);
+    TEST_ASSERT_TRUE(raised->timeMs >= stuckMs + LOW_DELTA_T_DURATION_S * 1000 - IDLE_SENSOR_READ_INTERVAL_MS);
+    TEST_ASSERT_TRUE(raised->timeMs <= stuckMs + LOW_DELTA_T_DURATION_S * 1000 + SENSOR_READ_INTERVAL_MS);
+
+    // Every reading in the window has to show it, so one healthy read clears it.
+    const AlertChange* cleared = findAlert(changes, "NONE", raised->timeMs);
+    TEST_ASSERT_NOT_NULL(cleared);
+    TEST_ASSERT_TRUE(cleared->timeMs >= stuckMs + lengthMs);
+    TEST_ASSERT_TRUE(cleared->timeMs <= stuckMs + lengthMs + SENSOR_READ_INTERVAL_MS + SimulatedHardware::CONVERSION_TIME_MS);
+}
+
+void test_noisy_cts_still_aggregate_to_the_plant_currents() {
+    HvacProfile profile(2);
+    profile.cycle({{HvacMode::COOLING, 20 * MINUTE_MS}, {HvacMode::OFF, 40 * MINUTE_MS}}).currentNoise(0.15);
+    MockFileSystem fs;
+    std::unique_ptr<HvacSimulator> sim(new HvacSimulator(profile, fs));
+    sim->boot();
+    sim->runFor(DAY_MS);
+
+    std::vector<Aggregate> received = aggregates(sim->broker());
+    TEST_ASSERT_TRUE(received.size() >= minimumDelivered(sim->nowMs()));
+    size_t running = 0;
+    size_t stopped = 0;
+    for (const Aggregate& aggregate : received) {
+        // Only periods spent entirely in one mode say what to expect.
+        HvacMode mode = profile.modeAt(aggregate.timestamp - 1);
+        bool steady = true;
+        for (uint32_t t = aggregate.timestamp - AGGREGATION_INTERVAL_MS; t < aggregate.timestamp; t += SENSOR_READ_INTERVAL_MS) {
+            steady = steady && profile.modeAt(t) == mode;
+        }
+        if (!steady) {
+            continue;
+        }
+        if (mode == HvacMode::COOLING) {
+            running++;
+            TEST_ASSERT_DOUBLE_WITHIN(0.1, 11.5, aggregate.avgCompressorAmps);
+            TEST_ASSERT_EQUAL_STRING("ON", aggregate.lastCompressorStatus.c_str());
+        } else {
+            stopped++;
+            TEST_ASSERT_TRUE(aggregate.avgCompressorAmps < AMPS_ON_THRESHOLD);
+        }
+    }
+    TEST_ASSERT_TRUE(running > 0);
+    TEST_ASSERT_TRUE(stopped > 0);
+}
+
+void test_outage_backlog_is_delivered_and_sequences_rise_across_a_reboot() {
+    // 37 minutes is seven aggregates, not a whole history page. The outage
+    // from 32 minutes leaves the last of them queued, and with batching
+    // configured the reboot lands with a batch part-filled.
+    const uint32_t rebootMs = 37 * MINUTE_MS;
+    const uint32_t firstOutageMs = 32 * MINUTE_MS;
+    const uint32_t sentBeforeOutage = firstOutageMs / AGGREGATION_INTERVAL_MS;
+    TEST_ASSERT_TRUE(MQTT_BATCH_MAX_RECORDS <= sentBeforeOutage); // A batch fills before the outage
+    HvacProfile profile(5);
+    profile.cycle(coolingCalls());
+    MockFileSystem fs;
+    std::vector<Aggregate> before;
+    {
+        std::unique_ptr<HvacSimulator> sim(new HvacSimulator(profile, fs));
+        sim->broker().addOutage(firstOutageMs, HOUR_MS);
+        sim->boot();
+        sim->runFor(rebootMs);
+        before = aggregates(sim->broker());
+        TEST_ASSERT_EQUAL(sentBeforeOutage - sentBeforeOutage % MQTT_BATCH_MAX_RECORDS, before.size());
+        assertConsecutive(before, 0);
+    }
+
+    // A power cut: the same filesystem, with millis() starting over, and the
+    // broker out of reach for another two hours.
+    HvacProfile after(6);
+    after.cycle(coolingCalls());
+    std::unique_ptr<HvacSimulator> sim(new HvacSimulator(after, fs));
+    sim->broker().addOutage(0, 2 * HOUR_MS);
+    sim->boot();
+    sim->runFor(4 * HOUR_MS);
+    std::vector<Aggregate> received = aggregates(sim->broker());
+
+    // Nothing produced before the reboot is lost, and no sequence number is
+    // ever sent again with different content.
+    std::vector<Aggregate> all = before;
+    all.insert(all.end(), received.begin(), received.end());
+    std::map<uint32_t, Aggregate> bySequence;
+    for (const Aggregate& aggregate : all) {
+        auto seen = bySequence.find(aggregate.sequence);
+        if (seen == bySequence.end()) {
+            bySequence[aggregate.sequence] = aggregate;
+            continue;
+        }
+        TEST_ASSERT_EQUAL_UINT32(seen->second.timestamp, aggregate.timestamp);
+        TEST_ASSERT_EQUAL_DOUBLE(seen->second.avgCompressorAmps, aggregate.avgCompressorAmps);
+        TEST_ASSERT_EQUAL_STRING(seen->second.lastCompressorStatus.c_str(), aggregate.lastCompressorStatus.c_str());
+    }
+    const uint32_t producedBeforeReboot = (rebootMs - 1) / AGGREGATION_INTERVAL_MS;
+    TEST_ASSERT_EQUAL(0, bySequence.begin()->first);
+    TEST_ASSERT_EQUAL(bySequence.size() - 1, bySequence.rbegin()->first);
+    TEST_ASSERT_TRUE(bySequence.size() >= producedBeforeReboot + minimumDelivered(sim->nowMs()));
+
+    // The aggregate still queued at the reboot went out after it.
+    const Aggregate& pending = bySequence[producedBeforeReboot - 1];
+    TEST_ASSERT_EQUAL_UINT32(producedBeforeReboot * AGGREGATION_INTERVAL_MS, pending.timestamp);
+
+    // The backlog from the outage went out in order.
+    TEST_ASSERT_EQUAL_UINT32(before.size(), received.front().sequence);
+    assertConsecutive(received, received.front().sequence);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_days_of_cycling_deliver_every_aggregate_in_order);
+    RUN_TEST(test_supply_probe_dropout_raises_and_clears_disconnected_alert);
+    RUN_TEST(test_stuck_compressor_raises_low_delta_t);
+    RUN_TEST(test_noisy_cts_still_aggregate_to_the_plant_currents);
+    RUN_TEST(test_outage_backlog_is_delivered_and_sequences_rise_across_a_reboot);
+    return UNITY_END();
+}
@@ -0,0 +1,196 @@
+#include <unity.h>
+#include "metrics/stage_metrics.h"
+#include "metrics/metrics_formatter.h"
+#include "concurrency/cooperative_scheduler.h"
+#include "mocks/MockClock.h"
+#include "mocks/Arduino.h"
+#include "config.h"
+#include <ArduinoJson.h>
+#include <cstring>
+#include <memory>
+#include <string>
+
+void setUp(void) {
+    set_mock_millis(0);
+    stageMetrics().reset();
+}
+void tearDown(void) {}
+
+void test_record_tracks_min_max_mean_and_buckets() {
+    StageMetrics metrics;
+    metrics.record(MetricStage::ALERT_CHECK, 40);
+    metrics.record(MetricStage::ALERT_CHECK, 100);  // On a bound: counted in that bucket
+    metrics.record(MetricStage::ALERT_CHECK, 101);
+    metrics.record(MetricStage::ALERT_CHECK, 3000000); // Above the last bound
+
+    StageStats stats = metrics.snapshot(MetricStage::ALERT_CHECK);
+    TEST_ASSERT_EQUAL(4, stats.count);
+    TEST_ASSERT_EQUAL(40, stats.minUs);
+    TEST_ASSERT_EQUAL(3000000, stats.maxUs);
+    TEST_ASSERT_EQUAL(3000241 / 4, stats.meanUs());
+    TEST_ASSERT_EQUAL(2, stats.buckets[0]);
+    TEST_ASSERT_EQUAL(1, stats.buckets[1]);
+    TEST_ASSERT_EQUAL(1, stats.buckets[STAGE_HISTOGRAM_BOUNDS]);
+
+    // Other stages are untouched, and reset clears everything.
+    TEST_ASSERT_EQUAL(0, metrics.snapshot(MetricStage::LOOP).count);
+    metrics.reset();
+    stats = metrics.snapshot(MetricStage::ALERT_CHECK);
+    TEST_ASSERT_EQUAL(0, stats.count);
+    TEST_ASSERT_EQUAL(0, stats.maxUs);
+    TEST_ASSERT_EQUAL(0, stats.buckets[0]);
+}
+
+void test_stage_timer_records_its_scope() {
+    StageMetrics metrics;
+    set_mock_millis(1000);
+    {
+        StageTimer timer(metrics, MetricStage::AGGREGATION);
+        set_mock_millis(1007);
+    }
+    StageStats stats = metrics.snapshot(MetricStage::AGGREGATION);
+    TEST_ASSERT_EQUAL(1, stats.count);
+    TEST_ASSERT_EQUAL(7000, stats.maxUs);
+}
+
+void test_stage_timer_macro_records_into_the_shared_instance() {
+    set_mock_millis(50);
+    {
+        STAGE_TIMER(MetricStage::MQTT_PUBLISH);
+        STAGE_TIMER(MetricStage::LOOP); // Two in one scope must not clash
+        set_mock_millis(52);
+    }
+    TEST_ASSERT_EQUAL(STAGE_METRICS_ENABLED ? 1 : 0, stageMetrics().snapshot(MetricStage::MQTT_PUBLISH).count);
+    TEST_ASSERT_EQUAL(STAGE_METRICS_ENABLED ? 2000 : 0, stageMetrics().snapshot(MetricStage::LOOP).maxUs);
+}
+
+void test_stage_names_are_distinct() {
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        const char* name = StageMetrics::stageName(static_cast<MetricStage>(i));
+        TEST_ASSERT_NOT_NULL(name);
+        for (size_t j = 0; j < i; j++) {
+            TEST_ASSERT_TRUE(std::string(name) != StageMetrics::stageName(static_cast<MetricStage>(j)));
+        }
+    }
+    TEST_ASSERT_EQUAL_STRING("unknown", StageMetrics::stageName(MetricStage::COUNT));
+}
+
+void test_json_lists_every_stage_and_task() {
+    StageMetrics metrics;
+    metrics.record(MetricStage::CURRENT_SAMPLING, 80000);
+    metrics.record(MetricStage::CURRENT_SAMPLING, 90000);
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    scheduler.addPeriodic("sensing", 0, 1, [&clock]() { clock.advanceUs(250); });
+    scheduler.runDue();
+
+    char buffer[2048];
+    size_t length = MetricsFormatter::buildJson(metrics, &scheduler, buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(length > 0);
+
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, buffer));
+    TEST_ASSERT_EQUAL(STAGE_HISTOGRAM_BOUNDS, doc["bucket_bounds_us"].size());
+    TEST_ASSERT_EQUAL(METRIC_STAGE_COUNT, doc["stages"].size());
+    JsonVariant sampling = doc["stages"][static_cast<int>(MetricStage::CURRENT_SAMPLING)];
+    TEST_ASSERT_EQUAL_STRING("current_sampling", sampling["stage"].as<const char*>());
+    TEST_ASSERT_EQUAL(2, sampling["count"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(80000, sampling["min_us"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(90000, sampling["max_us"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(85000, sampling["mean_us"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(STAGE_HISTOGRAM_BOUNDS + 1, sampling["buckets"].size());
+    TEST_ASSERT_EQUAL(2, sampling["buckets"][9].as<uint32_t>()); // (50 ms, 100 ms]
+
+    TEST_ASSERT_EQUAL(1, doc["tasks"].size());
+    TEST_ASSERT_EQUAL_STRING("sensing", doc["tasks"][0]["task"].as<const char*>());
+    TEST_ASSERT_EQUAL(1, doc["tasks"][0]["runs"].as<uint32_t>());
+    TEST_ASSERT_EQUAL(250, doc["tasks"][0]["max_run_us"].as<uint32_t>());
+
+    // Without a scheduler there is no task list; with too small a buffer, nothing.
+    length = MetricsFormatter::buildJson(metrics, nullptr, buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(length > 0);
+    TEST_ASSERT_NULL(strstr(buffer, "\"tasks\""));
+    TEST_ASSERT_EQUAL(0, MetricsFormatter::buildJson(metrics, nullptr, buffer, 64));
+}
+
+void test_json_fits_its_buffer_at_its_widest() {
+    StageMetrics metrics;
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        for (size_t bucket = 0; bucket <= STAGE_HISTOGRAM_BOUNDS; bucket++) {
+            metrics.record(static_cast<MetricStage>(i), UINT32_MAX); // Wide totals
+            metrics.record(static_cast<MetricStage>(i), bucket < STAGE_HISTOGRAM_BOUNDS
+                ? STAGE_HISTOGRAM_BOUNDS_US[bucket] : UINT32_MAX);
+        }
+    }
+    MockClock clock;
+    clock.setMs(1000000000);
+    CooperativeScheduler scheduler(clock);
+    for (size_t i = 0; i < CooperativeScheduler::MAX_TASKS; i++) {
+        scheduler.addPeriodic("mqtt-reconnect", 1, 0, [&clock]() { clock.advanceMs(100000); });
+    }
+    clock.advanceMs(1000000);
+    scheduler.runDue();
+
+    std::unique_ptr<char[]> buffer(new char[METRICS_JSON_BUFFER_SIZE]);
+    TEST_ASSERT_TRUE(MetricsFormatter::buildJson(metrics, &scheduler, buffer.get(), METRICS_JSON_BUFFER_SIZE) > 0);
+}
+
+void test_prometheus_histograms_are_cumulative() {
+    StageMetrics metrics;
+    metrics.record(MetricStage::LOOP, 50);
+    metrics.record(MetricStage::LOOP, 300);
+    metrics.record(MetricStage::LOOP, 2000000);
+    MockClock clock;
+    CooperativeScheduler scheduler(clock);
+    scheduler.addPeriodic("display", 10, 0, [&clock]() { clock.advanceUs(15000); });
+    clock.setMs(10);
+    scheduler.runDue();
+
+    std::string text;
+    size_t lines = 0;
+    MetricsFormatter::writePrometheus(metrics, &scheduler, [&](const char* line) {
+        text += line;
+        lines++;
+    });
+
+    const char* const expected[] = {
+        "# TYPE hvac_stage_duration_microseconds histogram\n",
+        "hvac_stage_duration_microseconds_bucket{stage=\"loop\",le=\"100\"} 1\n",
+        "hvac_stage_duration_microseconds_bucket{stage=\"loop\",le=\"250\"} 1\n",
+        "hvac_stage_duration_microseconds_bucket{stage=\"loop\",le=\"500\"} 2\n",
+        "hvac_stage_duration_microseconds_bucket{stage=\"loop\",le=\"1000000\"} 2\n",
+        "hvac_stage_duration_microseconds_bucket{stage=\"loop\",le=\"+Inf\"} 3\n",
+        "hvac_stage_duration_microseconds_sum{stage=\"loop\"} 2000350\n",
+        "hvac_stage_duration_microseconds_count{stage=\"loop\"} 3\n",
+        "hvac_stage_duration_microseconds_count{stage=\"mqtt_publish\"} 0\n",
+        "hvac_stage_duration_min_microseconds{stage=\"loop\"} 50\n",
+        "hvac_stage_duration_max_microseconds{stage=\"loop\"} 2000000\n",
+        "# TYPE hvac_task_runs_total counter\n",
+        "hvac_task_runs_total{task=\"display\"} 1\n",
+        "hvac_task_overruns_total{task=\"display\"} 1\n",
+        "hvac_task_missed_deadlines_total{task=\"display\"} 0\n",
+        "hvac_task_run_max_microseconds{task=\"display\"} 15000\n",
+    };
+    for (const char* line : expected) {
+        TEST_ASSERT_TRUE_MESSAGE(text.find(line) != std::string::npos, line);
+    }
+    // Every line came through the sink whole.
+    size_t newlines = 0;
+    for (char c : text) {
+        newlines += c == '\n';
+    }
+    TEST_ASSERT_EQUAL(lines, newlines);
+    TEST_ASSERT_EQUAL('\n', text.back());
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_record_tracks_min_max_mean_and_buckets);
+    RUN_TEST(test_stage_timer_records_its_scope);
+    RUN_TEST(test_stage_timer_macro_records_into_the_shared_instance);
+    RUN_TEST(test_stage_names_are_distinct);
+    RUN_TEST(test_json_lists_every_stage_and_task);
+    RUN_TEST(test_json_fits_its_buffer_at_its_widest);
+    RUN_TEST(test_prometheus_histograms_are_cumulative);
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+#include <unity.h>
+#include "storage/TimeSeriesLog.h"
+#include "mocks/MockFileSystem.h"
+#include "hvac_data.h"
+#include <string>
+#include <vector>
+
+// Pages hold 4 records; small segments so rotation is easy to reach.
+const size_t PAGE_SIZE = 4 * TimeSeriesLog::RECORD_SIZE;
+const size_t SEGMENTS = 3;
+const size_t RECORDS_PER_SEGMENT = 8;
+
+MockFileSystem fs;
+
+void setUp(void) {
+    fs.reset();
+}
+
+void tearDown(void) {}
+
+AggregatedHVACData make_record(uint32_t n) {
+    AggregatedHVACData data;
+    data.timestamp = 300000 * (n + 1);
+    data.sampleCount = 60;
+    data.avgReturnTempC = 20.0f + n * 0.01f;
+    data.avgDeltaT = 5.5f;
+    data.maxFanAmps = 2.25;
+    data.lastCompressorStatus = ComponentStatus::ON;
+    return data;
+}
+
+std::vector<AggregatedHVACData> replay_all(const TimeSeriesLog& log, size_t maxRecords = 1000) {
+    std::vector<AggregatedHVACData> records;
+    log.replay(maxRecords, [&records](const AggregatedHVACData& data) { records.push_back(data); });
+    return records;
+}
+
+void test_appends_are_batched_into_page_sized_writes() {
+    TimeSeriesLog log(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    log.begin();
+
+    for (uint32_t n = 0; n < 3; n++) {
+        log.append(make_record(n));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, fs.getFileContent("/ts_0.bin").size());
+    TEST_ASSERT_EQUAL_UINT32(3, log.pendingRecords());
+
+    log.append(make_record(3));
+    TEST_ASSERT_EQUAL_UINT32(PAGE_SIZE, fs.getFileContent("/ts_0.bin").size());
+    TEST_ASSERT_EQUAL_UINT32(0, log.pendingRecords());
+}
+
+void test_records_survive_a_restart() {
+    {
+        TimeSeriesLog log(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+        log.begin();
+        for (uint32_t n = 0; n < 6; n++) {
+            log.append(make_record(n));
+        }
+        TEST_ASSERT_TRUE(log.flush());
+    }
+
+    TimeSeriesLog rebooted(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    rebooted.begin();
+    std::vector<AggregatedHVACData> records = replay_all(rebooted);
+
+    TEST_ASSERT_EQUAL_UINT32(6, rebooted.nextSequence());
+    TEST_ASSERT_EQUAL_UINT32(6, records.size());
+    for (uint32_t n = 0; n < 6; n++) {
+        TEST_ASSERT_EQUAL_UINT32(make_record(n).timestamp, records[n].timestamp);
+        TEST_ASSERT_EQUAL_FLOAT(make_record(n).avgReturnTempC, records[n].avgReturnTempC);
+    }
+    TEST_ASSERT_EQUAL_UINT32(60, records[0].sampleCount);
+    TEST_ASSERT_EQUAL_FLOAT(2.25, records[0].maxFanAmps);
+    TEST_ASSERT_EQUAL(ComponentStatus::ON, records[0].lastCompressorStatus);
+}
+
+void test_flushing_each_append_survives_a_reboot_mid_page() {
+    {
+        TimeSeriesLog log(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+        log.begin();
+        for (uint32_t n = 0; n < 6; n++) {
+            log.append(make_record(n));
+            TEST_ASSERT_TRUE(log.flush());
+        }
+        TEST_ASSERT_EQUAL_UINT32(0, log.pendingRecords());
+    }
+
+    // A reset half way through the second page, then appends continue across
+    // the segment boundary.
+    {
+        TimeSeriesLog rebooted(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+        rebooted.begin();
+        TEST_ASSERT_EQUAL_UINT32(6, rebooted.nextSequence());
+        TEST_ASSERT_EQUAL_UINT32(6, replay_all(rebooted).size());
+        for (uint32_t n = 6; n < 11; n++) {
+            rebooted.append(make_record(n));
+            TEST_ASSERT_TRUE(rebooted.flush());
+        }
+    }
+
+    TimeSeriesLog again(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    again.begin();
+    std::vector<AggregatedHVACData> records = replay_all(again);
+    TEST_ASSERT_EQUAL_UINT32(0, again.corruptRecordsFound());
+    TEST_ASSERT_EQUAL_UINT32(11, again.nextSequence());
+    TEST_ASSERT_EQUAL_UINT32(11, records.size());
+    for (uint32_t n = 0; n < 11; n++) {
+        TEST_ASSERT_EQUAL_UINT32(make_record(n).timestamp, records[n].timestamp);
+    }
+    TEST_ASSERT_EQUAL_UINT32(RECORDS_PER_SEGMENT * TimeSeriesLog::RECORD_SIZE, fs.getFileContent("/ts_0.bin").size());
+}
+
+void test_replay_returns_only_the_newest_records() {
+    TimeSeriesLog log(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    log.begin();
+    for (uint32_t n = 0; n < 12; n++) {
+        log.append(make_record(n));
+    }
+
+    std::vector<AggregatedHVACData> records = replay_all(log, 5);
+
+    TEST_ASSERT_EQUAL_UINT32(5, records.size());
+    TEST_ASSERT_EQUAL_UINT32(make_record(7).timestamp, records[0].timestamp);
+    TEST_ASSERT_EQUAL_UINT32(make_record(11).timestamp, records[4].timestamp);
+}
+
+void test_segments_rotate_and_drop_the_oldest() {
+    TimeSeriesLog log(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    log.begin();
+
+    // 3 full segments, then 4 more records overwrite the first one.
+    const uint32_t total = SEGMENTS * RECORDS_PER_SEGMENT + 4;
+    for (uint32_t n = 0; n < total; n++) {
+        log.append(make_record(n));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(4 * TimeSeriesLog::RECORD_SIZE, fs.getFileContent("/ts_0.bin").size());
+    TEST_ASSERT_FALSE(fs.exists("/ts_3.bin"));
+
+    TimeSeriesLog rebooted(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    rebooted.begin();
+    std::vector<AggregatedHVACData> records = replay_all(rebooted);
+    TEST_ASSERT_EQUAL_UINT32(2 * RECORDS_PER_SEGMENT + 4, records.size());
+    TEST_ASSERT_EQUAL_UINT32(make_record(RECORDS_PER_SEGMENT).timestamp, records.front().timestamp);
+    TEST_ASSERT_EQUAL_UINT32(make_record(total - 1).timestamp, records.back().timestamp);
+}
+
+void test_torn_final_write_is_skipped_and_appends_resume_cleanly() {
+    {
+        TimeSeriesLog log(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+        log.begin();
+        for (uint32_t n = 0; n < 4; n++) {
+            log.append(make_record(n));
+        }
+    }
+    // Simulate a reset part way through writing the next record.
+    std::string content = fs.getFileContent("/ts_0.bin");
+    content.append(std::string(TimeSeriesLog::RECORD_SIZE / 2, '\x5A'));
+    fs.setFileContent("/ts_0.bin", content);
+
+    TimeSeriesLog rebooted(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT32(1, rebooted.corruptRecordsFound());
+    TEST_ASSERT_EQUAL_UINT32(4, rebooted.nextSequence());
+
+    for (uint32_t n = 4; n < 8; n++) {
+        rebooted.append(make_record(n));
+    }
+
+    std::vector<AggregatedHVACData> records = replay_all(rebooted);
+    TEST_ASSERT_EQUAL_UINT32(8, records.size());
+    for (uint32_t n = 0; n < 8; n++) {
+        TEST_ASSERT_EQUAL_UINT32(make_record(n).timestamp, records[n].timestamp);
+    }
+}
+
+void test_record_with_bad_crc_is_skipped() {
+    {
+        TimeSeriesLog log(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+        log.begin();
+        for (uint32_t n = 0; n < 4; n++) {
+            log.append(make_record(n));
+        }
+    }
+    std::string content = fs.getFileContent("/ts_0.bin");
+    content[TimeSeriesLog::RECORD_SIZE + 10] ^= 0x01; // Flip one bit in the second record
+    fs.setFileContent("/ts_0.bin", content);
+
+    TimeSeriesLog rebooted(fs, "/ts", SEGMENTS, RECORDS_PER_SEGMENT, PAGE_SIZE);
+    rebooted.begin();
+    std::vector<AggregatedHVACData> records = replay_all(rebooted);
+
+    TEST_ASSERT_EQUAL_UINT32(1, rebooted.corruptRecordsFound());
+    TEST_ASSERT_EQUAL_UINT32(3, records.size());
+    TEST_ASSERT_EQUAL_UINT32(make_record(0).timestamp, records[0].timestamp);
+    TEST_ASSERT_EQUAL_UINT32(make_record(2).timestamp, records[1].timestamp);
+}
+
+void test_crc32_matches_reference_value() {
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, TimeSeriesLog::crc32(reinterpret_cast<const uint8_t*>(check), 9));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_appends_are_batched_into_page_sized_writes);
+    RUN_TEST(test_records_survive_a_restart);
+    RUN_TEST(test_flushing_each_append_survives_a_reboot_mid_page);
+    RUN_TEST(test_replay_returns_only_the_newest_records);
+    RUN_TEST(test_segments_rotate_and_drop_the_oldest);
+    RUN_TEST(test_torn_final_write_is_skipped_and_appends_resume_cleanly);
+    RUN_TEST(test_record_with_bad_crc_is_skipped);
+    RUN_TEST(test_crc32_matches_reference_value);
+    return UNITY_END();
+}